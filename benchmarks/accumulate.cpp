@@ -0,0 +1,121 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// every vector dotted with the next, as a similarity pass over feature vectors does
+template <size_t S>
+BENCH_NOINLINE float dot_all(const std::vector<react::support::vector<S, float>>& v, const react::accumulation& policy, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t i = 0; i + 1 < v.size(); ++i)
+	{
+		out[i] = v[i].dot(v[i + 1], policy);
+		total += out[i];
+	}
+
+	return total;
+}
+
+// the vectors fit in L2, so the arithmetic is timed rather than memory
+template <size_t S>
+void run_dot(const size_t& passes)
+{
+	const size_t count = (256 * 1024) / sizeof(react::support::vector<S, float>);
+
+	std::vector<react::support::vector<S, float>> v(count);
+
+	for (auto& x : v)
+		for (size_t k = 0; k < S; ++k)
+			x[k] = bench::uniform(-1.0f, 1.0f) + (k % 16 == 0 ? 1000.0f : 0.0f);
+
+	// reference dots in double, to report the error of each policy
+	std::vector<double> truth(count);
+
+	for (size_t i = 0; i + 1 < count; ++i)
+	{
+		truth[i] = 0.0;
+
+		for (size_t k = 0; k < S; ++k)
+			truth[i] += static_cast<double>(v[i][k]) * v[i + 1][k];
+	}
+
+	std::cout << passes << " x " << count << " vector<" << S << ", float> dots, a large component every 16" << std::endl;
+
+	const react::accumulation policies[] = { react::accumulation::native, react::accumulation::in_double, react::accumulation::compensated, react::accumulation::pairwise };
+	const char* names[] = { "native", "in_double", "compensated", "pairwise" };
+	std::vector<float> out(count);
+	double native_ms = 0.0;
+
+	for (int p = 0; p < 4; ++p)
+	{
+		double ms = bench::time_ms([&]()
+		{
+			for (size_t k = 0; k < passes; ++k)
+				bench::keep(dot_all(v, policies[p], out.data()));
+		});
+
+		if (p == 0)
+			native_ms = ms;
+
+		double error = 0.0;
+
+		for (size_t i = 0; i + 1 < count; ++i)
+			error = std::max(error, std::abs(out[i] - truth[i]) / std::max(1e-30, std::abs(truth[i])));
+
+		bench::report("  " + std::string(names[p]), ms, passes * (count - 1) / ms / 1000.0, "Mdot/s");
+		std::cout << "    " << std::setprecision(2) << ms / native_ms << "x native, max relative error " << std::scientific
+			<< error << std::fixed << std::endl;
+	}
+}
+
+template <size_t N>
+void run_matrix()
+{
+	react::support::matrix<N, N, float> a;
+	react::support::matrix<N, N, float> b;
+
+	for (size_t k = 0; k < N * N; ++k)
+	{
+		a.m_data[k] = bench::uniform(-1.0f, 1.0f);
+		b.m_data[k] = bench::uniform(-1.0f, 1.0f);
+	}
+
+	std::cout << N << " x " << N << " float matrix multiply" << std::endl;
+
+	const react::accumulation policies[] = { react::accumulation::native, react::accumulation::in_double, react::accumulation::compensated, react::accumulation::pairwise };
+	const char* names[] = { "native", "in_double", "compensated", "pairwise" };
+	react::support::matrix<N, N, float> c;
+	double native_ms = 0.0;
+
+	for (int p = 0; p < 4; ++p)
+	{
+		double ms = bench::time_ms([&]() { c = a.dot(b, policies[p]); });
+
+		if (p == 0)
+			native_ms = ms;
+
+		bench::report("  " + std::string(names[p]), ms, 2.0 * N * N * N / ms / 1e6, "GFLOP/s");
+		std::cout << "    " << std::setprecision(2) << ms / native_ms << "x native" << std::endl;
+	}
+
+	bench::keep(c);
+}
+
+int main(int argc, char** argv)
+{
+	size_t passes = bench::arg_count(argc, argv, 1, 200);
+
+	run_dot<64>(passes);
+	run_dot<128>(passes);
+	run_dot<256>(passes);
+
+	run_matrix<64>();
+	run_matrix<128>();
+
+	return 0;
+}
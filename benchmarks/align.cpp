@@ -0,0 +1,65 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " pairs" << std::endl;
+
+	// a scan far from the origin with a little noise on the target
+	react::rigid_transformf truth(react::quatf(react::vec3f(0.2f, 1.0f, -0.4f), 0.6f), react::vec3f(3.0f, -1.0f, 0.5f));
+
+	std::vector<react::vec3f> a(count), b(count);
+	std::vector<float> weights(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		a[i] = react::vec3f(bench::uniform(-50.0f, 50.0f), bench::uniform(-20.0f, 20.0f), bench::uniform(-5.0f, 5.0f)) + react::vec3f(2000.0f, 500.0f, 0.0f);
+		b[i] = truth.apply(a[i]) + react::vec3f(bench::uniform(-0.01f, 0.01f), bench::uniform(-0.01f, 0.01f), bench::uniform(-0.01f, 0.01f));
+		weights[i] = bench::uniform(0.5f, 1.0f);
+	}
+
+	react::rigid_transformf result;
+
+	double ms = bench::time_ms([&]()
+	{
+		react::cross_covariance3f c;
+
+		for (size_t i = 0; i < count; ++i)
+			c.add(a[i], b[i]);
+
+		result = c.solve();
+	}, 3);
+	bench::report("align_rigid, per pair", ms, count / ms / 1000.0, "Mpairs/s");
+
+	ms = bench::time_ms([&]() { result = react::align_rigid(a.data(), b.data(), count); });
+	bench::report("align_rigid, batch", ms, count / ms / 1000.0, "Mpairs/s");
+
+	ms = bench::time_ms([&]() { result = react::align_rigid(a.data(), b.data(), weights.data(), count); });
+	bench::report("align_rigid, batch weighted", ms, count / ms / 1000.0, "Mpairs/s");
+
+	ms = bench::time_ms([&]() { result = react::align_rigid(a.data(), b.data(), count, false, true); });
+	bench::report("align_rigid, batch threaded", ms, count / ms / 1000.0, "Mpairs/s");
+
+	react::cross_covariance3f c;
+	c.add(a.data(), b.data(), count);
+
+	ms = bench::time_ms([&]() { for (int i = 0; i < 1000; ++i) result = c.solve(true); });
+	bench::report("solve", ms, 1000.0 / ms, "ksolves/s");
+
+	result = c.solve();
+
+	// small angles are read from the vector part of the difference rotation, acos of the dot product rounds to zero
+	float angle = 2.0f * std::asin(std::min(1.0f, (result.rotation * truth.rotation.conjugate()).xyz().length()));
+
+	std::cout << std::scientific << std::setprecision(2) << "rotation error " << angle << " rad, translation error " << (result.translation - truth.translation).length()
+		<< ", rms " << std::sqrt(c.residual(result)) << std::endl;
+
+	bench::keep(result);
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+#ifndef _RM_BENCH_H
+#define _RM_BENCH_H
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Keeps a kernel out of line, so it is timed and can be read with objdump on its own
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+namespace bench
+{
+	// Best wall time of 'repeats' runs of f, in milliseconds.
+	template <typename F>
+	double time_ms(F&& f, const int& repeats = 5)
+	{
+		double best = 1e300;
+
+		for (int i = 0; i < repeats; ++i)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			f();
+			auto end = std::chrono::high_resolution_clock::now();
+
+			double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+			if (ms < best)
+				best = ms;
+		}
+
+		return best;
+	}
+
+	inline size_t arg_count(int argc, char** argv, const int& index, const size_t& fallback)
+	{
+		return argc > index ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10)) : fallback;
+	}
+
+	inline std::mt19937& rng()
+	{
+		static std::mt19937 r(1234);
+
+		return r;
+	}
+
+	inline float uniform(const float& min, const float& max)
+	{
+		return std::uniform_real_distribution<float>(min, max)(rng());
+	}
+
+	inline void report(const std::string& name, const double& ms, const double& items, const std::string& unit)
+	{
+		std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed << std::setprecision(3) << ms << " ms"
+			<< std::setw(14) << std::setprecision(1) << items << ' ' << unit << std::endl;
+	}
+
+	// Keeps the optimizer from discarding results. The barrier takes the object's address and clobbers memory, so
+	// every byte of it, and all that went into it, has to be computed; elsewhere each byte is read through volatile.
+	template <typename T>
+	inline void keep(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		const volatile char* bytes = reinterpret_cast<const volatile char*>(&value);
+
+		for (size_t i = 0; i < sizeof(T); ++i)
+			static_cast<void>(bytes[i]);
+#endif
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// Bumpy height field with about 'triangles' triangles, the usual worst case of a lot of small, evenly spread primitives
+static void make_mesh(const size_t& triangles, std::vector<react::vec3f>& vertices, std::vector<uint32_t>& indices)
+{
+	size_t n = static_cast<size_t>(sqrt(triangles / 2.0));
+	float scale = 100.0f / n;
+
+	vertices.resize((n + 1) * (n + 1));
+	indices.clear();
+	indices.reserve(n * n * 6);
+
+	for (size_t z = 0; z <= n; ++z)
+	{
+		for (size_t x = 0; x <= n; ++x)
+		{
+			float fx = x * scale - 50.0f;
+			float fz = z * scale - 50.0f;
+
+			vertices[z * (n + 1) + x] = react::vec3f(fx, 3.0f * sin(fx * 0.3f) * cos(fz * 0.2f) + bench::uniform(-0.05f, 0.05f), fz);
+		}
+	}
+
+	for (size_t z = 0; z < n; ++z)
+	{
+		for (size_t x = 0; x < n; ++x)
+		{
+			uint32_t i = static_cast<uint32_t>(z * (n + 1) + x);
+			uint32_t row = static_cast<uint32_t>(n + 1);
+
+			indices.insert(indices.end(), { i, i + 1, i + row + 1, i, i + row + 1, i + row });
+		}
+	}
+}
+
+static void run(const size_t& triangles, const size_t& ray_count)
+{
+	std::vector<react::vec3f> vertices;
+	std::vector<uint32_t> indices;
+	make_mesh(triangles, vertices, indices);
+
+	react::triangle_mesh<float> mesh = { vertices.data(), indices.data(), indices.size() / 3 };
+
+	std::cout << mesh.triangle_count << " triangles" << std::endl;
+
+	react::bvhf tree;
+
+	double ms = bench::time_ms([&]() { tree.build(mesh); }, 1);
+	bench::report("  build", ms, mesh.triangle_count / ms / 1000.0, "Mtris/s");
+
+	ms = bench::time_ms([&]() { tree.build(mesh, true); }, 1);
+	bench::report("  build threaded", ms, mesh.triangle_count / ms / 1000.0, "Mtris/s");
+
+	std::cout << "  " << tree.node_count() << " nodes of " << sizeof(react::bvhf::node) << " bytes" << std::endl;
+
+	for (react::vec3f& v : vertices)
+		v.y() += 0.1f * sin(v.x());
+
+	ms = bench::time_ms([&]() { tree.refit(mesh); }, 3);
+	bench::report("  refit", ms, mesh.triangle_count / ms / 1000.0, "Mtris/s");
+
+	std::vector<react::rayf> rays(ray_count);
+
+	for (size_t i = 0; i < ray_count; ++i)
+	{
+		react::vec3f origin(bench::uniform(-50.0f, 50.0f), 50.0f, bench::uniform(-50.0f, 50.0f));
+		react::vec3f target(bench::uniform(-50.0f, 50.0f), 0.0f, bench::uniform(-50.0f, 50.0f));
+
+		rays[i] = react::rayf(origin, (target - origin).normalized());
+	}
+
+	std::vector<react::ray_hit<float>> hits(ray_count);
+
+	ms = bench::time_ms([&]() { tree.intersect(rays.data(), ray_count, hits.data()); }, 3);
+	bench::report("  closest hit", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	ms = bench::time_ms([&]() { tree.intersect(rays.data(), ray_count, hits.data(), true); }, 3);
+	bench::report("  closest hit threaded", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	size_t occluded = 0;
+
+	ms = bench::time_ms([&]()
+	{
+		occluded = 0;
+
+		for (const react::rayf& r : rays)
+			occluded += tree.occluded(r);
+	}, 3);
+	bench::report("  any hit", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	size_t found = 0;
+	size_t queries = ray_count / 4;
+
+	ms = bench::time_ms([&]()
+	{
+		found = 0;
+
+		for (size_t i = 0; i < queries; ++i)
+		{
+			react::vec3f c = rays[i].origin * 0.8f;
+			c.y() = 0.0f;
+
+			tree.overlap(react::aabbf(c - react::vec3f(1.0f), c + react::vec3f(1.0f)), [&](const uint32_t&) { ++found; });
+		}
+	}, 3);
+	bench::report("  aabb overlap", ms, queries / ms / 1000.0, "Mqueries/s");
+
+	std::cout << "  " << occluded << " occluded, " << found << " overlaps" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	size_t triangles = bench::arg_count(argc, argv, 1, 0);
+	size_t ray_count = bench::arg_count(argc, argv, 2, 1 << 18);
+
+	std::cout << react::support::thread_count() << " threads" << std::endl;
+
+	if (triangles)
+	{
+		run(triangles, ray_count);
+	}
+	else
+	{
+		run(100000, ray_count);
+		run(1000000, ray_count);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// Column-vector OpenGL style perspective projection looking down -z.
+static react::mat4f perspective(const float& fov_y, const float& aspect, const float& near_z, const float& far_z)
+{
+	float f = 1.0f / tan(fov_y / 2.0f);
+
+	react::mat4f m(0.0f);
+	m(0, 0) = f / aspect;
+	m(1, 1) = f;
+	m(2, 2) = (far_z + near_z) / (near_z - far_z);
+	m(2, 3) = (2.0f * far_z * near_z) / (near_z - far_z);
+	m(3, 2) = -1.0f;
+
+	return m;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1 << 20);
+
+	std::vector<float> x(count), y(count), z(count), r(count);
+	std::vector<float> min_x(count), min_y(count), min_z(count), max_x(count), max_y(count), max_z(count);
+	std::vector<react::vec4f> packed(count);
+	std::vector<uint32_t> visible(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = bench::uniform(-500.0f, 500.0f);
+		y[i] = bench::uniform(-500.0f, 500.0f);
+		z[i] = bench::uniform(-500.0f, 500.0f);
+		r[i] = bench::uniform(0.5f, 5.0f);
+
+		min_x[i] = x[i] - r[i]; max_x[i] = x[i] + r[i];
+		min_y[i] = y[i] - r[i]; max_y[i] = y[i] + r[i];
+		min_z[i] = z[i] - r[i]; max_z[i] = z[i] + r[i];
+
+		packed[i] = react::vec4f(x[i], y[i], z[i], r[i]);
+	}
+
+	react::frustumf f(perspective(react::math::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f));
+
+	react::sphere_soa<float> spheres = { x.data(), y.data(), z.data(), r.data(), count };
+	react::aabb_soa<float> boxes = { min_x.data(), min_y.data(), min_z.data(), max_x.data(), max_y.data(), max_z.data(), count };
+
+	size_t n = 0;
+
+	std::cout << count << " objects, " << react::support::thread_count() << " threads" << std::endl;
+
+	double ms = bench::time_ms([&]()
+	{
+		n = 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const react::vec4f& s = packed[i];
+
+			if (f.intersects(react::vec3f(s.x(), s.y(), s.z()), s.w()))
+				visible[n++] = static_cast<uint32_t>(i);
+		}
+	});
+	bench::report("spheres, per-object vec4f loop", ms, count / ms, "objects/ms");
+
+	ms = bench::time_ms([&]() { n = f.cull(spheres, visible.data()); });
+	bench::report("spheres, batch", ms, count / ms, "objects/ms");
+
+	ms = bench::time_ms([&]() { n = f.cull(spheres, visible.data(), true); });
+	bench::report("spheres, batch threaded", ms, count / ms, "objects/ms");
+
+	ms = bench::time_ms([&]() { n = f.cull(boxes, visible.data()); });
+	bench::report("aabbs, batch", ms, count / ms, "objects/ms");
+
+	ms = bench::time_ms([&]() { n = f.cull(boxes, visible.data(), true); });
+	bench::report("aabbs, batch threaded", ms, count / ms, "objects/ms");
+
+	std::cout << n << " visible" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
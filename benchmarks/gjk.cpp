@@ -0,0 +1,139 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// The previous approach: a hull as a plain array of vec3f, searched one point at a time
+struct point_hull
+{
+	std::vector<react::vec3f> points;
+};
+
+inline const react::vec3f support_point(const point_hull& h, const react::vec3f& direction)
+{
+	size_t best = 0;
+	float best_dot = h.points[0].dot(direction);
+
+	for (size_t i = 1; i < h.points.size(); ++i)
+	{
+		float d = h.points[i].dot(direction);
+
+		if (d > best_dot)
+		{
+			best_dot = d;
+			best = i;
+		}
+	}
+
+	return h.points[best];
+}
+
+inline const float shape_margin(const point_hull&)
+{
+	return 0.0f;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 100000);
+	size_t hull_points = bench::arg_count(argc, argv, 2, 64);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " pairs, " << hull_points << " hull points" << std::endl;
+
+	// points on an ellipsoid, every one of them is a hull vertex
+	point_hull plain;
+
+	for (size_t i = 0; i < hull_points; ++i)
+	{
+		react::vec3f d(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+		d.normalize();
+
+		plain.points.push_back(react::vec3f(d.x(), 0.7f * d.y(), 0.5f * d.z()));
+	}
+
+	react::convex_hullf hull(plain.points.data(), plain.points.size());
+
+	// every pair has its own two shapes, b placed near a so about a third of the pairs intersect
+	std::vector<react::rigid_transformf> poses;
+	std::vector<uint32_t> pairs;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::vec3f center(bench::uniform(-50.0f, 50.0f), bench::uniform(-50.0f, 50.0f), bench::uniform(-50.0f, 50.0f));
+
+		for (int k = 0; k < 2; ++k)
+		{
+			react::quatf r(react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f)), bench::uniform(-3.0f, 3.0f));
+			react::vec3f offset(bench::uniform(-1.6f, 1.6f), bench::uniform(-1.6f, 1.6f), bench::uniform(-1.6f, 1.6f));
+
+			pairs.push_back(static_cast<uint32_t>(poses.size()));
+			poses.push_back(react::rigid_transformf(r, center + offset * static_cast<float>(k)));
+		}
+	}
+
+	std::vector<react::transformed_shape<point_hull, float>> plain_shapes;
+	std::vector<react::transformed_shape<react::convex_hullf, float>> hull_shapes;
+	std::vector<react::obbf> boxes;
+	std::vector<react::capsulef> capsules;
+
+	for (const react::rigid_transformf& p : poses)
+	{
+		plain_shapes.push_back(react::transformed_shape<point_hull, float>(plain, p));
+		hull_shapes.push_back(react::transformed_shape<react::convex_hullf, float>(hull, p));
+		boxes.push_back(react::obbf(p.translation, p.rotation.toMat3(), react::vec3f(0.8f, 0.6f, 0.4f)));
+		capsules.push_back(react::capsulef(p.apply(react::vec3f(-0.6f, 0.0f, 0.0f)), p.apply(react::vec3f(0.6f, 0.0f, 0.0f)), 0.35f));
+	}
+
+	std::vector<react::contactf> out(count);
+	std::vector<react::gjk_cachef> caches(count);
+	size_t intersecting = 0;
+
+	double ms = bench::time_ms([&]()
+	{
+		react::collide(plain_shapes.data(), plain_shapes.data(), pairs.data(), count, out.data());
+	}, 3);
+	bench::report("hulls, vec3f support loop", ms, count / ms, "pairs/ms");
+
+	ms = bench::time_ms([&]()
+	{
+		react::collide(hull_shapes.data(), hull_shapes.data(), pairs.data(), count, out.data());
+	}, 3);
+	bench::report("hulls, SIMD support", ms, count / ms, "pairs/ms");
+
+	for (const react::contactf& c : out)
+		intersecting += c.intersecting;
+
+	std::cout << intersecting << " of " << count << " pairs intersect" << std::endl;
+
+	// the first pass fills the caches, the timed passes start from them
+	react::collide(hull_shapes.data(), hull_shapes.data(), pairs.data(), count, out.data(), caches.data());
+
+	ms = bench::time_ms([&]()
+	{
+		react::collide(hull_shapes.data(), hull_shapes.data(), pairs.data(), count, out.data(), caches.data());
+	}, 3);
+	bench::report("hulls, SIMD support, warm started", ms, count / ms, "pairs/ms");
+
+	ms = bench::time_ms([&]()
+	{
+		react::collide(hull_shapes.data(), hull_shapes.data(), pairs.data(), count, out.data(), caches.data(), true);
+	}, 3);
+	bench::report("hulls, warm started, threaded", ms, count / ms, "pairs/ms");
+
+	ms = bench::time_ms([&]()
+	{
+		react::collide(boxes.data(), boxes.data(), pairs.data(), count, out.data());
+	}, 3);
+	bench::report("boxes", ms, count / ms, "pairs/ms");
+
+	ms = bench::time_ms([&]()
+	{
+		react::collide(capsules.data(), boxes.data(), pairs.data(), count, out.data());
+	}, 3);
+	bench::report("capsules against boxes", ms, count / ms, "pairs/ms");
+
+	bench::keep(out);
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// a rolling terrain scan, side * side points with a little sensor noise
+static std::vector<react::vec3f> scan(const size_t& side, const float& extent, const float& noise)
+{
+	std::vector<react::vec3f> points(side * side);
+
+	for (size_t i = 0; i < side; ++i)
+	{
+		for (size_t j = 0; j < side; ++j)
+		{
+			float x = extent * (2.0f * i / (side - 1) - 1.0f) + bench::uniform(-noise, noise);
+			float y = extent * (2.0f * j / (side - 1) - 1.0f) + bench::uniform(-noise, noise);
+
+			points[i * side + j] = react::vec3f(x, y, 3.0f * sin(x * 0.11f) * cos(y * 0.08f) + 0.01f * x * y + bench::uniform(-noise, noise));
+		}
+	}
+
+	return points;
+}
+
+static void run(react::icpf& engine, const std::vector<react::vec3f>& source, const react::rigid_transformf& truth, const char* name, const react::icpf::settings& settings)
+{
+	react::rigid_transformf result;
+
+	double ms = bench::time_ms([&]() { result = engine.align(source.data(), source.size(), react::rigid_transformf(), settings); }, 1);
+	bench::report(name, ms, engine.iterations().size() * source.size() / settings.sample_stride / ms / 1000.0, "Mpoints/s");
+
+	double transform = 0, search = 0, rejection = 0, solve = 0;
+
+	for (const react::icpf::iteration& it : engine.iterations())
+	{
+		transform += it.transform_ms;
+		search += it.search_ms;
+		rejection += it.rejection_ms;
+		solve += it.solve_ms;
+	}
+
+	float angle = 2.0f * std::asin(std::min(1.0f, (result.rotation * truth.rotation.conjugate()).xyz().length()));
+
+	std::cout << "  " << engine.iterations().size() << " iterations" << (engine.converged() ? "" : " (not converged)") << std::fixed << std::setprecision(1)
+		<< ", transform " << transform << " ms, search " << search << " ms, rejection " << rejection << " ms, solve " << solve << " ms" << std::endl;
+	std::cout << "  " << std::scientific << std::setprecision(2) << "rms " << engine.iterations().back().rms << ", rotation error " << angle
+		<< " rad, translation error " << (result.translation - truth.translation).length() << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+	size_t side = std::max<size_t>(8, static_cast<size_t>(std::sqrt(static_cast<double>(count))));
+
+	std::cout << react::support::thread_count() << " threads, " << side * side << " target points" << std::endl;
+
+	// the source is a second, independently sampled scan of the middle of the terrain
+	react::rigid_transformf truth(react::quatf(react::vec3f(0.2f, -0.4f, 1.0f), 0.05f), react::vec3f(1.5f, -1.0f, 0.4f));
+
+	std::vector<react::vec3f> target = scan(side, 100.0f, 0.01f);
+	std::vector<react::vec3f> source = scan(side * 3 / 4, 70.0f, 0.01f);
+
+	for (react::vec3f& p : source)
+		p = truth.inverse().apply(p);
+
+	double ms = bench::time_ms([&]() { react::icpf engine(target.data(), target.size()); bench::keep(engine.normals().size()); }, 1);
+	bench::report("build", ms, target.size() / ms / 1000.0, "Mpoints/s");
+
+	react::icpf engine(target.data(), target.size());
+
+	react::icpf::settings settings;
+	settings.mode = react::icpf::POINT_TO_PLANE;
+
+	// normals are estimated on the first point to plane alignment
+	ms = bench::time_ms([&]() { react::estimate_normals(engine.tree(), target.data(), target.size(), 12, std::vector<react::vec3f>(target.size()).data(), true); }, 1);
+	bench::report("estimate_normals, threaded", ms, target.size() / ms / 1000.0, "Mpoints/s");
+
+	run(engine, source, truth, "point to plane, threaded", settings);
+
+	settings.parallel = false;
+	run(engine, source, truth, "point to plane, serial", settings);
+
+	settings.parallel = true;
+	settings.sample_stride = 8;
+	run(engine, source, truth, "point to plane, 1/8 sampled", settings);
+
+	settings = react::icpf::settings();
+	run(engine, source, truth, "point to point, threaded", settings);
+
+	settings.parallel = false;
+	run(engine, source, truth, "point to point, serial", settings);
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+	size_t query_count = bench::arg_count(argc, argv, 2, 100000);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " points" << std::endl;
+
+	float extent = static_cast<float>(cbrt(static_cast<double>(count))) * 0.5f;
+	const size_t k = 8;
+
+	std::vector<react::vec3f> points(count);
+
+	for (react::vec3f& p : points)
+		p = react::vec3f(bench::uniform(-extent, extent), bench::uniform(-extent, extent), bench::uniform(-extent, extent));
+
+	std::vector<react::vec3f> queries(query_count);
+
+	for (react::vec3f& q : queries)
+		q = react::vec3f(bench::uniform(-extent, extent), bench::uniform(-extent, extent), bench::uniform(-extent, extent));
+
+	react::kd_tree3f tree;
+
+	double ms = bench::time_ms([&]() { tree.build(points.data(), count); }, 3);
+	bench::report("build", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { tree.build(points.data(), count, true); }, 3);
+	bench::report("build threaded", ms, count / ms / 1000.0, "Mpoints/s");
+
+	std::vector<uint32_t> nearest(query_count * k);
+
+	ms = bench::time_ms([&]() { tree.nearest(queries.data(), query_count, 1, nearest.data()); }, 3);
+	bench::report("1 nearest", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	ms = bench::time_ms([&]() { tree.nearest(queries.data(), query_count, k, nearest.data()); }, 3);
+	bench::report("8 nearest", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	ms = bench::time_ms([&]() { tree.nearest(queries.data(), query_count, k, nearest.data(), false, 0.5f); }, 3);
+	bench::report("8 nearest, epsilon 0.5", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	ms = bench::time_ms([&]() { tree.nearest(queries.data(), query_count, k, nearest.data(), true); }, 3);
+	bench::report("8 nearest threaded", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> indices;
+
+	ms = bench::time_ms([&]() { tree.radius(queries.data(), query_count, 1.5f, offsets, indices); }, 3);
+	bench::report("radius 1.5", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	ms = bench::time_ms([&]() { tree.radius(queries.data(), query_count, 1.5f, offsets, indices, true); }, 3);
+	bench::report("radius 1.5 threaded", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	bench::keep(nearest[0]);
+	bench::keep(indices.size());
+
+	return 0;
+}
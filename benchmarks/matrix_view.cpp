@@ -0,0 +1,95 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// The previous cofactors, every minor copied out by reduce before its determinant
+BENCH_NOINLINE react::mat4f cofactors_copied(const react::mat4f& m)
+{
+	react::mat4f tmp = react::mat4f::ZERO;
+
+	for (size_t i = 0; i < 4; ++i)
+		for (size_t j = 0; j < 4; ++j)
+		{
+			react::mat3f minor = react::mat3f::ZERO;
+
+			for (size_t r = 0, rr = 0; r < 4; ++r)
+			{
+				if (r == i)
+					continue;
+
+				for (size_t c = 0, cc = 0; c < 4; ++c)
+					if (c != j)
+						minor.at(rr, cc++) = m.at(r, c);
+
+				++rr;
+			}
+
+			tmp.at(i, j) = ((i + j) & 1 ? -1.0f : 1.0f) * minor.determinant();
+		}
+
+	return tmp;
+}
+
+// The previous mat4 assembly, through a widened copy of the rotation and a temporary column
+BENCH_NOINLINE void assemble_copied(const react::rigid_transformf* t, react::mat4f* out, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::mat4f m(t[i].rotation.toMat3() * t[i].scale);
+
+		m.at(3, 3) = 1.0f;
+		m.set_col(react::vec4f(t[i].translation.x(), t[i].translation.y(), t[i].translation.z(), 1.0f), 3);
+
+		out[i] = m;
+	}
+}
+
+BENCH_NOINLINE void assemble_views(const react::rigid_transformf* t, react::mat4f* out, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::mat4f m;
+
+		m.block<3, 3>(0, 0) = t[i].rotation.toMat3() * t[i].scale;
+		m.col(3) = react::vec4f(t[i].translation.x(), t[i].translation.y(), t[i].translation.z(), 1.0f);
+
+		out[i] = m;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 200000);
+
+	std::cout << count << " matrices" << std::endl;
+
+	std::vector<react::rigid_transformf> transforms(count);
+	std::vector<react::mat4f> m(count), out(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::quatf r(react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f)), bench::uniform(-3.0f, 3.0f));
+
+		transforms[i] = react::rigid_transformf(r, react::vec3f(bench::uniform(-9.0f, 9.0f), bench::uniform(-9.0f, 9.0f), bench::uniform(-9.0f, 9.0f)), bench::uniform(0.5f, 2.0f));
+	}
+
+	assemble_views(transforms.data(), m.data(), count);
+
+	double ms = bench::time_ms([&]() { assemble_copied(transforms.data(), out.data(), count); });
+	bench::report("mat4 assembly, copies", ms, count / ms / 1000.0, "Mmat/s");
+
+	ms = bench::time_ms([&]() { assemble_views(transforms.data(), out.data(), count); });
+	bench::report("mat4 assembly, block and col views", ms, count / ms / 1000.0, "Mmat/s");
+
+	ms = bench::time_ms([&]() { for (size_t i = 0; i < count; ++i) out[i] = cofactors_copied(m[i]); });
+	bench::report("mat4 cofactors, copied minors", ms, count / ms / 1000.0, "Mmat/s");
+
+	ms = bench::time_ms([&]() { for (size_t i = 0; i < count; ++i) out[i] = m[i].cofactors(); });
+	bench::report("mat4 cofactors, minor views", ms, count / ms / 1000.0, "Mmat/s");
+
+	bench::keep(out);
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// Radius query from every point, the typical particle neighbour loop whose speed depends on memory order
+static size_t neighbour_loop(const react::spatial_hashf& grid, const std::vector<react::vec3f>& points, const float& radius)
+{
+	size_t found = 0;
+
+	for (const react::vec3f& p : points)
+		grid.radius(p, radius, [&](const uint32_t&, const float&) { ++found; });
+
+	return found;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " points" << std::endl;
+
+	float extent = static_cast<float>(cbrt(static_cast<double>(count))) * 0.5f;
+
+	std::vector<react::vec3f> points(count);
+
+	for (react::vec3f& p : points)
+		p = react::vec3f(bench::uniform(-extent, extent), bench::uniform(-extent, extent), bench::uniform(-extent, extent));
+
+	std::vector<float> x(count), y(count), z(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = points[i].x();
+		y[i] = points[i].y();
+		z[i] = points[i].z();
+	}
+
+	react::aabbf bounds = react::aabbf::from_points(points.data(), count);
+
+	std::vector<uint32_t> codes(count);
+	std::vector<uint64_t> codes63(count);
+
+	double ms = bench::time_ms([&]()
+	{
+		for (size_t i = 0; i < count; ++i)
+			codes[i] = react::morton_encode(points[i], bounds);
+	});
+	bench::report("encode 30-bit, per point", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { react::morton_encode(points.data(), count, bounds, codes.data()); });
+	bench::report("encode 30-bit, batch AoS", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { react::morton_encode(x.data(), y.data(), z.data(), count, bounds, codes.data()); });
+	bench::report("encode 30-bit, batch SoA", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { react::morton_encode63(x.data(), y.data(), z.data(), count, bounds, codes63.data()); });
+	bench::report("encode 63-bit, batch SoA", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { react::morton_encode63(x.data(), y.data(), z.data(), count, bounds, codes63.data(), true); });
+	bench::report("encode 63-bit, batch SoA threaded", ms, count / ms / 1000.0, "Mpoints/s");
+
+	std::vector<uint32_t> order(count);
+	std::vector<uint64_t> keys(count);
+
+	ms = bench::time_ms([&]()
+	{
+		keys = codes63;
+
+		for (uint32_t i = 0; i < count; ++i)
+			order[i] = i;
+
+		std::sort(order.begin(), order.end(), [&](const uint32_t& a, const uint32_t& b) { return keys[a] < keys[b]; });
+	}, 3);
+	bench::report("std::sort by 63-bit key", ms, count / ms / 1000.0, "Mkeys/s");
+
+	ms = bench::time_ms([&]()
+	{
+		keys = codes63;
+
+		for (uint32_t i = 0; i < count; ++i)
+			order[i] = i;
+
+		react::support::radix_sort(keys.data(), order.data(), count);
+	}, 3);
+	bench::report("radix sort 63-bit key", ms, count / ms / 1000.0, "Mkeys/s");
+
+	ms = bench::time_ms([&]() { react::morton_order(points.data(), count, order.data(), true); }, 3);
+	bench::report("morton_order threaded", ms, count / ms / 1000.0, "Mpoints/s");
+
+	// downstream effect on a neighbour loop, same points in random and in Z-order
+	std::vector<react::vec3f> sorted(points);
+	react::support::permute(sorted.data(), order.data(), count);
+
+	react::spatial_hashf grid(1.0f);
+	size_t found = 0;
+
+	grid.build(points.data(), count);
+	double random_ms = bench::time_ms([&]() { found = neighbour_loop(grid, points, 1.0f); }, 3);
+	bench::report("neighbour loop, random order", random_ms, count / random_ms / 1000.0, "Mqueries/s");
+
+	grid.build(sorted.data(), count);
+	double sorted_ms = bench::time_ms([&]() { found = neighbour_loop(grid, sorted, 1.0f); }, 3);
+	bench::report("neighbour loop, Z-order", sorted_ms, count / sorted_ms / 1000.0, "Mqueries/s");
+
+	std::cout << "  " << random_ms / sorted_ms << "x from reordering, " << found / static_cast<double>(count) << " neighbours per point" << std::endl;
+
+	// LBVH against the SAH builder on a soup of small triangles
+	size_t triangles = count / 2;
+	std::vector<react::vec3f> vertices(triangles * 3);
+
+	for (size_t i = 0; i < triangles; ++i)
+	{
+		react::vec3f c = points[i] * 2.0f;
+
+		for (int j = 0; j < 3; ++j)
+			vertices[3 * i + j] = c + react::vec3f(bench::uniform(-0.5f, 0.5f), bench::uniform(-0.5f, 0.5f), bench::uniform(-0.5f, 0.5f));
+	}
+
+	react::triangle_mesh<float> mesh = { vertices.data(), nullptr, triangles };
+
+	std::vector<react::rayf> rays(1 << 17);
+
+	for (react::rayf& r : rays)
+	{
+		react::vec3f origin(bench::uniform(-extent, extent), bench::uniform(-extent, extent), bench::uniform(-extent, extent));
+		react::vec3f direction(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+
+		r = react::rayf(origin * 2.0f, direction.normalized());
+	}
+
+	std::vector<react::ray_hit<float>> hits(rays.size());
+	react::bvhf tree;
+
+	ms = bench::time_ms([&]() { tree.build(mesh); }, 1);
+	bench::report("bvh SAH build", ms, triangles / ms / 1000.0, "Mtris/s");
+
+	ms = bench::time_ms([&]() { tree.intersect(rays.data(), rays.size(), hits.data()); }, 3);
+	bench::report("  closest hit", ms, rays.size() / ms / 1000.0, "Mrays/s");
+
+	ms = bench::time_ms([&]() { tree.build_lbvh(mesh); }, 1);
+	bench::report("bvh LBVH build", ms, triangles / ms / 1000.0, "Mtris/s");
+
+	ms = bench::time_ms([&]() { tree.intersect(rays.data(), rays.size(), hits.data()); }, 3);
+	bench::report("  closest hit", ms, rays.size() / ms / 1000.0, "Mrays/s");
+
+	bench::keep(codes[0]);
+	bench::keep(found);
+
+	return 0;
+}
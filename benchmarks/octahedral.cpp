@@ -0,0 +1,111 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// one at a time through the scalar lanes, what a per-vertex exporter does
+template <typename P>
+BENCH_NOINLINE void pack_each(const react::vec3f* n, P* out, const size_t& count, const react::octahedral_mode& mode)
+{
+	for (size_t i = 0; i < count; ++i)
+		react::normal_pack(n[i], out[i], mode);
+}
+
+template <typename P>
+BENCH_NOINLINE void unpack_each(const P* in, react::vec3f* n, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		react::normal_unpack(in[i], n[i]);
+}
+
+template <typename P>
+void run(const std::string& name, const std::vector<react::vec3f>& n, const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z)
+{
+	const size_t count = n.size();
+	std::vector<P> packed(count);
+	std::vector<react::vec3f> back(count);
+	std::vector<float> bx(count), by(count), bz(count);
+
+	std::cout << name << ", " << sizeof(P) << " bytes" << std::endl;
+
+	const react::octahedral_mode modes[] = { react::octahedral_mode::fast, react::octahedral_mode::precise };
+
+	for (react::octahedral_mode mode : modes)
+	{
+		const std::string label = mode == react::octahedral_mode::fast ? "fast" : "precise";
+
+		double ms = bench::time_ms([&]() { pack_each(n.data(), packed.data(), count, mode); });
+		bench::report("  encode " + label + ", one at a time", ms, count / ms / 1000.0, "Mvec/s");
+
+		ms = bench::time_ms([&]() { react::normal_pack(n.data(), count, packed.data(), mode); });
+		bench::report("  encode " + label + ", batch", ms, count / ms / 1000.0, "Mvec/s");
+
+		ms = bench::time_ms([&]() { react::normal_pack(x.data(), y.data(), z.data(), count, packed.data(), mode); });
+		bench::report("  encode " + label + ", structure of arrays", ms, count / ms / 1000.0, "Mvec/s");
+
+		react::normal_unpack(packed.data(), count, back.data());
+
+		double worst = 0.0;
+		double total = 0.0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			double e = 2.0 * asin(std::min(1.0, (back[i] - n[i]).length() * 0.5));
+
+			worst = std::max(worst, e);
+			total += e;
+		}
+
+		const double degrees = 180.0 / 3.14159265358979323846;
+
+		std::cout << "  error " << label << ", mean " << std::setprecision(4) << total / count * degrees << " deg, max "
+			<< worst * degrees << " deg" << std::endl;
+	}
+
+	double ms = bench::time_ms([&]() { unpack_each(packed.data(), back.data(), count); });
+	bench::report("  decode, one at a time", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { react::normal_unpack(packed.data(), count, back.data()); });
+	bench::report("  decode, batch", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { react::normal_unpack(packed.data(), count, bx.data(), by.data(), bz.data()); });
+	bench::report("  decode, structure of arrays", ms, count / ms / 1000.0, "Mvec/s");
+
+	bench::keep(back);
+	bench::keep(bx);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 4000000);
+
+	std::cout << count << " unit vec3f, 12 bytes each" << std::endl;
+
+	std::vector<react::vec3f> n(count);
+	std::vector<float> x(count), y(count), z(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::vec3f v;
+
+		do
+		{
+			v = react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+		}
+		while (v.length() > 1.0f || v.length() < 0.01f);
+
+		n[i] = v.normalized();
+		x[i] = n[i].x();
+		y[i] = n[i].y();
+		z[i] = n[i].z();
+	}
+
+	run<react::packed_normal16>("octahedral 2 x 8 bits", n, x, y, z);
+	run<react::packed_normal24>("octahedral 2 x 12 bits", n, x, y, z);
+	run<react::packed_normal32>("octahedral 2 x 16 bits", n, x, y, z);
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// largest |R^T R - I| over the upper 3x3 blocks
+template <size_t N>
+static float orthogonality_error(const std::vector<react::support::matrix<N, N, float>>& m)
+{
+	float error = 0.0f;
+
+	for (const react::support::matrix<N, N, float>& r : m)
+		for (size_t i = 0; i < 3; ++i)
+			for (size_t j = 0; j < 3; ++j)
+				error = std::max(error, std::abs(react::vec3f(r.col(i)).dot(react::vec3f(r.col(j))) - (i == j ? 1.0f : 0.0f)));
+
+	return error;
+}
+
+static void print_error(const float& error)
+{
+	std::cout << "  " << std::scientific << std::setprecision(2) << "max |R^T R - I| " << error << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " rotations" << std::endl;
+
+	// rotations accumulated by many multiplies drift slightly from orthonormal
+	std::vector<react::mat3f> drifted(count);
+	std::vector<react::mat4f> drifted4(count);
+	std::vector<react::quatf> quats(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::quatf q(react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f)), bench::uniform(-3.0f, 3.0f));
+
+		drifted[i] = q.toMat3();
+
+		for (int k = 0; k < 9; ++k)
+			drifted[i].m_data[k] += bench::uniform(-1e-3f, 1e-3f);
+
+		drifted4[i] = react::mat4f(drifted[i]);
+		drifted4[i].at(0, 3) = bench::uniform(-100.0f, 100.0f);
+
+		quats[i] = q * (1.0f + bench::uniform(-1e-3f, 1e-3f));
+	}
+
+	std::vector<react::mat3f> m = drifted;
+
+	std::cout << "mat3f" << std::endl;
+	print_error(orthogonality_error(m));
+
+	// the previous approach, round trip through a quaternion
+	double ms = bench::time_ms([&]() { m = drifted; for (react::mat3f& r : m) r = react::quatf(r).normalized().toMat3(); });
+	bench::report("  quat round trip", ms, count / ms / 1000.0, "Mmat/s");
+	print_error(orthogonality_error(m));
+
+	ms = bench::time_ms([&]() { m = drifted; for (react::mat3f& r : m) react::orthonormalize(r); });
+	bench::report("  gram-schmidt", ms, count / ms / 1000.0, "Mmat/s");
+	print_error(orthogonality_error(m));
+
+	ms = bench::time_ms([&]() { m = drifted; react::orthonormalize(m.data(), count); });
+	bench::report("  gram-schmidt, batch", ms, count / ms / 1000.0, "Mmat/s");
+
+	ms = bench::time_ms([&]() { m = drifted; react::orthonormalize(m.data(), count, true); });
+	bench::report("  gram-schmidt, batch threaded", ms, count / ms / 1000.0, "Mmat/s");
+
+	ms = bench::time_ms([&]() { m = drifted; for (react::mat3f& r : m) react::orthonormalize_fast(r); });
+	bench::report("  symmetric", ms, count / ms / 1000.0, "Mmat/s");
+	print_error(orthogonality_error(m));
+
+	ms = bench::time_ms([&]() { m = drifted; react::orthonormalize_fast(m.data(), count); });
+	bench::report("  symmetric, batch", ms, count / ms / 1000.0, "Mmat/s");
+
+	ms = bench::time_ms([&]() { m = drifted; react::orthonormalize_fast(m.data(), count, true); });
+	bench::report("  symmetric, batch threaded", ms, count / ms / 1000.0, "Mmat/s");
+
+	std::vector<react::mat4f> m4 = drifted4;
+
+	std::cout << "mat4f" << std::endl;
+
+	ms = bench::time_ms([&]() { m4 = drifted4; react::orthonormalize(m4.data(), count); });
+	bench::report("  gram-schmidt, batch", ms, count / ms / 1000.0, "Mmat/s");
+	print_error(orthogonality_error(m4));
+
+	ms = bench::time_ms([&]() { m4 = drifted4; react::orthonormalize_fast(m4.data(), count); });
+	bench::report("  symmetric, batch", ms, count / ms / 1000.0, "Mmat/s");
+	print_error(orthogonality_error(m4));
+
+	std::vector<react::quatf> q = quats;
+
+	std::cout << "quatf" << std::endl;
+
+	ms = bench::time_ms([&]() { q = quats; for (react::quatf& r : q) r.normalize(); });
+	bench::report("  normalize", ms, count / ms / 1000.0, "Mquat/s");
+
+	ms = bench::time_ms([&]() { q = quats; for (react::quatf& r : q) r.renormalize_fast(); });
+	bench::report("  renormalize_fast", ms, count / ms / 1000.0, "Mquat/s");
+
+	ms = bench::time_ms([&]() { q = quats; react::quatf::renormalize_fast(q.data(), count); });
+	bench::report("  renormalize_fast, batch", ms, count / ms / 1000.0, "Mquat/s");
+
+	ms = bench::time_ms([&]() { q = quats; react::quatf::renormalize_fast(q.data(), count, true); });
+	bench::report("  renormalize_fast, batch threaded", ms, count / ms / 1000.0, "Mquat/s");
+
+	float error = 0.0f;
+
+	for (const react::quatf& r : q)
+		error = std::max(error, std::abs(r.length() - 1.0f));
+
+	std::cout << "  " << std::scientific << std::setprecision(2) << "max ||q| - 1| " << error << std::endl;
+
+	bench::keep(m);
+	bench::keep(m4);
+	bench::keep(q);
+
+	return 0;
+}
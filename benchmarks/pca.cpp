@@ -0,0 +1,98 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+	size_t clusters = bench::arg_count(argc, argv, 2, 10000);
+	size_t cluster_size = bench::arg_count(argc, argv, 3, 100);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " points" << std::endl;
+
+	std::vector<react::vec3f> points(count);
+
+	for (react::vec3f& p : points)
+		p = react::vec3f(bench::uniform(-10.0f, 10.0f), bench::uniform(-3.0f, 3.0f), bench::uniform(-1.0f, 1.0f)) + react::vec3f(500.0f, 0.0f, 0.0f);
+
+	std::vector<float> x(count), y(count), z(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = points[i].x();
+		y[i] = points[i].y();
+		z[i] = points[i].z();
+	}
+
+	react::mat3f c;
+
+	double ms = bench::time_ms([&]()
+	{
+		react::covariance3f acc;
+
+		for (const react::vec3f& p : points)
+			acc.add(p);
+
+		c = acc.covariance();
+	});
+	bench::report("covariance, per point", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { c = react::covariance3f(points.data(), count).covariance(); });
+	bench::report("covariance, batch AoS", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { c = react::covariance3f().add(x.data(), y.data(), z.data(), count).covariance(); });
+	bench::report("covariance, batch SoA", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { c = react::covariance3f(points.data(), count, true).covariance(); });
+	bench::report("covariance, batch AoS threaded", ms, count / ms / 1000.0, "Mpoints/s");
+
+	std::vector<react::mat3f> matrices(count / 10);
+
+	for (react::mat3f& m : matrices)
+	{
+		for (size_t row = 0; row < 3; ++row)
+			for (size_t col = row; col < 3; ++col)
+				m(row, col) = m(col, row) = bench::uniform(-1.0f, 1.0f);
+	}
+
+	std::vector<react::symmetric_eigen3f> eigen(matrices.size());
+
+	ms = bench::time_ms([&]() { react::symmetric_eigen3f::compute(matrices.data(), matrices.size(), eigen.data()); }, 3);
+	bench::report("symmetric_eigen3", ms, matrices.size() / ms / 1000.0, "Mmatrices/s");
+
+	ms = bench::time_ms([&]() { react::symmetric_eigen3f::compute(matrices.data(), matrices.size(), eigen.data(), true); }, 3);
+	bench::report("symmetric_eigen3 threaded", ms, matrices.size() / ms / 1000.0, "Mmatrices/s");
+
+	// clusters of points around random centres
+	std::vector<react::vec3f> cluster_points(clusters * cluster_size);
+	std::vector<uint32_t> offsets(clusters + 1);
+
+	for (size_t i = 0; i < clusters; ++i)
+	{
+		react::vec3f center(bench::uniform(-100.0f, 100.0f), bench::uniform(-100.0f, 100.0f), bench::uniform(-100.0f, 100.0f));
+		react::vec3f stretch(bench::uniform(0.2f, 3.0f), bench::uniform(0.2f, 3.0f), bench::uniform(0.2f, 3.0f));
+
+		offsets[i] = static_cast<uint32_t>(i * cluster_size);
+
+		for (size_t j = 0; j < cluster_size; ++j)
+			cluster_points[i * cluster_size + j] = center + react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f)) * stretch;
+	}
+
+	offsets[clusters] = static_cast<uint32_t>(clusters * cluster_size);
+
+	std::vector<react::obbf> boxes(clusters);
+
+	ms = bench::time_ms([&]() { react::obbf::fit(cluster_points.data(), offsets.data(), clusters, boxes.data()); }, 3);
+	bench::report("obb fit", ms, clusters / ms, "kclusters/s");
+
+	ms = bench::time_ms([&]() { react::obbf::fit(cluster_points.data(), offsets.data(), clusters, boxes.data(), true); }, 3);
+	bench::report("obb fit threaded", ms, clusters / ms, "kclusters/s");
+
+	bench::keep(c);
+	bench::keep(eigen[0]);
+	bench::keep(boxes[0]);
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// one at a time through the scalar code, what a per-object serializer does
+template <typename P>
+BENCH_NOINLINE void pack_each(const react::quatf* q, P* out, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		react::quat_pack(q[i], out[i]);
+}
+
+template <typename P>
+BENCH_NOINLINE void unpack_each(const P* in, react::quatf* q, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		react::quat_unpack(in[i], q[i]);
+}
+
+template <typename P>
+BENCH_NOINLINE void pack_batch(const react::quatf* q, P* out, const size_t& count)
+{
+	react::quat_pack(q, count, out);
+}
+
+template <typename P>
+BENCH_NOINLINE void unpack_batch(const P* in, react::quatf* q, const size_t& count)
+{
+	react::quat_unpack(in, count, q);
+}
+
+static double angle(const react::quatf& a, const react::quatf& b)
+{
+	double plus = 0.0;
+	double minus = 0.0;
+
+	for (int k = 0; k < 4; ++k)
+	{
+		plus += (double(a.m_data[k]) - b.m_data[k]) * (double(a.m_data[k]) - b.m_data[k]);
+		minus += (double(a.m_data[k]) + b.m_data[k]) * (double(a.m_data[k]) + b.m_data[k]);
+	}
+
+	return 4.0 * asin(std::min(1.0, sqrt(std::min(plus, minus)) * 0.5));
+}
+
+template <typename P>
+void run(const std::string& name, const std::vector<react::quatf>& q)
+{
+	const size_t count = q.size();
+	std::vector<P> packed(count);
+	std::vector<react::quatf> back(count);
+
+	std::cout << name << ", " << sizeof(P) << " bytes" << std::endl;
+
+	double ms = bench::time_ms([&]() { pack_each(q.data(), packed.data(), count); });
+	bench::report("  encode, one at a time", ms, count / ms / 1000.0, "Mquat/s");
+
+	ms = bench::time_ms([&]() { pack_batch(q.data(), packed.data(), count); });
+	bench::report("  encode, batch", ms, count / ms / 1000.0, "Mquat/s");
+
+	ms = bench::time_ms([&]() { unpack_each(packed.data(), back.data(), count); });
+	bench::report("  decode, one at a time", ms, count / ms / 1000.0, "Mquat/s");
+
+	ms = bench::time_ms([&]() { unpack_batch(packed.data(), back.data(), count); });
+	bench::report("  decode, batch", ms, count / ms / 1000.0, "Mquat/s");
+
+	// rotation angle error as a fraction of the documented bound, in tenths
+	size_t histogram[11] = {};
+	double worst = 0.0;
+	double total = 0.0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		double e = angle(q[i], back[i]);
+
+		worst = std::max(worst, e);
+		total += e;
+		++histogram[std::min<size_t>(10, static_cast<size_t>(e / P::max_angle() * 10.0))];
+	}
+
+	const double degrees = 180.0 / 3.14159265358979323846;
+
+	std::cout << "  error, mean " << std::setprecision(5) << total / count * degrees << " deg, max " << worst * degrees
+		<< " deg, bound " << P::max_angle() * degrees << " deg" << std::endl;
+
+	for (int b = 0; b < 11; ++b)
+	{
+		std::cout << "    " << std::setw(4) << b * 10 << (b < 10 ? "% - " : "% +  ") << std::setw(8) << std::setprecision(3)
+			<< 100.0 * histogram[b] / count << "%" << std::endl;
+	}
+
+	bench::keep(back);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << count << " unit quaternions" << std::endl;
+
+	std::vector<react::quatf> q(count);
+
+	for (react::quatf& r : q)
+	{
+		r = react::quatf(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+		r = r * (1.0f / r.length());
+	}
+
+	run<react::packed_quat32>("smallest three, 2 + 3 x 10 bits", q);
+	run<react::packed_quat48>("smallest three, 2 + 3 x 15 bits", q);
+	run<react::packed_quat64>("snorm16 x 4", q);
+
+	return 0;
+}
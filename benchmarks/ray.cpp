@@ -0,0 +1,79 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+template <size_t W>
+static double trace_packets(const std::vector<react::rayf>& rays, const react::triangle_mesh<float>& mesh, std::vector<react::ray_hit<float>>& hits)
+{
+	return bench::time_ms([&]() { react::intersect_triangles<W>(rays.data(), rays.size(), mesh, hits.data()); }, 3);
+}
+
+int main(int argc, char** argv)
+{
+	size_t ray_count = bench::arg_count(argc, argv, 1, 1 << 16);
+	size_t triangle_count = bench::arg_count(argc, argv, 2, 256);
+
+	std::vector<react::vec3f> vertices(triangle_count * 3);
+
+	for (size_t i = 0; i < triangle_count; ++i)
+	{
+		react::vec3f center(bench::uniform(-10.0f, 10.0f), bench::uniform(-10.0f, 10.0f), bench::uniform(-30.0f, -10.0f));
+
+		for (int j = 0; j < 3; ++j)
+			vertices[3 * i + j] = center + react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+	}
+
+	std::vector<react::rayf> rays(ray_count);
+
+	for (size_t i = 0; i < ray_count; ++i)
+		rays[i] = react::rayf(react::vec3f::ZERO, react::vec3f(bench::uniform(-0.5f, 0.5f), bench::uniform(-0.5f, 0.5f), -1.0f).normalized());
+
+	react::triangle_mesh<float> mesh = { vertices.data(), nullptr, triangle_count };
+	std::vector<react::ray_hit<float>> hits(ray_count);
+
+	std::cout << ray_count << " rays x " << triangle_count << " triangles, " << react::support::thread_count() << " threads" << std::endl;
+
+	double ms = bench::time_ms([&]()
+	{
+		for (size_t i = 0; i < ray_count; ++i)
+		{
+			react::ray_hit<float> hit;
+
+			for (size_t tri = 0; tri < triangle_count; ++tri)
+			{
+				float t, u, v;
+
+				if (rays[i].intersects(vertices[3 * tri], vertices[3 * tri + 1], vertices[3 * tri + 2], t, u, v, hit.t))
+				{
+					hit.t = t;
+					hit.u = u;
+					hit.v = v;
+					hit.primitive = static_cast<uint32_t>(tri);
+				}
+			}
+
+			hits[i] = hit;
+		}
+	}, 3);
+	bench::report("scalar", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	ms = trace_packets<4>(rays, mesh, hits);
+	bench::report("packet x4", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	ms = trace_packets<8>(rays, mesh, hits);
+	bench::report("packet x8", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	ms = bench::time_ms([&]() { react::intersect_triangles(rays.data(), ray_count, mesh, hits.data(), true); }, 3);
+	bench::report("native packet, threaded", ms, ray_count / ms / 1000.0, "Mrays/s");
+
+	size_t hit_count = 0;
+
+	for (const react::ray_hit<float>& hit : hits)
+		hit_count += hit.hit();
+
+	std::cout << hit_count << " hits, " << (double)ray_count * triangle_count / ms / 1e6 << " G ray/triangle tests/s" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
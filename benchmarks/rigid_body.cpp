@@ -0,0 +1,104 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 100000);
+	const float dt = 1.0f / 60.0f;
+	const int steps = 100;
+
+	std::cout << react::support::thread_count() << " threads, " << count << " bodies, " << steps << " steps" << std::endl;
+
+	std::vector<react::rigid_bodyf> bodies(count);
+	std::vector<react::vec3f> torques(count);
+
+	react::rigid_body_statef state;
+	state.gravity = react::vec3f(0.0f, -9.81f, 0.0f);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::rigid_bodyf& b = bodies[i];
+		b.position = react::vec3f(bench::uniform(-100.0f, 100.0f), bench::uniform(0.0f, 50.0f), bench::uniform(-100.0f, 100.0f));
+		b.orientation = react::quatf(react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f)), bench::uniform(-3.0f, 3.0f));
+		b.linear_velocity = react::vec3f(bench::uniform(-5.0f, 5.0f), bench::uniform(-5.0f, 5.0f), bench::uniform(-5.0f, 5.0f));
+		b.angular_velocity = react::vec3f(bench::uniform(-2.0f, 2.0f), bench::uniform(-2.0f, 2.0f), bench::uniform(-2.0f, 2.0f));
+		b.inverse_mass = 1.0f / bench::uniform(1.0f, 10.0f);
+		b.inverse_inertia = react::vec3f(bench::uniform(0.5f, 2.0f), bench::uniform(0.5f, 2.0f), bench::uniform(0.5f, 2.0f));
+
+		torques[i] = react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+
+		state.add(b);
+	}
+
+	// the previous approach, array of structures stepped with the vec3, quat and mat3 operators
+	std::vector<react::rigid_bodyf> aos = bodies;
+
+	double ms = bench::time_ms([&]()
+	{
+		for (int s = 0; s < steps; ++s)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				react::rigid_bodyf& b = aos[i];
+				react::mat3f r = b.orientation.toMat3();
+				react::mat3f d(0.0f);
+
+				for (size_t k = 0; k < 3; ++k)
+					d.at(k, k) = b.inverse_inertia[k];
+
+				react::mat3f inertia = r.dot(d).dot(r.transpose());
+
+				b.angular_velocity += react::vec3f(inertia.row(0).dot(torques[i]), inertia.row(1).dot(torques[i]), inertia.row(2).dot(torques[i])) * dt;
+				b.linear_velocity += state.gravity * dt;
+				b.position += b.linear_velocity * dt;
+				b.orientation += react::quatf(b.angular_velocity.x(), b.angular_velocity.y(), b.angular_velocity.z(), 0.0f) * b.orientation * (0.5f * dt);
+				b.orientation.normalize();
+			}
+		}
+	}, 1);
+	bench::report("AoS operators", ms, count * steps / ms, "bodies/ms");
+
+	auto step = [&](const bool& parallel)
+	{
+		for (int s = 0; s < steps; ++s)
+		{
+			for (size_t i = 0; i < count; ++i)
+				state.apply_torque(i, torques[i]);
+
+			state.integrate(dt, parallel);
+		}
+	};
+
+	ms = bench::time_ms([&]() { step(false); }, 1);
+	bench::report("SoA integrate, with apply_torque", ms, count * steps / ms, "bodies/ms");
+
+	// torques written straight into the arrays, as a solver would
+	auto step_direct = [&](const bool& parallel)
+	{
+		for (int s = 0; s < steps; ++s)
+		{
+			for (size_t k = 0; k < 3; ++k)
+				for (size_t i = 0; i < count; ++i)
+					state.array(react::rigid_body_statef::TORQUE + k)[i] = torques[i][k];
+
+			state.integrate(dt, parallel);
+		}
+	};
+
+	ms = bench::time_ms([&]() { step_direct(false); }, 1);
+	bench::report("SoA integrate", ms, count * steps / ms, "bodies/ms");
+
+	ms = bench::time_ms([&]() { step_direct(true); }, 1);
+	bench::report("SoA integrate, threaded", ms, count * steps / ms, "bodies/ms");
+
+	ms = bench::time_ms([&]() { for (int s = 0; s < steps; ++s) state.integrate(dt); }, 1);
+	bench::report("SoA integrate only", ms, count * steps / ms, "bodies/ms");
+
+	bench::keep(aos);
+	bench::keep(state.array(react::rigid_body_statef::POSITION)[0]);
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+static const char* path = "bench_serialize.blob";
+
+// reads one float per 4 KiB page, the cost of faulting the mapping in and nothing else
+BENCH_NOINLINE float touch_pages(const react::mat4f* m, const size_t& count)
+{
+	const float* f = m->m_data;
+	const size_t floats = count * 16;
+	float sum = 0.0f;
+
+	for (size_t i = 0; i < floats; i += 1024)
+		sum += f[i];
+
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 2000000);
+	const double mb = count * sizeof(react::mat4f) / double(1 << 20);
+
+	std::cout << count << " mat4f, " << static_cast<size_t>(mb) << " MiB" << std::endl;
+
+	std::vector<react::mat4f> m(count);
+
+	for (react::mat4f& x : m)
+		for (int k = 0; k < 16; ++k)
+			x.m_data[k] = bench::uniform(-1.0f, 1.0f);
+
+	// the text output that existed before, for scale, over a tenth of the data
+	double ms = bench::time_ms([&]()
+	{
+		std::ostringstream out;
+
+		for (size_t i = 0; i < count / 10; ++i)
+			out << m[i] << '\n';
+
+		bench::keep(out.str().size());
+	}, 1) * 10.0;
+	bench::report("write, operator<< text (extrapolated)", ms, mb / ms * 1000.0, "MiB/s");
+
+	ms = bench::time_ms([&]() { react::save_blob(path, m.data(), m.size()); }, 3);
+	bench::report("write, blob with checksum", ms, mb / ms * 1000.0, "MiB/s");
+
+	react::blob_options options;
+	options.checksum = false;
+
+	ms = bench::time_ms([&]() { react::save_blob(path, m.data(), m.size(), options); }, 3);
+	bench::report("write, blob without checksum", ms, mb / ms * 1000.0, "MiB/s");
+
+	react::save_blob(path, m.data(), m.size());
+
+	std::vector<react::mat4f> loaded;
+
+	ms = bench::time_ms([&]() { react::load_blob(path, loaded, false); }, 3);
+	bench::report("load, read into a vector", ms, mb / ms * 1000.0, "MiB/s");
+
+	float sum = 0.0f;
+
+	ms = bench::time_ms([&]()
+	{
+		react::mapped_blob<react::mat4f> mapped;
+		mapped.open(path, true);
+		sum += touch_pages(mapped.data(), mapped.size());
+	}, 3);
+	bench::report("load, mapped and every page touched", ms, mb / ms * 1000.0, "MiB/s");
+
+	react::mapped_blob<react::mat4f> mapped;
+	mapped.open(path);
+
+	ms = bench::time_ms([&]() { mapped.verify(); }, 3);
+	bench::report("verify checksum", ms, mb / ms * 1000.0, "MiB/s");
+
+	ms = bench::time_ms([&]() { mapped.verify(true); }, 3);
+	bench::report("verify checksum, threaded", ms, mb / ms * 1000.0, "MiB/s");
+
+	mapped.close();
+	std::remove(path);
+
+	bench::keep(sum);
+	bench::keep(loaded);
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// least squares on many small overdetermined systems of COLS unknowns and ROWS equations
+template <size_t COLS, size_t ROWS, typename T>
+static void run(const char* name, const size_t& count)
+{
+	std::vector<react::support::matrix<COLS, ROWS, T>> a(count);
+	std::vector<react::support::vector<ROWS, T>> b(count);
+	std::vector<react::support::vector<COLS, T>> x(count);
+
+	for (size_t n = 0; n < count; ++n)
+	{
+		for (size_t k = 0; k < ROWS * COLS; ++k)
+			a[n].m_data[k] = static_cast<T>(bench::uniform(-1.0f, 1.0f));
+
+		for (size_t k = 0; k < ROWS; ++k)
+			b[n][k] = static_cast<T>(bench::uniform(-1.0f, 1.0f));
+	}
+
+	std::cout << name << std::endl;
+
+	double ms = bench::time_ms([&]() { for (size_t n = 0; n < count; ++n) x[n] = react::qr<COLS, ROWS, T>(a[n]).solve(b[n]); });
+	bench::report("  qr solve", ms, count / ms, "ksolves/s");
+
+	// the normal equations are faster but square the condition number
+	ms = bench::time_ms([&]()
+	{
+		for (size_t n = 0; n < count; ++n)
+		{
+			react::support::vector<COLS, T> atb;
+
+			for (size_t i = 0; i < COLS; ++i)
+				atb[i] = a[n].col(i).dot(b[n]);
+
+			x[n] = react::cholesky<COLS, T>(a[n].transpose().dot(a[n])).solve(atb);
+		}
+	});
+	bench::report("  normal equations", ms, count / ms, "ksolves/s");
+
+	ms = bench::time_ms([&]() { for (size_t n = 0; n < count / 10; ++n) bench::keep(react::pseudo_inverse(a[n])); });
+	bench::report("  qr pseudo_inverse", ms, count / 10 / ms, "ksolves/s");
+
+	ms = bench::time_ms([&]() { for (size_t n = 0; n < count / 10; ++n) bench::keep(react::support::svd_pseudo_inverse(a[n])); });
+	bench::report("  svd pseudo_inverse", ms, count / 10 / ms, "ksolves/s");
+
+	bench::keep(x);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 100000);
+
+	run<6, 12, float>("12x6 float", count);
+	run<6, 12, double>("12x6 double", count);
+	run<4, 30, float>("30x4 float", count);
+	run<4, 30, double>("30x4 double", count);
+
+	return 0;
+}
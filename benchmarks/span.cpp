@@ -0,0 +1,90 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// an interleaved vertex buffer, position, normal and uv at a 32 byte stride
+struct vertex
+{
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+// The previous import path: copy the positions out, run the kernel on the packed copy and write the results back
+BENCH_NOINLINE void transform_copied(const react::rigid_transformf& t, vertex* v, react::vec3f* scratch, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		scratch[i] = react::vec3f(v[i].position[0], v[i].position[1], v[i].position[2]);
+
+	react::rigid_transformf::apply(t, scratch, count, scratch);
+
+	for (size_t i = 0; i < count; ++i)
+		for (int k = 0; k < 3; ++k)
+			v[i].position[k] = scratch[i][k];
+}
+
+BENCH_NOINLINE void transform_span(const react::rigid_transformf& t, vertex* v, const size_t& count)
+{
+	react::vec_span<3, float> positions(v->position, count, sizeof(vertex));
+
+	react::rigid_transformf::apply(t, positions, positions);
+}
+
+BENCH_NOINLINE react::covariance3f covariance_copied(const vertex* v, react::vec3f* scratch, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		scratch[i] = react::vec3f(v[i].position[0], v[i].position[1], v[i].position[2]);
+
+	return react::covariance3f(scratch, count);
+}
+
+BENCH_NOINLINE react::covariance3f covariance_span(const vertex* v, const size_t& count)
+{
+	return react::covariance3f(react::vec_span<3, const float>(v->position, count, sizeof(vertex)));
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << count << " vertices, " << sizeof(vertex) << " byte stride" << std::endl;
+
+	std::vector<vertex> vertices(count);
+	std::vector<react::vec3f> scratch(count);
+
+	for (vertex& v : vertices)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			v.position[k] = bench::uniform(-10.0f, 10.0f);
+			v.normal[k] = bench::uniform(-1.0f, 1.0f);
+		}
+
+		v.uv[0] = bench::uniform(0.0f, 1.0f);
+		v.uv[1] = bench::uniform(0.0f, 1.0f);
+	}
+
+	// a rotation by a small angle keeps repeated passes in range
+	react::rigid_transformf t(react::quatf(react::vec3f(1.0f, 2.0f, 3.0f), 0.001f), react::vec3f(0.0f));
+
+	double ms = bench::time_ms([&]() { transform_copied(t, vertices.data(), scratch.data(), count); });
+	bench::report("transform, copy out and back", ms, count / ms / 1000.0, "Mvert/s");
+
+	ms = bench::time_ms([&]() { transform_span(t, vertices.data(), count); });
+	bench::report("transform, vec_span in place", ms, count / ms / 1000.0, "Mvert/s");
+
+	react::covariance3f c;
+
+	ms = bench::time_ms([&]() { c = covariance_copied(vertices.data(), scratch.data(), count); });
+	bench::report("covariance, copied positions", ms, count / ms / 1000.0, "Mvert/s");
+
+	ms = bench::time_ms([&]() { c = covariance_span(vertices.data(), count); });
+	bench::report("covariance, vec_span", ms, count / ms / 1000.0, "Mvert/s");
+
+	bench::keep(vertices);
+	bench::keep(c);
+
+	return 0;
+}
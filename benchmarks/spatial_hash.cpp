@@ -0,0 +1,85 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+	size_t query_count = bench::arg_count(argc, argv, 2, 100000);
+	size_t brute_count = bench::arg_count(argc, argv, 3, 200);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " points" << std::endl;
+
+	// about one point per unit cube
+	float extent = static_cast<float>(cbrt(static_cast<double>(count))) * 0.5f;
+	float radius = 1.5f;
+	const size_t k = 8;
+
+	std::vector<react::vec3f> points(count);
+
+	for (react::vec3f& p : points)
+		p = react::vec3f(bench::uniform(-extent, extent), bench::uniform(-extent, extent), bench::uniform(-extent, extent));
+
+	std::vector<react::vec3f> queries(query_count);
+
+	for (react::vec3f& q : queries)
+		q = react::vec3f(bench::uniform(-extent, extent), bench::uniform(-extent, extent), bench::uniform(-extent, extent));
+
+	react::spatial_hashf grid(radius);
+
+	double ms = bench::time_ms([&]() { grid.build(points.data(), count); }, 3);
+	bench::report("build", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { grid.build(points.data(), count, true); }, 3);
+	bench::report("build threaded", ms, count / ms / 1000.0, "Mpoints/s");
+
+	ms = bench::time_ms([&]() { grid.update(points.data()); }, 3);
+	bench::report("update (no cell changes)", ms, count / ms / 1000.0, "Mpoints/s");
+
+	std::vector<react::vec3f> moved(points);
+
+	for (react::vec3f& p : moved)
+		p += react::vec3f(0.1f, -0.05f, 0.02f);
+
+	ms = bench::time_ms([&]() { grid.update(moved.data()); grid.update(points.data()); }, 3) / 2.0;
+	bench::report("update (small moves)", ms, count / ms / 1000.0, "Mpoints/s");
+
+	// brute force reference on a handful of queries
+	size_t found = 0;
+
+	ms = bench::time_ms([&]()
+	{
+		found = 0;
+
+		for (size_t i = 0; i < brute_count; ++i)
+			for (const react::vec3f& p : points)
+				found += p.distance_squared(queries[i]) <= radius * radius;
+	}, 1);
+	bench::report("radius brute force", ms, brute_count / ms * 1000.0, "queries/s");
+
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> indices;
+
+	ms = bench::time_ms([&]() { grid.radius(queries.data(), query_count, radius, offsets, indices); }, 3);
+	bench::report("radius", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	ms = bench::time_ms([&]() { grid.radius(queries.data(), query_count, radius, offsets, indices, true); }, 3);
+	bench::report("radius threaded", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	std::cout << "  " << indices.size() / static_cast<double>(query_count) << " neighbours per query" << std::endl;
+
+	std::vector<uint32_t> nearest(query_count * k);
+
+	ms = bench::time_ms([&]() { grid.nearest(queries.data(), query_count, k, nearest.data()); }, 3);
+	bench::report("8 nearest", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	ms = bench::time_ms([&]() { grid.nearest(queries.data(), query_count, k, nearest.data(), true); }, 3);
+	bench::report("8 nearest threaded", ms, query_count / ms / 1000.0, "Mqueries/s");
+
+	bench::keep(found);
+	bench::keep(nearest[0]);
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+template <typename V>
+BENCH_NOINLINE void pack_each(const react::vec3f* in, V* out, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = in[i];
+}
+
+template <typename V>
+BENCH_NOINLINE void unpack_each(const V* in, react::vec3f* out, const size_t& count)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = in[i];
+}
+
+// a pass that only reads, the case the smaller storage is for
+BENCH_NOINLINE react::aabbf bounds_float(const react::vec3f* p, const size_t& count)
+{
+	return react::aabbf::from_points(p, count);
+}
+
+// decoded a block at a time into a small buffer that stays in cache
+template <typename V>
+BENCH_NOINLINE react::aabbf bounds_stored(const V* p, const size_t& count)
+{
+	react::vec3f block[1024];
+	react::aabbf b;
+
+	for (size_t i = 0; i < count; i += 1024)
+	{
+		size_t n = std::min<size_t>(1024, count - i);
+
+		react::storage_unpack(p + i, n, block);
+		b.expand(react::aabbf::from_points(block, n));
+	}
+
+	return b;
+}
+
+template <typename V>
+void run(const std::string& name, const std::vector<react::vec3f>& p, const react::aabbf& expected)
+{
+	const size_t count = p.size();
+	std::vector<V> stored(count);
+	std::vector<react::vec3f> back(count);
+
+	std::cout << name << ", " << sizeof(V) << " bytes" << std::endl;
+
+	double ms = bench::time_ms([&]() { pack_each(p.data(), stored.data(), count); });
+	bench::report("  encode, one at a time", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { react::storage_pack(p.data(), count, stored.data()); });
+	bench::report("  encode, storage_pack", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { unpack_each(stored.data(), back.data(), count); });
+	bench::report("  decode, one at a time", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { react::storage_unpack(stored.data(), count, back.data()); });
+	bench::report("  decode, storage_unpack", ms, count / ms / 1000.0, "Mvec/s");
+
+	react::aabbf b;
+	ms = bench::time_ms([&]() { b = bounds_stored(stored.data(), count); });
+	bench::report("  bounds, decoded in blocks", ms, count / ms / 1000.0, "Mvec/s");
+
+	std::cout << "  bounds error " << std::scientific << std::setprecision(2) << (b.min - expected.min).length() + (b.max - expected.max).length() << std::endl;
+
+	bench::keep(back);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 4000000);
+
+	std::cout << count << " vec3f, components in [-1, 1]" << std::endl;
+
+	std::vector<react::vec3f> p(count);
+
+	for (react::vec3f& x : p)
+		x = react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+
+	react::aabbf expected;
+
+	double ms = bench::time_ms([&]() { expected = bounds_float(p.data(), count); });
+	bench::report("vec3f bounds, 12 bytes", ms, count / ms / 1000.0, "Mvec/s");
+
+	run<react::vec3h>("vec3h", p, expected);
+	run<react::vec3sn16>("vec3sn16", p, expected);
+
+	// unorm8 only holds [0, 1]
+	for (react::vec3f& x : p)
+		x = x * 0.5f + react::vec3f(0.5f);
+
+	expected = bounds_float(p.data(), count);
+	run<react::vec3un8>("vec3un8, components in [0, 1]", p, expected);
+
+	return 0;
+}
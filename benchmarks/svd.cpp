@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// Largest entry of |U S V^T - A| relative to the largest entry of A, and of |U^T U - I|
+template <typename S>
+static void accuracy(const std::vector<react::mat3f>& matrices, const std::vector<S>& results, double& reconstruction, double& orthogonality)
+{
+	reconstruction = 0.0;
+	orthogonality = 0.0;
+
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		react::mat3d a(matrices[i]);
+		react::mat3d u(results[i].u);
+		react::mat3d v(results[i].v);
+
+		double scale = 0.0;
+
+		for (size_t k = 0; k < 9; ++k)
+			scale = std::max(scale, std::abs(a.m_data[k]));
+
+		for (size_t row = 0; row < 3; ++row)
+		{
+			for (size_t col = 0; col < 3; ++col)
+			{
+				double r = 0.0;
+
+				for (size_t k = 0; k < 3; ++k)
+					r += u(row, k) * static_cast<double>(results[i].values[k]) * v(col, k);
+
+				reconstruction = std::max(reconstruction, std::abs(r - a(row, col)) / scale);
+				orthogonality = std::max(orthogonality, std::abs(u.col(row).dot(u.col(col)) - (row == col ? 1.0 : 0.0)));
+				orthogonality = std::max(orthogonality, std::abs(v.col(row).dot(v.col(col)) - (row == col ? 1.0 : 0.0)));
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << react::support::thread_count() << " threads, " << count << " matrices" << std::endl;
+
+	// deformation gradients: rotations times stretches near the identity, some inverted, plus general matrices
+	std::vector<react::mat3f> matrices(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::mat3f m;
+
+		for (size_t k = 0; k < 9; ++k)
+			m.m_data[k] = i % 2 ? bench::uniform(-1.0f, 1.0f) : m.m_data[k] + bench::uniform(-0.3f, 0.3f);
+
+		if (i % 16 == 0)
+			m.set_col(react::vec3f(m.col(2)) * -1.0f, 2);
+
+		react::quatf q(react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f)), bench::uniform(-3.0f, 3.0f));
+
+		matrices[i] = q.toMat3().dot(m);
+	}
+
+	std::vector<react::svd3f> fast(count);
+	std::vector<react::svd<3, 3, float>> general(count / 10, react::svd<3, 3, float>(react::mat3f()));
+	std::vector<react::quatf> rotations(count);
+
+	double ms = bench::time_ms([&]()
+	{
+		for (size_t i = 0; i < general.size(); ++i)
+			general[i] = react::svd<3, 3, float>(matrices[i]);
+	}, 3);
+	bench::report("svd<3, 3> one-sided Jacobi", ms, general.size() / ms / 1000.0, "Mmatrices/s");
+
+	ms = bench::time_ms([&]()
+	{
+		for (size_t i = 0; i < count; ++i)
+			fast[i] = react::svd3f(matrices[i]);
+	}, 3);
+	bench::report("svd3, scalar", ms, count / ms / 1000.0, "Mmatrices/s");
+
+	ms = bench::time_ms([&]() { react::svd3f::compute(matrices.data(), count, fast.data()); }, 3);
+	bench::report("svd3, batch", ms, count / ms / 1000.0, "Mmatrices/s");
+
+	ms = bench::time_ms([&]() { react::svd3f::compute(matrices.data(), count, fast.data(), true); }, 3);
+	bench::report("svd3, batch threaded", ms, count / ms / 1000.0, "Mmatrices/s");
+
+	ms = bench::time_ms([&]() { react::polar3f::rotations(matrices.data(), count, rotations.data(), true); }, 3);
+	bench::report("polar3 rotations, threaded", ms, count / ms / 1000.0, "Mmatrices/s");
+
+	double reconstruction, orthogonality;
+
+	std::vector<react::svd<3, 3, float>> general_results(general.begin(), general.end());
+	std::vector<react::mat3f> general_matrices(matrices.begin(), matrices.begin() + general.size());
+
+	accuracy(general_matrices, general_results, reconstruction, orthogonality);
+	std::cout << std::scientific << std::setprecision(2) << "svd<3, 3> max relative error " << reconstruction << ", max orthogonality error " << orthogonality << std::endl;
+
+	std::vector<react::svd3f> scalar(general.size());
+
+	for (size_t i = 0; i < scalar.size(); ++i)
+		scalar[i] = react::svd3f(matrices[i]);
+
+	accuracy(general_matrices, scalar, reconstruction, orthogonality);
+	std::cout << std::scientific << std::setprecision(2) << "svd3 scalar max relative error " << reconstruction << ", max orthogonality error " << orthogonality << std::endl;
+
+	accuracy(matrices, fast, reconstruction, orthogonality);
+	std::cout << std::scientific << std::setprecision(2) << "svd3 batch max relative error " << reconstruction << ", max orthogonality error " << orthogonality << std::endl;
+
+	bench::keep(fast[0]);
+	bench::keep(general[0]);
+	bench::keep(rotations[0]);
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// Each pair of kernels does the same work by hand and through swizzles. They are kept out of line so their
+// machine code can be compared with objdump -d.
+BENCH_NOINLINE void read_manual(const react::vec4f* in, react::vec3f* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = react::vec3f(in[i].z(), in[i].y(), in[i].x()) * in[i].w();
+}
+
+BENCH_NOINLINE void read_swizzle(const react::vec4f* in, react::vec3f* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = in[i].zyx() * in[i].w();
+}
+
+BENCH_NOINLINE void write_manual(react::vec4f* v, const react::vec2f* in, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		v[i].x() = in[i].y();
+		v[i].z() = in[i].x();
+	}
+}
+
+BENCH_NOINLINE void write_swizzle(react::vec4f* v, const react::vec2f* in, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		v[i].xz() = in[i].yx();
+}
+
+// the previous quat::rotate, copying the vector part out and through two cross products
+BENCH_NOINLINE void rotate_copy(const react::quatf* q, const react::vec3f* in, react::vec3f* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::vec3f xyz(q[i].x(), q[i].y(), q[i].z());
+
+		out[i] = in[i] + 2.0f * xyz.cross(xyz.cross(in[i]) + q[i].w() * in[i]);
+	}
+}
+
+BENCH_NOINLINE void rotate_view(const react::quatf* q, const react::vec3f* in, react::vec3f* out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = q[i].rotate(in[i]);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+	std::cout << count << " vectors" << std::endl;
+
+	std::vector<react::vec4f> v4(count);
+	std::vector<react::vec3f> v3(count), out(count);
+	std::vector<react::vec2f> v2(count);
+	std::vector<react::quatf> q(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		v4[i] = react::vec4f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+		v3[i] = react::vec3f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+		v2[i] = react::vec2f(bench::uniform(-1.0f, 1.0f), bench::uniform(-1.0f, 1.0f));
+		q[i] = react::quatf(v3[i], bench::uniform(-3.0f, 3.0f));
+	}
+
+	double ms = bench::time_ms([&]() { read_manual(v4.data(), out.data(), count); });
+	bench::report("read, by hand", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { read_swizzle(v4.data(), out.data(), count); });
+	bench::report("read, zyx()", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { write_manual(v4.data(), v2.data(), count); });
+	bench::report("write mask, by hand", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { write_swizzle(v4.data(), v2.data(), count); });
+	bench::report("write mask, xz() = yx()", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { rotate_copy(q.data(), v3.data(), out.data(), count); });
+	bench::report("quat rotate, copied vector part", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { rotate_view(q.data(), v3.data(), out.data(), count); });
+	bench::report("quat rotate, xyz() view", ms, count / ms / 1000.0, "Mvec/s");
+
+	bench::keep(out);
+	bench::keep(v4);
+
+	return 0;
+}
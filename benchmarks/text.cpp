@@ -0,0 +1,82 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+BENCH_NOINLINE size_t write_stream(const react::vec3f* v, const size_t& count)
+{
+	std::ostringstream out;
+
+	for (size_t i = 0; i < count; ++i)
+		out << v[i] << '\n';
+
+	return out.str().size();
+}
+
+BENCH_NOINLINE size_t write_formatted(const react::vec3f* v, const size_t& count, std::vector<char>& buffer)
+{
+	return react::format_array(buffer.data(), v, count) - buffer.data();
+}
+
+BENCH_NOINLINE size_t read_stream(const std::string& text, react::vec3f* v, const size_t& count)
+{
+	std::istringstream in(text);
+	size_t n = 0;
+
+	while (n < count && in >> v[n].x() >> v[n].y() >> v[n].z())
+		++n;
+
+	return n;
+}
+
+BENCH_NOINLINE size_t read_parsed(const std::string& text, react::vec3f* v, const size_t& count)
+{
+	react::text_reader<react::vec3f> reader(text.data(), text.data() + text.size());
+
+	return reader.read(v, count);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = bench::arg_count(argc, argv, 1, 1000000);
+
+#ifdef _REACT_TEXT_CHARCONV
+	std::cout << count << " vec3f, std::to_chars / std::from_chars" << std::endl;
+#else
+	std::cout << count << " vec3f, snprintf / strtod fallback" << std::endl;
+#endif
+
+	std::vector<react::vec3f> v(count);
+	std::vector<react::vec3f> back(count);
+	std::vector<char> buffer(count * react::text_capacity<react::vec3f>::value);
+
+	for (react::vec3f& x : v)
+		x = react::vec3f(bench::uniform(-100.0f, 100.0f), bench::uniform(-1.0f, 1.0f), bench::uniform(0.0f, 1e4f));
+
+	size_t bytes = 0;
+
+	double ms = bench::time_ms([&]() { bytes = write_stream(v.data(), count); });
+	bench::report("write, operator<<", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { bytes = write_formatted(v.data(), count, buffer); });
+	bench::report("write, format_array", ms, count / ms / 1000.0, "Mvec/s");
+
+	std::string text(buffer.data(), bytes);
+	size_t n = 0;
+
+	ms = bench::time_ms([&]() { n = read_stream(text, back.data(), count); });
+	bench::report("read, operator>> on floats", ms, count / ms / 1000.0, "Mvec/s");
+
+	ms = bench::time_ms([&]() { n = read_parsed(text, back.data(), count); });
+	bench::report("read, text_reader in memory", ms, count / ms / 1000.0, "Mvec/s");
+
+	std::cout << (n == count && back == v ? "round trip exact" : "round trip FAILED") << std::endl;
+
+	bench::keep(back);
+	bench::keep(bytes);
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+const size_t S = 128;
+
+typedef react::support::vector<S, float> embedding;
+
+// what the search was before, vector::dot for every pair and a partial sort of the scores
+BENCH_NOINLINE void topk_each(const embedding* queries, const size_t& count, const embedding* db, const size_t& n, const size_t& k, uint32_t* indices, std::vector<float>& scores, std::vector<uint32_t>& order)
+{
+	for (size_t q = 0; q < count; ++q)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			scores[i] = queries[q].dot(db[i]);
+			order[i] = static_cast<uint32_t>(i);
+		}
+
+		std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](const uint32_t& a, const uint32_t& b)
+		{
+			return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+		});
+
+		std::copy(order.begin(), order.begin() + k, indices + q * k);
+	}
+}
+
+void report(const std::string& name, const double& ms, const size_t& count, const size_t& n)
+{
+	bench::report("  " + name, ms, double(count) * n / ms / 1000.0, "Mpair/s");
+	std::cout << "    " << std::setprecision(1) << 2.0 * S * count * n / ms / 1e6 << " GFLOP/s, "
+		<< ms / count << " ms a query" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	const size_t n = bench::arg_count(argc, argv, 1, 1000000);
+	const size_t batch = bench::arg_count(argc, argv, 2, 64);
+	const size_t k = 10;
+
+	react::support::aligned_vector<embedding, 64> db(n);
+	react::support::aligned_vector<embedding, 64> queries(batch);
+
+	for (auto& v : db)
+		for (size_t i = 0; i < S; ++i)
+			v[i] = bench::uniform(-1.0f, 1.0f);
+
+	for (auto& v : queries)
+		for (size_t i = 0; i < S; ++i)
+			v[i] = bench::uniform(-1.0f, 1.0f);
+
+	std::cout << n << " vector<" << S << ", float>, " << n * sizeof(embedding) / (1 << 20) << " MB, top " << k
+		<< ", " << react::support::thread_count() << " threads" << std::endl;
+
+	std::vector<uint32_t> indices(batch * k), reference(batch * k);
+	std::vector<float> scores(n);
+	std::vector<uint32_t> order(n);
+
+	// the per-pair loop is slow, time it on a few queries
+	const size_t few = std::min<size_t>(4, batch);
+
+	double ms = bench::time_ms([&]() { topk_each(queries.data(), few, db.data(), n, k, reference.data(), scores, order); }, 1);
+	report("vector::dot and partial_sort", ms, few, n);
+
+	ms = bench::time_ms([&]() { react::topk_dot(queries[0], db.data(), n, k, indices.data()); }, 3);
+	report("topk_dot, one query", ms, 1, n);
+
+	ms = bench::time_ms([&]() { react::topk_dot(queries[0], db.data(), n, k, indices.data(), nullptr, true); }, 3);
+	report("topk_dot, one query, threaded", ms, 1, n);
+
+	ms = bench::time_ms([&]() { react::topk_dot(queries.data(), batch, db.data(), n, k, indices.data()); }, 1);
+	report("topk_dot, " + std::to_string(batch) + " queries", ms, batch, n);
+
+	ms = bench::time_ms([&]() { react::topk_dot(queries.data(), batch, db.data(), n, k, indices.data(), nullptr, true); }, 1);
+	report("topk_dot, " + std::to_string(batch) + " queries, threaded", ms, batch, n);
+
+	// the same neighbours as the per-pair search, where no two scores are within rounding of each other
+	size_t same = 0;
+
+	for (size_t i = 0; i < few * k; ++i)
+		same += indices[i] == reference[i];
+
+	std::cout << "  " << same << " of " << few * k << " results as vector::dot ranks them" << std::endl;
+
+	ms = bench::time_ms([&]() { react::topk_l2(queries.data(), batch, db.data(), n, k, indices.data(), nullptr, true); }, 1);
+	report("topk_l2, " + std::to_string(batch) + " queries, threaded", ms, batch, n);
+
+	bench::keep(indices);
+
+	return 0;
+}
@@ -0,0 +1,196 @@
+#include <cmath>
+#include <string>
+
+#include <React-Math.h>
+
+#include "bench.h"
+
+// The loops support::vector had before the interleaved sums: in order, int indices, and normalize dividing each
+// component. Each pass runs over every neighbouring pair, as a similarity scan over embeddings does.
+template <size_t S>
+BENCH_NOINLINE float dot_loop(const react::support::vector<S, float>* v, const size_t& count, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t k = 0; k + 1 < count; ++k)
+	{
+		float tmp = 0;
+
+		for (int i = 0; i < static_cast<int>(S); ++i)
+			tmp += v[k].m_data[i] * v[k + 1].m_data[i];
+
+		out[k] = tmp;
+		total += tmp;
+	}
+
+	return total;
+}
+
+template <size_t S>
+BENCH_NOINLINE float dot_kernel(const react::support::vector<S, float>* v, const size_t& count, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t k = 0; k + 1 < count; ++k)
+	{
+		out[k] = v[k].dot(v[k + 1]);
+		total += out[k];
+	}
+
+	return total;
+}
+
+template <size_t S>
+BENCH_NOINLINE float length_loop(const react::support::vector<S, float>* v, const size_t& count, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t k = 0; k < count; ++k)
+	{
+		float tmp = 0;
+
+		for (int i = 0; i < static_cast<int>(S); ++i)
+			tmp += v[k].m_data[i] * v[k].m_data[i];
+
+		out[k] = std::sqrt(tmp);
+		total += out[k];
+	}
+
+	return total;
+}
+
+template <size_t S>
+BENCH_NOINLINE float length_kernel(const react::support::vector<S, float>* v, const size_t& count, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t k = 0; k < count; ++k)
+	{
+		out[k] = v[k].length();
+		total += out[k];
+	}
+
+	return total;
+}
+
+template <size_t S>
+BENCH_NOINLINE float distance_loop(const react::support::vector<S, float>* v, const size_t& count, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t k = 0; k + 1 < count; ++k)
+	{
+		float tmp = 0;
+
+		for (int i = 0; i < static_cast<int>(S); ++i)
+		{
+			float d = v[k].m_data[i] - v[k + 1].m_data[i];
+			tmp += d * d;
+		}
+
+		out[k] = std::sqrt(tmp);
+		total += out[k];
+	}
+
+	return total;
+}
+
+template <size_t S>
+BENCH_NOINLINE float distance_kernel(const react::support::vector<S, float>* v, const size_t& count, float* out)
+{
+	float total = 0.0f;
+
+	for (size_t k = 0; k + 1 < count; ++k)
+	{
+		out[k] = v[k].distance(v[k + 1]);
+		total += out[k];
+	}
+
+	return total;
+}
+
+template <size_t S>
+BENCH_NOINLINE void normalize_loop(const react::support::vector<S, float>* v, react::support::vector<S, float>* out, const size_t& count)
+{
+	for (size_t k = 0; k < count; ++k)
+	{
+		float tmp = 0;
+
+		for (int i = 0; i < static_cast<int>(S); ++i)
+			tmp += v[k].m_data[i] * v[k].m_data[i];
+
+		float len = std::sqrt(tmp);
+
+		for (int i = 0; i < static_cast<int>(S); ++i)
+			out[k].m_data[i] = v[k].m_data[i] / len;
+	}
+}
+
+template <size_t S>
+BENCH_NOINLINE void normalize_kernel(const react::support::vector<S, float>* v, react::support::vector<S, float>* out, const size_t& count)
+{
+	for (size_t k = 0; k < count; ++k)
+		out[k] = v[k].normalized();
+}
+
+template <typename F, typename G>
+void compare(const std::string& name, const size_t& items, F&& loop, G&& kernel)
+{
+	double before = bench::time_ms(loop);
+	double after = bench::time_ms(kernel);
+
+	bench::report("  " + name + ", plain loop", before, items / before / 1000.0, "M/s");
+	bench::report("  " + name + ", kernel", after, items / after / 1000.0, "M/s");
+	std::cout << "    " << std::setprecision(2) << before / after << "x" << std::endl;
+}
+
+// the vectors fit in L2, so the arithmetic is timed rather than memory
+template <size_t S>
+void run(const size_t& passes)
+{
+	typedef react::support::vector<S, float> V;
+
+	const size_t count = (256 * 1024) / sizeof(V);
+
+	react::support::aligned_vector<V, 64> v(count);
+	react::support::aligned_vector<V, 64> normalized(count);
+	std::vector<float> out(count);
+
+	for (auto& x : v)
+		for (size_t k = 0; k < S; ++k)
+			x[k] = bench::uniform(-1.0f, 1.0f);
+
+	std::cout << passes << " x " << count << " vector<" << S << ", float>, stored aligned to 64" << std::endl;
+
+	const size_t items = passes * count;
+
+	compare("dot", items,
+		[&]() { for (size_t p = 0; p < passes; ++p) bench::keep(dot_loop(v.data(), count, out.data())); },
+		[&]() { for (size_t p = 0; p < passes; ++p) bench::keep(dot_kernel(v.data(), count, out.data())); });
+
+	compare("length", items,
+		[&]() { for (size_t p = 0; p < passes; ++p) bench::keep(length_loop(v.data(), count, out.data())); },
+		[&]() { for (size_t p = 0; p < passes; ++p) bench::keep(length_kernel(v.data(), count, out.data())); });
+
+	compare("distance", items,
+		[&]() { for (size_t p = 0; p < passes; ++p) bench::keep(distance_loop(v.data(), count, out.data())); },
+		[&]() { for (size_t p = 0; p < passes; ++p) bench::keep(distance_kernel(v.data(), count, out.data())); });
+
+	compare("normalize", items,
+		[&]() { for (size_t p = 0; p < passes; ++p) normalize_loop(v.data(), normalized.data(), count); },
+		[&]() { for (size_t p = 0; p < passes; ++p) normalize_kernel(v.data(), normalized.data(), count); });
+
+	bench::keep(normalized[0]);
+}
+
+int main(int argc, char** argv)
+{
+	size_t passes = bench::arg_count(argc, argv, 1, 200);
+
+	run<16>(passes);
+	run<64>(passes);
+	run<256>(passes);
+	run<1024>(passes);
+
+	return 0;
+}
@@ -9,6 +9,31 @@
 #include "mat3.h"
 #include "mat4.h"
 
+#include "span.h"
+#include "storage.h"
+
 #include "quat.h"
+#include "quat_pack.h"
+#include "octahedral.h"
+
+#include "aabb.h"
+#include "frustum.h"
+#include "ray.h"
+#include "morton.h"
+#include "bvh.h"
+#include "spatial_hash.h"
+#include "kd_tree.h"
+#include "topk.h"
+#include "pca.h"
+#include "obb.h"
+#include "svd.h"
+#include "align.h"
+#include "solve.h"
+#include "icp.h"
+#include "orthonormalize.h"
+#include "rigid_body.h"
+#include "gjk.h"
+#include "serialize.h"
+#include "text.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#ifndef _RM_AABB_H
+#define _RM_AABB_H
+
+#include "vec3.h"
+#include "span.h"
+
+namespace react
+{
+	template <typename T>
+	class aabb
+	{
+	public:
+		// constructors
+		aabb() : min(vec3<T>::INF), max(vec3<T>::NEG_INF) {}
+		aabb(const vec3<T>& min, const vec3<T>& max) : min(min), max(max) {}
+
+		// Utility functions
+		const vec3<T> center() const;
+		const vec3<T> extents() const;
+		const vec3<T> size() const;
+		const T surface_area() const;
+		const bool empty() const;
+		const bool contains(const vec3<T>& p) const;
+		const bool intersects(const aabb<T>& b) const;
+
+		// Modifiers
+		aabb<T>& expand(const vec3<T>& p);
+		aabb<T>& expand(const aabb<T>& b);
+
+		// Static utility functions
+		static const aabb<T> merge(const aabb<T>& a, const aabb<T>& b);
+		static const aabb<T> from_points(const vec3<T>* points, const size_t& count);
+		static const aabb<T> from_points(const vec_span<3, const T>& points);
+
+		friend std::ostream& operator<<(std::ostream& out, const aabb<T>& b)
+		{
+			out << "AABB(" << b.min << ", " << b.max << ")";
+
+			return out;
+		}
+
+		vec3<T> min;
+		vec3<T> max;
+	};
+
+	// Structure-of-arrays view of a batch of boxes, as consumed by the batch culling and intersection kernels.
+	template <typename T>
+	struct aabb_soa
+	{
+		const T* min_x;
+		const T* min_y;
+		const T* min_z;
+		const T* max_x;
+		const T* max_y;
+		const T* max_z;
+		size_t count;
+	};
+
+	template <typename T>
+	const vec3<T> aabb<T>::center() const
+	{
+		return (min + max) * static_cast<T>(0.5);
+	}
+
+	template <typename T>
+	const vec3<T> aabb<T>::extents() const
+	{
+		return (max - min) * static_cast<T>(0.5);
+	}
+
+	template <typename T>
+	const vec3<T> aabb<T>::size() const
+	{
+		return max - min;
+	}
+
+	template <typename T>
+	const T aabb<T>::surface_area() const
+	{
+		if (empty())
+			return static_cast<T>(0);
+
+		vec3<T> d = max - min;
+
+		return static_cast<T>(2) * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+	}
+
+	template <typename T>
+	const bool aabb<T>::empty() const
+	{
+		return min.x() > max.x() || min.y() > max.y() || min.z() > max.z();
+	}
+
+	template <typename T>
+	const bool aabb<T>::contains(const vec3<T>& p) const
+	{
+		return p.x() >= min.x() && p.x() <= max.x() &&
+			p.y() >= min.y() && p.y() <= max.y() &&
+			p.z() >= min.z() && p.z() <= max.z();
+	}
+
+	template <typename T>
+	const bool aabb<T>::intersects(const aabb<T>& b) const
+	{
+		return min.x() <= b.max.x() && max.x() >= b.min.x() &&
+			min.y() <= b.max.y() && max.y() >= b.min.y() &&
+			min.z() <= b.max.z() && max.z() >= b.min.z();
+	}
+
+	template <typename T>
+	aabb<T>& aabb<T>::expand(const vec3<T>& p)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			min.m_data[i] = p.m_data[i] < min.m_data[i] ? p.m_data[i] : min.m_data[i];
+			max.m_data[i] = p.m_data[i] > max.m_data[i] ? p.m_data[i] : max.m_data[i];
+		}
+
+		return *this;
+	}
+
+	template <typename T>
+	aabb<T>& aabb<T>::expand(const aabb<T>& b)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			min.m_data[i] = b.min.m_data[i] < min.m_data[i] ? b.min.m_data[i] : min.m_data[i];
+			max.m_data[i] = b.max.m_data[i] > max.m_data[i] ? b.max.m_data[i] : max.m_data[i];
+		}
+
+		return *this;
+	}
+
+	template <typename T>
+	const aabb<T> aabb<T>::merge(const aabb<T>& a, const aabb<T>& b)
+	{
+		aabb<T> tmp = a;
+		tmp.expand(b);
+		return tmp;
+	}
+
+	template <typename T>
+	const aabb<T> aabb<T>::from_points(const vec3<T>* points, const size_t& count)
+	{
+		aabb<T> tmp;
+
+		for (size_t i = 0; i < count; ++i)
+			tmp.expand(points[i]);
+
+		return tmp;
+	}
+
+	template <typename T>
+	const aabb<T> aabb<T>::from_points(const vec_span<3, const T>& points)
+	{
+		aabb<T> tmp;
+
+		for (size_t i = 0; i < points.size(); ++i)
+			tmp.expand(points[i]);
+
+		return tmp;
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef aabb<float> aabbf;
+	typedef aabb<double> aabbd;
+#endif
+}
+
+#endif
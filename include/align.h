@@ -0,0 +1,589 @@
+#ifndef _RM_ALIGN_H
+#define _RM_ALIGN_H
+
+#include <algorithm>
+#include <vector>
+
+#include "vec3.h"
+#include "mat3.h"
+#include "quat.h"
+#include "pca.h"
+#include "svd.h"
+#include "span.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Similarity transform p -> scale * rotation(p) + translation, scale is 1 for a rigid transform.
+	template <typename T>
+	class rigid_transform
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// constructors
+		rigid_transform() : rotation(), translation(static_cast<T>(0)), scale(1) {}
+		rigid_transform(const quat<T>& rotation, const vec3<T>& translation, const T& scale = 1) : rotation(rotation), translation(translation), scale(scale) {}
+
+		// Utility functions
+		const vec3<T> apply(const vec3<T>& p) const;
+
+		// Needs a scale other than 0, which a scaling fit onto points that all coincide gives
+		const rigid_transform<T> inverse() const;
+
+		// Static utility functions
+		static void apply(const rigid_transform<T>& transform, const vec3<T>* points, const size_t& count, vec3<T>* out, const bool& parallel = false);
+		static void apply(const rigid_transform<T>& transform, const vec_span<3, const T>& points, const vec_span<3, T>& out, const bool& parallel = false);
+
+		// Operators
+
+		// (a * b).apply(p) == a.apply(b.apply(p))
+		const rigid_transform<T> operator*(const rigid_transform<T>& b) const;
+
+		friend std::ostream& operator<<(std::ostream& out, const rigid_transform<T>& t)
+		{
+			out << "RigidTransform(" << t.rotation << ", " << t.translation << ", " << t.scale << ")";
+
+			return out;
+		}
+
+		quat<T> rotation;
+		vec3<T> translation;
+		T scale;
+	};
+
+	// Weighted cross-covariance of paired point sets a[i] <-> b[i], accumulated like covariance3: blocks are summed
+	// relative to their first pair and merged with Chan's formula, the block sums and the merge both in at least
+	// double precision.
+	template <typename T>
+	class cross_covariance3
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		typedef typename support::covariance_accumulator<T>::type accumulator_type;
+
+		static const size_t BLOCK_SIZE = 1024;
+
+		// constructors
+		cross_covariance3() : m_weight(0), m_mean_a(), m_mean_b(), m_cross(), m_scatter_a(0), m_scatter_b(0) {}
+
+		// Modifiers
+		cross_covariance3<T>& add(const vec3<T>& a, const vec3<T>& b, const T& weight = 1);
+		cross_covariance3<T>& add(const vec3<T>* a, const vec3<T>* b, const size_t& count, const bool& parallel = false);
+		cross_covariance3<T>& add(const vec3<T>* a, const vec3<T>* b, const T* weights, const size_t& count, const bool& parallel = false);
+		cross_covariance3<T>& add(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const bool& parallel = false);
+		cross_covariance3<T>& add(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const T* weights, const bool& parallel = false);
+		cross_covariance3<T>& merge(const cross_covariance3<T>& other);
+
+		// Accessors
+		inline const accumulator_type& weight() const;
+		const vec3<T> mean_a() const;
+		const vec3<T> mean_b() const;
+
+		// sum of w (a - mean_a) (b - mean_b)^T over the total weight
+		const mat3<T> covariance() const;
+
+		// Utility functions
+
+		// Least squares transform taking a onto b, with a uniform scale when 'scaling' is set. The scale is 1 when the a
+		// points all coincide and 0 when the b points do, that transform has no inverse.
+		// credit Umeyama, "Least-Squares Estimation of Transformation Parameters Between Two Point Patterns"
+		const rigid_transform<T> solve(const bool& scaling = false) const;
+
+		// Weighted mean of |transform(a) - b|^2, from the sums alone
+		const T residual(const rigid_transform<T>& transform) const;
+
+	private:
+		cross_covariance3<T>& add_strided(const T* a, const size_t& a_stride, const T* b, const size_t& b_stride, const T* weights, const size_t& count, const bool& parallel);
+		void add_block(const T* a, const size_t& a_stride, const T* b, const size_t& b_stride, const T* weights, const size_t& begin, const size_t& end);
+
+		accumulator_type m_weight;
+		accumulator_type m_mean_a[3];
+		accumulator_type m_mean_b[3];
+
+		// sum of w (a - mean_a)(b - mean_b)^T, row major
+		accumulator_type m_cross[9];
+
+		// sums of w |a - mean_a|^2 and w |b - mean_b|^2
+		accumulator_type m_scatter_a;
+		accumulator_type m_scatter_b;
+	};
+
+	// Rotation and translation (and scale when 'scaling' is set) best taking the points a[i] onto b[i]
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec3<T>* a, const vec3<T>* b, const size_t& count, const bool& scaling = false, const bool& parallel = false);
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec3<T>* a, const vec3<T>* b, const T* weights, const size_t& count, const bool& scaling = false, const bool& parallel = false);
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const bool& scaling = false, const bool& parallel = false);
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const T* weights, const bool& scaling = false, const bool& parallel = false);
+
+	template <typename T>
+	const vec3<T> rigid_transform<T>::apply(const vec3<T>& p) const
+	{
+		return rotation.rotate(p) * scale + translation;
+	}
+
+	template <typename T>
+	const rigid_transform<T> rigid_transform<T>::inverse() const
+	{
+		assert(scale != 0);
+
+		quat<T> r = rotation.conjugate();
+
+		return rigid_transform<T>(r, r.rotate(translation) * (-1 / scale), 1 / scale);
+	}
+
+	namespace support
+	{
+		// P and O index like arrays of vec3, raw arrays or spans
+		template <typename T, typename P, typename O>
+		void rigid_apply(const rigid_transform<T>& transform, const P& points, const size_t& count, const O& out, const bool& parallel)
+		{
+			mat3<T> m = transform.rotation.toMat3() * transform.scale;
+			vec3<T> rows[3] = { m.row(0), m.row(1), m.row(2) };
+
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					vec3<T> p = points[i];
+
+					out[i] = vec3<T>(rows[0].dot(p), rows[1].dot(p), rows[2].dot(p)) + transform.translation;
+				}
+			};
+
+			if (parallel)
+				parallel_for(count, 1 << 14, kernel);
+			else
+				kernel(0, 0, count);
+		}
+	}
+
+	template <typename T>
+	void rigid_transform<T>::apply(const rigid_transform<T>& transform, const vec3<T>* points, const size_t& count, vec3<T>* out, const bool& parallel)
+	{
+		support::rigid_apply(transform, points, count, out, parallel);
+	}
+
+	template <typename T>
+	void rigid_transform<T>::apply(const rigid_transform<T>& transform, const vec_span<3, const T>& points, const vec_span<3, T>& out, const bool& parallel)
+	{
+		assert(out.size() >= points.size());
+
+		support::rigid_apply(transform, points, points.size(), out, parallel);
+	}
+
+	template <typename T>
+	const rigid_transform<T> rigid_transform<T>::operator*(const rigid_transform<T>& b) const
+	{
+		return rigid_transform<T>(rotation * b.rotation, apply(b.translation), scale * b.scale);
+	}
+
+	namespace support
+	{
+		// Weighted sums over [begin, end) of strided pairs relative to the origins oa and ob, with da = a - oa, db = b - ob:
+		// sums = { w, w da (3), w db (3), w da db^T (9, row major), w |da|^2, w |db|^2 }. 'weights' may be null for all ones.
+		// The products and sums are in A, the accumulator type.
+		template <typename T, typename A>
+		inline void cross_covariance_sums(const T* a, const size_t& a_stride, const T* b, const size_t& b_stride, const T* weights, const size_t& begin, const size_t& end, const T(&oa)[3], const T(&ob)[3], A(&sums)[18])
+		{
+			for (int k = 0; k < 18; ++k)
+				sums[k] = 0;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				A w = weights ? weights[i] : static_cast<A>(1);
+				A da[3], db[3];
+
+				for (int k = 0; k < 3; ++k)
+				{
+					da[k] = static_cast<A>(a[i * a_stride + k] - oa[k]);
+					db[k] = static_cast<A>(b[i * b_stride + k] - ob[k]);
+				}
+
+				sums[0] += w;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					sums[1 + k] += w * da[k];
+					sums[4 + k] += w * db[k];
+					sums[16] += w * da[k] * da[k];
+					sums[17] += w * db[k] * db[k];
+
+					for (int j = 0; j < 3; ++j)
+						sums[7 + k * 3 + j] += w * da[k] * db[j];
+				}
+			}
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		// Each lane sums at most RUN products in float, then the run is widened into double sums
+		inline void cross_covariance_sums(const float* a, const size_t& a_stride, const float* b, const size_t& b_stride, const float* weights, const size_t& begin, const size_t& end, const float(&oa)[3], const float(&ob)[3], double(&sums)[18])
+		{
+			const size_t RUN = 16;
+
+			const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			const __m256i a_offsets = _mm256_mullo_epi32(lane, _mm256_set1_epi32(static_cast<int>(a_stride)));
+			const __m256i b_offsets = _mm256_mullo_epi32(lane, _mm256_set1_epi32(static_cast<int>(b_stride)));
+
+			__m256d total[18];
+			__m256 s[18];
+
+			for (int k = 0; k < 18; ++k)
+			{
+				total[k] = _mm256_setzero_pd();
+				s[k] = _mm256_setzero_ps();
+			}
+
+			size_t i = begin;
+			size_t run = 0;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 w = weights ? _mm256_loadu_ps(weights + i) : _mm256_set1_ps(1.0f);
+				__m256 da[3], db[3], wda[3];
+
+				for (int k = 0; k < 3; ++k)
+				{
+					da[k] = _mm256_sub_ps(_mm256_i32gather_ps(a + i * a_stride + k, a_offsets, 4), _mm256_set1_ps(oa[k]));
+					db[k] = _mm256_sub_ps(_mm256_i32gather_ps(b + i * b_stride + k, b_offsets, 4), _mm256_set1_ps(ob[k]));
+					wda[k] = _mm256_mul_ps(w, da[k]);
+				}
+
+				s[0] = _mm256_add_ps(s[0], w);
+
+				for (int k = 0; k < 3; ++k)
+				{
+					s[1 + k] = _mm256_add_ps(s[1 + k], wda[k]);
+					s[4 + k] = mm256_fmadd(w, db[k], s[4 + k]);
+					s[16] = mm256_fmadd(wda[k], da[k], s[16]);
+					s[17] = mm256_fmadd(_mm256_mul_ps(w, db[k]), db[k], s[17]);
+
+					for (int j = 0; j < 3; ++j)
+						s[7 + k * 3 + j] = mm256_fmadd(wda[k], db[j], s[7 + k * 3 + j]);
+				}
+
+				if (++run == RUN || i + 16 > end)
+				{
+					for (int k = 0; k < 18; ++k)
+					{
+						__m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(s[k]));
+						__m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(s[k], 1));
+
+						total[k] = _mm256_add_pd(total[k], _mm256_add_pd(lo, hi));
+						s[k] = _mm256_setzero_ps();
+					}
+
+					run = 0;
+				}
+			}
+
+			double tail[18];
+			cross_covariance_sums<float, double>(a, a_stride, b, b_stride, weights, i, end, oa, ob, tail);
+
+			for (int k = 0; k < 18; ++k)
+			{
+				double lanes[4];
+				_mm256_storeu_pd(lanes, total[k]);
+
+				sums[k] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + tail[k];
+			}
+		}
+#endif
+	}
+
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::add(const vec3<T>& a, const vec3<T>& b, const T& weight)
+	{
+		if (weight <= 0)
+			return *this;
+
+		cross_covariance3<T> single;
+
+		single.m_weight = weight;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			single.m_mean_a[k] = a.m_data[k];
+			single.m_mean_b[k] = b.m_data[k];
+		}
+
+		return merge(single);
+	}
+
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::add(const vec3<T>* a, const vec3<T>* b, const size_t& count, const bool& parallel)
+	{
+		return add(a, b, nullptr, count, parallel);
+	}
+
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::add(const vec3<T>* a, const vec3<T>* b, const T* weights, const size_t& count, const bool& parallel)
+	{
+		static_assert(sizeof(vec3<T>) % sizeof(T) == 0, "vec3 must be a whole number of components");
+
+		if (count == 0)
+			return *this;
+
+		const size_t stride = sizeof(vec3<T>) / sizeof(T);
+
+		return add_strided(a->m_data, stride, b->m_data, stride, weights, count, parallel);
+	}
+
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::add(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const bool& parallel)
+	{
+		return add(a, b, nullptr, parallel);
+	}
+
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::add(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const T* weights, const bool& parallel)
+	{
+		assert(a.size() == b.size());
+
+		if (a.empty())
+			return *this;
+
+		return add_strided(a.data(), a.component_stride(), b.data(), b.component_stride(), weights, a.size(), parallel);
+	}
+
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::add_strided(const T* a, const size_t& a_stride, const T* b, const size_t& b_stride, const T* weights, const size_t& count, const bool& parallel)
+	{
+		if (!parallel)
+		{
+			for (size_t i = 0; i < count; i += BLOCK_SIZE)
+				add_block(a, a_stride, b, b_stride, weights, i, std::min(count, i + BLOCK_SIZE));
+
+			return *this;
+		}
+
+		std::vector<cross_covariance3<T>> partial(support::parallel_chunks(count, 1 << 16));
+
+		support::parallel_for(count, 1 << 16, [&](size_t chunk, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i += BLOCK_SIZE)
+				partial[chunk].add_block(a, a_stride, b, b_stride, weights, i, std::min(end, i + BLOCK_SIZE));
+		});
+
+		for (const cross_covariance3<T>& p : partial)
+			merge(p);
+
+		return *this;
+	}
+
+	template <typename T>
+	void cross_covariance3<T>::add_block(const T* a, const size_t& a_stride, const T* b, const size_t& b_stride, const T* weights, const size_t& begin, const size_t& end)
+	{
+		T oa[3] = { a[begin * a_stride], a[begin * a_stride + 1], a[begin * a_stride + 2] };
+		T ob[3] = { b[begin * b_stride], b[begin * b_stride + 1], b[begin * b_stride + 2] };
+		accumulator_type s[18];
+
+		support::cross_covariance_sums(a, a_stride, b, b_stride, weights, begin, end, oa, ob, s);
+
+		if (s[0] <= 0)
+			return;
+
+		cross_covariance3<T> block;
+
+		accumulator_type n = s[0];
+		accumulator_type ma[3], mb[3];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			ma[k] = s[1 + k] / n;
+			mb[k] = s[4 + k] / n;
+
+			block.m_mean_a[k] = static_cast<accumulator_type>(oa[k]) + ma[k];
+			block.m_mean_b[k] = static_cast<accumulator_type>(ob[k]) + mb[k];
+		}
+
+		block.m_weight = n;
+		block.m_scatter_a = s[16] - n * (ma[0] * ma[0] + ma[1] * ma[1] + ma[2] * ma[2]);
+		block.m_scatter_b = s[17] - n * (mb[0] * mb[0] + mb[1] * mb[1] + mb[2] * mb[2]);
+
+		for (int k = 0; k < 3; ++k)
+			for (int j = 0; j < 3; ++j)
+				block.m_cross[k * 3 + j] = s[7 + k * 3 + j] - n * ma[k] * mb[j];
+
+		merge(block);
+	}
+
+	// credit Chan, Golub & LeVeque, the pairwise update extended to cross terms
+	template <typename T>
+	cross_covariance3<T>& cross_covariance3<T>::merge(const cross_covariance3<T>& other)
+	{
+		if (other.m_weight <= 0)
+			return *this;
+
+		if (m_weight <= 0)
+		{
+			*this = other;
+			return *this;
+		}
+
+		accumulator_type total = m_weight + other.m_weight;
+		accumulator_type f = m_weight * other.m_weight / total;
+		accumulator_type da[3], db[3];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			da[k] = other.m_mean_a[k] - m_mean_a[k];
+			db[k] = other.m_mean_b[k] - m_mean_b[k];
+		}
+
+		for (int k = 0; k < 3; ++k)
+			for (int j = 0; j < 3; ++j)
+				m_cross[k * 3 + j] += other.m_cross[k * 3 + j] + f * da[k] * db[j];
+
+		m_scatter_a += other.m_scatter_a + f * (da[0] * da[0] + da[1] * da[1] + da[2] * da[2]);
+		m_scatter_b += other.m_scatter_b + f * (db[0] * db[0] + db[1] * db[1] + db[2] * db[2]);
+
+		for (int k = 0; k < 3; ++k)
+		{
+			m_mean_a[k] += da[k] * other.m_weight / total;
+			m_mean_b[k] += db[k] * other.m_weight / total;
+		}
+
+		m_weight = total;
+
+		return *this;
+	}
+
+	template <typename T>
+	inline const typename cross_covariance3<T>::accumulator_type& cross_covariance3<T>::weight() const
+	{
+		return m_weight;
+	}
+
+	template <typename T>
+	const vec3<T> cross_covariance3<T>::mean_a() const
+	{
+		return vec3<T>(static_cast<T>(m_mean_a[0]), static_cast<T>(m_mean_a[1]), static_cast<T>(m_mean_a[2]));
+	}
+
+	template <typename T>
+	const vec3<T> cross_covariance3<T>::mean_b() const
+	{
+		return vec3<T>(static_cast<T>(m_mean_b[0]), static_cast<T>(m_mean_b[1]), static_cast<T>(m_mean_b[2]));
+	}
+
+	template <typename T>
+	const mat3<T> cross_covariance3<T>::covariance() const
+	{
+		mat3<T> tmp(static_cast<T>(0));
+
+		if (m_weight <= 0)
+			return tmp;
+
+		for (int row = 0; row < 3; ++row)
+			for (int col = 0; col < 3; ++col)
+				tmp.at(row, col) = static_cast<T>(m_cross[row * 3 + col] / m_weight);
+
+		return tmp;
+	}
+
+	template <typename T>
+	const rigid_transform<T> cross_covariance3<T>::solve(const bool& scaling) const
+	{
+		typedef accumulator_type A;
+
+		if (m_weight <= 0)
+			return rigid_transform<T>();
+
+		// H = U S V^T with U and V rotations and the sign of det(H) on the last singular value, so R = V U^T is already
+		// the proper rotation Kabsch and Umeyama correct reflections to
+		mat3<A> h;
+
+		for (int row = 0; row < 3; ++row)
+			for (int col = 0; col < 3; ++col)
+				h.at(row, col) = m_cross[row * 3 + col];
+
+		svd3<A> s(h);
+		mat3<A> r(static_cast<A>(0));
+
+		for (int row = 0; row < 3; ++row)
+			for (int col = 0; col < 3; ++col)
+				for (int k = 0; k < 3; ++k)
+					r.at(row, col) += s.v.at(row, k) * s.u.at(col, k);
+
+		A scale = 1;
+
+		if (scaling && m_scatter_a > 0)
+			scale = (s.values.x() + s.values.y() + s.values.z()) / m_scatter_a;
+
+		vec3<A> ma(m_mean_a[0], m_mean_a[1], m_mean_a[2]);
+		vec3<A> mb(m_mean_b[0], m_mean_b[1], m_mean_b[2]);
+		vec3<A> t = mb - vec3<A>(r.row(0).dot(ma), r.row(1).dot(ma), r.row(2).dot(ma)) * scale;
+
+		quat<A> q = quat<A>(r).normalized();
+
+		return rigid_transform<T>(quat<T>(static_cast<T>(q.x()), static_cast<T>(q.y()), static_cast<T>(q.z()), static_cast<T>(q.w())), vec3<T>(t), static_cast<T>(scale));
+	}
+
+	template <typename T>
+	const T cross_covariance3<T>::residual(const rigid_transform<T>& transform) const
+	{
+		typedef accumulator_type A;
+
+		if (m_weight <= 0)
+			return 0;
+
+		// sum w |s R a + t - b|^2 = s^2 Sa + Sb - 2 s tr(R H) + W |s R ma + t - mb|^2
+		mat3<T> rt = transform.rotation.toMat3();
+		A trace = 0;
+
+		for (int k = 0; k < 3; ++k)
+			for (int j = 0; j < 3; ++j)
+				trace += static_cast<A>(rt.at(j, k)) * m_cross[k * 3 + j];
+
+		vec3<A> d = vec3<A>(transform.apply(mean_a())) - vec3<A>(m_mean_b[0], m_mean_b[1], m_mean_b[2]);
+		A s = transform.scale;
+		A sum = s * s * m_scatter_a + m_scatter_b - 2 * s * trace + m_weight * d.length_squared();
+
+		return static_cast<T>(std::max<A>(sum, 0) / m_weight);
+	}
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec3<T>* a, const vec3<T>* b, const size_t& count, const bool& scaling, const bool& parallel)
+	{
+		return cross_covariance3<T>().add(a, b, count, parallel).solve(scaling);
+	}
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec3<T>* a, const vec3<T>* b, const T* weights, const size_t& count, const bool& scaling, const bool& parallel)
+	{
+		return cross_covariance3<T>().add(a, b, weights, count, parallel).solve(scaling);
+	}
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const bool& scaling, const bool& parallel)
+	{
+		return cross_covariance3<T>().add(a, b, parallel).solve(scaling);
+	}
+
+	template <typename T>
+	const rigid_transform<T> align_rigid(const vec_span<3, const T>& a, const vec_span<3, const T>& b, const T* weights, const bool& scaling, const bool& parallel)
+	{
+		return cross_covariance3<T>().add(a, b, weights, parallel).solve(scaling);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef rigid_transform<float> rigid_transformf;
+	typedef rigid_transform<double> rigid_transformd;
+
+	typedef cross_covariance3<float> cross_covariance3f;
+	typedef cross_covariance3<double> cross_covariance3d;
+#endif
+}
+
+#endif
@@ -0,0 +1,986 @@
+#ifndef _RM_BVH_H
+#define _RM_BVH_H
+
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "vec3.h"
+#include "aabb.h"
+#include "ray.h"
+#include "morton.h"
+#include "support/memory.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Four-wide bounding volume hierarchy over a triangle mesh. Built top-down with binned SAH, then
+	// collapsed into flat nodes holding the bounds of four children each.
+	template <typename T>
+	class bvh
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static const size_t WIDTH = 4;
+		static const size_t MAX_LEAF_SIZE = 4;
+		static const size_t BINS = 16;
+		static const size_t STACK_SIZE = 256;
+
+		// Deepest collapsed node, every level leaves at most WIDTH - 1 siblings on the traversal stack. Builds switch
+		// to median splits where the SAH or Morton splits would go deeper.
+		static const size_t MAX_DEPTH = (STACK_SIZE - 1) / (WIDTH - 1);
+		static const uint32_t EMPTY = 0xffffffffu;
+
+		struct alignas(32) node
+		{
+			// min x, y, z then max x, y, z, one column per child
+			T bounds[6][WIDTH];
+
+			// inner children: node index, leaf children: first primitive in leaf order
+			uint32_t child[WIDTH];
+
+			// primitives in a leaf child, 0 for inner children
+			uint32_t count[WIDTH];
+		};
+
+		// constructors
+		bvh() {}
+		explicit bvh(const triangle_mesh<T>& mesh, const bool& parallel = false);
+
+		// Modifiers
+		void build(const triangle_mesh<T>& mesh, const bool& parallel = false);
+
+		// Linear BVH, splits at the Morton code bits of the triangle centroids. Several times faster to build than
+		// build(), at the cost of somewhat slower queries.
+		void build_lbvh(const triangle_mesh<T>& mesh, const bool& parallel = false);
+		void refit(const triangle_mesh<T>& mesh);
+		void clear();
+
+		// Queries, primitive ids are triangle indices in the input mesh
+		const bool intersect(const ray<T>& r, ray_hit<T>& hit) const;
+		void intersect(const ray<T>* rays, const size_t& count, ray_hit<T>* hits, const bool& parallel = false) const;
+		const bool occluded(const ray<T>& r, const T& t_max = std::numeric_limits<T>::infinity()) const;
+
+		template <typename F>
+		void overlap(const aabb<T>& box, F&& f) const;
+		size_t overlap(const aabb<T>& box, std::vector<uint32_t>& primitives) const;
+
+		// Accessors
+		const aabb<T> bounds() const;
+		inline const size_t node_count() const;
+		inline const size_t primitive_count() const;
+		inline const node* nodes() const;
+
+	private:
+		struct build_node
+		{
+			aabb<T> bounds;
+			uint32_t left;
+			uint32_t right;
+			uint32_t first;
+			uint32_t count;
+		};
+
+		struct build_input
+		{
+			const aabb<T>* bounds;
+			const vec3<T>* centroids;
+			uint32_t* indices;
+			size_t spawn_depth;
+
+			// Morton codes in index order, only for build_lbvh
+			const uint64_t* codes;
+		};
+
+		void prepare(const triangle_mesh<T>& mesh, std::vector<aabb<T>>& prim_bounds, std::vector<vec3<T>>& centroids, const bool& parallel);
+		static uint32_t build_recursive(std::vector<build_node>& nodes, const build_input& in, const uint32_t& begin, const uint32_t& end, const size_t& depth);
+		static uint32_t build_morton_recursive(std::vector<build_node>& nodes, const build_input& in, const uint32_t& begin, const uint32_t& end, const size_t& depth);
+		static void append(std::vector<build_node>& nodes, const std::vector<build_node>& other);
+		static size_t median_levels(uint32_t count);
+		uint32_t collapse(const std::vector<build_node>& nodes, const uint32_t& root);
+		void gather(const triangle_mesh<T>& mesh);
+		const aabb<T> triangle_bounds(const size_t& index) const;
+		inline const bool intersect_triangle(const size_t& index, const T(&origin)[3], const T(&direction)[3], T& t, T& u, T& v) const;
+
+		support::aligned_vector<node, 32> m_nodes;
+		std::vector<uint32_t> m_indices;
+
+		// leaf order, v0 then the edges v1 - v0 and v2 - v0 per triangle
+		std::vector<T> m_triangles;
+	};
+
+	namespace support
+	{
+		// One ray against the four child boxes of a bvh node, returns the mask of children entered before t_max
+		template <typename T>
+		inline int bvh_slab4(const T(&b)[6][4], const T(&origin)[3], const T(&inv_direction)[3], const T& t_max, T(&t_near)[4])
+		{
+			int mask = 0;
+
+			for (int i = 0; i < 4; ++i)
+			{
+				T t0 = 0;
+				T t1 = t_max;
+
+				for (int j = 0; j < 3; ++j)
+				{
+					T a = (b[j][i] - origin[j]) * inv_direction[j];
+					T c = (b[j + 3][i] - origin[j]) * inv_direction[j];
+
+					t0 = std::max(t0, std::min(a, c));
+					t1 = std::min(t1, std::max(a, c));
+				}
+
+				t_near[i] = t0;
+				mask |= (t0 <= t1) << i;
+			}
+
+			return mask;
+		}
+
+#ifdef _REACT_SIMD_SSE2
+		inline int bvh_slab4(const float(&b)[6][4], const float(&origin)[3], const float(&inv_direction)[3], const float& t_max, float(&t_near)[4])
+		{
+			__m128 t0 = _mm_setzero_ps();
+			__m128 t1 = _mm_set1_ps(t_max);
+
+			for (int j = 0; j < 3; ++j)
+			{
+				__m128 o = _mm_set1_ps(origin[j]);
+				__m128 inv = _mm_set1_ps(inv_direction[j]);
+				__m128 a = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b[j]), o), inv);
+				__m128 c = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b[j + 3]), o), inv);
+
+				t0 = _mm_max_ps(t0, _mm_min_ps(a, c));
+				t1 = _mm_min_ps(t1, _mm_max_ps(a, c));
+			}
+
+			_mm_storeu_ps(t_near, t0);
+
+			return _mm_movemask_ps(_mm_cmple_ps(t0, t1));
+		}
+#endif
+	}
+
+	template <typename T>
+	bvh<T>::bvh(const triangle_mesh<T>& mesh, const bool& parallel)
+	{
+		build(mesh, parallel);
+	}
+
+	template <typename T>
+	void bvh<T>::prepare(const triangle_mesh<T>& mesh, std::vector<aabb<T>>& prim_bounds, std::vector<vec3<T>>& centroids, const bool& parallel)
+	{
+		assert(mesh.triangle_count < EMPTY);
+
+		size_t count = mesh.triangle_count;
+
+		prim_bounds.resize(count);
+		centroids.resize(count);
+		m_indices.resize(count);
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			vec3<T> v0, v1, v2;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				mesh.triangle(i, v0, v1, v2);
+
+				prim_bounds[i] = aabb<T>(v0, v0);
+				prim_bounds[i].expand(v1).expand(v2);
+				centroids[i] = prim_bounds[i].center();
+				m_indices[i] = static_cast<uint32_t>(i);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 14, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	void bvh<T>::build(const triangle_mesh<T>& mesh, const bool& parallel)
+	{
+		clear();
+
+		if (mesh.triangle_count == 0)
+			return;
+
+		size_t count = mesh.triangle_count;
+
+		std::vector<aabb<T>> prim_bounds;
+		std::vector<vec3<T>> centroids;
+		prepare(mesh, prim_bounds, centroids, parallel);
+
+		// fork a thread per subtree until every hardware thread has work
+		size_t spawn_depth = 0;
+
+		while (parallel && (size_t(1) << spawn_depth) < support::thread_count())
+			++spawn_depth;
+
+		build_input in = { prim_bounds.data(), centroids.data(), m_indices.data(), spawn_depth, nullptr };
+
+		std::vector<build_node> nodes;
+		nodes.reserve(2 * count / MAX_LEAF_SIZE + 1);
+
+		uint32_t root = build_recursive(nodes, in, 0, static_cast<uint32_t>(count), 0);
+
+		m_nodes.reserve(nodes.size() / 2 + 1);
+		collapse(nodes, root);
+
+		gather(mesh);
+	}
+
+	template <typename T>
+	void bvh<T>::build_lbvh(const triangle_mesh<T>& mesh, const bool& parallel)
+	{
+		clear();
+
+		if (mesh.triangle_count == 0)
+			return;
+
+		size_t count = mesh.triangle_count;
+
+		std::vector<aabb<T>> prim_bounds;
+		std::vector<vec3<T>> centroids;
+		prepare(mesh, prim_bounds, centroids, parallel);
+
+		std::vector<uint64_t> codes(count);
+
+		morton_encode63(centroids.data(), count, aabb<T>::from_points(centroids.data(), count), codes.data(), parallel);
+		support::radix_sort(codes.data(), m_indices.data(), count, parallel);
+
+		size_t spawn_depth = 0;
+
+		while (parallel && (size_t(1) << spawn_depth) < support::thread_count())
+			++spawn_depth;
+
+		build_input in = { prim_bounds.data(), centroids.data(), m_indices.data(), spawn_depth, codes.data() };
+
+		std::vector<build_node> nodes;
+		nodes.reserve(2 * count / MAX_LEAF_SIZE + 1);
+
+		uint32_t root = build_morton_recursive(nodes, in, 0, static_cast<uint32_t>(count), 0);
+
+		m_nodes.reserve(nodes.size() / 2 + 1);
+		collapse(nodes, root);
+
+		gather(mesh);
+	}
+
+	// credit Karras, "Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d Trees"
+	template <typename T>
+	uint32_t bvh<T>::build_morton_recursive(std::vector<build_node>& nodes, const build_input& in, const uint32_t& begin, const uint32_t& end, const size_t& depth)
+	{
+		uint32_t index = static_cast<uint32_t>(nodes.size());
+		nodes.push_back(build_node());
+
+		uint32_t count = end - begin;
+
+		aabb<T> bounds;
+
+		for (uint32_t i = begin; i < end; ++i)
+			bounds.expand(in.bounds[in.indices[i]]);
+
+		if (count <= MAX_LEAF_SIZE)
+		{
+			nodes[index] = { bounds, EMPTY, EMPTY, begin, count };
+			return index;
+		}
+
+		// codes are sorted, split where the highest bit that differs across the range turns on
+		uint64_t first = in.codes[begin];
+		uint64_t last = in.codes[end - 1];
+		uint32_t mid = begin + count / 2;
+
+		if (first != last && depth + median_levels(count) < MAX_DEPTH)
+		{
+			int bit = 63;
+
+			while (!(((first ^ last) >> bit) & 1))
+				--bit;
+
+			mid = static_cast<uint32_t>(std::partition_point(in.codes + begin, in.codes + end, [&](const uint64_t& code)
+			{
+				return !((code >> bit) & 1);
+			}) - in.codes);
+		}
+
+		uint32_t left;
+		uint32_t right;
+
+		if (depth < in.spawn_depth && count > (1u << 12))
+		{
+			std::vector<build_node> left_nodes;
+
+			std::thread worker([&]() { build_morton_recursive(left_nodes, in, begin, mid, depth + 1); });
+			right = build_morton_recursive(nodes, in, mid, end, depth + 1);
+			worker.join();
+
+			left = static_cast<uint32_t>(nodes.size());
+			append(nodes, left_nodes);
+		}
+		else
+		{
+			left = build_morton_recursive(nodes, in, begin, mid, depth + 1);
+			right = build_morton_recursive(nodes, in, mid, end, depth + 1);
+		}
+
+		nodes[index] = { bounds, left, right, 0, 0 };
+
+		return index;
+	}
+
+	template <typename T>
+	uint32_t bvh<T>::build_recursive(std::vector<build_node>& nodes, const build_input& in, const uint32_t& begin, const uint32_t& end, const size_t& depth)
+	{
+		uint32_t index = static_cast<uint32_t>(nodes.size());
+		nodes.push_back(build_node());
+
+		uint32_t count = end - begin;
+
+		aabb<T> bounds;
+		aabb<T> centroid_bounds;
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			bounds.expand(in.bounds[in.indices[i]]);
+			centroid_bounds.expand(in.centroids[in.indices[i]]);
+		}
+
+		// binned SAH, cost of a leaf is its primitive count, a split costs one traversal step plus its area weighted children
+		int best_axis = -1;
+		size_t best_bin = 0;
+		T best_cost = std::numeric_limits<T>::infinity();
+
+		T parent_area = bounds.surface_area();
+
+		// near MAX_DEPTH the rest is split at the median of the widest centroid axis, which stays balanced
+		bool balance = depth + median_levels(count) >= MAX_DEPTH;
+
+		for (int axis = 0; axis < 3 && count > 1 && !balance; ++axis)
+		{
+			T lo = centroid_bounds.min.m_data[axis];
+			T extent = centroid_bounds.max.m_data[axis] - lo;
+
+			if (extent <= 0)
+				continue;
+
+			aabb<T> bin_bounds[BINS];
+			uint32_t bin_count[BINS] = {};
+
+			T scale = static_cast<T>(BINS) / extent;
+
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				uint32_t prim = in.indices[i];
+				size_t bin = std::min(BINS - 1, static_cast<size_t>((in.centroids[prim].m_data[axis] - lo) * scale));
+
+				bin_bounds[bin].expand(in.bounds[prim]);
+				++bin_count[bin];
+			}
+
+			T right_area[BINS];
+			uint32_t right_count[BINS];
+
+			aabb<T> acc;
+			uint32_t n = 0;
+
+			for (size_t bin = BINS - 1; bin > 0; --bin)
+			{
+				acc.expand(bin_bounds[bin]);
+				n += bin_count[bin];
+				right_area[bin] = acc.surface_area();
+				right_count[bin] = n;
+			}
+
+			acc = aabb<T>();
+			n = 0;
+
+			for (size_t bin = 0; bin < BINS - 1; ++bin)
+			{
+				acc.expand(bin_bounds[bin]);
+				n += bin_count[bin];
+
+				if (n == 0 || n == count)
+					continue;
+
+				T cost = static_cast<T>(1) + (acc.surface_area() * n + right_area[bin + 1] * right_count[bin + 1]) / parent_area;
+
+				if (cost < best_cost)
+				{
+					best_cost = cost;
+					best_axis = axis;
+					best_bin = bin;
+				}
+			}
+		}
+
+		bool leaf = count <= MAX_LEAF_SIZE && (best_axis < 0 || static_cast<T>(count) <= best_cost);
+
+		if (leaf)
+		{
+			nodes[index] = { bounds, EMPTY, EMPTY, begin, count };
+			return index;
+		}
+
+		uint32_t mid = begin + count / 2;
+
+		if (best_axis >= 0)
+		{
+			T lo = centroid_bounds.min.m_data[best_axis];
+			T scale = static_cast<T>(BINS) / (centroid_bounds.max.m_data[best_axis] - lo);
+
+			uint32_t* split = std::partition(in.indices + begin, in.indices + end, [&](const uint32_t& prim)
+			{
+				return std::min(BINS - 1, static_cast<size_t>((in.centroids[prim].m_data[best_axis] - lo) * scale)) <= best_bin;
+			});
+
+			mid = static_cast<uint32_t>(split - in.indices);
+
+			if (mid == begin || mid == end)
+				mid = begin + count / 2;
+		}
+		else if (balance)
+		{
+			vec3<T> extent = centroid_bounds.max - centroid_bounds.min;
+			int axis = extent.x() >= extent.y() ? (extent.x() >= extent.z() ? 0 : 2) : (extent.y() >= extent.z() ? 1 : 2);
+
+			std::nth_element(in.indices + begin, in.indices + mid, in.indices + end, [&](const uint32_t& a, const uint32_t& b)
+			{
+				return in.centroids[a].m_data[axis] < in.centroids[b].m_data[axis];
+			});
+		}
+
+		uint32_t left;
+		uint32_t right;
+
+		if (depth < in.spawn_depth && count > (1u << 12))
+		{
+			std::vector<build_node> left_nodes;
+
+			std::thread worker([&]() { build_recursive(left_nodes, in, begin, mid, depth + 1); });
+			right = build_recursive(nodes, in, mid, end, depth + 1);
+			worker.join();
+
+			left = static_cast<uint32_t>(nodes.size());
+			append(nodes, left_nodes);
+		}
+		else
+		{
+			left = build_recursive(nodes, in, begin, mid, depth + 1);
+			right = build_recursive(nodes, in, mid, end, depth + 1);
+		}
+
+		nodes[index] = { bounds, left, right, 0, 0 };
+
+		return index;
+	}
+
+	template <typename T>
+	void bvh<T>::append(std::vector<build_node>& nodes, const std::vector<build_node>& other)
+	{
+		uint32_t offset = static_cast<uint32_t>(nodes.size());
+
+		for (build_node n : other)
+		{
+			if (n.count == 0)
+			{
+				n.left += offset;
+				n.right += offset;
+			}
+
+			nodes.push_back(n);
+		}
+	}
+
+	// median splits from count primitives down to leaves
+	template <typename T>
+	size_t bvh<T>::median_levels(uint32_t count)
+	{
+		size_t levels = 0;
+
+		for (; count > MAX_LEAF_SIZE; ++levels)
+			count = count - count / 2;
+
+		return levels;
+	}
+
+	template <typename T>
+	uint32_t bvh<T>::collapse(const std::vector<build_node>& nodes, const uint32_t& root)
+	{
+		uint32_t index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back(node());
+
+		uint32_t children[WIDTH];
+		size_t n = 0;
+
+		if (nodes[root].count > 0)
+		{
+			children[n++] = root;
+		}
+		else
+		{
+			children[n++] = nodes[root].left;
+			children[n++] = nodes[root].right;
+
+			// open the largest inner child until the node is full
+			while (n < WIDTH)
+			{
+				int largest = -1;
+				T largest_area = -1;
+
+				for (size_t i = 0; i < n; ++i)
+				{
+					const build_node& c = nodes[children[i]];
+
+					if (c.count == 0 && c.bounds.surface_area() > largest_area)
+					{
+						largest = static_cast<int>(i);
+						largest_area = c.bounds.surface_area();
+					}
+				}
+
+				if (largest < 0)
+					break;
+
+				const build_node& c = nodes[children[largest]];
+				children[largest] = c.left;
+				children[n++] = c.right;
+			}
+		}
+
+		uint32_t child[WIDTH];
+		uint32_t count[WIDTH];
+
+		for (size_t i = 0; i < WIDTH; ++i)
+		{
+			if (i >= n)
+			{
+				child[i] = EMPTY;
+				count[i] = 0;
+				continue;
+			}
+
+			const build_node& c = nodes[children[i]];
+
+			count[i] = c.count;
+			child[i] = c.count > 0 ? c.first : collapse(nodes, children[i]);
+		}
+
+		node& out = m_nodes[index];
+
+		for (size_t i = 0; i < WIDTH; ++i)
+		{
+			aabb<T> b = i < n ? nodes[children[i]].bounds : aabb<T>();
+
+			for (int j = 0; j < 3; ++j)
+			{
+				out.bounds[j][i] = b.min.m_data[j];
+				out.bounds[j + 3][i] = b.max.m_data[j];
+			}
+
+			out.child[i] = child[i];
+			out.count[i] = count[i];
+		}
+
+		return index;
+	}
+
+	template <typename T>
+	void bvh<T>::gather(const triangle_mesh<T>& mesh)
+	{
+		m_triangles.resize(m_indices.size() * 9);
+
+		vec3<T> v0, v1, v2;
+
+		for (size_t i = 0; i < m_indices.size(); ++i)
+		{
+			mesh.triangle(m_indices[i], v0, v1, v2);
+
+			T* tri = &m_triangles[9 * i];
+
+			for (int j = 0; j < 3; ++j)
+			{
+				tri[j] = v0.m_data[j];
+				tri[3 + j] = v1.m_data[j] - v0.m_data[j];
+				tri[6 + j] = v2.m_data[j] - v0.m_data[j];
+			}
+		}
+	}
+
+	template <typename T>
+	void bvh<T>::refit(const triangle_mesh<T>& mesh)
+	{
+		assert(mesh.triangle_count == m_indices.size());
+
+		gather(mesh);
+
+		// children are always stored after their parent
+		for (size_t i = m_nodes.size(); i-- > 0;)
+		{
+			node& n = m_nodes[i];
+
+			for (size_t s = 0; s < WIDTH; ++s)
+			{
+				if (n.child[s] == EMPTY)
+					continue;
+
+				aabb<T> b;
+
+				if (n.count[s] > 0)
+				{
+					for (uint32_t k = n.child[s]; k < n.child[s] + n.count[s]; ++k)
+						b.expand(triangle_bounds(k));
+				}
+				else
+				{
+					const node& c = m_nodes[n.child[s]];
+
+					for (size_t cs = 0; cs < WIDTH; ++cs)
+						if (c.child[cs] != EMPTY)
+							b.expand(aabb<T>(vec3<T>(c.bounds[0][cs], c.bounds[1][cs], c.bounds[2][cs]), vec3<T>(c.bounds[3][cs], c.bounds[4][cs], c.bounds[5][cs])));
+				}
+
+				for (int j = 0; j < 3; ++j)
+				{
+					n.bounds[j][s] = b.min.m_data[j];
+					n.bounds[j + 3][s] = b.max.m_data[j];
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	void bvh<T>::clear()
+	{
+		m_nodes.clear();
+		m_indices.clear();
+		m_triangles.clear();
+	}
+
+	template <typename T>
+	const aabb<T> bvh<T>::triangle_bounds(const size_t& index) const
+	{
+		const T* tri = &m_triangles[9 * index];
+
+		vec3<T> v0(tri[0], tri[1], tri[2]);
+
+		aabb<T> b(v0, v0);
+		b.expand(v0 + vec3<T>(tri[3], tri[4], tri[5]));
+		b.expand(v0 + vec3<T>(tri[6], tri[7], tri[8]));
+
+		return b;
+	}
+
+	template <typename T>
+	inline const bool bvh<T>::intersect_triangle(const size_t& index, const T(&o)[3], const T(&d)[3], T& t, T& u, T& v) const
+	{
+		const T* tri = &m_triangles[9 * index];
+		const T* e1 = tri + 3;
+		const T* e2 = tri + 6;
+
+		T px = d[1] * e2[2] - d[2] * e2[1];
+		T py = d[2] * e2[0] - d[0] * e2[2];
+		T pz = d[0] * e2[1] - d[1] * e2[0];
+
+		T det = e1[0] * px + e1[1] * py + e1[2] * pz;
+
+		T e1_length_squared = e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2];
+		T e2_length_squared = e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2];
+
+		if (det * det <= support::triangle_parallel_limit(e1_length_squared, e2_length_squared) * (d[0] * d[0] + d[1] * d[1] + d[2] * d[2]))
+			return false;
+
+		T inv_det = static_cast<T>(1) / det;
+
+		T sx = o[0] - tri[0], sy = o[1] - tri[1], sz = o[2] - tri[2];
+		T uu = (sx * px + sy * py + sz * pz) * inv_det;
+
+		if (uu < 0 || uu > 1)
+			return false;
+
+		T qx = sy * e1[2] - sz * e1[1];
+		T qy = sz * e1[0] - sx * e1[2];
+		T qz = sx * e1[1] - sy * e1[0];
+
+		T vv = (d[0] * qx + d[1] * qy + d[2] * qz) * inv_det;
+
+		if (vv < 0 || uu + vv > 1)
+			return false;
+
+		T tt = (e2[0] * qx + e2[1] * qy + e2[2] * qz) * inv_det;
+
+		if (tt <= 0 || tt >= t)
+			return false;
+
+		t = tt;
+		u = uu;
+		v = vv;
+
+		return true;
+	}
+
+	template <typename T>
+	const bool bvh<T>::intersect(const ray<T>& r, ray_hit<T>& hit) const
+	{
+		if (m_nodes.empty())
+			return false;
+
+		T origin[3], direction[3], inv_direction[3];
+
+		for (int i = 0; i < 3; ++i)
+		{
+			origin[i] = r.origin.m_data[i];
+			direction[i] = r.direction.m_data[i];
+			inv_direction[i] = static_cast<T>(1) / direction[i];
+		}
+
+		uint32_t stack[STACK_SIZE];
+		T stack_t[STACK_SIZE];
+		size_t sp = 0;
+
+		stack[sp] = 0;
+		stack_t[sp++] = 0;
+
+		bool found = false;
+
+		while (sp > 0)
+		{
+			--sp;
+
+			if (stack_t[sp] >= hit.t)
+				continue;
+
+			const node& n = m_nodes[stack[sp]];
+
+			T t_near[WIDTH];
+			int mask = support::bvh_slab4(n.bounds, origin, inv_direction, hit.t, t_near);
+
+			uint32_t inner[WIDTH];
+			T inner_t[WIDTH];
+			size_t inner_count = 0;
+
+			while (mask)
+			{
+				int s = support::ctz32(mask);
+				mask &= mask - 1;
+
+				if (n.child[s] == EMPTY)
+					continue;
+
+				if (n.count[s] > 0)
+				{
+					for (uint32_t k = n.child[s]; k < n.child[s] + n.count[s]; ++k)
+					{
+						if (intersect_triangle(k, origin, direction, hit.t, hit.u, hit.v))
+						{
+							hit.primitive = m_indices[k];
+							found = true;
+						}
+					}
+				}
+				else
+				{
+					// keep sorted far to near so the nearest child is popped first
+					size_t j = inner_count++;
+
+					while (j > 0 && inner_t[j - 1] < t_near[s])
+					{
+						inner[j] = inner[j - 1];
+						inner_t[j] = inner_t[j - 1];
+						--j;
+					}
+
+					inner[j] = n.child[s];
+					inner_t[j] = t_near[s];
+				}
+			}
+
+			assert(sp + inner_count <= STACK_SIZE);
+
+			for (size_t i = 0; i < inner_count; ++i)
+			{
+				stack[sp] = inner[i];
+				stack_t[sp++] = inner_t[i];
+			}
+		}
+
+		return found;
+	}
+
+	template <typename T>
+	void bvh<T>::intersect(const ray<T>* rays, const size_t& count, ray_hit<T>* hits, const bool& parallel) const
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				hits[i] = ray_hit<T>();
+				intersect(rays[i], hits[i]);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(count, 256, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	const bool bvh<T>::occluded(const ray<T>& r, const T& t_max) const
+	{
+		if (m_nodes.empty())
+			return false;
+
+		T origin[3], direction[3], inv_direction[3];
+
+		for (int i = 0; i < 3; ++i)
+		{
+			origin[i] = r.origin.m_data[i];
+			direction[i] = r.direction.m_data[i];
+			inv_direction[i] = static_cast<T>(1) / direction[i];
+		}
+
+		uint32_t stack[STACK_SIZE];
+		size_t sp = 0;
+
+		stack[sp++] = 0;
+
+		while (sp > 0)
+		{
+			const node& n = m_nodes[stack[--sp]];
+
+			T t_near[WIDTH];
+			int mask = support::bvh_slab4(n.bounds, origin, inv_direction, t_max, t_near);
+
+			while (mask)
+			{
+				int s = support::ctz32(mask);
+				mask &= mask - 1;
+
+				if (n.child[s] == EMPTY)
+					continue;
+
+				if (n.count[s] > 0)
+				{
+					for (uint32_t k = n.child[s]; k < n.child[s] + n.count[s]; ++k)
+					{
+						T t = t_max, u, v;
+
+						if (intersect_triangle(k, origin, direction, t, u, v))
+							return true;
+					}
+				}
+				else
+				{
+					assert(sp < STACK_SIZE);
+					stack[sp++] = n.child[s];
+				}
+			}
+		}
+
+		return false;
+	}
+
+	template <typename T>
+	template <typename F>
+	void bvh<T>::overlap(const aabb<T>& box, F&& f) const
+	{
+		if (m_nodes.empty())
+			return;
+
+		uint32_t stack[STACK_SIZE];
+		size_t sp = 0;
+
+		stack[sp++] = 0;
+
+		while (sp > 0)
+		{
+			const node& n = m_nodes[stack[--sp]];
+
+			for (size_t s = 0; s < WIDTH; ++s)
+			{
+				if (n.child[s] == EMPTY)
+					continue;
+
+				bool hit = n.bounds[0][s] <= box.max.x() && n.bounds[3][s] >= box.min.x() &&
+					n.bounds[1][s] <= box.max.y() && n.bounds[4][s] >= box.min.y() &&
+					n.bounds[2][s] <= box.max.z() && n.bounds[5][s] >= box.min.z();
+
+				if (!hit)
+					continue;
+
+				if (n.count[s] > 0)
+				{
+					for (uint32_t k = n.child[s]; k < n.child[s] + n.count[s]; ++k)
+						if (triangle_bounds(k).intersects(box))
+							f(m_indices[k]);
+				}
+				else
+				{
+					assert(sp < STACK_SIZE);
+					stack[sp++] = n.child[s];
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	size_t bvh<T>::overlap(const aabb<T>& box, std::vector<uint32_t>& primitives) const
+	{
+		size_t before = primitives.size();
+
+		overlap(box, [&](const uint32_t& primitive) { primitives.push_back(primitive); });
+
+		return primitives.size() - before;
+	}
+
+	template <typename T>
+	const aabb<T> bvh<T>::bounds() const
+	{
+		aabb<T> b;
+
+		if (m_nodes.empty())
+			return b;
+
+		const node& n = m_nodes[0];
+
+		for (size_t s = 0; s < WIDTH; ++s)
+			if (n.child[s] != EMPTY)
+				b.expand(aabb<T>(vec3<T>(n.bounds[0][s], n.bounds[1][s], n.bounds[2][s]), vec3<T>(n.bounds[3][s], n.bounds[4][s], n.bounds[5][s])));
+
+		return b;
+	}
+
+	template <typename T>
+	inline const size_t bvh<T>::node_count() const
+	{
+		return m_nodes.size();
+	}
+
+	template <typename T>
+	inline const size_t bvh<T>::primitive_count() const
+	{
+		return m_indices.size();
+	}
+
+	template <typename T>
+	inline const typename bvh<T>::node* bvh<T>::nodes() const
+	{
+		return m_nodes.data();
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef bvh<float> bvhf;
+	typedef bvh<double> bvhd;
+#endif
+}
+
+#endif
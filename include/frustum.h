@@ -0,0 +1,339 @@
+#ifndef _RM_FRUSTUM_H
+#define _RM_FRUSTUM_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "vec3.h"
+#include "vec4.h"
+#include "mat4.h"
+#include "aabb.h"
+#include "support/simd.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	// Structure-of-arrays view of a batch of bounding spheres.
+	template <typename T>
+	struct sphere_soa
+	{
+		const T* x;
+		const T* y;
+		const T* z;
+		const T* radius;
+		size_t count;
+	};
+
+	template <typename T>
+	class frustum
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		enum plane_index
+		{
+			PLANE_LEFT = 0,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		// constructors
+		frustum() : m_planes() {}
+		explicit frustum(const support::matrix<4, 4, T>& view_projection, const bool& zero_to_one = false);
+
+		// Accessors
+		inline const vec4<T>& plane(const size_t& index) const;
+
+		// Utility functions
+		const bool contains(const vec3<T>& p) const;
+		const bool intersects(const vec3<T>& center, const T& radius) const;
+		const bool intersects(const aabb<T>& box) const;
+
+		// Batch culling, writes the indices of the visible objects to 'visible' (capacity >= count) and returns how many there are
+		size_t cull(const sphere_soa<T>& spheres, uint32_t* visible, const bool& parallel = false) const;
+		size_t cull(const aabb_soa<T>& boxes, uint32_t* visible, const bool& parallel = false) const;
+
+		// Static utility functions
+		static const frustum<T> from_matrix(const support::matrix<4, 4, T>& view_projection, const bool& zero_to_one = false);
+
+		// Planes are normalized, a point p is inside when dot(plane.xyz, p) + plane.w >= 0
+		vec4<T> m_planes[PLANE_COUNT];
+	};
+
+	namespace support
+	{
+		template <typename T>
+		size_t frustum_cull_spheres(const vec4<T>(&planes)[6], const sphere_soa<T>& s, const size_t& begin, const size_t& end, uint32_t* out)
+		{
+			T p[6][4];
+
+			for (int i = 0; i < 6; ++i)
+				for (int j = 0; j < 4; ++j)
+					p[i][j] = planes[i].m_data[j];
+
+			size_t n = 0;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				T neg_radius = -s.radius[i];
+				bool visible = true;
+
+				for (int j = 0; j < 6; ++j)
+					visible &= p[j][0] * s.x[i] + p[j][1] * s.y[i] + p[j][2] * s.z[i] + p[j][3] >= neg_radius;
+
+				out[n] = static_cast<uint32_t>(i);
+				n += visible;
+			}
+
+			return n;
+		}
+
+		template <typename T>
+		size_t frustum_cull_aabbs(const vec4<T>(&planes)[6], const aabb_soa<T>& b, const size_t& begin, const size_t& end, uint32_t* out)
+		{
+			// per plane, the corner furthest along the normal is fixed, so pick its source arrays once
+			T p[6][4];
+			const T* corner[6][3];
+
+			for (int i = 0; i < 6; ++i)
+			{
+				for (int j = 0; j < 4; ++j)
+					p[i][j] = planes[i].m_data[j];
+
+				corner[i][0] = p[i][0] >= 0 ? b.max_x : b.min_x;
+				corner[i][1] = p[i][1] >= 0 ? b.max_y : b.min_y;
+				corner[i][2] = p[i][2] >= 0 ? b.max_z : b.min_z;
+			}
+
+			size_t n = 0;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				bool visible = true;
+
+				for (int j = 0; j < 6; ++j)
+					visible &= p[j][0] * corner[j][0][i] + p[j][1] * corner[j][1][i] + p[j][2] * corner[j][2][i] + p[j][3] >= 0;
+
+				out[n] = static_cast<uint32_t>(i);
+				n += visible;
+			}
+
+			return n;
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		inline size_t frustum_cull_spheres(const vec4<float>(&planes)[6], const sphere_soa<float>& s, const size_t& begin, const size_t& end, uint32_t* out)
+		{
+			__m256 p[6][4];
+
+			for (int i = 0; i < 6; ++i)
+				for (int j = 0; j < 4; ++j)
+					p[i][j] = _mm256_set1_ps(planes[i].m_data[j]);
+
+			const __m256 sign = _mm256_set1_ps(-0.0f);
+
+			size_t n = 0;
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 x = _mm256_loadu_ps(s.x + i);
+				__m256 y = _mm256_loadu_ps(s.y + i);
+				__m256 z = _mm256_loadu_ps(s.z + i);
+				__m256 neg_radius = _mm256_xor_ps(_mm256_loadu_ps(s.radius + i), sign);
+				__m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+				for (int j = 0; j < 6; ++j)
+				{
+					__m256 d = mm256_fmadd(p[j][0], x, mm256_fmadd(p[j][1], y, mm256_fmadd(p[j][2], z, p[j][3])));
+					visible = _mm256_and_ps(visible, _mm256_cmp_ps(d, neg_radius, _CMP_GE_OQ));
+				}
+
+				n += mm256_store_compressed_indices(out + n, static_cast<uint32_t>(i), _mm256_movemask_ps(visible));
+			}
+
+			return n + frustum_cull_spheres<float>(planes, s, i, end, out + n);
+		}
+
+		inline size_t frustum_cull_aabbs(const vec4<float>(&planes)[6], const aabb_soa<float>& b, const size_t& begin, const size_t& end, uint32_t* out)
+		{
+			__m256 p[6][4];
+			bool positive[6][3];
+
+			for (int i = 0; i < 6; ++i)
+			{
+				for (int j = 0; j < 4; ++j)
+					p[i][j] = _mm256_set1_ps(planes[i].m_data[j]);
+
+				for (int j = 0; j < 3; ++j)
+					positive[i][j] = planes[i].m_data[j] >= 0.0f;
+			}
+
+			const __m256 zero = _mm256_setzero_ps();
+
+			size_t n = 0;
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 lo[3] = { _mm256_loadu_ps(b.min_x + i), _mm256_loadu_ps(b.min_y + i), _mm256_loadu_ps(b.min_z + i) };
+				__m256 hi[3] = { _mm256_loadu_ps(b.max_x + i), _mm256_loadu_ps(b.max_y + i), _mm256_loadu_ps(b.max_z + i) };
+				__m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+				for (int j = 0; j < 6; ++j)
+				{
+					__m256 x = positive[j][0] ? hi[0] : lo[0];
+					__m256 y = positive[j][1] ? hi[1] : lo[1];
+					__m256 z = positive[j][2] ? hi[2] : lo[2];
+					__m256 d = mm256_fmadd(p[j][0], x, mm256_fmadd(p[j][1], y, mm256_fmadd(p[j][2], z, p[j][3])));
+					visible = _mm256_and_ps(visible, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+				}
+
+				n += mm256_store_compressed_indices(out + n, static_cast<uint32_t>(i), _mm256_movemask_ps(visible));
+			}
+
+			return n + frustum_cull_aabbs<float>(planes, b, i, end, out + n);
+		}
+#endif
+
+		// Runs 'kernel' over [0, count), in parallel chunks if requested, and packs the per-chunk results to the front of 'out'.
+		template <typename K>
+		size_t frustum_cull_chunked(const size_t& count, uint32_t* out, const bool& parallel, K&& kernel)
+		{
+			assert(count <= std::numeric_limits<uint32_t>::max());
+
+			if (!parallel)
+				return kernel(size_t(0), count, out);
+
+			const size_t grain = 1 << 16;
+
+			std::vector<size_t> begins(parallel_chunks(count, grain));
+			std::vector<size_t> counts(begins.size());
+
+			parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end)
+			{
+				begins[chunk] = begin;
+				counts[chunk] = kernel(begin, end, out + begin);
+			});
+
+			size_t n = counts[0];
+
+			for (size_t chunk = 1; chunk < counts.size(); ++chunk)
+			{
+				std::memmove(out + n, out + begins[chunk], counts[chunk] * sizeof(uint32_t));
+				n += counts[chunk];
+			}
+
+			return n;
+		}
+	}
+
+	// credit Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+	template <typename T>
+	frustum<T>::frustum(const support::matrix<4, 4, T>& m, const bool& zero_to_one)
+	{
+		vec4<T> row[4];
+
+		for (int i = 0; i < 4; ++i)
+			row[i] = m.row(i);
+
+		m_planes[PLANE_LEFT] = row[3] + row[0];
+		m_planes[PLANE_RIGHT] = row[3] - row[0];
+		m_planes[PLANE_BOTTOM] = row[3] + row[1];
+		m_planes[PLANE_TOP] = row[3] - row[1];
+		m_planes[PLANE_NEAR] = zero_to_one ? row[2] : vec4<T>(row[3] + row[2]);
+		m_planes[PLANE_FAR] = row[3] - row[2];
+
+		for (int i = 0; i < PLANE_COUNT; ++i)
+		{
+			vec4<T>& p = m_planes[i];
+			T len = sqrt(p.x() * p.x() + p.y() * p.y() + p.z() * p.z());
+
+			if (len > static_cast<T>(0))
+				p *= static_cast<T>(1) / len;
+		}
+	}
+
+	template <typename T>
+	inline const vec4<T>& frustum<T>::plane(const size_t& index) const
+	{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+		assert(index < PLANE_COUNT);
+#endif
+		return m_planes[index];
+	}
+
+	template <typename T>
+	const bool frustum<T>::contains(const vec3<T>& p) const
+	{
+		return intersects(p, static_cast<T>(0));
+	}
+
+	template <typename T>
+	const bool frustum<T>::intersects(const vec3<T>& center, const T& radius) const
+	{
+		for (int i = 0; i < PLANE_COUNT; ++i)
+		{
+			const vec4<T>& p = m_planes[i];
+
+			if (p.x() * center.x() + p.y() * center.y() + p.z() * center.z() + p.w() < -radius)
+				return false;
+		}
+
+		return true;
+	}
+
+	template <typename T>
+	const bool frustum<T>::intersects(const aabb<T>& box) const
+	{
+		for (int i = 0; i < PLANE_COUNT; ++i)
+		{
+			const vec4<T>& p = m_planes[i];
+
+			T x = p.x() >= 0 ? box.max.x() : box.min.x();
+			T y = p.y() >= 0 ? box.max.y() : box.min.y();
+			T z = p.z() >= 0 ? box.max.z() : box.min.z();
+
+			if (p.x() * x + p.y() * y + p.z() * z + p.w() < 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	template <typename T>
+	size_t frustum<T>::cull(const sphere_soa<T>& spheres, uint32_t* visible, const bool& parallel) const
+	{
+		return support::frustum_cull_chunked(spheres.count, visible, parallel, [&](size_t begin, size_t end, uint32_t* out)
+		{
+			return support::frustum_cull_spheres(m_planes, spheres, begin, end, out);
+		});
+	}
+
+	template <typename T>
+	size_t frustum<T>::cull(const aabb_soa<T>& boxes, uint32_t* visible, const bool& parallel) const
+	{
+		return support::frustum_cull_chunked(boxes.count, visible, parallel, [&](size_t begin, size_t end, uint32_t* out)
+		{
+			return support::frustum_cull_aabbs(m_planes, boxes, begin, end, out);
+		});
+	}
+
+	template <typename T>
+	const frustum<T> frustum<T>::from_matrix(const support::matrix<4, 4, T>& view_projection, const bool& zero_to_one)
+	{
+		return frustum<T>(view_projection, zero_to_one);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef frustum<float> frustumf;
+	typedef frustum<double> frustumd;
+#endif
+}
+
+#endif
@@ -0,0 +1,1176 @@
+#ifndef _RM_GJK_H
+#define _RM_GJK_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vec3.h"
+#include "mat3.h"
+#include "aabb.h"
+#include "obb.h"
+#include "align.h"
+#include "span.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Convex shapes for the GJK and EPA queries. A shape is anything with a support_point(shape, direction) overload returning its
+	// furthest point along direction, and a shape_margin(shape) overload. Spheres and capsules are a point and a segment inflated
+	// by their radius: GJK runs on the core and the radius is added afterwards, so round shapes are exact and shallow contacts
+	// between them need no EPA.
+	template <typename T>
+	struct sphere
+	{
+		sphere() : center(static_cast<T>(0)), radius(0) {}
+		sphere(const vec3<T>& center, const T& radius) : center(center), radius(radius) {}
+
+		vec3<T> center;
+		T radius;
+	};
+
+	template <typename T>
+	struct capsule
+	{
+		capsule() : a(static_cast<T>(0)), b(static_cast<T>(0)), radius(0) {}
+		capsule(const vec3<T>& a, const vec3<T>& b, const T& radius) : a(a), b(b), radius(radius) {}
+
+		// end points of the core segment
+		vec3<T> a;
+		vec3<T> b;
+		T radius;
+	};
+
+	// Convex hull of a point set. The points are kept as padded x, y and z arrays so the support search tests 8 (AVX2) or
+	// 4 (SSE2) points per step. Points inside the hull are allowed, they only cost search time. A hull needs at least one
+	// point, and the search carries indices in T lanes, so fewer than 2^24 points for float.
+	template <typename T>
+	class convex_hull
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// constructors
+		convex_hull() : m_size(0), m_padded(0) {}
+		convex_hull(const vec3<T>* points, const size_t& count);
+		explicit convex_hull(const vec_span<3, const T>& points);
+
+		// Modifiers
+		void assign(const vec3<T>* points, const size_t& count);
+		void assign(const vec_span<3, const T>& points);
+
+		// Accessors
+		inline const size_t size() const;
+		const vec3<T> point(const size_t& index) const;
+
+		// Utility functions
+		const size_t support_index(const vec3<T>& direction) const;
+		const vec3<T> support(const vec3<T>& direction) const;
+
+	private:
+		static const size_t PADDING = 8;
+
+		// x block, y block and z block of m_padded values each, padded with copies of the first point
+		std::vector<T> m_points;
+		size_t m_size;
+		size_t m_padded;
+	};
+
+	// A shape placed by a rigid transform. The shape is referenced, so many instances can share one hull.
+	template <typename S, typename T>
+	struct transformed_shape
+	{
+		transformed_shape() : shape(nullptr), basis(), translation(static_cast<T>(0)), scale(1) {}
+		transformed_shape(const S& shape, const rigid_transform<T>& transform) : shape(&shape), basis(transform.rotation.toMat3()),
+			translation(transform.translation), scale(transform.scale) {}
+
+		const S* shape;
+		mat3<T> basis;
+		vec3<T> translation;
+		T scale;
+	};
+
+	// The simplex a query ended with, kept as the search directions of its vertices. Passing the same cache to the next query on a
+	// pair rebuilds the simplex on the moved shapes, so small motions converge in one or two iterations.
+	template <typename T>
+	struct gjk_cache
+	{
+		gjk_cache() : count(0) {}
+
+		vec3<T> directions[4];
+		int count;
+	};
+
+	template <typename T>
+	struct gjk_result
+	{
+		// distance is 0 and the points are not meaningful when the shapes intersect
+		bool intersecting;
+		T distance;
+
+		// closest points on a and b
+		vec3<T> point_a;
+		vec3<T> point_b;
+
+		int iterations;
+	};
+
+	template <typename T>
+	struct contact
+	{
+		bool intersecting;
+
+		// distance between the shapes when apart, minus the penetration depth when intersecting
+		T separation;
+
+		// unit normal from a towards b, moving b by -separation * normal makes the shapes touch
+		vec3<T> normal;
+
+		// closest points when apart, deepest points when intersecting
+		vec3<T> point_a;
+		vec3<T> point_b;
+	};
+
+	// Support functions of the provided shapes
+	template <typename T>
+	inline const vec3<T> support_point(const sphere<T>& s, const vec3<T>& direction);
+
+	template <typename T>
+	inline const vec3<T> support_point(const capsule<T>& c, const vec3<T>& direction);
+
+	template <typename T>
+	inline const vec3<T> support_point(const aabb<T>& b, const vec3<T>& direction);
+
+	template <typename T>
+	inline const vec3<T> support_point(const obb<T>& b, const vec3<T>& direction);
+
+	template <typename T>
+	inline const vec3<T> support_point(const convex_hull<T>& h, const vec3<T>& direction);
+
+	template <typename S, typename T>
+	inline const vec3<T> support_point(const transformed_shape<S, T>& s, const vec3<T>& direction);
+
+	template <typename T>
+	inline const T shape_margin(const sphere<T>& s);
+
+	template <typename T>
+	inline const T shape_margin(const capsule<T>& c);
+
+	template <typename T>
+	inline const T shape_margin(const aabb<T>& b);
+
+	template <typename T>
+	inline const T shape_margin(const obb<T>& b);
+
+	template <typename T>
+	inline const T shape_margin(const convex_hull<T>& h);
+
+	template <typename S, typename T>
+	inline const T shape_margin(const transformed_shape<S, T>& s);
+
+	// Scalar type of a shape
+	template <typename S>
+	using shape_scalar = typename std::decay<decltype(shape_margin(std::declval<S>()))>::type;
+
+	// Boolean overlap test, stops as soon as a separating axis is found
+	template <typename A, typename B, typename T = shape_scalar<A>>
+	const bool gjk_intersect(const A& a, const B& b, gjk_cache<T>* cache = nullptr);
+
+	// Distance and closest points of separated shapes
+	template <typename A, typename B, typename T = shape_scalar<A>>
+	const gjk_result<T> gjk_distance(const A& a, const B& b, gjk_cache<T>* cache = nullptr);
+
+	// GJK, followed by EPA on the cores when they overlap, for the penetration depth and normal
+	template <typename A, typename B, typename T = shape_scalar<A>>
+	const contact<T> collide(const A& a, const B& b, gjk_cache<T>* cache = nullptr);
+
+	// Batch version, pair i is a[pairs[2 * i]] against b[pairs[2 * i + 1]]. caches, when given, has one entry per pair.
+	template <typename A, typename B, typename T>
+	void collide(const A* a, const B* b, const uint32_t* pairs, const size_t& count, contact<T>* out, gjk_cache<T>* caches = nullptr, const bool& parallel = false);
+
+	namespace support
+	{
+		// Index of the largest x * dx + y * dy + z * dz, count a multiple of the lane width. The lanes track indices as T,
+		// exact below 2^24 points for float.
+		template <typename L, typename T>
+		inline size_t hull_support_search(const T* x, const T* y, const T* z, const size_t& count, const T(&d)[3])
+		{
+			const size_t W = lane_traits<L>::WIDTH;
+
+			T first[W];
+
+			for (size_t k = 0; k < W; ++k)
+				first[k] = static_cast<T>(k);
+
+			const L dx(d[0]), dy(d[1]), dz(d[2]), step(static_cast<T>(W));
+			L best(std::numeric_limits<T>::lowest()), best_index(static_cast<T>(0)), index;
+
+			lane_load(index, first);
+
+			for (size_t i = 0; i < count; i += W)
+			{
+				L px, py, pz;
+
+				lane_load(px, x + i);
+				lane_load(py, y + i);
+				lane_load(pz, z + i);
+
+				L dot = px * dx + py * dy + pz * dz;
+				auto greater = dot > best;
+
+				best = lane_select(greater, dot, best);
+				best_index = lane_select(greater, index, best_index);
+				index += step;
+			}
+
+			T values[W], indices[W];
+
+			lane_store(values, best);
+			lane_store(indices, best_index);
+
+			// ties go to the lower index, so the padding never wins over the point it copies
+			size_t k = 0;
+
+			for (size_t j = 1; j < W; ++j)
+				if (values[j] > values[k] || (values[j] == values[k] && indices[j] < indices[k]))
+					k = j;
+
+			return static_cast<size_t>(indices[k]);
+		}
+
+		template <typename T>
+		inline size_t hull_support(const T* x, const T* y, const T* z, const size_t& count, const T(&d)[3])
+		{
+			return hull_support_search<T>(x, y, z, count, d);
+		}
+
+#ifdef _REACT_SIMD_SSE2
+		inline size_t hull_support(const float* x, const float* y, const float* z, const size_t& count, const float(&d)[3])
+		{
+#ifdef _REACT_SIMD_AVX2
+			return hull_support_search<float8>(x, y, z, count, d);
+#else
+			return hull_support_search<float4>(x, y, z, count, d);
+#endif
+		}
+#endif
+
+		// A point of the Minkowski difference of the cores, w = a - b, with the support points it came from and the direction
+		// that produced it
+		template <typename T>
+		struct minkowski_vertex
+		{
+			vec3<T> w;
+			vec3<T> a;
+			vec3<T> b;
+			vec3<T> d;
+		};
+
+		template <typename T, typename A, typename B>
+		inline void minkowski_support(const A& a, const B& b, const vec3<T>& d, minkowski_vertex<T>& out)
+		{
+			out.d = d;
+			out.a = support_point(a, d);
+			out.b = support_point(b, vec3<T>(static_cast<T>(0) - d));
+			out.w = out.a - out.b;
+		}
+
+		// Vertices of a simplex with the barycentric weights of its point closest to the origin
+		template <typename T>
+		struct gjk_feature
+		{
+			int count;
+			int index[4];
+			T lambda[4];
+
+			inline void set(const int& i0)
+			{
+				count = 1;
+				index[0] = i0;
+				lambda[0] = 1;
+			}
+
+			inline void set(const int& i0, const int& i1, const T& l1)
+			{
+				count = 2;
+				index[0] = i0;
+				index[1] = i1;
+				lambda[0] = 1 - l1;
+				lambda[1] = l1;
+			}
+
+			inline void set(const int& i0, const int& i1, const int& i2, const T& l0, const T& l1, const T& l2)
+			{
+				count = 3;
+				index[0] = i0;
+				index[1] = i1;
+				index[2] = i2;
+				lambda[0] = l0;
+				lambda[1] = l1;
+				lambda[2] = l2;
+			}
+
+			const vec3<T> closest(const minkowski_vertex<T>* v) const
+			{
+				vec3<T> p(static_cast<T>(0));
+
+				for (int i = 0; i < count; ++i)
+					p += v[index[i]].w * lambda[i];
+
+				return p;
+			}
+
+			void witnesses(const minkowski_vertex<T>* v, vec3<T>& a, vec3<T>& b) const
+			{
+				a = vec3<T>(static_cast<T>(0));
+				b = vec3<T>(static_cast<T>(0));
+
+				for (int i = 0; i < count; ++i)
+				{
+					a += v[index[i]].a * lambda[i];
+					b += v[index[i]].b * lambda[i];
+				}
+			}
+		};
+
+		// One spare slot past the active vertices takes the candidate vertex
+		template <typename T>
+		struct gjk_simplex
+		{
+			gjk_simplex() : count(0) {}
+
+			minkowski_vertex<T> v[5];
+			gjk_feature<T> feature;
+			int count;
+
+			// keeps the vertices of the feature, in its order
+			void reduce(const gjk_feature<T>& f)
+			{
+				minkowski_vertex<T> kept[4];
+
+				for (int i = 0; i < f.count; ++i)
+					kept[i] = v[f.index[i]];
+
+				for (int i = 0; i < f.count; ++i)
+				{
+					v[i] = kept[i];
+					feature.index[i] = i;
+					feature.lambda[i] = f.lambda[i];
+				}
+
+				count = feature.count = f.count;
+			}
+
+			inline const vec3<T> closest() const
+			{
+				return feature.closest(v);
+			}
+
+			inline void witnesses(vec3<T>& a, vec3<T>& b) const
+			{
+				feature.witnesses(v, a, b);
+			}
+		};
+
+		// Closest point to the origin on segment, triangle and tetrahedron, as the feature it lies on.
+		// credit Ericson, Real-Time Collision Detection, 5.1
+		template <typename T>
+		inline void gjk_closest_segment(const minkowski_vertex<T>* v, const int& ia, const int& ib, gjk_feature<T>& f)
+		{
+			const vec3<T>& a = v[ia].w;
+			vec3<T> ab = v[ib].w - a;
+
+			T t = -a.dot(ab);
+			T denom = ab.dot(ab);
+
+			if (t <= 0)
+				f.set(ia);
+			else if (t >= denom)
+				f.set(ib);
+			else
+				f.set(ia, ib, t / denom);
+		}
+
+		template <typename T>
+		inline void gjk_closest_triangle(const minkowski_vertex<T>* v, const int& ia, const int& ib, const int& ic, gjk_feature<T>& f)
+		{
+			const vec3<T>& a = v[ia].w;
+			const vec3<T>& b = v[ib].w;
+			const vec3<T>& c = v[ic].w;
+
+			vec3<T> ab = b - a;
+			vec3<T> ac = c - a;
+
+			T d1 = -ab.dot(a);
+			T d2 = -ac.dot(a);
+
+			if (d1 <= 0 && d2 <= 0)
+				return f.set(ia);
+
+			T d3 = -ab.dot(b);
+			T d4 = -ac.dot(b);
+
+			if (d3 >= 0 && d4 <= d3)
+				return f.set(ib);
+
+			T vc = d1 * d4 - d3 * d2;
+
+			if (vc <= 0 && d1 >= 0 && d3 <= 0)
+				return f.set(ia, ib, d1 / (d1 - d3));
+
+			T d5 = -ab.dot(c);
+			T d6 = -ac.dot(c);
+
+			if (d6 >= 0 && d5 <= d6)
+				return f.set(ic);
+
+			T vb = d5 * d2 - d1 * d6;
+
+			if (vb <= 0 && d2 >= 0 && d6 <= 0)
+				return f.set(ia, ic, d2 / (d2 - d6));
+
+			T va = d3 * d6 - d5 * d4;
+
+			if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+				return f.set(ib, ic, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+			T denom = va + vb + vc;
+
+			// degenerate triangles fall back to their best edge
+			if (!(denom > 0))
+			{
+				gjk_feature<T> e0, e1;
+
+				gjk_closest_segment(v, ia, ib, e0);
+				gjk_closest_segment(v, ia, ic, e1);
+				gjk_closest_segment(v, ib, ic, f);
+
+				if (e0.closest(v).length_squared() < f.closest(v).length_squared())
+					f = e0;
+
+				if (e1.closest(v).length_squared() < f.closest(v).length_squared())
+					f = e1;
+
+				return;
+			}
+
+			f.set(ia, ib, ic, va / denom, vb / denom, vc / denom);
+		}
+
+		// Returns true when the origin is inside the tetrahedron v[0] .. v[3]
+		template <typename T>
+		inline bool gjk_closest_tetrahedron(const minkowski_vertex<T>* v, gjk_feature<T>& f)
+		{
+			static const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+
+			const vec3<T>& a = v[0].w;
+
+			T volume = (v[1].w - a).dot(vec3<T>::cross(v[2].w - a, v[3].w - a));
+			T scale = std::max((v[1].w - a).length_squared(), std::max((v[2].w - a).length_squared(), (v[3].w - a).length_squared()));
+
+			// a flat tetrahedron can not enclose anything, every face is treated as facing the origin
+			bool flat = std::abs(volume) <= std::numeric_limits<T>::epsilon() * 16 * scale * std::sqrt(scale);
+
+			T best_distance = std::numeric_limits<T>::max();
+			bool outside = false;
+
+			for (const auto& face : faces)
+			{
+				const vec3<T>& p = v[face[0]].w;
+				vec3<T> n = vec3<T>::cross(v[face[1]].w - p, v[face[2]].w - p);
+
+				T side_origin = -n.dot(p);
+				T side_opposite = n.dot(v[face[3]].w - p);
+
+				if (!flat && side_origin * side_opposite >= 0)
+					continue;
+
+				outside = true;
+
+				gjk_feature<T> t;
+				gjk_closest_triangle(v, face[0], face[1], face[2], t);
+
+				T distance = t.closest(v).length_squared();
+
+				if (distance < best_distance)
+				{
+					best_distance = distance;
+					f = t;
+				}
+			}
+
+			if (!outside)
+			{
+				f.count = 4;
+
+				for (int i = 0; i < 4; ++i)
+				{
+					f.index[i] = i;
+					f.lambda[i] = static_cast<T>(0.25);
+				}
+
+				return true;
+			}
+
+			return false;
+		}
+
+		// Returns true when the simplex v[0] .. v[count - 1] encloses the origin
+		template <typename T>
+		inline bool gjk_closest(const minkowski_vertex<T>* v, const int& count, gjk_feature<T>& f)
+		{
+			switch (count)
+			{
+			case 1:
+				f.set(0);
+				return false;
+			case 2:
+				gjk_closest_segment(v, 0, 1, f);
+				return false;
+			case 3:
+				gjk_closest_triangle(v, 0, 1, 2, f);
+				return false;
+			default:
+				return gjk_closest_tetrahedron(v, f);
+			}
+		}
+
+		template <typename T>
+		inline bool gjk_contains(const gjk_simplex<T>& s, const vec3<T>& w, const T& tolerance)
+		{
+			for (int i = 0; i < s.count; ++i)
+				if ((s.v[i].w - w).length_squared() <= tolerance)
+					return true;
+
+			return false;
+		}
+
+		static const int GJK_MAX_ITERATIONS = 64;
+
+		// van den Bergen's GJK distance loop on the cores of a and b. Returns true when the cores are closer than 'margin',
+		// which is 0 for touching. With early_out the loop stops as soon as an axis separates the cores by more than the margin,
+		// otherwise it runs to convergence and s holds the closest feature.
+		// credit van den Bergen, Collision Detection in Interactive 3D Environments, 4.3
+		template <typename T, typename A, typename B>
+		bool gjk(const A& a, const B& b, const T& margin, const bool& early_out, gjk_cache<T>* cache, gjk_simplex<T>& s, vec3<T>& v, int& iterations)
+		{
+			const T eps = std::numeric_limits<T>::epsilon();
+			const T relative = eps * 64;
+
+			iterations = 0;
+			s.count = 0;
+
+			bool enclosed = false;
+
+			gjk_feature<T> f;
+
+			if (cache && cache->count > 0)
+			{
+				for (int i = 0; i < cache->count; ++i)
+				{
+					minkowski_support(a, b, cache->directions[i], s.v[s.count]);
+
+					if (!gjk_contains(s, s.v[s.count].w, eps * std::max(static_cast<T>(1), s.v[s.count].w.length_squared())))
+						++s.count;
+				}
+
+				enclosed = gjk_closest(s.v, s.count, f);
+			}
+			else
+			{
+				minkowski_support(a, b, vec3<T>(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0)), s.v[0]);
+				s.count = 1;
+				f.set(0);
+			}
+
+			s.reduce(f);
+			v = s.closest();
+
+			bool intersecting = enclosed;
+			T max_w = 0;
+
+			for (int i = 0; i < s.count; ++i)
+				max_w = std::max(max_w, s.v[i].w.length_squared());
+
+			while (!intersecting && iterations < GJK_MAX_ITERATIONS)
+			{
+				++iterations;
+
+				T vv = v.dot(v);
+
+				if (vv <= relative * std::max(max_w, static_cast<T>(1)) * eps)
+				{
+					intersecting = true;
+					break;
+				}
+
+				// the candidate goes to the spare slot, the simplex only changes once it is known to make progress
+				minkowski_vertex<T>& p = s.v[s.count];
+				minkowski_support(a, b, vec3<T>(static_cast<T>(0) - v), p);
+
+				T vw = v.dot(p.w);
+
+				// v.w / |v| is a lower bound of the core distance
+				if (early_out && vw > 0 && vw * vw > vv * margin * margin)
+					break;
+
+				if (vv - vw <= relative * vv || gjk_contains(s, p.w, eps * std::max(max_w, static_cast<T>(1))))
+					break;
+
+				max_w = std::max(max_w, p.w.length_squared());
+
+				if (gjk_closest(s.v, s.count + 1, f))
+				{
+					s.reduce(f);
+					intersecting = true;
+					break;
+				}
+
+				vec3<T> next = f.closest(s.v);
+
+				// no progress, rounding has taken over
+				if (next.dot(next) >= vv)
+					break;
+
+				s.reduce(f);
+				v = next;
+			}
+
+			if (!intersecting)
+			{
+				T distance = v.length();
+
+				intersecting = distance <= margin;
+			}
+
+			if (cache)
+			{
+				cache->count = s.count;
+
+				for (int i = 0; i < s.count; ++i)
+					cache->directions[i] = s.v[i].d;
+			}
+
+			return intersecting;
+		}
+
+		// The Minkowski difference of the cores is found to contain the origin: expanding polytope search for the face closest to
+		// the origin. Returns the depth of the cores, with normal pointing from a to b and the deepest points on the cores.
+		// credit van den Bergen, Proximity Queries and Penetration Depth Computation on 3D Game Objects, GDC 2001
+		template <typename T>
+		struct epa_face
+		{
+			int v[3];
+			vec3<T> n;
+			T distance;
+			bool removed;
+		};
+
+		static const int EPA_MAX_VERTICES = 64;
+		static const int EPA_MAX_FACES = 2 * EPA_MAX_VERTICES;
+		static const int EPA_MAX_ITERATIONS = EPA_MAX_VERTICES - 4;
+
+		template <typename T>
+		inline void epa_make_face(const minkowski_vertex<T>* vertices, epa_face<T>& f, const int& a, const int& b, const int& c)
+		{
+			f.v[0] = a;
+			f.v[1] = b;
+			f.v[2] = c;
+			f.removed = false;
+
+			vec3<T> n = vec3<T>::cross(vertices[b].w - vertices[a].w, vertices[c].w - vertices[a].w);
+			T length = n.length();
+
+			if (length > 0)
+			{
+				f.n = n / length;
+				f.distance = f.n.dot(vertices[a].w);
+			}
+			else
+			{
+				f.n = vec3<T>(static_cast<T>(0));
+				f.distance = std::numeric_limits<T>::max();
+			}
+		}
+
+		// Any unit vector perpendicular to v
+		template <typename T>
+		inline const vec3<T> epa_perpendicular(const vec3<T>& v)
+		{
+			vec3<T> axis = std::abs(v.x()) < std::abs(v.y()) ? (std::abs(v.x()) < std::abs(v.z()) ? vec3<T>(1, 0, 0) : vec3<T>(0, 0, 1))
+				: (std::abs(v.y()) < std::abs(v.z()) ? vec3<T>(0, 1, 0) : vec3<T>(0, 0, 1));
+
+			return vec3<T>::cross(v, axis).normalized();
+		}
+
+		template <typename T, typename A, typename B>
+		T epa(const A& a, const B& b, const gjk_simplex<T>& simplex, vec3<T>& normal, vec3<T>& point_a, vec3<T>& point_b)
+		{
+			const T eps = std::numeric_limits<T>::epsilon();
+
+			minkowski_vertex<T> vertices[EPA_MAX_VERTICES];
+			int vertex_count = simplex.count;
+
+			for (int i = 0; i < simplex.count; ++i)
+				vertices[i] = simplex.v[i];
+
+			T scale = 0;
+
+			for (int i = 0; i < vertex_count; ++i)
+				scale = std::max(scale, vertices[i].w.length_squared());
+
+			const T tiny = eps * 64 * std::max(scale, static_cast<T>(1));
+
+			// The simplex is blown up to a tetrahedron that still holds the origin. When the difference is flat along some axis
+			// the cores only touch along it and the depth is 0.
+			auto fallback = [&](const vec3<T>& n)
+			{
+				normal = n;
+				point_a = vertices[0].a;
+				point_b = vertices[0].b;
+
+				return static_cast<T>(0);
+			};
+
+			if (vertex_count == 1)
+			{
+				static const T axes[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+				for (const auto& axis : axes)
+				{
+					minkowski_support(a, b, vec3<T>(axis[0], axis[1], axis[2]), vertices[1]);
+
+					if ((vertices[1].w - vertices[0].w).length_squared() > tiny)
+					{
+						vertex_count = 2;
+						break;
+					}
+				}
+
+				if (vertex_count == 1)
+					return fallback(vec3<T>(1, 0, 0));
+			}
+
+			if (vertex_count == 2)
+			{
+				vec3<T> e = vertices[1].w - vertices[0].w;
+				vec3<T> u = epa_perpendicular(e);
+				vec3<T> directions[4] = { u, static_cast<T>(0) - u, vec3<T>::cross(e.normalized(), u), static_cast<T>(0) - vec3<T>::cross(e.normalized(), u) };
+
+				for (const vec3<T>& d : directions)
+				{
+					minkowski_support(a, b, d, vertices[2]);
+
+					if (vec3<T>::cross(vertices[2].w - vertices[0].w, e).length_squared() > tiny * e.length_squared())
+					{
+						vertex_count = 3;
+						break;
+					}
+				}
+
+				if (vertex_count == 2)
+					return fallback(u);
+			}
+
+			if (vertex_count == 3)
+			{
+				vec3<T> n = vec3<T>::cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w).normalized();
+
+				minkowski_support(a, b, n, vertices[3]);
+
+				if (std::abs(n.dot(vertices[3].w - vertices[0].w)) <= std::sqrt(tiny))
+				{
+					minkowski_support(a, b, vec3<T>(static_cast<T>(0) - n), vertices[3]);
+
+					if (std::abs(n.dot(vertices[3].w - vertices[0].w)) <= std::sqrt(tiny))
+						return fallback(n.dot(vertices[0].w) < 0 ? vec3<T>(static_cast<T>(0) - n) : n);
+				}
+
+				vertex_count = 4;
+			}
+
+			// outward winding
+			if ((vertices[1].w - vertices[0].w).dot(vec3<T>::cross(vertices[2].w - vertices[0].w, vertices[3].w - vertices[0].w)) > 0)
+				std::swap(vertices[1], vertices[2]);
+
+			epa_face<T> faces[EPA_MAX_FACES];
+			int face_count = 4;
+
+			epa_make_face(vertices, faces[0], 0, 1, 2);
+			epa_make_face(vertices, faces[1], 0, 3, 1);
+			epa_make_face(vertices, faces[2], 0, 2, 3);
+			epa_make_face(vertices, faces[3], 1, 3, 2);
+
+			int closest = 0;
+
+			for (int iteration = 0; iteration < EPA_MAX_ITERATIONS; ++iteration)
+			{
+				closest = -1;
+
+				for (int i = 0; i < face_count; ++i)
+					if (!faces[i].removed && (closest < 0 || faces[i].distance < faces[closest].distance))
+						closest = i;
+
+				const epa_face<T>& f = faces[closest];
+
+				if (f.distance == std::numeric_limits<T>::max())
+					break;
+
+				minkowski_vertex<T> p;
+				minkowski_support(a, b, f.n, p);
+
+				T d = f.n.dot(p.w);
+
+				if (d - f.distance <= eps * 64 * std::max(static_cast<T>(1), d) || vertex_count == EPA_MAX_VERTICES)
+					break;
+
+				int index = vertex_count++;
+				vertices[index] = p;
+
+				// the faces p sees are removed, the edges they share with the faces it does not see form the horizon
+				int horizon[EPA_MAX_FACES * 3][2];
+				int edge_count = 0;
+
+				for (int i = 0; i < face_count; ++i)
+				{
+					epa_face<T>& g = faces[i];
+
+					if (g.removed || g.n.dot(p.w - vertices[g.v[0]].w) <= 0)
+						continue;
+
+					g.removed = true;
+
+					for (int e = 0; e < 3; ++e)
+					{
+						int from = g.v[e], to = g.v[(e + 1) % 3];
+						bool shared = false;
+
+						for (int k = 0; k < edge_count; ++k)
+						{
+							if (horizon[k][0] == to && horizon[k][1] == from)
+							{
+								horizon[k][0] = horizon[--edge_count][0];
+								horizon[k][1] = horizon[edge_count][1];
+								shared = true;
+								break;
+							}
+						}
+
+						if (!shared)
+						{
+							horizon[edge_count][0] = from;
+							horizon[edge_count][1] = to;
+							++edge_count;
+						}
+					}
+				}
+
+				// compact before adding, the removed faces are reused
+				int kept = 0;
+
+				for (int i = 0; i < face_count; ++i)
+					if (!faces[i].removed)
+						faces[kept++] = faces[i];
+
+				face_count = kept;
+
+				if (face_count + edge_count > EPA_MAX_FACES)
+					break;
+
+				for (int k = 0; k < edge_count; ++k)
+					epa_make_face(vertices, faces[face_count++], horizon[k][0], horizon[k][1], index);
+			}
+
+			// faces were compacted and appended since closest was picked when the loop ran out of iterations or face space
+			closest = 0;
+
+			for (int i = 1; i < face_count; ++i)
+				if (faces[i].distance < faces[closest].distance)
+					closest = i;
+
+			const epa_face<T>& f = faces[closest];
+
+			// barycentric weights of the origin projected on the face give the deepest points
+			gjk_feature<T> feature;
+
+			gjk_closest_triangle(vertices, f.v[0], f.v[1], f.v[2], feature);
+			feature.witnesses(vertices, point_a, point_b);
+
+			normal = f.n;
+
+			return std::max(f.distance, static_cast<T>(0));
+		}
+	}
+
+	template <typename T>
+	convex_hull<T>::convex_hull(const vec3<T>* points, const size_t& count) : m_size(0), m_padded(0)
+	{
+		assign(points, count);
+	}
+
+	template <typename T>
+	convex_hull<T>::convex_hull(const vec_span<3, const T>& points) : m_size(0), m_padded(0)
+	{
+		assign(points);
+	}
+
+	template <typename T>
+	void convex_hull<T>::assign(const vec3<T>* points, const size_t& count)
+	{
+		assign(vec_span<3, const T>(points, count));
+	}
+
+	template <typename T>
+	void convex_hull<T>::assign(const vec_span<3, const T>& points)
+	{
+		const size_t count = points.size();
+
+		m_size = count;
+		m_padded = (count + PADDING - 1) / PADDING * PADDING;
+
+		assert(count > 0);
+		assert(m_padded <= size_t(1) << std::numeric_limits<T>::digits);
+		m_points.assign(m_padded * 3, static_cast<T>(0));
+
+		for (size_t i = 0; i < m_padded; ++i)
+		{
+			const vec3<T>& p = points[i < count ? i : 0];
+
+			for (int k = 0; k < 3; ++k)
+				m_points[k * m_padded + i] = p.m_data[k];
+		}
+	}
+
+	template <typename T>
+	inline const size_t convex_hull<T>::size() const
+	{
+		return m_size;
+	}
+
+	template <typename T>
+	const vec3<T> convex_hull<T>::point(const size_t& index) const
+	{
+		return vec3<T>(m_points[index], m_points[m_padded + index], m_points[2 * m_padded + index]);
+	}
+
+	template <typename T>
+	const size_t convex_hull<T>::support_index(const vec3<T>& direction) const
+	{
+		assert(m_size > 0);
+
+		const T d[3] = { direction.m_data[0], direction.m_data[1], direction.m_data[2] };
+		const T* x = m_points.data();
+
+		return support::hull_support(x, x + m_padded, x + 2 * m_padded, m_padded, d);
+	}
+
+	template <typename T>
+	const vec3<T> convex_hull<T>::support(const vec3<T>& direction) const
+	{
+		return point(support_index(direction));
+	}
+
+	template <typename T>
+	inline const vec3<T> support_point(const sphere<T>& s, const vec3<T>&)
+	{
+		return s.center;
+	}
+
+	template <typename T>
+	inline const vec3<T> support_point(const capsule<T>& c, const vec3<T>& direction)
+	{
+		return (c.b - c.a).dot(direction) > 0 ? c.b : c.a;
+	}
+
+	template <typename T>
+	inline const vec3<T> support_point(const aabb<T>& b, const vec3<T>& direction)
+	{
+		return vec3<T>(direction.x() > 0 ? b.max.x() : b.min.x(), direction.y() > 0 ? b.max.y() : b.min.y(), direction.z() > 0 ? b.max.z() : b.min.z());
+	}
+
+	template <typename T>
+	inline const vec3<T> support_point(const obb<T>& b, const vec3<T>& direction)
+	{
+		vec3<T> tmp = b.center;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			vec3<T> axis = b.axis(k);
+
+			tmp += axis * (axis.dot(direction) > 0 ? b.extents.m_data[k] : -b.extents.m_data[k]);
+		}
+
+		return tmp;
+	}
+
+	template <typename T>
+	inline const vec3<T> support_point(const convex_hull<T>& h, const vec3<T>& direction)
+	{
+		return h.support(direction);
+	}
+
+	template <typename S, typename T>
+	inline const vec3<T> support_point(const transformed_shape<S, T>& s, const vec3<T>& direction)
+	{
+		// the direction goes to shape space through the transposed basis, the point comes back through the basis
+		const mat3<T>& m = s.basis;
+		vec3<T> local;
+
+		for (int k = 0; k < 3; ++k)
+			local.m_data[k] = m.at(0, k) * direction.m_data[0] + m.at(1, k) * direction.m_data[1] + m.at(2, k) * direction.m_data[2];
+
+		vec3<T> p = support_point(*s.shape, local);
+		vec3<T> tmp = s.translation;
+
+		for (int k = 0; k < 3; ++k)
+			tmp.m_data[k] += (m.at(k, 0) * p.m_data[0] + m.at(k, 1) * p.m_data[1] + m.at(k, 2) * p.m_data[2]) * s.scale;
+
+		return tmp;
+	}
+
+	template <typename T>
+	inline const T shape_margin(const sphere<T>& s)
+	{
+		return s.radius;
+	}
+
+	template <typename T>
+	inline const T shape_margin(const capsule<T>& c)
+	{
+		return c.radius;
+	}
+
+	template <typename T>
+	inline const T shape_margin(const aabb<T>&)
+	{
+		return static_cast<T>(0);
+	}
+
+	template <typename T>
+	inline const T shape_margin(const obb<T>&)
+	{
+		return static_cast<T>(0);
+	}
+
+	template <typename T>
+	inline const T shape_margin(const convex_hull<T>&)
+	{
+		return static_cast<T>(0);
+	}
+
+	template <typename S, typename T>
+	inline const T shape_margin(const transformed_shape<S, T>& s)
+	{
+		return shape_margin(*s.shape) * s.scale;
+	}
+
+	template <typename A, typename B, typename T>
+	const bool gjk_intersect(const A& a, const B& b, gjk_cache<T>* cache)
+	{
+		support::gjk_simplex<T> s;
+		vec3<T> v;
+		int iterations;
+
+		return support::gjk(a, b, static_cast<T>(shape_margin(a) + shape_margin(b)), true, cache, s, v, iterations);
+	}
+
+	template <typename A, typename B, typename T>
+	const gjk_result<T> gjk_distance(const A& a, const B& b, gjk_cache<T>* cache)
+	{
+		const T ma = shape_margin(a), mb = shape_margin(b);
+
+		support::gjk_simplex<T> s;
+		vec3<T> v;
+		gjk_result<T> result;
+
+		result.intersecting = support::gjk(a, b, ma + mb, false, cache, s, v, result.iterations);
+		s.witnesses(result.point_a, result.point_b);
+
+		T distance = v.length();
+
+		if (result.intersecting)
+		{
+			result.distance = 0;
+		}
+		else
+		{
+			// the margins move the core points towards each other
+			vec3<T> n = v / -distance;
+
+			result.distance = distance - ma - mb;
+			result.point_a += n * ma;
+			result.point_b -= n * mb;
+		}
+
+		return result;
+	}
+
+	template <typename A, typename B, typename T>
+	const contact<T> collide(const A& a, const B& b, gjk_cache<T>* cache)
+	{
+		const T ma = shape_margin(a), mb = shape_margin(b);
+
+		support::gjk_simplex<T> s;
+		vec3<T> v;
+		int iterations;
+		contact<T> result;
+
+		bool cores = support::gjk(a, b, static_cast<T>(0), false, cache, s, v, iterations);
+		T distance = v.length();
+
+		if (!cores && distance > 0)
+		{
+			s.witnesses(result.point_a, result.point_b);
+			result.separation = distance;
+			result.normal = v / -distance;
+		}
+		else
+		{
+			// inflating the cores by the margins adds the margins to the depth of the cores
+			result.separation = -support::epa(a, b, s, result.normal, result.point_a, result.point_b);
+		}
+
+		result.separation -= ma + mb;
+		result.intersecting = result.separation <= 0;
+		result.point_a += result.normal * ma;
+		result.point_b -= result.normal * mb;
+
+		return result;
+	}
+
+	template <typename A, typename B, typename T>
+	void collide(const A* a, const B* b, const uint32_t* pairs, const size_t& count, contact<T>* out, gjk_cache<T>* caches, const bool& parallel)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				out[i] = collide(a[pairs[2 * i]], b[pairs[2 * i + 1]], caches ? caches + i : nullptr);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 256, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef sphere<float> spheref;
+	typedef sphere<double> sphered;
+	typedef capsule<float> capsulef;
+	typedef capsule<double> capsuled;
+	typedef convex_hull<float> convex_hullf;
+	typedef convex_hull<double> convex_hulld;
+	typedef gjk_cache<float> gjk_cachef;
+	typedef gjk_cache<double> gjk_cached;
+	typedef contact<float> contactf;
+	typedef contact<double> contactd;
+#endif
+}
+
+#endif
@@ -0,0 +1,448 @@
+#ifndef _RM_ICP_H
+#define _RM_ICP_H
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include "vec3.h"
+#include "quat.h"
+#include "kd_tree.h"
+#include "pca.h"
+#include "align.h"
+#include "solve.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	// Unit normals from the smallest principal axis of each point's k nearest neighbours in 'tree'. The sign is arbitrary.
+	template <typename T>
+	void estimate_normals(const kd_tree<3, T>& tree, const vec3<T>* points, const size_t& count, const size_t& k, vec3<T>* normals, const bool& parallel = false);
+
+	// Iterative closest point registration of source scans onto a fixed target. Each iteration matches every (sampled)
+	// source point to its nearest target point, rejects distant pairs and solves for the transform update: in closed form
+	// for point to point, by a Gauss-Newton step on the linearized rotation for point to plane.
+	template <typename T>
+	class icp
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		typedef typename support::covariance_accumulator<T>::type accumulator_type;
+
+		enum metric
+		{
+			POINT_TO_POINT,
+			POINT_TO_PLANE
+		};
+
+		static const size_t NORMAL_NEIGHBOURS = 12;
+
+		struct settings
+		{
+			settings() : mode(POINT_TO_POINT), max_iterations(50), sample_stride(1), max_distance(std::numeric_limits<T>::max()),
+				rejection_multiplier(3), rotation_tolerance(static_cast<T>(1e-5)), translation_tolerance(static_cast<T>(1e-5)),
+				error_tolerance(static_cast<T>(1e-5)), parallel(false) {}
+
+			metric mode;
+			size_t max_iterations;
+
+			// only every n-th source point is matched
+			size_t sample_stride;
+
+			// pairs further apart than max_distance, or than rejection_multiplier times the median pair distance, are ignored
+			T max_distance;
+			T rejection_multiplier;
+
+			// converged once an update rotates less than rotation_tolerance radians and moves less than
+			// translation_tolerance, or the rms error changes by less than error_tolerance relative to the last
+			T rotation_tolerance;
+			T translation_tolerance;
+			T error_tolerance;
+
+			// off by default like every other parallel flag in the library
+			bool parallel;
+		};
+
+		struct iteration
+		{
+			size_t correspondences;
+
+			// rms distance of the kept pairs (point to plane: along the target normal) before the update
+			T rms;
+			T rotation_step;
+			T translation_step;
+
+			// wall time of the iteration's phases in milliseconds
+			double transform_ms;
+			double search_ms;
+			double rejection_ms;
+			double solve_ms;
+			double total_ms;
+		};
+
+		// constructors
+		icp() : m_converged(false) {}
+		icp(const vec3<T>* target, const size_t& count, const vec3<T>* normals = nullptr, const bool& parallel = false);
+
+		// Modifiers
+
+		// Copies the target and builds its k-d tree. Normals are only needed for point to plane, they are estimated
+		// on first use when not given.
+		void build(const vec3<T>* target, const size_t& count, const vec3<T>* normals = nullptr, const bool& parallel = false);
+
+		// Utility functions
+
+		// Transform taking the source onto the target, starting from 'initial'
+		const rigid_transform<T> align(const vec3<T>* source, const size_t& count, const rigid_transform<T>& initial = rigid_transform<T>(), const settings& s = settings());
+
+		// Accessors
+		inline const std::vector<iteration>& iterations() const;
+		inline const bool converged() const;
+		inline const kd_tree<3, T>& tree() const;
+		inline const std::vector<vec3<T>>& normals() const;
+
+	private:
+		typedef std::chrono::steady_clock clock;
+
+		static double elapsed_ms(const clock::time_point& start);
+
+		const rigid_transform<T> solve_point_to_point(const bool& parallel) const;
+		const rigid_transform<T> solve_point_to_plane(const bool& parallel, bool& solved) const;
+
+		kd_tree<3, T> m_tree;
+		std::vector<vec3<T>> m_target;
+		std::vector<vec3<T>> m_normals;
+		std::vector<iteration> m_iterations;
+		bool m_converged;
+
+		// per iteration buffers, kept to avoid reallocating for every scan
+		std::vector<vec3<T>> m_moved;
+		std::vector<uint32_t> m_matches;
+		std::vector<T> m_weights;
+		std::vector<T> m_distances;
+	};
+
+	template <typename T>
+	void estimate_normals(const kd_tree<3, T>& tree, const vec3<T>* points, const size_t& count, const size_t& k, vec3<T>* normals, const bool& parallel)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			std::vector<uint32_t> neighbours(k);
+			std::vector<vec3<T>> local(k);
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				size_t found = tree.nearest(points[i], k, neighbours.data());
+
+				for (size_t j = 0; j < found; ++j)
+					local[j] = points[neighbours[j]];
+
+				normals[i] = found < 3 ? vec3<T>(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1)) : covariance3<T>(local.data(), found).principal_axes().vector(2);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 12, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	icp<T>::icp(const vec3<T>* target, const size_t& count, const vec3<T>* normals, const bool& parallel) : m_converged(false)
+	{
+		build(target, count, normals, parallel);
+	}
+
+	template <typename T>
+	void icp<T>::build(const vec3<T>* target, const size_t& count, const vec3<T>* normals, const bool& parallel)
+	{
+		m_target.assign(target, target + count);
+		m_tree.build(target, count, parallel);
+
+		if (normals)
+			m_normals.assign(normals, normals + count);
+		else
+			m_normals.clear();
+
+		m_iterations.clear();
+		m_converged = false;
+	}
+
+	template <typename T>
+	const rigid_transform<T> icp<T>::align(const vec3<T>* source, const size_t& count, const rigid_transform<T>& initial, const settings& s)
+	{
+		m_iterations.clear();
+		m_converged = false;
+
+		if (s.mode == POINT_TO_PLANE && m_normals.size() != m_target.size())
+		{
+			const size_t neighbours = NORMAL_NEIGHBOURS;
+
+			m_normals.resize(m_target.size());
+			estimate_normals(m_tree, m_target.data(), m_target.size(), neighbours, m_normals.data(), s.parallel);
+		}
+
+		const size_t stride = std::max<size_t>(1, s.sample_stride);
+		const size_t samples = (count + stride - 1) / stride;
+
+		// nothing to match, and no median distance to reject against
+		if (samples == 0)
+			return initial;
+
+		std::vector<vec3<T>> sampled;
+		const vec3<T>* points = source;
+
+		if (stride > 1)
+		{
+			sampled.resize(samples);
+
+			for (size_t i = 0; i < samples; ++i)
+				sampled[i] = source[i * stride];
+
+			points = sampled.data();
+		}
+
+		m_moved.resize(samples);
+		m_matches.resize(samples);
+		m_weights.resize(samples);
+
+		rigid_transform<T> current = initial;
+		T previous_rms = std::numeric_limits<T>::max();
+
+		for (size_t n = 0; n < s.max_iterations && !m_target.empty(); ++n)
+		{
+			iteration it = {};
+			clock::time_point start = clock::now();
+
+			rigid_transform<T>::apply(current, points, samples, m_moved.data(), s.parallel);
+			it.transform_ms = elapsed_ms(start);
+
+			clock::time_point phase = clock::now();
+			m_tree.nearest(m_moved.data(), samples, 1, m_matches.data(), s.parallel);
+			it.search_ms = elapsed_ms(phase);
+
+			// pair distances, then the rejection threshold from their median
+			phase = clock::now();
+
+			auto distances = [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					m_weights[i] = m_matches[i] == kd_tree<3, T>::EMPTY ? std::numeric_limits<T>::max() : m_moved[i].distance_squared(m_target[m_matches[i]]);
+			};
+
+			if (s.parallel)
+				support::parallel_for(samples, 1 << 14, distances);
+			else
+				distances(0, 0, samples);
+
+			m_distances.assign(m_weights.begin(), m_weights.end());
+
+			auto middle = m_distances.begin() + m_distances.size() / 2;
+			std::nth_element(m_distances.begin(), middle, m_distances.end());
+
+			T limit = std::min(s.max_distance * s.max_distance, s.rejection_multiplier * s.rejection_multiplier * *middle);
+
+			// kept pairs get weight 1 and add to the rms, point to plane measures it along the normals
+			accumulator_type sum = 0;
+
+			for (size_t i = 0; i < samples; ++i)
+			{
+				bool keep = m_weights[i] <= limit;
+
+				if (keep)
+				{
+					T e = s.mode == POINT_TO_PLANE ? (m_moved[i] - m_target[m_matches[i]]).dot(m_normals[m_matches[i]]) : sqrt(m_weights[i]);
+
+					sum += static_cast<accumulator_type>(e) * e;
+					++it.correspondences;
+				}
+
+				m_weights[i] = keep ? static_cast<T>(1) : static_cast<T>(0);
+			}
+
+			it.rejection_ms = elapsed_ms(phase);
+
+			if (it.correspondences < 3)
+			{
+				it.total_ms = elapsed_ms(start);
+				m_iterations.push_back(it);
+				break;
+			}
+
+			it.rms = static_cast<T>(sqrt(sum / it.correspondences));
+
+			phase = clock::now();
+
+			bool solved = true;
+			rigid_transform<T> update = s.mode == POINT_TO_PLANE ? solve_point_to_plane(s.parallel, solved) : solve_point_to_point(s.parallel);
+
+			it.solve_ms = elapsed_ms(phase);
+
+			if (!solved)
+			{
+				it.total_ms = elapsed_ms(start);
+				m_iterations.push_back(it);
+				break;
+			}
+
+			current = update * current;
+
+			it.rotation_step = 2 * std::asin(std::min<T>(1, update.rotation.xyz().length()));
+			it.translation_step = update.translation.length();
+			it.total_ms = elapsed_ms(start);
+			m_iterations.push_back(it);
+
+			if ((it.rotation_step <= s.rotation_tolerance && it.translation_step <= s.translation_tolerance) ||
+				std::abs(previous_rms - it.rms) <= s.error_tolerance * previous_rms)
+			{
+				m_converged = true;
+				break;
+			}
+
+			previous_rms = it.rms;
+		}
+
+		return current;
+	}
+
+	template <typename T>
+	const rigid_transform<T> icp<T>::solve_point_to_point(const bool& parallel) const
+	{
+		// the weights are 0 for rejected pairs, matched points are gathered so the SIMD sums stream through memory
+		std::vector<vec3<T>> matched(m_moved.size());
+
+		for (size_t i = 0; i < m_moved.size(); ++i)
+			matched[i] = m_weights[i] > 0 ? m_target[m_matches[i]] : m_moved[i];
+
+		return cross_covariance3<T>().add(m_moved.data(), matched.data(), m_weights.data(), m_moved.size(), parallel).solve();
+	}
+
+	template <typename T>
+	const rigid_transform<T> icp<T>::solve_point_to_plane(const bool& parallel, bool& solved) const
+	{
+		typedef accumulator_type A;
+
+		// r = n . (p - q), linearized in the small rotation w and translation t as r + (p x n) . w + n . t
+		struct normal_equations
+		{
+			A ata[21];
+			A atb[6];
+		};
+
+		const size_t count = m_moved.size();
+		std::vector<normal_equations> partial(parallel ? support::parallel_chunks(count, 1 << 14) : 1, normal_equations{});
+
+		auto kernel = [&](size_t chunk, size_t begin, size_t end)
+		{
+			normal_equations& e = partial[chunk];
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				if (m_weights[i] == 0)
+					continue;
+
+				const vec3<T>& p = m_moved[i];
+				const vec3<T>& q = m_target[m_matches[i]];
+				const vec3<T>& n = m_normals[m_matches[i]];
+
+				vec3<T> c = vec3<T>::cross(p, n);
+				A j[6] = { c.x(), c.y(), c.z(), n.x(), n.y(), n.z() };
+				A r = n.dot(p - q);
+
+				for (int row = 0, k = 0; row < 6; ++row)
+				{
+					for (int col = 0; col <= row; ++col)
+						e.ata[k++] += j[row] * j[col];
+
+					e.atb[row] -= j[row] * r;
+				}
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 14, kernel);
+		else
+			kernel(0, 0, count);
+
+		support::matrix<6, 6, A> ata(static_cast<A>(0));
+		support::vector<6, A> atb;
+
+		for (const normal_equations& e : partial)
+		{
+			for (int row = 0, k = 0; row < 6; ++row)
+			{
+				for (int col = 0; col <= row; ++col, ++k)
+				{
+					ata.at(row, col) += e.ata[k];
+					ata.at(col, row) = ata.at(row, col);
+				}
+
+				atb[row] += e.atb[row];
+			}
+		}
+
+		// Cholesky for the usual well conditioned case, LU when the geometry leaves a direction barely constrained
+		support::vector<6, A> x;
+		cholesky<6, A> llt(ata);
+
+		if (llt.valid())
+			x = llt.solve(atb);
+		else
+		{
+			lu<6, A> plu(ata);
+
+			solved = plu.valid();
+
+			if (!solved)
+				return rigid_transform<T>();
+
+			x = plu.solve(atb);
+		}
+
+		vec3<A> w(x[0], x[1], x[2]);
+		A angle = w.length();
+		quat<T> rotation = angle > 0 ? quat<T>(vec3<T>(w / angle), static_cast<T>(angle)) : quat<T>();
+
+		return rigid_transform<T>(rotation, vec3<T>(static_cast<T>(x[3]), static_cast<T>(x[4]), static_cast<T>(x[5])));
+	}
+
+	template <typename T>
+	double icp<T>::elapsed_ms(const clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	}
+
+	template <typename T>
+	inline const std::vector<typename icp<T>::iteration>& icp<T>::iterations() const
+	{
+		return m_iterations;
+	}
+
+	template <typename T>
+	inline const bool icp<T>::converged() const
+	{
+		return m_converged;
+	}
+
+	template <typename T>
+	inline const kd_tree<3, T>& icp<T>::tree() const
+	{
+		return m_tree;
+	}
+
+	template <typename T>
+	inline const std::vector<vec3<T>>& icp<T>::normals() const
+	{
+		return m_normals;
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef icp<float> icpf;
+	typedef icp<double> icpd;
+#endif
+}
+
+#endif
@@ -0,0 +1,422 @@
+#ifndef _RM_KD_TREE_H
+#define _RM_KD_TREE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "span.h"
+#include "support/vector.h"
+#include "support/csr.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	// Static k-d tree over S dimensional points. Splits at the median of the widest axis, so the tree is complete and
+	// stored implicitly (children of node i are 2i + 1 and 2i + 2) and a node's point range follows from its position.
+	template <size_t S, typename T>
+	class kd_tree
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static const size_t MAX_LEAF_SIZE = 8;
+		static const size_t STACK_SIZE = 64;
+		static const uint32_t EMPTY = 0xffffffffu;
+
+		using point_type = support::vector<S, T>;
+
+		struct node
+		{
+			T split;
+			uint32_t axis;
+		};
+
+		// constructors
+		kd_tree() : m_leaf_start(0) {}
+
+		template <typename V>
+		kd_tree(const V* points, const size_t& count, const bool& parallel = false);
+
+		// Modifiers, V is point_type or a type derived from it (vec2, vec3, vec4)
+		template <typename V>
+		void build(const V* points, const size_t& count, const bool& parallel = false);
+		void clear();
+
+		// k nearest points sorted by distance and equal distances by index, returns how many were found (< k only when
+		// there are fewer points).
+		// With epsilon > 0 the search is approximate, each result is within (1 + epsilon) of the true k-th distance.
+		size_t nearest(const point_type& p, const size_t& k, uint32_t* indices, T* distances_squared = nullptr, const T& epsilon = 0) const;
+
+		// Batch k nearest, k results per query, unused slots are EMPTY. The queries are an array or a strided span.
+		template <typename V>
+		void nearest(const V* queries, const size_t& count, const size_t& k, uint32_t* indices, const bool& parallel = false, const T& epsilon = 0) const;
+		void nearest(const vec_span<S, const T>& queries, const size_t& k, uint32_t* indices, const bool& parallel = false, const T& epsilon = 0) const;
+
+		// Points within r of center
+		template <typename F>
+		void radius(const point_type& center, const T& r, F&& f) const;
+		size_t radius(const point_type& center, const T& r, std::vector<uint32_t>& indices) const;
+
+		// Batch radius query, results of query i are indices[offsets[i] .. offsets[i + 1])
+		template <typename V>
+		void radius(const V* centers, const size_t& count, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel = false) const;
+		void radius(const vec_span<S, const T>& centers, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel = false) const;
+
+		// Accessors
+		inline const size_t size() const;
+		inline const size_t node_count() const;
+		inline const std::vector<node>& nodes() const;
+
+	private:
+		struct stack_entry
+		{
+			uint32_t node;
+			uint32_t begin;
+			uint32_t end;
+			T distance_squared;
+		};
+
+		struct build_item
+		{
+			point_type point;
+			uint32_t index;
+		};
+
+		void build_recursive(build_item* items, const uint32_t& index, const uint32_t& begin, const uint32_t& end, const size_t& depth, const size_t& spawn_depth);
+		size_t nearest(const point_type& p, const size_t& k, uint32_t* indices, T* distances_squared, const T& epsilon, std::vector<T>& scratch) const;
+
+		template <typename F>
+		inline void traverse(const point_type& p, F&& f, const T& bound_scale) const;
+
+		std::vector<node> m_nodes;
+		std::vector<point_type> m_points;
+		std::vector<uint32_t> m_indices;
+		uint32_t m_leaf_start;
+	};
+
+	template <size_t S, typename T>
+	template <typename V>
+	kd_tree<S, T>::kd_tree(const V* points, const size_t& count, const bool& parallel) : m_leaf_start(0)
+	{
+		build(points, count, parallel);
+	}
+
+	template <size_t S, typename T>
+	template <typename V>
+	void kd_tree<S, T>::build(const V* points, const size_t& count, const bool& parallel)
+	{
+		static_assert(std::is_base_of<point_type, V>::value, "kd_tree points must be support::vector<S, T> based");
+		assert(count < EMPTY);
+
+		// smallest complete tree whose leaves hold at most MAX_LEAF_SIZE points
+		size_t depth = 0;
+
+		while (((count + (size_t(1) << depth) - 1) >> depth) > MAX_LEAF_SIZE)
+			++depth;
+
+		m_leaf_start = static_cast<uint32_t>((size_t(1) << depth) - 1);
+		m_nodes.assign(m_leaf_start, node{ 0, 0 });
+		m_points.resize(count);
+		m_indices.resize(count);
+
+		// points are partitioned together with their index, nth_element then streams through contiguous memory
+		std::vector<build_item> items(count);
+
+		for (size_t i = 0; i < count; ++i)
+			items[i] = build_item{ points[i], static_cast<uint32_t>(i) };
+
+		size_t spawn_depth = 0;
+
+		while (parallel && (size_t(1) << spawn_depth) < support::thread_count())
+			++spawn_depth;
+
+		if (count > 0)
+			build_recursive(items.data(), 0, 0, static_cast<uint32_t>(count), 0, spawn_depth);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_points[i] = items[i].point;
+			m_indices[i] = items[i].index;
+		}
+	}
+
+	template <size_t S, typename T>
+	void kd_tree<S, T>::build_recursive(build_item* items, const uint32_t& index, const uint32_t& begin, const uint32_t& end, const size_t& depth, const size_t& spawn_depth)
+	{
+		if (index >= m_leaf_start)
+			return;
+
+		// split the widest axis of the range
+		point_type lo(std::numeric_limits<T>::max());
+		point_type hi(std::numeric_limits<T>::lowest());
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const point_type& point = items[i].point;
+
+			for (size_t a = 0; a < S; ++a)
+			{
+				lo.m_data[a] = std::min(lo.m_data[a], point.m_data[a]);
+				hi.m_data[a] = std::max(hi.m_data[a], point.m_data[a]);
+			}
+		}
+
+		uint32_t axis = 0;
+
+		for (size_t a = 1; a < S; ++a)
+			if (hi.m_data[a] - lo.m_data[a] > hi.m_data[axis] - lo.m_data[axis])
+				axis = static_cast<uint32_t>(a);
+
+		uint32_t mid = begin + (end - begin) / 2;
+
+		std::nth_element(items + begin, items + mid, items + end, [&](const build_item& a, const build_item& b)
+		{
+			return a.point.m_data[axis] < b.point.m_data[axis];
+		});
+
+		m_nodes[index] = node{ items[mid].point.m_data[axis], axis };
+
+		// left holds values <= split, right values >= split
+		if (depth < spawn_depth && end - begin > (1u << 12))
+		{
+			std::thread worker([&]() { build_recursive(items, 2 * index + 1, begin, mid, depth + 1, spawn_depth); });
+			build_recursive(items, 2 * index + 2, mid, end, depth + 1, spawn_depth);
+			worker.join();
+		}
+		else
+		{
+			build_recursive(items, 2 * index + 1, begin, mid, depth + 1, spawn_depth);
+			build_recursive(items, 2 * index + 2, mid, end, depth + 1, spawn_depth);
+		}
+	}
+
+	template <size_t S, typename T>
+	void kd_tree<S, T>::clear()
+	{
+		m_nodes.clear();
+		m_points.clear();
+		m_indices.clear();
+		m_leaf_start = 0;
+	}
+
+	// Depth first walk with a fixed stack, nearer child first. f(begin, end) is called per leaf range and returns
+	// the current pruning distance, subtrees whose lower bound (scaled by bound_scale) exceeds it are skipped.
+	template <size_t S, typename T>
+	template <typename F>
+	inline void kd_tree<S, T>::traverse(const point_type& p, F&& f, const T& bound_scale) const
+	{
+		if (m_points.empty())
+			return;
+
+		stack_entry stack[STACK_SIZE];
+		size_t top = 0;
+
+		stack[top++] = stack_entry{ 0, 0, static_cast<uint32_t>(m_points.size()), 0 };
+
+		T limit = std::numeric_limits<T>::infinity();
+
+		while (top > 0)
+		{
+			stack_entry e = stack[--top];
+
+			if (e.distance_squared * bound_scale > limit)
+				continue;
+
+			// descend to a leaf, pushing the far sides
+			while (e.node < m_leaf_start)
+			{
+				const node& n = m_nodes[e.node];
+				uint32_t mid = e.begin + (e.end - e.begin) / 2;
+				T diff = p.m_data[n.axis] - n.split;
+
+				stack_entry left = { 2 * e.node + 1, e.begin, mid, e.distance_squared };
+				stack_entry right = { 2 * e.node + 2, mid, e.end, e.distance_squared };
+
+				stack_entry& near = diff < 0 ? left : right;
+				stack_entry& far = diff < 0 ? right : left;
+
+				far.distance_squared = std::max(e.distance_squared, diff * diff);
+
+#ifndef _REACT_NO_SAFE_ACCESSORS
+				assert(top < STACK_SIZE);
+#endif
+				if (far.distance_squared * bound_scale <= limit)
+					stack[top++] = far;
+
+				e = near;
+			}
+
+			limit = f(e.begin, e.end);
+		}
+	}
+
+	template <size_t S, typename T>
+	size_t kd_tree<S, T>::nearest(const point_type& p, const size_t& k, uint32_t* indices, T* distances_squared, const T& epsilon) const
+	{
+		std::vector<T> scratch;
+
+		return nearest(p, k, indices, distances_squared, epsilon, scratch);
+	}
+
+	template <size_t S, typename T>
+	size_t kd_tree<S, T>::nearest(const point_type& p, const size_t& k, uint32_t* indices, T* distances_squared, const T& epsilon, std::vector<T>& scratch) const
+	{
+		if (k == 0)
+			return 0;
+
+		if (!distances_squared)
+		{
+			scratch.resize(k);
+			distances_squared = scratch.data();
+		}
+
+		// results are kept sorted in the output arrays, nearest first and ties by index as in spatial_hash and topk,
+		// the last one is the pruning distance once k are found. Subtrees at exactly that distance are still walked,
+		// so a tied point with a lower index is never pruned.
+		size_t found = 0;
+		T scale = (1 + epsilon) * (1 + epsilon);
+
+		auto before = [&](const T& d2, const uint32_t& index, const size_t& j)
+		{
+			return d2 < distances_squared[j] || (d2 == distances_squared[j] && index < indices[j]);
+		};
+
+		traverse(p, [&](const uint32_t& begin, const uint32_t& end)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				T d2 = m_points[i].distance_squared(p);
+				uint32_t index = m_indices[i];
+
+				if (found == k && !before(d2, index, k - 1))
+					continue;
+
+				size_t j = found < k ? found++ : k - 1;
+
+				for (; j > 0 && before(d2, index, j - 1); --j)
+				{
+					distances_squared[j] = distances_squared[j - 1];
+					indices[j] = indices[j - 1];
+				}
+
+				distances_squared[j] = d2;
+				indices[j] = index;
+			}
+
+			return found == k ? distances_squared[k - 1] : std::numeric_limits<T>::infinity();
+		}, scale);
+
+		return found;
+	}
+
+	template <size_t S, typename T>
+	template <typename V>
+	void kd_tree<S, T>::nearest(const V* queries, const size_t& count, const size_t& k, uint32_t* indices, const bool& parallel, const T& epsilon) const
+	{
+		static_assert(std::is_base_of<point_type, V>::value, "kd_tree queries must be support::vector<S, T> based");
+
+		nearest(vec_span<S, const T>(count ? queries->m_data : nullptr, count, sizeof(V)), k, indices, parallel, epsilon);
+	}
+
+	template <size_t S, typename T>
+	void kd_tree<S, T>::nearest(const vec_span<S, const T>& queries, const size_t& k, uint32_t* indices, const bool& parallel, const T& epsilon) const
+	{
+		const size_t count = queries.size();
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			std::vector<T> scratch;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				size_t found = nearest(queries[i], k, indices + i * k, nullptr, epsilon, scratch);
+
+				for (size_t j = found; j < k; ++j)
+					indices[i * k + j] = EMPTY;
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 10, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <size_t S, typename T>
+	template <typename F>
+	void kd_tree<S, T>::radius(const point_type& center, const T& r, F&& f) const
+	{
+		T r2 = r * r;
+
+		traverse(center, [&](const uint32_t& begin, const uint32_t& end)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				T d2 = m_points[i].distance_squared(center);
+
+				if (d2 <= r2)
+					f(m_indices[i], d2);
+			}
+
+			return r2;
+		}, static_cast<T>(1));
+	}
+
+	template <size_t S, typename T>
+	size_t kd_tree<S, T>::radius(const point_type& center, const T& r, std::vector<uint32_t>& indices) const
+	{
+		size_t before = indices.size();
+
+		radius(center, r, [&](const uint32_t& index, const T&) { indices.push_back(index); });
+
+		return indices.size() - before;
+	}
+
+	template <size_t S, typename T>
+	template <typename V>
+	void kd_tree<S, T>::radius(const V* centers, const size_t& count, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel) const
+	{
+		static_assert(std::is_base_of<point_type, V>::value, "kd_tree queries must be support::vector<S, T> based");
+
+		radius(vec_span<S, const T>(count ? centers->m_data : nullptr, count, sizeof(V)), r, offsets, indices, parallel);
+	}
+
+	template <size_t S, typename T>
+	void kd_tree<S, T>::radius(const vec_span<S, const T>& centers, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel) const
+	{
+		support::gather_rows(centers.size(), [&](const size_t& i, std::vector<uint32_t>& out) { radius(centers[i], r, out); }, offsets, indices, parallel);
+	}
+
+	template <size_t S, typename T>
+	inline const size_t kd_tree<S, T>::size() const
+	{
+		return m_points.size();
+	}
+
+	template <size_t S, typename T>
+	inline const size_t kd_tree<S, T>::node_count() const
+	{
+		return m_nodes.size();
+	}
+
+	template <size_t S, typename T>
+	inline const std::vector<typename kd_tree<S, T>::node>& kd_tree<S, T>::nodes() const
+	{
+		return m_nodes;
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef kd_tree<2, float> kd_tree2f;
+	typedef kd_tree<3, float> kd_tree3f;
+	typedef kd_tree<2, double> kd_tree2d;
+	typedef kd_tree<3, double> kd_tree3d;
+#endif
+}
+
+#endif
@@ -27,6 +27,8 @@ namespace react
 	typedef mat2x4<float> mat2x4f;
 	typedef mat2x4<int> mat2x4i;
 #endif
+
+	static_assert(sizeof(support::matrix<2, 2, float>) == 4 * sizeof(float), "mat2<float> holds only its components");
 }
 
 #endif
\ No newline at end of file
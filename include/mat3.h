@@ -27,6 +27,8 @@ namespace react
 	typedef mat3x4<float> mat3x4f;
 	typedef mat3x4<int> mat3x4i;
 #endif
+
+	static_assert(sizeof(support::matrix<3, 3, float>) == 9 * sizeof(float), "mat3<float> holds only its components");
 }
 
 #endif
\ No newline at end of file
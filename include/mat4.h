@@ -27,6 +27,8 @@ namespace react
 	typedef mat4x3<float> mat4x3f;
 	typedef mat4x3<int> mat4x3i;
 #endif
+
+	static_assert(sizeof(support::matrix<4, 4, float>) == 16 * sizeof(float), "mat4<float> holds only its components");
 }
 
 #endif
\ No newline at end of file
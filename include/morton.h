@@ -0,0 +1,423 @@
+#ifndef _RM_MORTON_H
+#define _RM_MORTON_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "vec3.h"
+#include "aabb.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+#include "support/sort.h"
+
+namespace react
+{
+	namespace support
+	{
+		// credit https://fgiesen.wordpress.com/2009/12/13/decoding-morton-codes/
+		inline uint32_t morton_expand10(uint32_t v)
+		{
+			v &= 0x000003ffu;
+			v = (v | (v << 16)) & 0x030000ffu;
+			v = (v | (v << 8)) & 0x0300f00fu;
+			v = (v | (v << 4)) & 0x030c30c3u;
+			v = (v | (v << 2)) & 0x09249249u;
+
+			return v;
+		}
+
+		inline uint32_t morton_compact10(uint32_t v)
+		{
+			v &= 0x09249249u;
+			v = (v | (v >> 2)) & 0x030c30c3u;
+			v = (v | (v >> 4)) & 0x0300f00fu;
+			v = (v | (v >> 8)) & 0x030000ffu;
+			v = (v | (v >> 16)) & 0x000003ffu;
+
+			return v;
+		}
+
+		inline uint64_t morton_expand21(uint64_t v)
+		{
+			v &= 0x00000000001fffffull;
+			v = (v | (v << 32)) & 0x001f00000000ffffull;
+			v = (v | (v << 16)) & 0x001f0000ff0000ffull;
+			v = (v | (v << 8)) & 0x100f00f00f00f00full;
+			v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+			v = (v | (v << 2)) & 0x1249249249249249ull;
+
+			return v;
+		}
+
+		inline uint64_t morton_compact21(uint64_t v)
+		{
+			v &= 0x1249249249249249ull;
+			v = (v | (v >> 2)) & 0x10c30c30c30c30c3ull;
+			v = (v | (v >> 4)) & 0x100f00f00f00f00full;
+			v = (v | (v >> 8)) & 0x001f0000ff0000ffull;
+			v = (v | (v >> 16)) & 0x001f00000000ffffull;
+			v = (v | (v >> 32)) & 0x00000000001fffffull;
+
+			return v;
+		}
+
+		// Interleaves 10 bits per axis, x in bit 0
+		inline uint32_t morton_encode30(const uint32_t& x, const uint32_t& y, const uint32_t& z)
+		{
+#ifdef _REACT_SIMD_BMI2
+			return _pdep_u32(x, 0x09249249u) | _pdep_u32(y, 0x12492492u) | _pdep_u32(z, 0x24924924u);
+#else
+			return morton_expand10(x) | (morton_expand10(y) << 1) | (morton_expand10(z) << 2);
+#endif
+		}
+
+		// Interleaves 21 bits per axis, x in bit 0
+		inline uint64_t morton_encode63(const uint64_t& x, const uint64_t& y, const uint64_t& z)
+		{
+#if defined(_REACT_SIMD_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+			return _pdep_u64(x, 0x1249249249249249ull) | _pdep_u64(y, 0x2492492492492492ull) | _pdep_u64(z, 0x4924924924924924ull);
+#else
+			return morton_expand21(x) | (morton_expand21(y) << 1) | (morton_expand21(z) << 2);
+#endif
+		}
+
+		inline void morton_decode30(const uint32_t& code, uint32_t& x, uint32_t& y, uint32_t& z)
+		{
+#ifdef _REACT_SIMD_BMI2
+			x = _pext_u32(code, 0x09249249u);
+			y = _pext_u32(code, 0x12492492u);
+			z = _pext_u32(code, 0x24924924u);
+#else
+			x = morton_compact10(code);
+			y = morton_compact10(code >> 1);
+			z = morton_compact10(code >> 2);
+#endif
+		}
+
+		inline void morton_decode63(const uint64_t& code, uint64_t& x, uint64_t& y, uint64_t& z)
+		{
+#if defined(_REACT_SIMD_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+			x = _pext_u64(code, 0x1249249249249249ull);
+			y = _pext_u64(code, 0x2492492492492492ull);
+			z = _pext_u64(code, 0x4924924924924924ull);
+#else
+			x = morton_compact21(code);
+			y = morton_compact21(code >> 1);
+			z = morton_compact21(code >> 2);
+#endif
+		}
+
+		// Maps v from [lo, lo + cells / scale) onto a grid cell in [0, cells), clamping outside values (and NaN) to the edges
+		template <typename T>
+		inline uint32_t morton_quantize(const T& v, const T& lo, const T& scale, const T& max_cell)
+		{
+			T f = (v - lo) * scale;
+
+			if (!(f > 0))
+				f = 0;
+
+			return static_cast<uint32_t>(std::min(f, max_cell));
+		}
+
+		// Per axis offset and scale that map bounds onto 2^bits cells
+		template <typename T>
+		inline void morton_grid(const aabb<T>& bounds, const int& bits, T(&lo)[3], T(&scale)[3])
+		{
+			T cells = static_cast<T>(uint64_t(1) << bits);
+
+			for (int i = 0; i < 3; ++i)
+			{
+				T extent = bounds.max.m_data[i] - bounds.min.m_data[i];
+
+				lo[i] = bounds.min.m_data[i];
+				scale[i] = extent > 0 ? cells / extent : static_cast<T>(0);
+			}
+		}
+
+		// 30-bit codes for [begin, end) of SoA coordinates, x/y/z may be strided views of an AoS array
+		template <typename T>
+		void morton_encode30_range(const T* x, const T* y, const T* z, const size_t& stride, const T(&lo)[3], const T(&scale)[3], const size_t& begin, const size_t& end, uint32_t* codes)
+		{
+			const T max_cell = static_cast<T>(1023);
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				codes[i] = morton_encode30(
+					morton_quantize(x[i * stride], lo[0], scale[0], max_cell),
+					morton_quantize(y[i * stride], lo[1], scale[1], max_cell),
+					morton_quantize(z[i * stride], lo[2], scale[2], max_cell));
+			}
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		inline __m256i mm256_morton_expand10(__m256i v)
+		{
+			v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 16)), _mm256_set1_epi32(0x030000ff));
+			v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 8)), _mm256_set1_epi32(0x0300f00f));
+			v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 4)), _mm256_set1_epi32(0x030c30c3));
+			v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 2)), _mm256_set1_epi32(0x09249249));
+
+			return v;
+		}
+
+		inline __m256i mm256_morton_quantize(const __m256& v, const __m256& lo, const __m256& scale, const __m256& max_cell)
+		{
+			// max_ps returns the second operand for NaN, matching the scalar clamp
+			__m256 f = _mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(v, lo), scale), _mm256_setzero_ps());
+
+			return _mm256_cvttps_epi32(_mm256_min_ps(f, max_cell));
+		}
+
+		// Eight codes at a time, contiguous coordinates are loaded directly and strided ones gathered
+		inline void morton_encode30_range(const float* x, const float* y, const float* z, const size_t& stride, const float(&lo)[3], const float(&scale)[3], const size_t& begin, const size_t& end, uint32_t* codes)
+		{
+			const __m256 lo_x = _mm256_set1_ps(lo[0]), lo_y = _mm256_set1_ps(lo[1]), lo_z = _mm256_set1_ps(lo[2]);
+			const __m256 scale_x = _mm256_set1_ps(scale[0]), scale_y = _mm256_set1_ps(scale[1]), scale_z = _mm256_set1_ps(scale[2]);
+			const __m256 max_cell = _mm256_set1_ps(1023.0f);
+			const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 vx, vy, vz;
+
+				if (stride == 1)
+				{
+					vx = _mm256_loadu_ps(x + i);
+					vy = _mm256_loadu_ps(y + i);
+					vz = _mm256_loadu_ps(z + i);
+				}
+				else
+				{
+					vx = _mm256_i32gather_ps(x + i * stride, offsets, 4);
+					vy = _mm256_i32gather_ps(y + i * stride, offsets, 4);
+					vz = _mm256_i32gather_ps(z + i * stride, offsets, 4);
+				}
+
+				__m256i cx = mm256_morton_expand10(mm256_morton_quantize(vx, lo_x, scale_x, max_cell));
+				__m256i cy = mm256_morton_expand10(mm256_morton_quantize(vy, lo_y, scale_y, max_cell));
+				__m256i cz = mm256_morton_expand10(mm256_morton_quantize(vz, lo_z, scale_z, max_cell));
+
+				__m256i code = _mm256_or_si256(cx, _mm256_or_si256(_mm256_slli_epi32(cy, 1), _mm256_slli_epi32(cz, 2)));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(codes + i), code);
+			}
+
+			morton_encode30_range<float>(x, y, z, stride, lo, scale, i, end, codes);
+		}
+#endif
+
+		template <typename T>
+		void morton_encode63_range(const T* x, const T* y, const T* z, const size_t& stride, const T(&lo)[3], const T(&scale)[3], const size_t& begin, const size_t& end, uint64_t* codes)
+		{
+			const T max_cell = static_cast<T>((1 << 21) - 1);
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				codes[i] = morton_encode63(
+					morton_quantize(x[i * stride], lo[0], scale[0], max_cell),
+					morton_quantize(y[i * stride], lo[1], scale[1], max_cell),
+					morton_quantize(z[i * stride], lo[2], scale[2], max_cell));
+			}
+		}
+	}
+
+	// Z-order code of p inside bounds, 10 bits per axis
+	template <typename T>
+	inline const uint32_t morton_encode(const vec3<T>& p, const aabb<T>& bounds)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 10, lo, scale);
+
+		const T max_cell = static_cast<T>(1023);
+
+		return support::morton_encode30(
+			support::morton_quantize(p.m_data[0], lo[0], scale[0], max_cell),
+			support::morton_quantize(p.m_data[1], lo[1], scale[1], max_cell),
+			support::morton_quantize(p.m_data[2], lo[2], scale[2], max_cell));
+	}
+
+	// Z-order code of p inside bounds, 21 bits per axis
+	template <typename T>
+	inline const uint64_t morton_encode63(const vec3<T>& p, const aabb<T>& bounds)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 21, lo, scale);
+
+		const T max_cell = static_cast<T>((1 << 21) - 1);
+
+		return support::morton_encode63(
+			support::morton_quantize(p.m_data[0], lo[0], scale[0], max_cell),
+			support::morton_quantize(p.m_data[1], lo[1], scale[1], max_cell),
+			support::morton_quantize(p.m_data[2], lo[2], scale[2], max_cell));
+	}
+
+	// Batch encoding of AoS points
+	template <typename T>
+	void morton_encode(const vec3<T>* points, const size_t& count, const aabb<T>& bounds, uint32_t* codes, const bool& parallel = false)
+	{
+		static_assert(sizeof(vec3<T>) % sizeof(T) == 0, "vec3 must be a whole number of components");
+
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 10, lo, scale);
+
+		const T* base = points ? points->m_data : nullptr;
+		const size_t stride = sizeof(vec3<T>) / sizeof(T);
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::morton_encode30_range(base, base + 1, base + 2, stride, lo, scale, begin, end, codes);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 16, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	void morton_encode63(const vec3<T>* points, const size_t& count, const aabb<T>& bounds, uint64_t* codes, const bool& parallel = false)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 21, lo, scale);
+
+		const T* base = points ? points->m_data : nullptr;
+		const size_t stride = sizeof(vec3<T>) / sizeof(T);
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::morton_encode63_range(base, base + 1, base + 2, stride, lo, scale, begin, end, codes);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 16, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	// Batch encoding of strided points, such as the positions of an interleaved vertex buffer
+	template <typename T>
+	void morton_encode(const vec_span<3, const T>& points, const aabb<T>& bounds, uint32_t* codes, const bool& parallel = false)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 10, lo, scale);
+
+		const T* base = points.data();
+		const size_t stride = points.component_stride();
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::morton_encode30_range(base, base + 1, base + 2, stride, lo, scale, begin, end, codes);
+		};
+
+		if (parallel)
+			support::parallel_for(points.size(), 1 << 16, kernel);
+		else
+			kernel(0, 0, points.size());
+	}
+
+	template <typename T>
+	void morton_encode63(const vec_span<3, const T>& points, const aabb<T>& bounds, uint64_t* codes, const bool& parallel = false)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 21, lo, scale);
+
+		const T* base = points.data();
+		const size_t stride = points.component_stride();
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::morton_encode63_range(base, base + 1, base + 2, stride, lo, scale, begin, end, codes);
+		};
+
+		if (parallel)
+			support::parallel_for(points.size(), 1 << 16, kernel);
+		else
+			kernel(0, 0, points.size());
+	}
+
+	// Batch encoding of SoA points
+	template <typename T>
+	void morton_encode(const T* x, const T* y, const T* z, const size_t& count, const aabb<T>& bounds, uint32_t* codes, const bool& parallel = false)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 10, lo, scale);
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::morton_encode30_range(x, y, z, size_t(1), lo, scale, begin, end, codes);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 16, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	void morton_encode63(const T* x, const T* y, const T* z, const size_t& count, const aabb<T>& bounds, uint64_t* codes, const bool& parallel = false)
+	{
+		T lo[3], scale[3];
+		support::morton_grid(bounds, 21, lo, scale);
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::morton_encode63_range(x, y, z, size_t(1), lo, scale, begin, end, codes);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 16, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	// Z-order permutation of a point set, order[i] is the index of the i-th point along the curve. Apply it with
+	// support::permute to the AoS array or to each SoA component (and any per-point attributes).
+	template <typename T>
+	void morton_order(const vec3<T>* points, const size_t& count, uint32_t* order, const bool& parallel = false)
+	{
+		std::vector<uint64_t> codes(count);
+
+		morton_encode63(points, count, aabb<T>::from_points(points, count), codes.data(), parallel);
+
+		for (size_t i = 0; i < count; ++i)
+			order[i] = static_cast<uint32_t>(i);
+
+		support::radix_sort(codes.data(), order, count, parallel);
+	}
+
+	template <typename T>
+	void morton_order(const vec_span<3, const T>& points, uint32_t* order, const bool& parallel = false)
+	{
+		std::vector<uint64_t> codes(points.size());
+
+		morton_encode63(points, aabb<T>::from_points(points), codes.data(), parallel);
+
+		for (size_t i = 0; i < points.size(); ++i)
+			order[i] = static_cast<uint32_t>(i);
+
+		support::radix_sort(codes.data(), order, points.size(), parallel);
+	}
+
+	template <typename T>
+	void morton_order(const T* x, const T* y, const T* z, const size_t& count, uint32_t* order, const bool& parallel = false)
+	{
+		aabb<T> bounds;
+
+		for (size_t i = 0; i < count; ++i)
+			bounds.expand(vec3<T>(x[i], y[i], z[i]));
+
+		std::vector<uint64_t> codes(count);
+
+		morton_encode63(x, y, z, count, bounds, codes.data(), parallel);
+
+		for (size_t i = 0; i < count; ++i)
+			order[i] = static_cast<uint32_t>(i);
+
+		support::radix_sort(codes.data(), order, count, parallel);
+	}
+}
+
+#endif
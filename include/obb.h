@@ -0,0 +1,202 @@
+#ifndef _RM_OBB_H
+#define _RM_OBB_H
+
+#include <cstdint>
+
+#include "vec3.h"
+#include "mat3.h"
+#include "aabb.h"
+#include "pca.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	// Oriented bounding box, the columns of 'axes' are its unit axes and 'extents' the half sizes along them.
+	template <typename T>
+	class obb
+	{
+	public:
+		// constructors
+		obb() : center(static_cast<T>(0)), axes(), extents(static_cast<T>(0)) {}
+		obb(const vec3<T>& center, const mat3<T>& axes, const vec3<T>& extents) : center(center), axes(axes), extents(extents) {}
+		explicit obb(const aabb<T>& box) : center(box.center()), axes(), extents(box.extents()) {}
+
+		// Utility functions
+		inline const vec3<T> axis(const size_t& index) const;
+		const vec3<T> corner(const size_t& index) const;
+		const T volume() const;
+		const T surface_area() const;
+		const bool contains(const vec3<T>& p) const;
+		const aabb<T> bounds() const;
+
+		// Static utility functions
+
+		// Box aligned with the principal axes of the points
+		static const obb<T> fit(const vec3<T>* points, const size_t& count, const bool& parallel = false);
+		static const obb<T> fit(const vec_span<3, const T>& points, const bool& parallel = false);
+
+		// One box per cluster, cluster i is points[offsets[i] .. offsets[i + 1])
+		static void fit(const vec3<T>* points, const uint32_t* offsets, const size_t& cluster_count, obb<T>* out, const bool& parallel = false);
+		static void fit(const vec_span<3, const T>& points, const uint32_t* offsets, const size_t& cluster_count, obb<T>* out, const bool& parallel = false);
+
+		friend std::ostream& operator<<(std::ostream& out, const obb<T>& b)
+		{
+			out << "OBB(" << b.center << ", " << b.axis(0) << ", " << b.axis(1) << ", " << b.axis(2) << ", " << b.extents << ")";
+
+			return out;
+		}
+
+		vec3<T> center;
+		mat3<T> axes;
+		vec3<T> extents;
+
+	private:
+		// P indexes like an array of vec3, a raw array or a span
+		template <typename P>
+		static const obb<T> fit(const P& points, const size_t& count, const mat3<T>& axes);
+	};
+
+	template <typename T>
+	inline const vec3<T> obb<T>::axis(const size_t& index) const
+	{
+		return axes.col(index);
+	}
+
+	// corner i takes the positive extent on axis k when bit k of i is set
+	template <typename T>
+	const vec3<T> obb<T>::corner(const size_t& index) const
+	{
+		vec3<T> tmp = center;
+
+		for (int k = 0; k < 3; ++k)
+			tmp += axis(k) * ((index >> k) & 1 ? extents.m_data[k] : -extents.m_data[k]);
+
+		return tmp;
+	}
+
+	template <typename T>
+	const T obb<T>::volume() const
+	{
+		return 8 * extents.x() * extents.y() * extents.z();
+	}
+
+	template <typename T>
+	const T obb<T>::surface_area() const
+	{
+		return 8 * (extents.x() * extents.y() + extents.y() * extents.z() + extents.z() * extents.x());
+	}
+
+	template <typename T>
+	const bool obb<T>::contains(const vec3<T>& p) const
+	{
+		vec3<T> d = p - center;
+
+		for (int k = 0; k < 3; ++k)
+			if (std::abs(d.dot(axis(k))) > extents.m_data[k])
+				return false;
+
+		return true;
+	}
+
+	template <typename T>
+	const aabb<T> obb<T>::bounds() const
+	{
+		// half size along each world axis is the extents projected through |axes|
+		vec3<T> half(static_cast<T>(0));
+
+		for (int row = 0; row < 3; ++row)
+			for (int k = 0; k < 3; ++k)
+				half.m_data[row] += std::abs(axes.at(row, k)) * extents.m_data[k];
+
+		return aabb<T>(center - half, center + half);
+	}
+
+	template <typename T>
+	template <typename P>
+	const obb<T> obb<T>::fit(const P& points, const size_t& count, const mat3<T>& axes)
+	{
+		if (count == 0)
+			return obb<T>();
+
+		vec3<T> a[3] = { axes.col(0), axes.col(1), axes.col(2) };
+		vec3<T> lo(std::numeric_limits<T>::max());
+		vec3<T> hi(std::numeric_limits<T>::lowest());
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				T d = points[i].dot(a[k]);
+
+				lo.m_data[k] = std::min(lo.m_data[k], d);
+				hi.m_data[k] = std::max(hi.m_data[k], d);
+			}
+		}
+
+		vec3<T> mid = (lo + hi) * static_cast<T>(0.5);
+
+		return obb<T>(a[0] * mid.x() + a[1] * mid.y() + a[2] * mid.z(), axes, (hi - lo) * static_cast<T>(0.5));
+	}
+
+	template <typename T>
+	const obb<T> obb<T>::fit(const vec3<T>* points, const size_t& count, const bool& parallel)
+	{
+		covariance3<T> c(points, count, parallel);
+
+		return fit(points, count, c.principal_axes().vectors);
+	}
+
+	template <typename T>
+	const obb<T> obb<T>::fit(const vec_span<3, const T>& points, const bool& parallel)
+	{
+		covariance3<T> c(points, parallel);
+
+		return fit(points, points.size(), c.principal_axes().vectors);
+	}
+
+	template <typename T>
+	void obb<T>::fit(const vec3<T>* points, const uint32_t* offsets, const size_t& cluster_count, obb<T>* out, const bool& parallel)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				const vec3<T>* first = points + offsets[i];
+				size_t count = offsets[i + 1] - offsets[i];
+
+				out[i] = fit(first, count, covariance3<T>(first, count).principal_axes().vectors);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(cluster_count, 64, kernel);
+		else
+			kernel(0, 0, cluster_count);
+	}
+
+	template <typename T>
+	void obb<T>::fit(const vec_span<3, const T>& points, const uint32_t* offsets, const size_t& cluster_count, obb<T>* out, const bool& parallel)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				vec_span<3, const T> cluster(points.data() + offsets[i] * points.component_stride(), offsets[i + 1] - offsets[i], points.stride());
+
+				out[i] = fit(cluster, cluster.size(), covariance3<T>(cluster).principal_axes().vectors);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(cluster_count, 64, kernel);
+		else
+			kernel(0, 0, cluster_count);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef obb<float> obbf;
+	typedef obb<double> obbd;
+#endif
+}
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef _RM_ORTHONORMALIZE_H
+#define _RM_ORTHONORMALIZE_H
+
+#include "mat3.h"
+#include "mat4.h"
+#include "span.h"
+#include "support/matrix.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Re-orthonormalizes a drifted rotation by modified Gram-Schmidt: the first column keeps its direction, the second is made
+	// orthogonal to it and the third to both. For mat4 only the upper 3x3 block is changed, the translation is kept.
+	template <typename T>
+	support::matrix<3, 3, T>& orthonormalize(support::matrix<3, 3, T>& m);
+
+	template <typename T>
+	support::matrix<4, 4, T>& orthonormalize(support::matrix<4, 4, T>& m);
+
+	// Cheaper symmetric correction R' = R (3 I - R^T R) / 2, one Newton step of the polar iteration towards the closest
+	// rotation. No column is preferred and there are no square roots, but only first order drift is removed, so it suits
+	// frequent correction of small drift rather than repair of a badly skewed matrix.
+	template <typename T>
+	support::matrix<3, 3, T>& orthonormalize_fast(support::matrix<3, 3, T>& m);
+
+	template <typename T>
+	support::matrix<4, 4, T>& orthonormalize_fast(support::matrix<4, 4, T>& m);
+
+	// Batch versions, in place, 8 matrices at a time when AVX2 is available
+	template <typename T>
+	void orthonormalize(support::matrix<3, 3, T>* m, const size_t& count, const bool& parallel = false);
+
+	template <typename T>
+	void orthonormalize(support::matrix<4, 4, T>* m, const size_t& count, const bool& parallel = false);
+
+	template <typename T>
+	void orthonormalize_fast(support::matrix<3, 3, T>* m, const size_t& count, const bool& parallel = false);
+
+	template <typename T>
+	void orthonormalize_fast(support::matrix<4, 4, T>* m, const size_t& count, const bool& parallel = false);
+
+	// Batch versions over strided matrices, such as the transforms of an instance buffer
+	template <typename T>
+	void orthonormalize(const mat_span<3, 3, T>& m, const bool& parallel = false);
+
+	template <typename T>
+	void orthonormalize(const mat_span<4, 4, T>& m, const bool& parallel = false);
+
+	template <typename T>
+	void orthonormalize_fast(const mat_span<3, 3, T>& m, const bool& parallel = false);
+
+	template <typename T>
+	void orthonormalize_fast(const mat_span<4, 4, T>& m, const bool& parallel = false);
+
+	namespace support
+	{
+		// Columns of a 3x3 block, c[row + 3 * col]. L is a scalar or a SIMD lane type.
+		template <typename L>
+		inline void gram_schmidt3(L(&c)[9])
+		{
+			L d = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+			L n = lane_rsqrt(d);
+
+			for (int k = 0; k < 3; ++k)
+				c[k] *= n;
+
+			d = c[0] * c[3] + c[1] * c[4] + c[2] * c[5];
+
+			for (int k = 0; k < 3; ++k)
+				c[3 + k] -= d * c[k];
+
+			n = lane_rsqrt(c[3] * c[3] + c[4] * c[4] + c[5] * c[5]);
+
+			for (int k = 0; k < 3; ++k)
+				c[3 + k] *= n;
+
+			// projections are removed one after the other from the updated column, that is what makes it modified
+			d = c[0] * c[6] + c[1] * c[7] + c[2] * c[8];
+
+			for (int k = 0; k < 3; ++k)
+				c[6 + k] -= d * c[k];
+
+			d = c[3] * c[6] + c[4] * c[7] + c[5] * c[8];
+
+			for (int k = 0; k < 3; ++k)
+				c[6 + k] -= d * c[3 + k];
+
+			n = lane_rsqrt(c[6] * c[6] + c[7] * c[7] + c[8] * c[8]);
+
+			for (int k = 0; k < 3; ++k)
+				c[6 + k] *= n;
+		}
+
+		template <typename L>
+		inline void polar_step3(L(&c)[9])
+		{
+			typedef typename lane_traits<L>::scalar scalar;
+
+			// S = R^T R is symmetric, s[i][j] = column i . column j
+			L s[3][3];
+
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = i; j < 3; ++j)
+				{
+					s[i][j] = c[3 * i] * c[3 * j] + c[3 * i + 1] * c[3 * j + 1] + c[3 * i + 2] * c[3 * j + 2];
+					s[j][i] = s[i][j];
+				}
+			}
+
+			const L three_halves(static_cast<scalar>(1.5));
+			const L half(static_cast<scalar>(0.5));
+
+			L r[9];
+
+			for (int col = 0; col < 3; ++col)
+				for (int row = 0; row < 3; ++row)
+					r[row + 3 * col] = three_halves * c[row + 3 * col] - half * (c[row] * s[0][col] + c[row + 3] * s[1][col] + c[row + 6] * s[2][col]);
+
+			for (int k = 0; k < 9; ++k)
+				c[k] = r[k];
+		}
+
+		// The upper 3x3 blocks of matrices whose element (row, col) is at data[i * stride + row + rows * col]
+		template <typename T>
+		inline void orthonormalize_range(T* data, const size_t& stride, const size_t& rows, const bool& fast, const size_t& begin, const size_t& end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				T* m = data + i * stride;
+				T c[9];
+
+				for (int col = 0; col < 3; ++col)
+					for (int row = 0; row < 3; ++row)
+						c[row + 3 * col] = m[row + rows * col];
+
+				if (fast)
+					polar_step3(c);
+				else
+					gram_schmidt3(c);
+
+				for (int col = 0; col < 3; ++col)
+					for (int row = 0; row < 3; ++row)
+						m[row + rows * col] = c[row + 3 * col];
+			}
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		inline void orthonormalize_range(float* data, const size_t& stride, const size_t& rows, const bool& fast, const size_t& begin, const size_t& end)
+		{
+			const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				float* m = data + i * stride;
+				float8 c[9];
+
+				for (int col = 0; col < 3; ++col)
+					for (int row = 0; row < 3; ++row)
+						c[row + 3 * col] = float8(_mm256_i32gather_ps(m + row + rows * col, offsets, 4));
+
+				if (fast)
+					polar_step3(c);
+				else
+					gram_schmidt3(c);
+
+				// AVX2 has no scatter
+				alignas(32) float lanes[9][8];
+
+				for (int e = 0; e < 9; ++e)
+					_mm256_store_ps(lanes[e], c[e].v);
+
+				for (int k = 0; k < 8; ++k)
+					for (int col = 0; col < 3; ++col)
+						for (int row = 0; row < 3; ++row)
+							m[k * stride + row + rows * col] = lanes[row + 3 * col][k];
+			}
+
+			orthonormalize_range<float>(data, stride, rows, fast, i, end);
+		}
+#endif
+
+		template <size_t N, typename T>
+		void orthonormalize_batch(const mat_span<N, N, T>& m, const bool& fast, const bool& parallel)
+		{
+			const size_t count = m.size();
+
+			if (count == 0)
+				return;
+
+			T* data = m.data();
+			const size_t stride = m.component_stride();
+			const size_t rows = N;
+
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				orthonormalize_range(data, stride, rows, fast, begin, end);
+			};
+
+			if (parallel)
+				parallel_for(count, 1 << 14, kernel);
+			else
+				kernel(0, 0, count);
+		}
+	}
+
+	template <typename T>
+	support::matrix<3, 3, T>& orthonormalize(support::matrix<3, 3, T>& m)
+	{
+		support::orthonormalize_range(m.m_data, 0, 3, false, 0, 1);
+
+		return m;
+	}
+
+	template <typename T>
+	support::matrix<4, 4, T>& orthonormalize(support::matrix<4, 4, T>& m)
+	{
+		support::orthonormalize_range(m.m_data, 0, 4, false, 0, 1);
+
+		return m;
+	}
+
+	template <typename T>
+	support::matrix<3, 3, T>& orthonormalize_fast(support::matrix<3, 3, T>& m)
+	{
+		support::orthonormalize_range(m.m_data, 0, 3, true, 0, 1);
+
+		return m;
+	}
+
+	template <typename T>
+	support::matrix<4, 4, T>& orthonormalize_fast(support::matrix<4, 4, T>& m)
+	{
+		support::orthonormalize_range(m.m_data, 0, 4, true, 0, 1);
+
+		return m;
+	}
+
+	template <typename T>
+	void orthonormalize(support::matrix<3, 3, T>* m, const size_t& count, const bool& parallel)
+	{
+		support::orthonormalize_batch(mat_span<3, 3, T>(m, count), false, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize(support::matrix<4, 4, T>* m, const size_t& count, const bool& parallel)
+	{
+		support::orthonormalize_batch(mat_span<4, 4, T>(m, count), false, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize_fast(support::matrix<3, 3, T>* m, const size_t& count, const bool& parallel)
+	{
+		support::orthonormalize_batch(mat_span<3, 3, T>(m, count), true, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize_fast(support::matrix<4, 4, T>* m, const size_t& count, const bool& parallel)
+	{
+		support::orthonormalize_batch(mat_span<4, 4, T>(m, count), true, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize(const mat_span<3, 3, T>& m, const bool& parallel)
+	{
+		support::orthonormalize_batch(m, false, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize(const mat_span<4, 4, T>& m, const bool& parallel)
+	{
+		support::orthonormalize_batch(m, false, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize_fast(const mat_span<3, 3, T>& m, const bool& parallel)
+	{
+		support::orthonormalize_batch(m, true, parallel);
+	}
+
+	template <typename T>
+	void orthonormalize_fast(const mat_span<4, 4, T>& m, const bool& parallel)
+	{
+		support::orthonormalize_batch(m, true, parallel);
+	}
+}
+
+#endif
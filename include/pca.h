@@ -0,0 +1,517 @@
+#ifndef _RM_PCA_H
+#define _RM_PCA_H
+
+#include <algorithm>
+#include <vector>
+
+#include "vec3.h"
+#include "mat3.h"
+#include "span.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Eigen decomposition of a symmetric 3x3 matrix by cyclic Jacobi rotations. Eigenvalues are sorted in descending
+	// order, the eigenvectors are the matching columns of 'vectors' and form a right handed rotation.
+	template <typename T>
+	class symmetric_eigen3
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static const int MAX_SWEEPS = 16;
+
+		// constructors
+		symmetric_eigen3() : values(static_cast<T>(0)), vectors() {}
+		explicit symmetric_eigen3(const mat3<T>& m);
+
+		// Accessors
+		inline const vec3<T> vector(const size_t& index) const;
+
+		// Static utility functions
+		static void compute(const mat3<T>* matrices, const size_t& count, symmetric_eigen3<T>* out, const bool& parallel = false);
+		static void compute(const mat_span<3, 3, const T>& matrices, symmetric_eigen3<T>* out, const bool& parallel = false);
+
+		vec3<T> values;
+		mat3<T> vectors;
+	};
+
+	namespace support
+	{
+		// Wider type the covariance sums are kept in
+		template <typename T>
+		struct covariance_accumulator
+		{
+			typedef double type;
+		};
+
+		template <>
+		struct covariance_accumulator<long double>
+		{
+			typedef long double type;
+		};
+	}
+
+	// Running mean and covariance of a (weighted) point set. Blocks of points are summed relative to their first point
+	// and merged with Chan's formula, so the result stays accurate for large sets far from the origin.
+	template <typename T>
+	class covariance3
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		typedef typename support::covariance_accumulator<T>::type accumulator_type;
+
+		static const size_t BLOCK_SIZE = 1024;
+
+		// constructors
+		covariance3() : m_weight(0), m_mean(), m_scatter() {}
+		covariance3(const vec3<T>* points, const size_t& count, const bool& parallel = false);
+		explicit covariance3(const vec_span<3, const T>& points, const bool& parallel = false);
+
+		// Modifiers
+		covariance3<T>& add(const vec3<T>& p, const T& weight = 1);
+		covariance3<T>& add(const vec3<T>* points, const size_t& count, const bool& parallel = false);
+		covariance3<T>& add(const vec_span<3, const T>& points, const bool& parallel = false);
+		covariance3<T>& add(const T* x, const T* y, const T* z, const size_t& count, const bool& parallel = false);
+		covariance3<T>& merge(const covariance3<T>& other);
+
+		// Accessors
+		inline const accumulator_type& weight() const;
+		const vec3<T> mean() const;
+
+		// Population covariance (divided by the total weight)
+		const mat3<T> covariance() const;
+
+		// Principal axes, the eigenvectors of the covariance by decreasing variance
+		const symmetric_eigen3<T> principal_axes() const;
+
+	private:
+		void add_block(const T* x, const T* y, const T* z, const size_t& stride, const size_t& begin, const size_t& end);
+		covariance3<T>& add_strided(const T* x, const T* y, const T* z, const size_t& stride, const size_t& count, const bool& parallel);
+
+		accumulator_type m_weight;
+		accumulator_type m_mean[3];
+
+		// sum of weighted outer products of deviations from the mean, xx xy xz yy yz zz
+		accumulator_type m_scatter[6];
+	};
+
+	template <typename T>
+	symmetric_eigen3<T>::symmetric_eigen3(const mat3<T>& m)
+	{
+		T a[3][3];
+		T v[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+				a[i][j] = (m.at(i, j) + m.at(j, i)) * static_cast<T>(0.5);
+
+		// credit Press et al., "Numerical Recipes", jacobi
+		for (int sweep = 0; sweep < MAX_SWEEPS; ++sweep)
+		{
+			T off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+			T diag = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+
+			if (off <= std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon() * diag || off == 0)
+				break;
+
+			for (int p = 0; p < 2; ++p)
+			{
+				for (int q = p + 1; q < 3; ++q)
+				{
+					T apq = a[p][q];
+
+					if (apq == 0)
+						continue;
+
+					T theta = (a[q][q] - a[p][p]) / (2 * apq);
+					T t = (theta >= 0 ? static_cast<T>(1) : static_cast<T>(-1)) / (std::abs(theta) + sqrt(theta * theta + 1));
+					T c = 1 / sqrt(t * t + 1);
+					T s = t * c;
+
+					for (int k = 0; k < 3; ++k)
+					{
+						if (k == p || k == q)
+							continue;
+
+						T akp = a[k][p];
+						T akq = a[k][q];
+
+						a[k][p] = a[p][k] = c * akp - s * akq;
+						a[k][q] = a[q][k] = s * akp + c * akq;
+					}
+
+					a[p][p] -= t * apq;
+					a[q][q] += t * apq;
+					a[p][q] = a[q][p] = 0;
+
+					for (int k = 0; k < 3; ++k)
+					{
+						T vkp = v[k][p];
+						T vkq = v[k][q];
+
+						v[k][p] = c * vkp - s * vkq;
+						v[k][q] = s * vkp + c * vkq;
+					}
+				}
+			}
+		}
+
+		int order[3] = { 0, 1, 2 };
+
+		std::sort(order, order + 3, [&](const int& i, const int& j) { return a[i][i] > a[j][j]; });
+
+		for (int i = 0; i < 3; ++i)
+		{
+			values.m_data[i] = a[order[i]][order[i]];
+
+			for (int k = 0; k < 3; ++k)
+				vectors.at(k, i) = v[k][order[i]];
+		}
+
+		// keep the basis right handed so it can be used as a rotation
+		vec3<T> third = vec3<T>::cross(vector(0), vector(1));
+
+		for (int k = 0; k < 3; ++k)
+			vectors.at(k, 2) = third.m_data[k];
+	}
+
+	template <typename T>
+	inline const vec3<T> symmetric_eigen3<T>::vector(const size_t& index) const
+	{
+		return vectors.col(index);
+	}
+
+	namespace support
+	{
+		// M indexes like an array of mat3, a raw array or a span
+		template <typename T, typename M>
+		void symmetric_eigen3_batch(const M& matrices, const size_t& count, symmetric_eigen3<T>* out, const bool& parallel)
+		{
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					out[i] = symmetric_eigen3<T>(matrices[i]);
+			};
+
+			if (parallel)
+				parallel_for(count, 1 << 10, kernel);
+			else
+				kernel(0, 0, count);
+		}
+	}
+
+	template <typename T>
+	void symmetric_eigen3<T>::compute(const mat3<T>* matrices, const size_t& count, symmetric_eigen3<T>* out, const bool& parallel)
+	{
+		support::symmetric_eigen3_batch(matrices, count, out, parallel);
+	}
+
+	template <typename T>
+	void symmetric_eigen3<T>::compute(const mat_span<3, 3, const T>& matrices, symmetric_eigen3<T>* out, const bool& parallel)
+	{
+		support::symmetric_eigen3_batch(matrices, matrices.size(), out, parallel);
+	}
+
+	namespace support
+	{
+		// Sums over [begin, end) of strided coordinates, relative to the first point: s = sum(d), q = sum(d d^T) as xx xy xz yy yz zz
+		template <typename T>
+		inline void covariance_sums(const T* x, const T* y, const T* z, const size_t& stride, const size_t& begin, const size_t& end, const T(&origin)[3], T(&s)[3], T(&q)[6])
+		{
+			for (int i = 0; i < 3; ++i)
+				s[i] = 0;
+
+			for (int i = 0; i < 6; ++i)
+				q[i] = 0;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				T dx = x[i * stride] - origin[0];
+				T dy = y[i * stride] - origin[1];
+				T dz = z[i * stride] - origin[2];
+
+				s[0] += dx;
+				s[1] += dy;
+				s[2] += dz;
+
+				q[0] += dx * dx;
+				q[1] += dx * dy;
+				q[2] += dx * dz;
+				q[3] += dy * dy;
+				q[4] += dy * dz;
+				q[5] += dz * dz;
+			}
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		inline void covariance_sums(const float* x, const float* y, const float* z, const size_t& stride, const size_t& begin, const size_t& end, const float(&origin)[3], float(&s)[3], float(&q)[6])
+		{
+			const __m256 ox = _mm256_set1_ps(origin[0]), oy = _mm256_set1_ps(origin[1]), oz = _mm256_set1_ps(origin[2]);
+			const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+
+			__m256 sx = _mm256_setzero_ps(), sy = sx, sz = sx;
+			__m256 qxx = sx, qxy = sx, qxz = sx, qyy = sx, qyz = sx, qzz = sx;
+
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 dx, dy, dz;
+
+				if (stride == 1)
+				{
+					dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), ox);
+					dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), oy);
+					dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), oz);
+				}
+				else
+				{
+					dx = _mm256_sub_ps(_mm256_i32gather_ps(x + i * stride, offsets, 4), ox);
+					dy = _mm256_sub_ps(_mm256_i32gather_ps(y + i * stride, offsets, 4), oy);
+					dz = _mm256_sub_ps(_mm256_i32gather_ps(z + i * stride, offsets, 4), oz);
+				}
+
+				sx = _mm256_add_ps(sx, dx);
+				sy = _mm256_add_ps(sy, dy);
+				sz = _mm256_add_ps(sz, dz);
+
+				qxx = mm256_fmadd(dx, dx, qxx);
+				qxy = mm256_fmadd(dx, dy, qxy);
+				qxz = mm256_fmadd(dx, dz, qxz);
+				qyy = mm256_fmadd(dy, dy, qyy);
+				qyz = mm256_fmadd(dy, dz, qyz);
+				qzz = mm256_fmadd(dz, dz, qzz);
+			}
+
+			float ts[3], tq[6];
+			covariance_sums<float>(x, y, z, stride, i, end, origin, ts, tq);
+
+			float sums[8];
+			lane_sum4(float8(sx), float8(sy), float8(sz), float8(qxx), sums);
+			lane_sum4(float8(qxy), float8(qxz), float8(qyy), float8(qyz), sums + 4);
+
+			for (int k = 0; k < 3; ++k)
+				s[k] = sums[k] + ts[k];
+
+			for (int k = 0; k < 5; ++k)
+				q[k] = sums[3 + k] + tq[k];
+
+			q[5] = lane_sum(float8(qzz)) + tq[5];
+		}
+#endif
+	}
+
+	template <typename T>
+	covariance3<T>::covariance3(const vec3<T>* points, const size_t& count, const bool& parallel) : m_weight(0), m_mean(), m_scatter()
+	{
+		add(points, count, parallel);
+	}
+
+	template <typename T>
+	covariance3<T>::covariance3(const vec_span<3, const T>& points, const bool& parallel) : m_weight(0), m_mean(), m_scatter()
+	{
+		add(points, parallel);
+	}
+
+	// credit Welford, weighted incremental update
+	template <typename T>
+	covariance3<T>& covariance3<T>::add(const vec3<T>& p, const T& weight)
+	{
+		if (weight <= 0)
+			return *this;
+
+		accumulator_type total = m_weight + weight;
+		accumulator_type d[3];
+
+		for (int i = 0; i < 3; ++i)
+			d[i] = static_cast<accumulator_type>(p.m_data[i]) - m_mean[i];
+
+		accumulator_type f = static_cast<accumulator_type>(weight) * m_weight / total;
+
+		m_scatter[0] += f * d[0] * d[0];
+		m_scatter[1] += f * d[0] * d[1];
+		m_scatter[2] += f * d[0] * d[2];
+		m_scatter[3] += f * d[1] * d[1];
+		m_scatter[4] += f * d[1] * d[2];
+		m_scatter[5] += f * d[2] * d[2];
+
+		for (int i = 0; i < 3; ++i)
+			m_mean[i] += d[i] * weight / total;
+
+		m_weight = total;
+
+		return *this;
+	}
+
+	template <typename T>
+	covariance3<T>& covariance3<T>::add(const vec3<T>* points, const size_t& count, const bool& parallel)
+	{
+		static_assert(sizeof(vec3<T>) % sizeof(T) == 0, "vec3 must be a whole number of components");
+
+		if (count == 0)
+			return *this;
+
+		const T* base = points->m_data;
+
+		return add_strided(base, base + 1, base + 2, sizeof(vec3<T>) / sizeof(T), count, parallel);
+	}
+
+	template <typename T>
+	covariance3<T>& covariance3<T>::add(const vec_span<3, const T>& points, const bool& parallel)
+	{
+		if (points.empty())
+			return *this;
+
+		const T* base = points.data();
+
+		return add_strided(base, base + 1, base + 2, points.component_stride(), points.size(), parallel);
+	}
+
+	template <typename T>
+	covariance3<T>& covariance3<T>::add(const T* x, const T* y, const T* z, const size_t& count, const bool& parallel)
+	{
+		return add_strided(x, y, z, 1, count, parallel);
+	}
+
+	template <typename T>
+	covariance3<T>& covariance3<T>::add_strided(const T* x, const T* y, const T* z, const size_t& stride, const size_t& count, const bool& parallel)
+	{
+		if (!parallel)
+		{
+			for (size_t i = 0; i < count; i += BLOCK_SIZE)
+				add_block(x, y, z, stride, i, std::min(count, i + BLOCK_SIZE));
+
+			return *this;
+		}
+
+		std::vector<covariance3<T>> partial(support::parallel_chunks(count, 1 << 16));
+
+		support::parallel_for(count, 1 << 16, [&](size_t chunk, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i += BLOCK_SIZE)
+				partial[chunk].add_block(x, y, z, stride, i, std::min(end, i + BLOCK_SIZE));
+		});
+
+		for (const covariance3<T>& p : partial)
+			merge(p);
+
+		return *this;
+	}
+
+	template <typename T>
+	void covariance3<T>::add_block(const T* x, const T* y, const T* z, const size_t& stride, const size_t& begin, const size_t& end)
+	{
+		// sums relative to the block's first point stay small, the block is then merged as a whole
+		T origin[3] = { x[begin * stride], y[begin * stride], z[begin * stride] };
+		T s[3], q[6];
+
+		support::covariance_sums(x, y, z, stride, begin, end, origin, s, q);
+
+		covariance3<T> block;
+
+		accumulator_type n = static_cast<accumulator_type>(end - begin);
+		accumulator_type mean[3];
+
+		for (int i = 0; i < 3; ++i)
+			mean[i] = static_cast<accumulator_type>(s[i]) / n;
+
+		block.m_weight = n;
+
+		for (int i = 0; i < 3; ++i)
+			block.m_mean[i] = static_cast<accumulator_type>(origin[i]) + mean[i];
+
+		block.m_scatter[0] = q[0] - n * mean[0] * mean[0];
+		block.m_scatter[1] = q[1] - n * mean[0] * mean[1];
+		block.m_scatter[2] = q[2] - n * mean[0] * mean[2];
+		block.m_scatter[3] = q[3] - n * mean[1] * mean[1];
+		block.m_scatter[4] = q[4] - n * mean[1] * mean[2];
+		block.m_scatter[5] = q[5] - n * mean[2] * mean[2];
+
+		merge(block);
+	}
+
+	// credit Chan, Golub & LeVeque, "Updating Formulae and a Pairwise Algorithm for Computing Sample Variances"
+	template <typename T>
+	covariance3<T>& covariance3<T>::merge(const covariance3<T>& other)
+	{
+		if (other.m_weight <= 0)
+			return *this;
+
+		if (m_weight <= 0)
+		{
+			*this = other;
+			return *this;
+		}
+
+		accumulator_type total = m_weight + other.m_weight;
+		accumulator_type f = m_weight * other.m_weight / total;
+		accumulator_type d[3];
+
+		for (int i = 0; i < 3; ++i)
+			d[i] = other.m_mean[i] - m_mean[i];
+
+		m_scatter[0] += other.m_scatter[0] + f * d[0] * d[0];
+		m_scatter[1] += other.m_scatter[1] + f * d[0] * d[1];
+		m_scatter[2] += other.m_scatter[2] + f * d[0] * d[2];
+		m_scatter[3] += other.m_scatter[3] + f * d[1] * d[1];
+		m_scatter[4] += other.m_scatter[4] + f * d[1] * d[2];
+		m_scatter[5] += other.m_scatter[5] + f * d[2] * d[2];
+
+		for (int i = 0; i < 3; ++i)
+			m_mean[i] += d[i] * other.m_weight / total;
+
+		m_weight = total;
+
+		return *this;
+	}
+
+	template <typename T>
+	inline const typename covariance3<T>::accumulator_type& covariance3<T>::weight() const
+	{
+		return m_weight;
+	}
+
+	template <typename T>
+	const vec3<T> covariance3<T>::mean() const
+	{
+		return vec3<T>(static_cast<T>(m_mean[0]), static_cast<T>(m_mean[1]), static_cast<T>(m_mean[2]));
+	}
+
+	template <typename T>
+	const mat3<T> covariance3<T>::covariance() const
+	{
+		mat3<T> tmp(static_cast<T>(0));
+
+		if (m_weight <= 0)
+			return tmp;
+
+		static const int index[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+
+		for (int row = 0; row < 3; ++row)
+			for (int col = 0; col < 3; ++col)
+				tmp.at(row, col) = static_cast<T>(m_scatter[index[row][col]] / m_weight);
+
+		return tmp;
+	}
+
+	template <typename T>
+	const symmetric_eigen3<T> covariance3<T>::principal_axes() const
+	{
+		return symmetric_eigen3<T>(covariance());
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef symmetric_eigen3<float> symmetric_eigen3f;
+	typedef symmetric_eigen3<double> symmetric_eigen3d;
+
+	typedef covariance3<float> covariance3f;
+	typedef covariance3<double> covariance3d;
+#endif
+}
+
+#endif
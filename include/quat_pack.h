@@ -0,0 +1,577 @@
+#ifndef _RM_QUAT_PACK_H
+#define _RM_QUAT_PACK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "quat.h"
+#include "span.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Quantized unit quaternions for replication and animation storage.
+	//
+	// packed_quat32 and packed_quat48 are "smallest three": the largest magnitude component is dropped, its sign
+	// folded into the other three (q and -q are the same rotation) and it is rebuilt from the unit length on decode.
+	// The other three lie in [-1 / sqrt(2), 1 / sqrt(2)] and are stored with 10 or 15 bits each behind a 2 bit index.
+	// packed_quat64 keeps all four components as snorm16 and renormalizes on decode.
+	//
+	// Encoding rounds to nearest even in float whatever the path, so the SSE batch and the scalar code give the same
+	// bits for the same input on every host. max_angle() is a bound on the rotation angle between a unit quaternion
+	// and its decoded copy: the step over two per stored component, doubled by rebuilding or renormalizing, and
+	// doubled again from quaternion to rotation angle.
+	struct packed_quat32
+	{
+		// index of the dropped component in bits 30 - 31, then the others from the lowest index at bits 20, 10 and 0
+		uint32_t bits;
+
+		static const int COMPONENT_BITS = 10;
+
+		static constexpr float max_angle()
+		{
+			return static_cast<float>(2.0 * 1.73205080756887729353 * 1.41421356237309504880 / 1023.0);
+		}
+	};
+
+	struct packed_quat48
+	{
+		// the same layout as packed_quat32 with 15 bit components, index at bits 45 - 46, as three 16 bit words
+		// from the lowest
+		uint16_t bits[3];
+
+		static const int COMPONENT_BITS = 15;
+
+		static constexpr float max_angle()
+		{
+			return static_cast<float>(2.0 * 1.73205080756887729353 * 1.41421356237309504880 / 32767.0);
+		}
+	};
+
+	struct packed_quat64
+	{
+		// x y z w as round(c * 32767)
+		int16_t bits[4];
+
+		static const int COMPONENT_BITS = 16;
+
+		static constexpr float max_angle()
+		{
+			return static_cast<float>(4.0 / 32767.0);
+		}
+	};
+
+	namespace support
+	{
+		// the smallest three quantizer with B bits a component, [-1 / sqrt(2), 1 / sqrt(2)] onto [0, 2^B - 1]
+		template <int B>
+		struct smallest_three
+		{
+			static const int32_t MAX_CODE = (1 << B) - 1;
+
+			static float range()
+			{
+				return static_cast<float>(0.70710678118654752440);
+			}
+
+			static float encode_scale()
+			{
+				return static_cast<float>(MAX_CODE * 0.70710678118654752440);
+			}
+
+			static float decode_step()
+			{
+				return static_cast<float>(1.41421356237309504880 / MAX_CODE);
+			}
+
+			static float half_code()
+			{
+				return MAX_CODE * 0.5f;
+			}
+		};
+
+		// The index of the largest magnitude component, the first on ties, and the codes of the other three
+		template <int B>
+		inline uint32_t smallest_three_encode(const float* c, uint32_t* codes)
+		{
+			typedef smallest_three<B> st;
+
+			uint32_t largest = 0;
+			float m = std::fabs(c[0]);
+
+			for (uint32_t k = 1; k < 4; ++k)
+			{
+				float a = std::fabs(c[k]);
+
+				if (a > m)
+				{
+					m = a;
+					largest = k;
+				}
+			}
+
+			const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+			const float scale = st::encode_scale();
+			const float top = static_cast<float>(st::MAX_CODE);
+
+			for (uint32_t k = 0, j = 0; k < 4; ++k)
+			{
+				if (k == largest)
+					continue;
+
+				// add then multiply, so there is nothing for the compiler to contract into an fma
+				float x = (c[k] * sign + st::range()) * scale;
+				x = x < top ? x : top;
+				x = x > 0.0f ? x : 0.0f;
+
+				codes[j++] = static_cast<uint32_t>(round_nearest_even(x));
+			}
+
+			return largest;
+		}
+
+		template <int B>
+		inline void smallest_three_decode(const uint32_t& largest, const uint32_t* codes, float* c)
+		{
+			typedef smallest_three<B> st;
+
+			float v[3];
+
+			for (int j = 0; j < 3; ++j)
+				v[j] = (static_cast<float>(codes[j]) - st::half_code()) * st::decode_step();
+
+			float d = 1.0f - (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+			d = std::sqrt(d > 0.0f ? d : 0.0f);
+
+			for (uint32_t k = 0, j = 0; k < 4; ++k)
+				c[k] = k == largest ? d : v[j++];
+		}
+
+		inline void quat_pack_one(const float* c, packed_quat32& p)
+		{
+			uint32_t codes[3];
+			uint32_t largest = smallest_three_encode<10>(c, codes);
+
+			p.bits = largest << 30 | codes[0] << 20 | codes[1] << 10 | codes[2];
+		}
+
+		inline void quat_unpack_one(const packed_quat32& p, float* c)
+		{
+			uint32_t codes[3] = { (p.bits >> 20) & 0x3ffu, (p.bits >> 10) & 0x3ffu, p.bits & 0x3ffu };
+
+			smallest_three_decode<10>(p.bits >> 30, codes, c);
+		}
+
+		inline void quat_pack_codes48(const uint32_t& largest, const uint32_t* codes, packed_quat48& p)
+		{
+			uint64_t v = uint64_t(largest) << 45 | uint64_t(codes[0]) << 30 | uint64_t(codes[1]) << 15 | codes[2];
+
+			p.bits[0] = static_cast<uint16_t>(v);
+			p.bits[1] = static_cast<uint16_t>(v >> 16);
+			p.bits[2] = static_cast<uint16_t>(v >> 32);
+		}
+
+		inline void quat_pack_one(const float* c, packed_quat48& p)
+		{
+			uint32_t codes[3];
+			uint32_t largest = smallest_three_encode<15>(c, codes);
+
+			quat_pack_codes48(largest, codes, p);
+		}
+
+		inline void quat_unpack_one(const packed_quat48& p, float* c)
+		{
+			uint64_t v = uint64_t(p.bits[0]) | uint64_t(p.bits[1]) << 16 | uint64_t(p.bits[2]) << 32;
+			uint32_t codes[3] = { uint32_t(v >> 30) & 0x7fffu, uint32_t(v >> 15) & 0x7fffu, uint32_t(v) & 0x7fffu };
+
+			smallest_three_decode<15>(uint32_t(v >> 45) & 3u, codes, c);
+		}
+
+		inline void quat_pack_one(const float* c, packed_quat64& p)
+		{
+			for (int k = 0; k < 4; ++k)
+			{
+				float x = c[k] * 32767.0f;
+				x = x < 32767.0f ? x : 32767.0f;
+				x = x > -32767.0f ? x : -32767.0f;
+
+				p.bits[k] = static_cast<int16_t>(round_nearest_even(x));
+			}
+		}
+
+		inline void quat_unpack_one(const packed_quat64& p, float* c)
+		{
+			const float step = 1.0f / 32767.0f;
+
+			for (int k = 0; k < 4; ++k)
+				c[k] = static_cast<float>(p.bits[k]) * step;
+
+			// summed in the pairs the SSE path sums in
+			float n = std::sqrt((c[0] * c[0] + c[1] * c[1]) + (c[2] * c[2] + c[3] * c[3]));
+
+			for (int k = 0; k < 4; ++k)
+				c[k] = c[k] / n;
+		}
+
+		template <typename T, typename P>
+		inline void quat_pack_range(const quat<T>* q, P* out, const size_t& begin, const size_t& end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				float c[4] = { static_cast<float>(q[i].m_data[0]), static_cast<float>(q[i].m_data[1]), static_cast<float>(q[i].m_data[2]), static_cast<float>(q[i].m_data[3]) };
+
+				quat_pack_one(c, out[i]);
+			}
+		}
+
+		template <typename T, typename P>
+		inline void quat_unpack_range(const P* in, quat<T>* q, const size_t& begin, const size_t& end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				float c[4];
+				quat_unpack_one(in[i], c);
+
+				for (int k = 0; k < 4; ++k)
+					q[i].m_data[k] = static_cast<T>(c[k]);
+			}
+		}
+
+#ifdef _REACT_SIMD_SSE2
+		// Four quaternions at a time, one per lane. The index of the largest magnitude component and the three codes,
+		// lane for lane the values smallest_three_encode gives.
+		template <int B>
+		inline void smallest_three_encode4(const float* q, __m128i& largest, __m128i& a, __m128i& b, __m128i& c)
+		{
+			typedef smallest_three<B> st;
+
+			__m128 x = _mm_loadu_ps(q);
+			__m128 y = _mm_loadu_ps(q + 4);
+			__m128 z = _mm_loadu_ps(q + 8);
+			__m128 w = _mm_loadu_ps(q + 12);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			const __m128 sign_bit = _mm_set1_ps(-0.0f);
+			__m128 ax = _mm_andnot_ps(sign_bit, x);
+			__m128 ay = _mm_andnot_ps(sign_bit, y);
+			__m128 az = _mm_andnot_ps(sign_bit, z);
+			__m128 aw = _mm_andnot_ps(sign_bit, w);
+			__m128 m = _mm_max_ps(_mm_max_ps(ax, ay), _mm_max_ps(az, aw));
+
+			// the first component equal to the maximum, as the scalar scan picks it
+			__m128 is0 = _mm_cmpeq_ps(ax, m);
+			__m128 is1 = _mm_andnot_ps(is0, _mm_cmpeq_ps(ay, m));
+			__m128 before2 = _mm_or_ps(is0, is1);
+			__m128 is2 = _mm_andnot_ps(before2, _mm_cmpeq_ps(az, m));
+			__m128 is3 = _mm_andnot_ps(_mm_or_ps(before2, is2), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+			__m128 top = _mm_or_ps(_mm_or_ps(_mm_and_ps(is0, x), _mm_and_ps(is1, y)), _mm_or_ps(_mm_and_ps(is2, z), _mm_and_ps(is3, w)));
+			__m128 flip = _mm_and_ps(top, sign_bit);
+
+			x = _mm_xor_ps(x, flip);
+			y = _mm_xor_ps(y, flip);
+			z = _mm_xor_ps(z, flip);
+			w = _mm_xor_ps(w, flip);
+
+			largest = _mm_or_si128(_mm_and_si128(_mm_castps_si128(is1), _mm_set1_epi32(1)), _mm_or_si128(_mm_and_si128(_mm_castps_si128(is2), _mm_set1_epi32(2)), _mm_and_si128(_mm_castps_si128(is3), _mm_set1_epi32(3))));
+
+			// the three kept, lowest index first
+			__m128 va = _mm_or_ps(_mm_and_ps(is0, y), _mm_andnot_ps(is0, x));
+			__m128 vb = _mm_or_ps(_mm_and_ps(before2, z), _mm_andnot_ps(before2, y));
+			__m128 vc = _mm_or_ps(_mm_and_ps(is3, z), _mm_andnot_ps(is3, w));
+
+			const __m128 range = _mm_set1_ps(st::range());
+			const __m128 scale = _mm_set1_ps(st::encode_scale());
+			const __m128 max_code = _mm_set1_ps(static_cast<float>(st::MAX_CODE));
+			const __m128 zero = _mm_setzero_ps();
+
+			a = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_add_ps(va, range), scale), max_code), zero));
+			b = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_add_ps(vb, range), scale), max_code), zero));
+			c = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_add_ps(vc, range), scale), max_code), zero));
+		}
+
+		template <int B>
+		inline void smallest_three_decode4(const __m128i& largest, const __m128i& a, const __m128i& b, const __m128i& c, float* q)
+		{
+			typedef smallest_three<B> st;
+
+			const __m128 half = _mm_set1_ps(st::half_code());
+			const __m128 step = _mm_set1_ps(st::decode_step());
+
+			__m128 va = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(a), half), step);
+			__m128 vb = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(b), half), step);
+			__m128 vc = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(c), half), step);
+
+			__m128 d = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_add_ps(_mm_add_ps(_mm_mul_ps(va, va), _mm_mul_ps(vb, vb)), _mm_mul_ps(vc, vc)));
+			d = _mm_sqrt_ps(_mm_max_ps(d, _mm_setzero_ps()));
+
+			__m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_setzero_si128()));
+			__m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(1)));
+			__m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(2)));
+			__m128 is3 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(3)));
+
+			// largest 0: d a b c, 1: a d b c, 2: a b d c, 3: a b c d
+			__m128 x = _mm_or_ps(_mm_and_ps(is0, d), _mm_andnot_ps(is0, va));
+			__m128 y = _mm_or_ps(_mm_and_ps(is0, va), _mm_or_ps(_mm_and_ps(is1, d), _mm_andnot_ps(_mm_or_ps(is0, is1), vb)));
+			__m128 z = _mm_or_ps(_mm_and_ps(is3, vc), _mm_or_ps(_mm_and_ps(is2, d), _mm_andnot_ps(_mm_or_ps(is2, is3), vb)));
+			__m128 w = _mm_or_ps(_mm_and_ps(is3, d), _mm_andnot_ps(is3, vc));
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			_mm_storeu_ps(q, x);
+			_mm_storeu_ps(q + 4, y);
+			_mm_storeu_ps(q + 8, z);
+			_mm_storeu_ps(q + 12, w);
+		}
+
+		inline void quat_pack_range(const quat<float>* q, packed_quat32* out, const size_t& begin, const size_t& end)
+		{
+			size_t i = begin;
+
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128i largest, a, b, c;
+				smallest_three_encode4<10>(q[i].m_data, largest, a, b, c);
+
+				__m128i bits = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(largest, 30), _mm_slli_epi32(a, 20)), _mm_or_si128(_mm_slli_epi32(b, 10), c));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bits);
+			}
+
+			quat_pack_range<float, packed_quat32>(q, out, i, end);
+		}
+
+		inline void quat_unpack_range(const packed_quat32* in, quat<float>* q, const size_t& begin, const size_t& end)
+		{
+			const __m128i mask = _mm_set1_epi32(0x3ff);
+			size_t i = begin;
+
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+				smallest_three_decode4<10>(_mm_srli_epi32(bits, 30), _mm_and_si128(_mm_srli_epi32(bits, 20), mask), _mm_and_si128(_mm_srli_epi32(bits, 10), mask), _mm_and_si128(bits, mask), q[i].m_data);
+			}
+
+			quat_unpack_range<float, packed_quat32>(in, q, i, end);
+		}
+
+		// six byte elements do not suit vector stores, the codes are made four at a time and packed one by one
+		inline void quat_pack_range(const quat<float>* q, packed_quat48* out, const size_t& begin, const size_t& end)
+		{
+			size_t i = begin;
+
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128i largest, a, b, c;
+				smallest_three_encode4<15>(q[i].m_data, largest, a, b, c);
+
+				alignas(16) uint32_t codes[4][4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(codes[0]), largest);
+				_mm_store_si128(reinterpret_cast<__m128i*>(codes[1]), a);
+				_mm_store_si128(reinterpret_cast<__m128i*>(codes[2]), b);
+				_mm_store_si128(reinterpret_cast<__m128i*>(codes[3]), c);
+
+				for (int k = 0; k < 4; ++k)
+				{
+					uint32_t kept[3] = { codes[1][k], codes[2][k], codes[3][k] };
+
+					quat_pack_codes48(codes[0][k], kept, out[i + k]);
+				}
+			}
+
+			quat_pack_range<float, packed_quat48>(q, out, i, end);
+		}
+
+		inline void quat_unpack_range(const packed_quat48* in, quat<float>* q, const size_t& begin, const size_t& end)
+		{
+			size_t i = begin;
+
+			for (; i + 4 <= end; i += 4)
+			{
+				// the 47 bits of each element into a 64 bit lane, then the fields split out two lanes at a time
+				int64_t v[4];
+
+				for (int k = 0; k < 4; ++k)
+				{
+					const uint16_t* p = in[i + k].bits;
+					v[k] = static_cast<int64_t>(uint64_t(p[0]) | uint64_t(p[1]) << 16 | uint64_t(p[2]) << 32);
+				}
+
+				__m128i lo = _mm_set_epi64x(v[1], v[0]);
+				__m128i hi = _mm_set_epi64x(v[3], v[2]);
+
+				// fields of lanes 0 and 1 sit in the low dword of each 64 bit half, shuffle them together
+				const __m128i mask = _mm_set1_epi64x(0x7fff);
+				__m128i c = _mm_unpacklo_epi64(_mm_shuffle_epi32(_mm_and_si128(lo, mask), _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(_mm_and_si128(hi, mask), _MM_SHUFFLE(3, 1, 2, 0)));
+				__m128i b = _mm_unpacklo_epi64(_mm_shuffle_epi32(_mm_and_si128(_mm_srli_epi64(lo, 15), mask), _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(_mm_and_si128(_mm_srli_epi64(hi, 15), mask), _MM_SHUFFLE(3, 1, 2, 0)));
+				__m128i a = _mm_unpacklo_epi64(_mm_shuffle_epi32(_mm_and_si128(_mm_srli_epi64(lo, 30), mask), _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(_mm_and_si128(_mm_srli_epi64(hi, 30), mask), _MM_SHUFFLE(3, 1, 2, 0)));
+				__m128i largest = _mm_unpacklo_epi64(_mm_shuffle_epi32(_mm_srli_epi64(lo, 45), _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(_mm_srli_epi64(hi, 45), _MM_SHUFFLE(3, 1, 2, 0)));
+
+				smallest_three_decode4<15>(largest, a, b, c, q[i].m_data);
+			}
+
+			quat_unpack_range<float, packed_quat48>(in, q, i, end);
+		}
+
+		// snorm16 needs no transpose, each quaternion is one register and two pack into one store
+		inline void quat_pack_range(const quat<float>* q, packed_quat64* out, const size_t& begin, const size_t& end)
+		{
+			const __m128 scale = _mm_set1_ps(32767.0f);
+			const __m128 top = _mm_set1_ps(32767.0f);
+			const __m128 bottom = _mm_set1_ps(-32767.0f);
+			size_t i = begin;
+
+			for (; i + 2 <= end; i += 2)
+			{
+				__m128i a = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(q[i].m_data), scale), top), bottom));
+				__m128i b = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(q[i + 1].m_data), scale), top), bottom));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+			}
+
+			quat_pack_range<float, packed_quat64>(q, out, i, end);
+		}
+
+		inline void quat_unpack_range(const packed_quat64* in, quat<float>* q, const size_t& begin, const size_t& end)
+		{
+			const __m128 step = _mm_set1_ps(1.0f / 32767.0f);
+			size_t i = begin;
+
+			for (; i + 2 <= end; i += 2)
+			{
+				__m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+				// sign extend by shifting each word to the top of its lane and back
+				__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(bits, bits), 16);
+				__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(bits, bits), 16);
+				__m128 c[2] = { _mm_mul_ps(_mm_cvtepi32_ps(lo), step), _mm_mul_ps(_mm_cvtepi32_ps(hi), step) };
+
+				for (int k = 0; k < 2; ++k)
+				{
+					__m128 n = _mm_mul_ps(c[k], c[k]);
+					n = _mm_add_ps(n, _mm_shuffle_ps(n, n, _MM_SHUFFLE(2, 3, 0, 1)));
+					n = _mm_add_ps(n, _mm_shuffle_ps(n, n, _MM_SHUFFLE(1, 0, 3, 2)));
+
+					_mm_storeu_ps(q[i + k].m_data, _mm_div_ps(c[k], _mm_sqrt_ps(n)));
+				}
+			}
+
+			quat_unpack_range<float, packed_quat64>(in, q, i, end);
+		}
+#endif
+	}
+
+	// Single quaternions. Encoding expects a unit quaternion, anything else is clamped into range.
+	template <typename T, typename P>
+	inline void quat_pack(const quat<T>& q, P& out)
+	{
+		support::quat_pack_range(&q, &out, 0, 1);
+	}
+
+	template <typename T, typename P>
+	inline void quat_unpack(const P& in, quat<T>& q)
+	{
+		support::quat_unpack_range(&in, &q, 0, 1);
+	}
+
+	// Arrays, with SSE for quatf and split over threads when 'parallel' is set. The encoded bits are the same as
+	// packing one at a time.
+	template <typename T, typename P>
+	inline void quat_pack(const quat<T>* q, const size_t& count, P* out, const bool& parallel = false)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::quat_pack_range(q, out, begin, end);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 15, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T, typename P>
+	inline void quat_unpack(const P* in, const size_t& count, quat<T>* q, const bool& parallel = false)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::quat_unpack_range(in, q, begin, end);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 15, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	// Strided spans of x, y, z, w. A packed span takes the array path, any other stride is gathered (scattered) a
+	// block of 64 quaternions at a time so quatf keeps its SSE encoder.
+	template <typename T, typename P>
+	inline void quat_pack(const vec_span<4, const T>& q, P* out, const bool& parallel = false)
+	{
+		typedef typename support::check_layout<quat<T>, T, 4>::type cl;
+
+		if (q.stride() == sizeof(cl))
+		{
+			quat_pack(reinterpret_cast<const cl*>(q.data()), q.size(), out, parallel);
+			return;
+		}
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			quat<T> block[64];
+
+			for (size_t i = begin; i < end; i += 64)
+			{
+				const size_t m = std::min<size_t>(64, end - i);
+
+				for (size_t j = 0; j < m; ++j)
+					block[j] = quat<T>(q[i + j]);
+
+				support::quat_pack_range(block, out + i, 0, m);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(q.size(), 1 << 15, kernel);
+		else
+			kernel(0, 0, q.size());
+	}
+
+	template <typename T, typename P>
+	inline void quat_unpack(const P* in, const vec_span<4, T>& q, const bool& parallel = false)
+	{
+		typedef typename support::check_layout<quat<T>, T, 4>::type cl;
+
+		if (q.stride() == sizeof(cl))
+		{
+			quat_unpack(in, q.size(), reinterpret_cast<cl*>(q.data()), parallel);
+			return;
+		}
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			quat<T> block[64];
+
+			for (size_t i = begin; i < end; i += 64)
+			{
+				const size_t m = std::min<size_t>(64, end - i);
+
+				support::quat_unpack_range(in + i, block, 0, m);
+
+				for (size_t j = 0; j < m; ++j)
+					q[i + j] = vec4<T>(block[j].x(), block[j].y(), block[j].z(), block[j].w());
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(q.size(), 1 << 15, kernel);
+		else
+			kernel(0, 0, q.size());
+	}
+}
+
+#endif
@@ -0,0 +1,540 @@
+#ifndef _RM_RAY_H
+#define _RM_RAY_H
+
+#include <cstdint>
+
+#include "vec3.h"
+#include "aabb.h"
+#include "support/simd.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	template <typename T>
+	class ray
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// constructors
+		ray() : origin(vec3<T>::ZERO), direction(vec3<T>::FORWARD) {}
+		ray(const vec3<T>& origin, const vec3<T>& direction) : origin(origin), direction(direction) {}
+
+		// Utility functions
+		const vec3<T> at(const T& t) const;
+		const vec3<T> inverse_direction() const;
+
+		// Moller-Trumbore, hits with 0 < t < t_max
+		const bool intersects(const vec3<T>& v0, const vec3<T>& v1, const vec3<T>& v2, T& t, T& u, T& v, const T& t_max = std::numeric_limits<T>::infinity()) const;
+
+		// Slab test, hits with t_near <= t_far, t_far >= 0 and t_near < t_max. t_near is negative from inside the box,
+		// and a ray lying in the plane of a face is inside that slab.
+		const bool intersects(const aabb<T>& box, T& t_near, T& t_far, const T& t_max = std::numeric_limits<T>::infinity()) const;
+
+		friend std::ostream& operator<<(std::ostream& out, const ray<T>& r)
+		{
+			out << "Ray(" << r.origin << ", " << r.direction << ")";
+
+			return out;
+		}
+
+		vec3<T> origin;
+		vec3<T> direction;
+	};
+
+	template <typename T>
+	struct ray_hit
+	{
+		static const uint32_t MISS = 0xffffffffu;
+
+		T t = std::numeric_limits<T>::infinity();
+		T u = 0;
+		T v = 0;
+		uint32_t primitive = MISS;
+
+		inline const bool hit() const { return primitive != MISS; }
+	};
+
+	// Indexed triangle mesh, triangle i is (indices[3i], indices[3i + 1], indices[3i + 2]).
+	// With indices == nullptr the vertices are a triangle soup, triangle i is vertices[3i .. 3i + 2].
+	template <typename T>
+	struct triangle_mesh
+	{
+		const vec3<T>* vertices;
+		const uint32_t* indices;
+		size_t triangle_count;
+
+		inline void triangle(const size_t& index, vec3<T>& v0, vec3<T>& v1, vec3<T>& v2) const
+		{
+			if (indices)
+			{
+				v0 = vertices[indices[3 * index]];
+				v1 = vertices[indices[3 * index + 1]];
+				v2 = vertices[indices[3 * index + 2]];
+			}
+			else
+			{
+				v0 = vertices[3 * index];
+				v1 = vertices[3 * index + 1];
+				v2 = vertices[3 * index + 2];
+			}
+		}
+	};
+
+	// W rays in structure-of-arrays form. Intersections against a packet return a bit mask with one bit per lane.
+	template <typename T, size_t W>
+	struct ray_packet
+	{
+		alignas(sizeof(T) * W) T origin[3][W];
+		alignas(sizeof(T) * W) T direction[3][W];
+		alignas(sizeof(T) * W) T inv_direction[3][W];
+
+		static const size_t WIDTH = W;
+
+		void set(const size_t& lane, const ray<T>& r);
+
+		// Loads up to W rays, unused lanes repeat the last ray
+		void load(const ray<T>* rays, const size_t& count);
+	};
+
+	namespace support
+	{
+		// Widest packet the enabled SIMD backend handles natively
+		template <typename T>
+		struct ray_packet_width
+		{
+			static const size_t value = 4;
+		};
+
+#ifdef _REACT_SIMD_AVX2
+		template <>
+		struct ray_packet_width<float>
+		{
+			static const size_t value = 8;
+		};
+#endif
+
+		// Moller-Trumbore's determinant is |d| |e1 x e2| times the cosine between d and the normal, so it scales with
+		// the triangle and the direction. A ray is parallel to the triangle when det^2 <= limit |d|^2, this limit from
+		// the squared edge lengths, compared squared so no kernel needs a square root.
+		template <typename T>
+		inline T triangle_parallel_limit(const T& e1_length_squared, const T& e2_length_squared)
+		{
+			const T eps = std::numeric_limits<T>::epsilon();
+
+			return eps * eps * e1_length_squared * e2_length_squared;
+		}
+	}
+
+	template <typename T>
+	const vec3<T> ray<T>::at(const T& t) const
+	{
+		return origin + direction * t;
+	}
+
+	template <typename T>
+	const vec3<T> ray<T>::inverse_direction() const
+	{
+		return static_cast<T>(1) / direction;
+	}
+
+	// credit Moller & Trumbore, "Fast, Minimum Storage Ray/Triangle Intersection"
+	template <typename T>
+	const bool ray<T>::intersects(const vec3<T>& v0, const vec3<T>& v1, const vec3<T>& v2, T& t, T& u, T& v, const T& t_max) const
+	{
+		vec3<T> e1 = v1 - v0;
+		vec3<T> e2 = v2 - v0;
+		vec3<T> p = direction.cross(e2);
+
+		T det = e1.dot(p);
+
+		if (det * det <= support::triangle_parallel_limit(e1.length_squared(), e2.length_squared()) * direction.length_squared())
+			return false;
+
+		T inv_det = static_cast<T>(1) / det;
+
+		vec3<T> s = origin - v0;
+		T uu = s.dot(p) * inv_det;
+
+		if (uu < 0 || uu > 1)
+			return false;
+
+		vec3<T> q = s.cross(e1);
+		T vv = direction.dot(q) * inv_det;
+
+		if (vv < 0 || uu + vv > 1)
+			return false;
+
+		T tt = e2.dot(q) * inv_det;
+
+		if (tt <= 0 || tt >= t_max)
+			return false;
+
+		t = tt;
+		u = uu;
+		v = vv;
+
+		return true;
+	}
+
+	template <typename T>
+	const bool ray<T>::intersects(const aabb<T>& box, T& t_near, T& t_far, const T& t_max) const
+	{
+		T t0 = -std::numeric_limits<T>::infinity();
+		T t1 = std::numeric_limits<T>::infinity();
+
+		for (int i = 0; i < 3; ++i)
+		{
+			T inv = static_cast<T>(1) / direction.m_data[i];
+			T a = (box.min.m_data[i] - origin.m_data[i]) * inv;
+			T b = (box.max.m_data[i] - origin.m_data[i]) * inv;
+
+			// 0 * inf, a ray parallel to and on a face, leaves the interval alone
+			if (a != a || b != b)
+				continue;
+
+			t0 = std::max(t0, std::min(a, b));
+			t1 = std::min(t1, std::max(a, b));
+		}
+
+		if (t0 > t1 || t1 < 0 || t0 >= t_max)
+			return false;
+
+		t_near = t0;
+		t_far = t1;
+
+		return true;
+	}
+
+	template <typename T, size_t W>
+	void ray_packet<T, W>::set(const size_t& lane, const ray<T>& r)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			origin[i][lane] = r.origin.m_data[i];
+			direction[i][lane] = r.direction.m_data[i];
+			inv_direction[i][lane] = static_cast<T>(1) / r.direction.m_data[i];
+		}
+	}
+
+	template <typename T, size_t W>
+	void ray_packet<T, W>::load(const ray<T>* rays, const size_t& count)
+	{
+		for (size_t lane = 0; lane < W; ++lane)
+			set(lane, rays[lane < count ? lane : count - 1]);
+	}
+
+	// Packet ray/triangle test. Lanes that hit closer than t[lane] update t, u, v; returns the mask of updated lanes.
+	template <typename T, size_t W>
+	int intersect(const ray_packet<T, W>& r, const vec3<T>& v0, const vec3<T>& v1, const vec3<T>& v2, T(&t)[W], T(&u)[W], T(&v)[W])
+	{
+		vec3<T> e1 = v1 - v0;
+		vec3<T> e2 = v2 - v0;
+
+		const T limit = support::triangle_parallel_limit(e1.length_squared(), e2.length_squared());
+
+		int mask = 0;
+
+		for (size_t i = 0; i < W; ++i)
+		{
+			T dx = r.direction[0][i], dy = r.direction[1][i], dz = r.direction[2][i];
+
+			T px = dy * e2.z() - dz * e2.y();
+			T py = dz * e2.x() - dx * e2.z();
+			T pz = dx * e2.y() - dy * e2.x();
+
+			T det = e1.x() * px + e1.y() * py + e1.z() * pz;
+			T inv_det = static_cast<T>(1) / det;
+
+			T sx = r.origin[0][i] - v0.x(), sy = r.origin[1][i] - v0.y(), sz = r.origin[2][i] - v0.z();
+
+			T uu = (sx * px + sy * py + sz * pz) * inv_det;
+
+			T qx = sy * e1.z() - sz * e1.y();
+			T qy = sz * e1.x() - sx * e1.z();
+			T qz = sx * e1.y() - sy * e1.x();
+
+			T vv = (dx * qx + dy * qy + dz * qz) * inv_det;
+			T tt = (e2.x() * qx + e2.y() * qy + e2.z() * qz) * inv_det;
+
+			bool hit = det * det > limit * (dx * dx + dy * dy + dz * dz) && uu >= 0 && uu <= 1 && vv >= 0 && uu + vv <= 1 && tt > 0 && tt < t[i];
+
+			if (hit)
+			{
+				t[i] = tt;
+				u[i] = uu;
+				v[i] = vv;
+				mask |= 1 << i;
+			}
+		}
+
+		return mask;
+	}
+
+	// Packet slab test against one box, each lane hitting exactly when ray::intersects does with t_max[lane]. Returns
+	// the mask of lanes that hit, writing their entry distance.
+	template <typename T, size_t W>
+	int intersect(const ray_packet<T, W>& r, const aabb<T>& box, const T(&t_max)[W], T(&t_near)[W])
+	{
+		int mask = 0;
+
+		for (size_t i = 0; i < W; ++i)
+		{
+			T t0 = -std::numeric_limits<T>::infinity();
+			T t1 = std::numeric_limits<T>::infinity();
+
+			for (int j = 0; j < 3; ++j)
+			{
+				T a = (box.min.m_data[j] - r.origin[j][i]) * r.inv_direction[j][i];
+				T b = (box.max.m_data[j] - r.origin[j][i]) * r.inv_direction[j][i];
+
+				if (a != a || b != b)
+					continue;
+
+				t0 = std::max(t0, std::min(a, b));
+				t1 = std::min(t1, std::max(a, b));
+			}
+
+			if (t0 <= t1 && t1 >= 0 && t0 < t_max[i])
+			{
+				t_near[i] = t0;
+				mask |= 1 << i;
+			}
+		}
+
+		return mask;
+	}
+
+#ifdef _REACT_SIMD_SSE2
+	inline int intersect(const ray_packet<float, 4>& r, const vec3<float>& v0, const vec3<float>& v1, const vec3<float>& v2, float(&t)[4], float(&u)[4], float(&v)[4])
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		const vec3<float> e1 = v1 - v0;
+		const vec3<float> e2 = v2 - v0;
+
+		__m128 e1x = _mm_set1_ps(e1.x()), e1y = _mm_set1_ps(e1.y()), e1z = _mm_set1_ps(e1.z());
+		__m128 e2x = _mm_set1_ps(e2.x()), e2y = _mm_set1_ps(e2.y()), e2z = _mm_set1_ps(e2.z());
+
+		__m128 dx = _mm_load_ps(r.direction[0]), dy = _mm_load_ps(r.direction[1]), dz = _mm_load_ps(r.direction[2]);
+
+		__m128 limit = _mm_set1_ps(support::triangle_parallel_limit(e1.length_squared(), e2.length_squared()));
+		__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		__m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+		__m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+		__m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+		__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+		__m128 inv_det = _mm_div_ps(one, det);
+
+		__m128 sx = _mm_sub_ps(_mm_load_ps(r.origin[0]), _mm_set1_ps(v0.x()));
+		__m128 sy = _mm_sub_ps(_mm_load_ps(r.origin[1]), _mm_set1_ps(v0.y()));
+		__m128 sz = _mm_sub_ps(_mm_load_ps(r.origin[2]), _mm_set1_ps(v0.z()));
+
+		__m128 uu = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv_det);
+
+		__m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+		__m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+		__m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+		__m128 vv = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+		__m128 tt = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+
+		__m128 t_old = _mm_loadu_ps(t);
+
+		__m128 hit = _mm_cmpgt_ps(_mm_mul_ps(det, det), _mm_mul_ps(limit, d2));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(uu, zero), _mm_cmple_ps(uu, one)));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(vv, zero), _mm_cmple_ps(_mm_add_ps(uu, vv), one)));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpgt_ps(tt, zero), _mm_cmplt_ps(tt, t_old)));
+
+		int mask = _mm_movemask_ps(hit);
+
+		if (mask)
+		{
+			_mm_storeu_ps(t, _mm_or_ps(_mm_and_ps(hit, tt), _mm_andnot_ps(hit, t_old)));
+			_mm_storeu_ps(u, _mm_or_ps(_mm_and_ps(hit, uu), _mm_andnot_ps(hit, _mm_loadu_ps(u))));
+			_mm_storeu_ps(v, _mm_or_ps(_mm_and_ps(hit, vv), _mm_andnot_ps(hit, _mm_loadu_ps(v))));
+		}
+
+		return mask;
+	}
+
+	inline int intersect(const ray_packet<float, 4>& r, const aabb<float>& box, const float(&t_max)[4], float(&t_near)[4])
+	{
+		__m128 t0 = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+		__m128 t1 = _mm_set1_ps(std::numeric_limits<float>::infinity());
+
+		for (int j = 0; j < 3; ++j)
+		{
+			__m128 o = _mm_load_ps(r.origin[j]);
+			__m128 inv = _mm_load_ps(r.inv_direction[j]);
+			__m128 a = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.m_data[j]), o), inv);
+			__m128 b = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.m_data[j]), o), inv);
+
+			// lanes where either is NaN keep their interval, as the scalar test skips the axis
+			__m128 slab = _mm_cmpord_ps(a, b);
+
+			t0 = _mm_or_ps(_mm_and_ps(slab, _mm_max_ps(t0, _mm_min_ps(a, b))), _mm_andnot_ps(slab, t0));
+			t1 = _mm_or_ps(_mm_and_ps(slab, _mm_min_ps(t1, _mm_max_ps(a, b))), _mm_andnot_ps(slab, t1));
+		}
+
+		__m128 hit = _mm_and_ps(_mm_cmple_ps(t0, t1), _mm_and_ps(_mm_cmpge_ps(t1, _mm_setzero_ps()), _mm_cmplt_ps(t0, _mm_loadu_ps(t_max))));
+		_mm_storeu_ps(t_near, _mm_or_ps(_mm_and_ps(hit, t0), _mm_andnot_ps(hit, _mm_loadu_ps(t_near))));
+
+		return _mm_movemask_ps(hit);
+	}
+#endif
+
+#ifdef _REACT_SIMD_AVX2
+	inline int intersect(const ray_packet<float, 8>& r, const vec3<float>& v0, const vec3<float>& v1, const vec3<float>& v2, float(&t)[8], float(&u)[8], float(&v)[8])
+	{
+		using support::mm256_fmadd;
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		const vec3<float> e1 = v1 - v0;
+		const vec3<float> e2 = v2 - v0;
+
+		__m256 e1x = _mm256_set1_ps(e1.x()), e1y = _mm256_set1_ps(e1.y()), e1z = _mm256_set1_ps(e1.z());
+		__m256 e2x = _mm256_set1_ps(e2.x()), e2y = _mm256_set1_ps(e2.y()), e2z = _mm256_set1_ps(e2.z());
+
+		__m256 dx = _mm256_load_ps(r.direction[0]), dy = _mm256_load_ps(r.direction[1]), dz = _mm256_load_ps(r.direction[2]);
+
+		__m256 limit = _mm256_set1_ps(support::triangle_parallel_limit(e1.length_squared(), e2.length_squared()));
+		__m256 d2 = mm256_fmadd(dx, dx, mm256_fmadd(dy, dy, _mm256_mul_ps(dz, dz)));
+
+		__m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+		__m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+		__m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+
+		__m256 det = mm256_fmadd(e1x, px, mm256_fmadd(e1y, py, _mm256_mul_ps(e1z, pz)));
+		__m256 inv_det = _mm256_div_ps(one, det);
+
+		__m256 sx = _mm256_sub_ps(_mm256_load_ps(r.origin[0]), _mm256_set1_ps(v0.x()));
+		__m256 sy = _mm256_sub_ps(_mm256_load_ps(r.origin[1]), _mm256_set1_ps(v0.y()));
+		__m256 sz = _mm256_sub_ps(_mm256_load_ps(r.origin[2]), _mm256_set1_ps(v0.z()));
+
+		__m256 uu = _mm256_mul_ps(mm256_fmadd(sx, px, mm256_fmadd(sy, py, _mm256_mul_ps(sz, pz))), inv_det);
+
+		__m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+		__m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+		__m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+
+		__m256 vv = _mm256_mul_ps(mm256_fmadd(dx, qx, mm256_fmadd(dy, qy, _mm256_mul_ps(dz, qz))), inv_det);
+		__m256 tt = _mm256_mul_ps(mm256_fmadd(e2x, qx, mm256_fmadd(e2y, qy, _mm256_mul_ps(e2z, qz))), inv_det);
+
+		__m256 t_old = _mm256_loadu_ps(t);
+
+		__m256 hit = _mm256_cmp_ps(_mm256_mul_ps(det, det), _mm256_mul_ps(limit, d2), _CMP_GT_OQ);
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(uu, zero, _CMP_GE_OQ), _mm256_cmp_ps(uu, one, _CMP_LE_OQ)));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(vv, zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(uu, vv), one, _CMP_LE_OQ)));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(tt, zero, _CMP_GT_OQ), _mm256_cmp_ps(tt, t_old, _CMP_LT_OQ)));
+
+		int mask = _mm256_movemask_ps(hit);
+
+		if (mask)
+		{
+			_mm256_storeu_ps(t, _mm256_blendv_ps(t_old, tt, hit));
+			_mm256_storeu_ps(u, _mm256_blendv_ps(_mm256_loadu_ps(u), uu, hit));
+			_mm256_storeu_ps(v, _mm256_blendv_ps(_mm256_loadu_ps(v), vv, hit));
+		}
+
+		return mask;
+	}
+
+	inline int intersect(const ray_packet<float, 8>& r, const aabb<float>& box, const float(&t_max)[8], float(&t_near)[8])
+	{
+		__m256 t0 = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+		__m256 t1 = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+
+		for (int j = 0; j < 3; ++j)
+		{
+			__m256 o = _mm256_load_ps(r.origin[j]);
+			__m256 inv = _mm256_load_ps(r.inv_direction[j]);
+			__m256 a = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min.m_data[j]), o), inv);
+			__m256 b = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max.m_data[j]), o), inv);
+			__m256 slab = _mm256_cmp_ps(a, b, _CMP_ORD_Q);
+
+			t0 = _mm256_blendv_ps(t0, _mm256_max_ps(t0, _mm256_min_ps(a, b)), slab);
+			t1 = _mm256_blendv_ps(t1, _mm256_min_ps(t1, _mm256_max_ps(a, b)), slab);
+		}
+
+		__m256 hit = _mm256_and_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ), _mm256_and_ps(_mm256_cmp_ps(t1, _mm256_setzero_ps(), _CMP_GE_OQ), _mm256_cmp_ps(t0, _mm256_loadu_ps(t_max), _CMP_LT_OQ)));
+		_mm256_storeu_ps(t_near, _mm256_blendv_ps(_mm256_loadu_ps(t_near), t0, hit));
+
+		return _mm256_movemask_ps(hit);
+	}
+#endif
+
+	// Closest hit of every ray against every triangle, tracing W rays per packet. Brute force, see bvh for large meshes.
+	template <size_t W, typename T>
+	void intersect_triangles(const ray<T>* rays, const size_t& ray_count, const triangle_mesh<T>& mesh, ray_hit<T>* hits, const bool& parallel = false)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			ray_packet<T, W> packet;
+
+			for (size_t first = begin; first < end; first += W)
+			{
+				size_t lanes = std::min(W, end - first);
+
+				packet.load(rays + first, lanes);
+
+				T t[W], u[W], v[W];
+				uint32_t primitive[W];
+
+				for (size_t i = 0; i < W; ++i)
+				{
+					t[i] = std::numeric_limits<T>::infinity();
+					u[i] = v[i] = 0;
+					primitive[i] = ray_hit<T>::MISS;
+				}
+
+				vec3<T> v0, v1, v2;
+
+				for (size_t tri = 0; tri < mesh.triangle_count; ++tri)
+				{
+					mesh.triangle(tri, v0, v1, v2);
+
+					int mask = intersect(packet, v0, v1, v2, t, u, v);
+
+					while (mask)
+					{
+						primitive[support::ctz32(mask)] = static_cast<uint32_t>(tri);
+						mask &= mask - 1;
+					}
+				}
+
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					hits[first + i].t = t[i];
+					hits[first + i].u = u[i];
+					hits[first + i].v = v[i];
+					hits[first + i].primitive = primitive[i];
+				}
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(ray_count, 64, kernel);
+		else
+			kernel(0, 0, ray_count);
+	}
+
+	template <typename T>
+	void intersect_triangles(const ray<T>* rays, const size_t& ray_count, const triangle_mesh<T>& mesh, ray_hit<T>* hits, const bool& parallel = false)
+	{
+		intersect_triangles<support::ray_packet_width<T>::value>(rays, ray_count, mesh, hits, parallel);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef ray<float> rayf;
+	typedef ray<double> rayd;
+#endif
+}
+
+#endif
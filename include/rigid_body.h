@@ -0,0 +1,438 @@
+#ifndef _RM_RIGID_BODY_H
+#define _RM_RIGID_BODY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "vec3.h"
+#include "mat3.h"
+#include "quat.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// A single body, used to add bodies to and read them back from rigid_body_state
+	template <typename T>
+	struct rigid_body
+	{
+		rigid_body() : position(static_cast<T>(0)), orientation(), linear_velocity(static_cast<T>(0)), angular_velocity(static_cast<T>(0)),
+			inverse_mass(1), inverse_inertia(static_cast<T>(1)) {}
+
+		vec3<T> position;
+		quat<T> orientation;
+		vec3<T> linear_velocity;
+		vec3<T> angular_velocity;
+
+		// 0 for static bodies
+		T inverse_mass;
+
+		// inverse of the principal moments of inertia, in body space
+		vec3<T> inverse_inertia;
+	};
+
+	// Structure of arrays state of many rigid bodies. Every component has its own contiguous array, so integrate() streams
+	// through memory and evaluates 8 bodies per AVX2 register, or 4 per SSE2 register, without gathers. The arrays share one allocation with their
+	// starts staggered by a cache line, separate page aligned allocations would all map to the same cache sets.
+	template <typename T>
+	class rigid_body_state
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// Component arrays, POSITION + 1 is the y position and so on
+		enum field
+		{
+			POSITION = 0,
+			ORIENTATION = 3,
+			LINEAR_VELOCITY = 7,
+			ANGULAR_VELOCITY = 10,
+			FORCE = 13,
+			TORQUE = 16,
+			INVERSE_INERTIA = 19,
+			INVERSE_MASS = 22,
+			FIELDS = 23
+		};
+
+		// constructors
+		rigid_body_state() : gravity(static_cast<T>(0)), m_size(0), m_capacity(0), m_stride(0), m_base(nullptr) {}
+		rigid_body_state(const rigid_body_state<T>& s);
+
+		// Modifiers
+		const size_t add(const rigid_body<T>& body);
+		void set(const size_t& index, const rigid_body<T>& body);
+		void reserve(const size_t& count);
+		void clear();
+
+		// Forces and torques are accumulated in world space until the next integrate()
+		void apply_force(const size_t& index, const vec3<T>& force);
+		void apply_force(const size_t& index, const vec3<T>& force, const vec3<T>& point);
+		void apply_torque(const size_t& index, const vec3<T>& torque);
+
+		// Accessors
+		inline const size_t size() const;
+		const rigid_body<T> get(const size_t& index) const;
+
+		// size() contiguous values of one component, invalidated when the state grows
+		inline T* array(const size_t& f);
+		inline const T* array(const size_t& f) const;
+
+		// I^-1 in world space, R diag(inverse_inertia) R^T
+		const mat3<T> world_inverse_inertia(const size_t& index) const;
+
+		// Utility functions
+
+		// Semi-implicit Euler step: velocities are updated from the accumulated forces first, positions and orientations
+		// then move with the new velocities, q += dt / 2 (w, 0) q followed by renormalization. Gyroscopic torque is ignored.
+		// The force and torque accumulators are cleared.
+		void integrate(const T& dt, const bool& parallel = false);
+
+		// Operators
+		rigid_body_state<T>& operator=(const rigid_body_state<T>& s);
+
+		// Applied to every body with a non-zero inverse mass
+		vec3<T> gravity;
+
+	private:
+		std::vector<T> m_storage;
+		size_t m_size;
+		size_t m_capacity;
+		size_t m_stride;
+		T* m_base;
+	};
+
+	namespace support
+	{
+		// Component arrays of a rigid_body_state
+		template <typename T>
+		struct rigid_body_arrays
+		{
+			T* p[3];
+			T* q[4];
+			T* v[3];
+			T* w[3];
+			T* f[3];
+			T* t[3];
+			const T* inverse_mass;
+			const T* inverse_inertia[3];
+		};
+
+		template <typename L, typename T>
+		inline void rigid_body_step(const rigid_body_arrays<T>& a, const size_t& i, const T& dt, const T(&gravity)[3])
+		{
+			const L step(dt);
+			const L half_step(dt * static_cast<T>(0.5));
+			const L zero(static_cast<T>(0));
+
+			L p[3], q[4], v[3], w[3], f[3], t[3], im, ii[3];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				lane_load(p[k], a.p[k] + i);
+				lane_load(v[k], a.v[k] + i);
+				lane_load(w[k], a.w[k] + i);
+				lane_load(f[k], a.f[k] + i);
+				lane_load(t[k], a.t[k] + i);
+				lane_load(ii[k], a.inverse_inertia[k] + i);
+			}
+
+			for (int k = 0; k < 4; ++k)
+				lane_load(q[k], a.q[k] + i);
+
+			lane_load(im, a.inverse_mass + i);
+
+			// R from q, as quat::toMat3
+			const L one(static_cast<T>(1));
+			const L two(static_cast<T>(2));
+
+			L r[3][3];
+
+			r[0][0] = one - two * (q[1] * q[1] + q[2] * q[2]);
+			r[0][1] = two * (q[0] * q[1] - q[2] * q[3]);
+			r[0][2] = two * (q[0] * q[2] + q[1] * q[3]);
+			r[1][0] = two * (q[0] * q[1] + q[2] * q[3]);
+			r[1][1] = one - two * (q[0] * q[0] + q[2] * q[2]);
+			r[1][2] = two * (q[1] * q[2] - q[0] * q[3]);
+			r[2][0] = two * (q[0] * q[2] - q[1] * q[3]);
+			r[2][1] = two * (q[1] * q[2] + q[0] * q[3]);
+			r[2][2] = one - two * (q[0] * q[0] + q[1] * q[1]);
+
+			// w += dt R diag(I^-1) R^T torque
+			L local[3];
+
+			for (int k = 0; k < 3; ++k)
+				local[k] = (r[0][k] * t[0] + r[1][k] * t[1] + r[2][k] * t[2]) * ii[k];
+
+			for (int k = 0; k < 3; ++k)
+				w[k] += step * (r[k][0] * local[0] + r[k][1] * local[1] + r[k][2] * local[2]);
+
+			// v += dt (f / m + g), static bodies stay put
+			for (int k = 0; k < 3; ++k)
+			{
+				v[k] += step * (im * f[k] + lane_select(im > zero, L(gravity[k]), zero));
+				p[k] += step * v[k];
+			}
+
+			// q += dt / 2 (w, 0) q
+			L dq[4];
+
+			dq[0] = w[0] * q[3] + w[1] * q[2] - w[2] * q[1];
+			dq[1] = w[1] * q[3] + w[2] * q[0] - w[0] * q[2];
+			dq[2] = w[2] * q[3] + w[0] * q[1] - w[1] * q[0];
+			dq[3] = -(w[0] * q[0] + w[1] * q[1] + w[2] * q[2]);
+
+			for (int k = 0; k < 4; ++k)
+				q[k] += half_step * dq[k];
+
+			const L n = lane_rsqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+			for (int k = 0; k < 4; ++k)
+				q[k] *= n;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				lane_store(a.p[k] + i, p[k]);
+				lane_store(a.v[k] + i, v[k]);
+				lane_store(a.w[k] + i, w[k]);
+				lane_store(a.f[k] + i, zero);
+				lane_store(a.t[k] + i, zero);
+			}
+
+			for (int k = 0; k < 4; ++k)
+				lane_store(a.q[k] + i, q[k]);
+		}
+
+		template <typename T>
+		inline void rigid_body_range(const rigid_body_arrays<T>& a, const size_t& begin, const size_t& end, const T& dt, const T(&gravity)[3])
+		{
+			for (size_t i = begin; i < end; ++i)
+				rigid_body_step<T>(a, i, dt, gravity);
+		}
+
+#ifdef _REACT_SIMD_SSE2
+		inline void rigid_body_range(const rigid_body_arrays<float>& a, const size_t& begin, const size_t& end, const float& dt, const float(&gravity)[3])
+		{
+			size_t i = begin;
+
+#ifdef _REACT_SIMD_AVX2
+			for (; i + 8 <= end; i += 8)
+				rigid_body_step<float8>(a, i, dt, gravity);
+#endif
+
+			for (; i + 4 <= end; i += 4)
+				rigid_body_step<float4>(a, i, dt, gravity);
+
+			for (; i < end; ++i)
+				rigid_body_step<float>(a, i, dt, gravity);
+		}
+#endif
+	}
+
+	template <typename T>
+	rigid_body_state<T>::rigid_body_state(const rigid_body_state<T>& s) : rigid_body_state()
+	{
+		*this = s;
+	}
+
+	template <typename T>
+	const size_t rigid_body_state<T>::add(const rigid_body<T>& body)
+	{
+		if (m_size == m_capacity)
+			reserve(std::max<size_t>(64, m_capacity * 2));
+
+		const size_t index = m_size++;
+
+		for (size_t f = 0; f < FIELDS; ++f)
+			array(f)[index] = 0;
+
+		set(index, body);
+
+		return index;
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::set(const size_t& index, const rigid_body<T>& body)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			array(POSITION + k)[index] = body.position[k];
+			array(LINEAR_VELOCITY + k)[index] = body.linear_velocity[k];
+			array(ANGULAR_VELOCITY + k)[index] = body.angular_velocity[k];
+			array(INVERSE_INERTIA + k)[index] = body.inverse_inertia[k];
+		}
+
+		for (size_t k = 0; k < 4; ++k)
+			array(ORIENTATION + k)[index] = body.orientation[k];
+
+		array(INVERSE_MASS)[index] = body.inverse_mass;
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::reserve(const size_t& count)
+	{
+		if (count <= m_capacity)
+			return;
+
+		// arrays start on cache lines, and a stride one line longer than a whole number of lines staggers them
+		const size_t line = 64 / sizeof(T);
+		const size_t capacity = (count + line - 1) / line * line;
+		const size_t stride = capacity + line;
+
+		std::vector<T> storage(stride * FIELDS + line);
+		T* base = storage.data();
+
+		while (reinterpret_cast<uintptr_t>(base) % 64 != 0)
+			++base;
+
+		for (size_t f = 0; f < FIELDS; ++f)
+			std::copy(array(f), array(f) + m_size, base + f * stride);
+
+		m_storage.swap(storage);
+		m_capacity = capacity;
+		m_stride = stride;
+		m_base = base;
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::clear()
+	{
+		m_size = 0;
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::apply_force(const size_t& index, const vec3<T>& f)
+	{
+		for (size_t k = 0; k < 3; ++k)
+			array(FORCE + k)[index] += f[k];
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::apply_force(const size_t& index, const vec3<T>& f, const vec3<T>& point)
+	{
+		vec3<T> arm = point - vec3<T>(array(POSITION)[index], array(POSITION + 1)[index], array(POSITION + 2)[index]);
+
+		apply_force(index, f);
+		apply_torque(index, arm.cross(f));
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::apply_torque(const size_t& index, const vec3<T>& t)
+	{
+		for (size_t k = 0; k < 3; ++k)
+			array(TORQUE + k)[index] += t[k];
+	}
+
+	template <typename T>
+	inline const size_t rigid_body_state<T>::size() const
+	{
+		return m_size;
+	}
+
+	template <typename T>
+	const rigid_body<T> rigid_body_state<T>::get(const size_t& index) const
+	{
+		rigid_body<T> body;
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			body.position[k] = array(POSITION + k)[index];
+			body.linear_velocity[k] = array(LINEAR_VELOCITY + k)[index];
+			body.angular_velocity[k] = array(ANGULAR_VELOCITY + k)[index];
+			body.inverse_inertia[k] = array(INVERSE_INERTIA + k)[index];
+		}
+
+		for (size_t k = 0; k < 4; ++k)
+			body.orientation[k] = array(ORIENTATION + k)[index];
+
+		body.inverse_mass = array(INVERSE_MASS)[index];
+
+		return body;
+	}
+
+	template <typename T>
+	inline T* rigid_body_state<T>::array(const size_t& f)
+	{
+		return m_base + f * m_stride;
+	}
+
+	template <typename T>
+	inline const T* rigid_body_state<T>::array(const size_t& f) const
+	{
+		return m_base + f * m_stride;
+	}
+
+	template <typename T>
+	const mat3<T> rigid_body_state<T>::world_inverse_inertia(const size_t& index) const
+	{
+		const mat3<T> r = quat<T>(array(ORIENTATION)[index], array(ORIENTATION + 1)[index], array(ORIENTATION + 2)[index], array(ORIENTATION + 3)[index]).toMat3();
+
+		mat3<T> d(static_cast<T>(0));
+
+		for (size_t k = 0; k < 3; ++k)
+			d.at(k, k) = array(INVERSE_INERTIA + k)[index];
+
+		return r.dot(d).dot(r.transpose());
+	}
+
+	template <typename T>
+	void rigid_body_state<T>::integrate(const T& dt, const bool& parallel)
+	{
+		support::rigid_body_arrays<T> a;
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			a.p[k] = array(POSITION + k);
+			a.v[k] = array(LINEAR_VELOCITY + k);
+			a.w[k] = array(ANGULAR_VELOCITY + k);
+			a.f[k] = array(FORCE + k);
+			a.t[k] = array(TORQUE + k);
+			a.inverse_inertia[k] = array(INVERSE_INERTIA + k);
+		}
+
+		for (size_t k = 0; k < 4; ++k)
+			a.q[k] = array(ORIENTATION + k);
+
+		a.inverse_mass = array(INVERSE_MASS);
+
+		const T g[3] = { gravity[0], gravity[1], gravity[2] };
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::rigid_body_range(a, begin, end, dt, g);
+		};
+
+		if (parallel)
+			support::parallel_for(size(), 1 << 13, kernel);
+		else
+			kernel(0, 0, size());
+	}
+
+	template <typename T>
+	rigid_body_state<T>& rigid_body_state<T>::operator=(const rigid_body_state<T>& s)
+	{
+		if (this == &s)
+			return *this;
+
+		gravity = s.gravity;
+		m_size = 0;
+		reserve(s.m_size);
+		m_size = s.m_size;
+
+		for (size_t f = 0; f < FIELDS; ++f)
+			std::copy(s.array(f), s.array(f) + m_size, array(f));
+
+		return *this;
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef rigid_body<float> rigid_bodyf;
+	typedef rigid_body<double> rigid_bodyd;
+
+	typedef rigid_body_state<float> rigid_body_statef;
+	typedef rigid_body_state<double> rigid_body_stated;
+#endif
+}
+
+#endif
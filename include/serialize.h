@@ -0,0 +1,947 @@
+#ifndef _RM_SERIALIZE_H
+#define _RM_SERIALIZE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "quat.h"
+#include "octahedral.h"
+#include "span.h"
+#include "support/mapped_file.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	// Binary arrays of vector<S, T>, matrix<M, N, T>, quat<T> and the packed_normal formats. A blob is a 64 byte little-endian header followed,
+	// at an aligned offset, by the elements packed exactly as they are in memory. Header bytes:
+	//
+	//     0   magic "RMBN"                  32  data bytes
+	//     4   version                       40  data checksum
+	//     6   header size, 64               48  flags
+	//     8   kind, scalar                  52  rows, cols, 16 bits each
+	//     10  reserved                      56  header check, low 32 bits of the checksum of bytes 0 - 55
+	//     12  alignment                     60  reserved
+	//     16  count
+	//     24  data offset
+	//
+	// On a little-endian host the data section is the in-memory array, so mapped_blob hands it out without a copy
+	// and blob_writer / blob_reader stream it in pieces. The checksum is only computed when asked for.
+	enum class blob_status
+	{
+		ok,
+		open_failed,
+		io_error,
+		bad_header,
+		unsupported_version,
+		type_mismatch,
+		truncated,
+		checksum_mismatch,
+		unsupported_host
+	};
+
+	struct blob_options
+	{
+		blob_options() : alignment(64), checksum(true) {}
+
+		// of the data section within the file, a power of two. Page size (4096) lets the data be mapped on its own.
+		size_t alignment;
+		bool checksum;
+	};
+
+	struct blob_header
+	{
+		static const uint32_t MAGIC = 0x4e424d52;
+		static const uint16_t VERSION = 1;
+		static const size_t SIZE = 64;
+		static const uint32_t HAS_CHECKSUM = 1;
+
+		blob_header() : version(VERSION), kind(0), scalar(0), rows(0), cols(0), alignment(64), count(0), data_offset(SIZE), data_bytes(0), checksum(0), flags(0) {}
+
+		uint16_t version;
+		uint8_t kind;
+		uint8_t scalar;
+		uint16_t rows;
+		uint16_t cols;
+		uint32_t alignment;
+		uint64_t count;
+		uint64_t data_offset;
+		uint64_t data_bytes;
+		uint64_t checksum;
+		uint32_t flags;
+	};
+
+	namespace support
+	{
+		inline const bool host_little_endian()
+		{
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+			return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+#else
+			const uint16_t probe = 1;
+			unsigned char first;
+
+			std::memcpy(&first, &probe, 1);
+
+			return first == 1;
+#endif
+		}
+
+		inline const uint64_t load_le(const unsigned char* p, const size_t& bytes)
+		{
+			uint64_t v = 0;
+
+			for (size_t i = 0; i < bytes; ++i)
+				v |= static_cast<uint64_t>(p[i]) << (8 * i);
+
+			return v;
+		}
+
+		inline void store_le(unsigned char* p, const uint64_t& v, const size_t& bytes)
+		{
+			for (size_t i = 0; i < bytes; ++i)
+				p[i] = static_cast<unsigned char>(v >> (8 * i));
+		}
+
+		// reverses the bytes of each of the 'count' components of 'size' bytes, between host and file order
+		inline void swap_components(unsigned char* data, const size_t& size, const size_t& count)
+		{
+			for (size_t i = 0; i < count; ++i)
+				std::reverse(data + i * size, data + (i + 1) * size);
+		}
+
+		enum blob_kind : uint8_t
+		{
+			BLOB_VECTOR = 1,
+			BLOB_MATRIX = 2,
+			BLOB_QUAT = 3,
+			BLOB_OCTAHEDRAL = 4
+		};
+
+		template <typename T>
+		struct blob_scalar;
+
+#define _RM_BLOB_SCALAR(T, TAG) \
+		template <> \
+		struct blob_scalar<T> \
+		{ \
+			static const uint8_t TAG_VALUE = TAG; \
+		};
+
+		_RM_BLOB_SCALAR(float, 1)
+		_RM_BLOB_SCALAR(double, 2)
+		_RM_BLOB_SCALAR(int8_t, 3)
+		_RM_BLOB_SCALAR(uint8_t, 4)
+		_RM_BLOB_SCALAR(int16_t, 5)
+		_RM_BLOB_SCALAR(uint16_t, 6)
+		_RM_BLOB_SCALAR(int32_t, 7)
+		_RM_BLOB_SCALAR(uint32_t, 8)
+		_RM_BLOB_SCALAR(int64_t, 9)
+		_RM_BLOB_SCALAR(uint64_t, 10)
+
+#undef _RM_BLOB_SCALAR
+
+		inline const size_t blob_scalar_size(const uint8_t& tag)
+		{
+			static const size_t sizes[] = { 0, 4, 8, 1, 1, 2, 2, 4, 4, 8, 8 };
+
+			return tag < sizeof(sizes) / sizeof(sizes[0]) ? sizes[tag] : 0;
+		}
+
+		// What a blob of V records about V. ROWS x COLS components of T, checked to be all V holds.
+		template <uint8_t KIND, size_t R, size_t C, typename T, typename V>
+		struct blob_layout
+		{
+			static_assert(R <= 0xffff && C <= 0xffff, "A blob dimension must fit the header's 16 bits");
+
+			typedef T component_type;
+			typedef typename check_layout<V, T, R * C>::type cl;
+
+			static const uint8_t KIND_VALUE = KIND;
+			static const uint8_t SCALAR = blob_scalar<T>::TAG_VALUE;
+			static const uint16_t ROWS = R;
+			static const uint16_t COLS = C;
+		};
+
+		template <typename V>
+		struct blob_element;
+
+		template <size_t S, typename T>
+		struct blob_element<vector<S, T>> : blob_layout<BLOB_VECTOR, S, 1, T, vector<S, T>> {};
+
+		template <typename T>
+		struct blob_element<vec2<T>> : blob_layout<BLOB_VECTOR, 2, 1, T, vec2<T>> {};
+
+		template <typename T>
+		struct blob_element<vec3<T>> : blob_layout<BLOB_VECTOR, 3, 1, T, vec3<T>> {};
+
+		template <typename T>
+		struct blob_element<vec4<T>> : blob_layout<BLOB_VECTOR, 4, 1, T, vec4<T>> {};
+
+		template <size_t M, size_t N, typename T>
+		struct blob_element<matrix<M, N, T>> : blob_layout<BLOB_MATRIX, N, M, T, matrix<M, N, T>> {};
+
+		template <typename T>
+		struct blob_element<quat<T>> : blob_layout<BLOB_QUAT, 4, 1, T, quat<T>> {};
+
+		// octahedral normals are told apart by their storage, two int8, three bytes of two 12 bit fields or two int16
+		template <>
+		struct blob_element<packed_normal16> : blob_layout<BLOB_OCTAHEDRAL, 2, 1, int8_t, packed_normal16> {};
+
+		template <>
+		struct blob_element<packed_normal24> : blob_layout<BLOB_OCTAHEDRAL, 3, 1, uint8_t, packed_normal24> {};
+
+		template <>
+		struct blob_element<packed_normal32> : blob_layout<BLOB_OCTAHEDRAL, 2, 1, int16_t, packed_normal32> {};
+
+		template <typename V>
+		inline blob_header blob_header_for()
+		{
+			typedef blob_element<V> element;
+
+			blob_header h;
+			h.kind = element::KIND_VALUE;
+			h.scalar = element::SCALAR;
+			h.rows = element::ROWS;
+			h.cols = element::COLS;
+
+			return h;
+		}
+
+		inline const bool blob_same_type(const blob_header& a, const blob_header& b)
+		{
+			return a.kind == b.kind && a.scalar == b.scalar && a.rows == b.rows && a.cols == b.cols;
+		}
+
+		inline const uint64_t rotl64(const uint64_t& x, const int& r)
+		{
+			return (x << r) | (x >> (64 - r));
+		}
+
+		// Multiply-rotate hash in the style of xxHash64, over independent 1 MiB blocks which are then folded in order.
+		// Blocks let a mapped blob be verified on all cores and a streamed one hashed as it goes, to the same value.
+		class blob_checksum
+		{
+		public:
+			static const size_t BLOCK_SIZE = 1 << 20;
+
+			// constructors
+			blob_checksum() : m_index(0), m_block_bytes(0), m_stripe_bytes(0), m_fold(P5)
+			{
+				start_block();
+			}
+
+			// Modifiers
+			inline void update(const unsigned char* data, size_t size);
+
+			// Accessors
+			inline const uint64_t finish() const;
+
+			// Static utility functions
+			static inline const uint64_t compute(const unsigned char* data, const size_t& size, const bool& parallel = false);
+
+		private:
+			static const uint64_t P1 = 0x9e3779b185ebca87ull;
+			static const uint64_t P2 = 0xc2b2ae3d27d4eb4full;
+			static const uint64_t P3 = 0x165667b19e3779f9ull;
+			static const uint64_t P4 = 0x85ebca77c2b2ae63ull;
+			static const uint64_t P5 = 0x27d4eb2f165667c5ull;
+
+			static inline const uint64_t word(const unsigned char* p)
+			{
+				uint64_t w;
+				std::memcpy(&w, p, 8);
+
+				return host_little_endian() ? w : load_le(p, 8);
+			}
+
+			static inline const uint64_t round(const uint64_t& acc, const uint64_t& w)
+			{
+				return rotl64(acc + w * P2, 31) * P1;
+			}
+
+			static inline const uint64_t fold(const uint64_t& h, const uint64_t& block)
+			{
+				return rotl64(h ^ block, 27) * P1 + P4;
+			}
+
+			static inline const uint64_t block_hash(const unsigned char* data, const size_t& size, const uint64_t& index);
+
+			inline void start_block();
+			inline void consume(const unsigned char* data, size_t size);
+			inline const uint64_t end_block() const;
+
+			uint64_t m_lanes[4];
+			uint64_t m_index;
+			size_t m_block_bytes;
+			unsigned char m_stripe[32];
+			size_t m_stripe_bytes;
+			uint64_t m_fold;
+		};
+
+		inline void blob_checksum::start_block()
+		{
+			m_lanes[0] = m_index + P1 + P2;
+			m_lanes[1] = m_index + P2;
+			m_lanes[2] = m_index;
+			m_lanes[3] = m_index - P1;
+			m_block_bytes = 0;
+			m_stripe_bytes = 0;
+		}
+
+		inline void blob_checksum::consume(const unsigned char* data, size_t size)
+		{
+			m_block_bytes += size;
+
+			if (m_stripe_bytes > 0)
+			{
+				size_t n = std::min(size, 32 - m_stripe_bytes);
+
+				std::memcpy(m_stripe + m_stripe_bytes, data, n);
+				m_stripe_bytes += n;
+				data += n;
+				size -= n;
+
+				if (m_stripe_bytes < 32)
+					return;
+
+				for (int k = 0; k < 4; ++k)
+					m_lanes[k] = round(m_lanes[k], word(m_stripe + 8 * k));
+
+				m_stripe_bytes = 0;
+			}
+
+			uint64_t v0 = m_lanes[0], v1 = m_lanes[1], v2 = m_lanes[2], v3 = m_lanes[3];
+
+			for (; size >= 32; data += 32, size -= 32)
+			{
+				v0 = round(v0, word(data));
+				v1 = round(v1, word(data + 8));
+				v2 = round(v2, word(data + 16));
+				v3 = round(v3, word(data + 24));
+			}
+
+			m_lanes[0] = v0;
+			m_lanes[1] = v1;
+			m_lanes[2] = v2;
+			m_lanes[3] = v3;
+
+			std::memcpy(m_stripe, data, size);
+			m_stripe_bytes = size;
+		}
+
+		inline const uint64_t blob_checksum::end_block() const
+		{
+			uint64_t h = rotl64(m_lanes[0], 1) + rotl64(m_lanes[1], 7) + rotl64(m_lanes[2], 12) + rotl64(m_lanes[3], 18);
+
+			for (int k = 0; k < 4; ++k)
+				h = (h ^ round(0, m_lanes[k])) * P1 + P4;
+
+			h += m_block_bytes;
+
+			size_t i = 0;
+
+			for (; i + 8 <= m_stripe_bytes; i += 8)
+				h = rotl64(h ^ round(0, word(m_stripe + i)), 27) * P1 + P4;
+
+			for (; i < m_stripe_bytes; ++i)
+				h = rotl64(h ^ (m_stripe[i] * P5), 11) * P1;
+
+			h ^= h >> 33;
+			h *= P2;
+			h ^= h >> 29;
+			h *= P3;
+			h ^= h >> 32;
+
+			return h;
+		}
+
+		inline const uint64_t blob_checksum::block_hash(const unsigned char* data, const size_t& size, const uint64_t& index)
+		{
+			blob_checksum c;
+
+			c.m_index = index;
+			c.start_block();
+			c.consume(data, size);
+
+			return c.end_block();
+		}
+
+		inline void blob_checksum::update(const unsigned char* data, size_t size)
+		{
+			while (size > 0)
+			{
+				size_t n = std::min(size, BLOCK_SIZE - m_block_bytes);
+
+				consume(data, n);
+				data += n;
+				size -= n;
+
+				if (m_block_bytes == BLOCK_SIZE)
+				{
+					m_fold = fold(m_fold, end_block());
+					++m_index;
+					start_block();
+				}
+			}
+		}
+
+		inline const uint64_t blob_checksum::finish() const
+		{
+			// the last, partial block; an empty input is one empty block
+			if (m_block_bytes > 0 || m_index == 0)
+				return fold(m_fold, end_block());
+
+			return m_fold;
+		}
+
+		inline const uint64_t blob_checksum::compute(const unsigned char* data, const size_t& size, const bool& parallel)
+		{
+			const size_t block = BLOCK_SIZE;
+			size_t blocks = std::max<size_t>(1, (size + block - 1) / block);
+			std::vector<uint64_t> hashes(blocks);
+
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					hashes[i] = block_hash(data + i * block, std::min(block, size - i * block), i);
+			};
+
+			if (parallel)
+				parallel_for(blocks, 4, kernel);
+			else
+				kernel(0, 0, blocks);
+
+			uint64_t h = P5;
+
+			for (const uint64_t& b : hashes)
+				h = fold(h, b);
+
+			return h;
+		}
+
+		inline void encode_blob_header(const blob_header& h, unsigned char (&out)[blob_header::SIZE])
+		{
+			std::memset(out, 0, sizeof(out));
+
+			store_le(out, blob_header::MAGIC, 4);
+			store_le(out + 4, h.version, 2);
+			store_le(out + 6, static_cast<uint64_t>(blob_header::SIZE), 2);
+			out[8] = h.kind;
+			out[9] = h.scalar;
+			store_le(out + 12, h.alignment, 4);
+			store_le(out + 16, h.count, 8);
+			store_le(out + 24, h.data_offset, 8);
+			store_le(out + 32, h.data_bytes, 8);
+			store_le(out + 40, h.checksum, 8);
+			store_le(out + 48, h.flags, 4);
+			store_le(out + 52, h.rows, 2);
+			store_le(out + 54, h.cols, 2);
+			store_le(out + 56, blob_checksum::compute(out, 56) & 0xffffffffu, 4);
+		}
+
+		inline const blob_status decode_blob_header(const unsigned char* in, const size_t& available, blob_header& h)
+		{
+			if (available < blob_header::SIZE || load_le(in, 4) != blob_header::MAGIC)
+				return blob_status::bad_header;
+
+			if (load_le(in + 56, 4) != (blob_checksum::compute(in, 56) & 0xffffffffu))
+				return blob_status::bad_header;
+
+			h.version = static_cast<uint16_t>(load_le(in + 4, 2));
+
+			if (h.version > blob_header::VERSION)
+				return blob_status::unsupported_version;
+
+			h.kind = in[8];
+			h.scalar = in[9];
+			h.alignment = static_cast<uint32_t>(load_le(in + 12, 4));
+			h.count = load_le(in + 16, 8);
+			h.data_offset = load_le(in + 24, 8);
+			h.data_bytes = load_le(in + 32, 8);
+			h.checksum = load_le(in + 40, 8);
+			h.flags = static_cast<uint32_t>(load_le(in + 48, 4));
+			h.rows = static_cast<uint16_t>(load_le(in + 52, 2));
+			h.cols = static_cast<uint16_t>(load_le(in + 54, 2));
+
+			const uint64_t element_size = static_cast<uint64_t>(blob_scalar_size(h.scalar)) * h.rows * h.cols;
+
+			if (load_le(in + 6, 2) != blob_header::SIZE || element_size == 0)
+				return blob_status::bad_header;
+
+			if (h.alignment == 0 || (h.alignment & (h.alignment - 1)) != 0 || h.data_offset < blob_header::SIZE || h.data_offset % h.alignment != 0)
+				return blob_status::bad_header;
+
+			if (h.data_bytes / element_size != h.count || h.data_bytes % element_size != 0)
+				return blob_status::bad_header;
+
+			// the end of the data has to be representable before it can be compared with the file size
+			if (h.data_bytes > std::numeric_limits<uint64_t>::max() - h.data_offset)
+				return blob_status::bad_header;
+
+			return blob_status::ok;
+		}
+	}
+
+	// Streams a blob of V to a file, any number of elements per write. The header is completed by close().
+	template <typename V>
+	class blob_writer
+	{
+	public:
+		// constructors
+		blob_writer() : m_file(nullptr), m_status(blob_status::ok) {}
+		blob_writer(const blob_writer<V>&) = delete;
+		blob_writer<V>& operator=(const blob_writer<V>&) = delete;
+
+		~blob_writer()
+		{
+			close();
+		}
+
+		// Modifiers
+		blob_status open(const std::string& path, const blob_options& options = blob_options());
+		blob_status write(const V* data, const size_t& count);
+
+		// any span of V, such as a vec_span or mat_span over an interleaved buffer
+		template <typename S>
+		blob_status write(const S& span);
+
+		blob_status close();
+
+		// Accessors
+		inline const size_t count() const
+		{
+			return static_cast<size_t>(m_header.count);
+		}
+
+	private:
+		blob_status write_bytes(const unsigned char* data, const size_t& size);
+
+		std::FILE* m_file;
+		blob_status m_status;
+		blob_header m_header;
+		bool m_checksum;
+		support::blob_checksum m_hash;
+	};
+
+	// Streams a blob of V from a file, for data sets larger than memory. With 'verify' the data is hashed as it is read
+	// and finish() compares the result with the stored checksum.
+	template <typename V>
+	class blob_reader
+	{
+	public:
+		// constructors
+		blob_reader() : m_file(nullptr), m_status(blob_status::ok), m_read(0), m_verify(false) {}
+		blob_reader(const blob_reader<V>&) = delete;
+		blob_reader<V>& operator=(const blob_reader<V>&) = delete;
+
+		~blob_reader()
+		{
+			close();
+		}
+
+		// Modifiers
+		blob_status open(const std::string& path, const bool& verify = false);
+
+		// reads up to 'count' elements, returns the number read, 0 at the end or after an error
+		size_t read(V* out, const size_t& count);
+		blob_status finish();
+		void close();
+
+		// Accessors
+		inline const blob_header& header() const
+		{
+			return m_header;
+		}
+
+		inline const size_t remaining() const
+		{
+			return static_cast<size_t>(m_header.count) - m_read;
+		}
+
+		inline const blob_status status() const
+		{
+			return m_status;
+		}
+
+	private:
+		std::FILE* m_file;
+		blob_status m_status;
+		blob_header m_header;
+		size_t m_read;
+		bool m_verify;
+		support::blob_checksum m_hash;
+	};
+
+	// A blob of V mapped read only, its elements used in place. Opening costs a page fault, not a read of the file.
+	template <typename V>
+	class mapped_blob
+	{
+	public:
+		// constructors
+		mapped_blob() : m_data(nullptr) {}
+
+		// Modifiers
+		blob_status open(const std::string& path, const bool& sequential = false);
+		void close();
+
+		// Accessors
+		inline const V* data() const
+		{
+			return m_data;
+		}
+
+		inline const size_t size() const
+		{
+			return static_cast<size_t>(m_header.count);
+		}
+
+		inline const V& operator[](const size_t& index) const
+		{
+			assert(index < size());
+
+			return m_data[index];
+		}
+
+		inline const blob_header& header() const
+		{
+			return m_header;
+		}
+
+		// Utility functions
+
+		// Hashes the data section, on all cores with 'parallel', and compares it with the stored checksum
+		blob_status verify(const bool& parallel = false) const;
+
+	private:
+		support::mapped_file m_file;
+		blob_header m_header;
+		const V* m_data;
+	};
+
+	// Whole arrays at once
+	template <typename V>
+	blob_status save_blob(const std::string& path, const V* data, const size_t& count, const blob_options& options = blob_options());
+
+	// 'out' is left empty unless the whole blob loads
+	template <typename V>
+	blob_status load_blob(const std::string& path, std::vector<V>& out, const bool& verify = true);
+
+	template <typename V>
+	blob_status blob_writer<V>::open(const std::string& path, const blob_options& options)
+	{
+		close();
+
+		assert(options.alignment > 0 && (options.alignment & (options.alignment - 1)) == 0);
+
+		m_header = support::blob_header_for<V>();
+		m_header.alignment = static_cast<uint32_t>(std::max<size_t>(options.alignment, alignof(V)));
+		m_header.data_offset = (blob_header::SIZE + m_header.alignment - 1) / m_header.alignment * m_header.alignment;
+		m_header.flags = options.checksum ? blob_header::HAS_CHECKSUM : 0;
+		m_checksum = options.checksum;
+		m_hash = support::blob_checksum();
+		m_status = blob_status::ok;
+
+		m_file = std::fopen(path.c_str(), "wb");
+
+		if (!m_file)
+			return m_status = blob_status::open_failed;
+
+		// the header is rewritten by close(), until then the file is not a valid blob
+		std::vector<unsigned char> padding(static_cast<size_t>(m_header.data_offset), 0);
+
+		if (std::fwrite(padding.data(), 1, padding.size(), m_file) != padding.size())
+			m_status = blob_status::io_error;
+
+		return m_status;
+	}
+
+	template <typename V>
+	blob_status blob_writer<V>::write_bytes(const unsigned char* data, const size_t& size)
+	{
+		if (!m_file)
+			return blob_status::io_error;
+
+		if (m_status != blob_status::ok)
+			return m_status;
+
+		if (!support::host_little_endian())
+		{
+			typedef typename support::blob_element<V>::component_type T;
+
+			std::vector<unsigned char> swapped(data, data + size);
+			support::swap_components(swapped.data(), sizeof(T), size / sizeof(T));
+
+			if (m_checksum)
+				m_hash.update(swapped.data(), size);
+
+			if (std::fwrite(swapped.data(), 1, size, m_file) != size)
+				m_status = blob_status::io_error;
+
+			return m_status;
+		}
+
+		if (m_checksum)
+			m_hash.update(data, size);
+
+		if (std::fwrite(data, 1, size, m_file) != size)
+			m_status = blob_status::io_error;
+
+		return m_status;
+	}
+
+	template <typename V>
+	blob_status blob_writer<V>::write(const V* data, const size_t& count)
+	{
+		blob_status s = write_bytes(reinterpret_cast<const unsigned char*>(data), count * sizeof(V));
+
+		if (s == blob_status::ok)
+			m_header.count += count;
+
+		return s;
+	}
+
+	template <typename V>
+	template <typename S>
+	blob_status blob_writer<V>::write(const S& span)
+	{
+		// packed a chunk at a time, 64 KiB of elements
+		const size_t chunk = std::max<size_t>(1, (64 << 10) / sizeof(V));
+		std::vector<V> packed(std::min(chunk, span.size()));
+
+		for (size_t i = 0; i < span.size(); i += chunk)
+		{
+			size_t n = std::min(chunk, span.size() - i);
+
+			for (size_t k = 0; k < n; ++k)
+				packed[k] = span[i + k];
+
+			blob_status s = write(packed.data(), n);
+
+			if (s != blob_status::ok)
+				return s;
+		}
+
+		return m_status;
+	}
+
+	template <typename V>
+	blob_status blob_writer<V>::close()
+	{
+		if (!m_file)
+			return m_status;
+
+		if (m_status == blob_status::ok)
+		{
+			unsigned char bytes[blob_header::SIZE];
+
+			m_header.data_bytes = m_header.count * sizeof(V);
+			m_header.checksum = m_checksum ? m_hash.finish() : 0;
+
+			support::encode_blob_header(m_header, bytes);
+
+			if (std::fseek(m_file, 0, SEEK_SET) != 0 || std::fwrite(bytes, 1, sizeof(bytes), m_file) != sizeof(bytes))
+				m_status = blob_status::io_error;
+		}
+
+		if (std::fclose(m_file) != 0 && m_status == blob_status::ok)
+			m_status = blob_status::io_error;
+
+		m_file = nullptr;
+
+		return m_status;
+	}
+
+	template <typename V>
+	blob_status blob_reader<V>::open(const std::string& path, const bool& verify)
+	{
+		close();
+
+		m_read = 0;
+		m_verify = verify;
+		m_hash = support::blob_checksum();
+		m_header = blob_header();
+
+		m_file = std::fopen(path.c_str(), "rb");
+
+		if (!m_file)
+			return m_status = blob_status::open_failed;
+
+		unsigned char bytes[blob_header::SIZE];
+		size_t got = std::fread(bytes, 1, sizeof(bytes), m_file);
+
+		m_status = support::decode_blob_header(bytes, got, m_header);
+
+		if (m_status == blob_status::ok && !support::blob_same_type(m_header, support::blob_header_for<V>()))
+			m_status = blob_status::type_mismatch;
+
+		// the header's count is only trusted once the file is long enough to hold it, as mapped_blob checks
+		long size = -1;
+
+		if (m_status == blob_status::ok && std::fseek(m_file, 0, SEEK_END) == 0)
+			size = std::ftell(m_file);
+
+		if (m_status == blob_status::ok && (size < 0 || m_header.data_offset > static_cast<uint64_t>(size) || m_header.data_bytes > static_cast<uint64_t>(size) - m_header.data_offset))
+			m_status = blob_status::truncated;
+
+		if (m_status == blob_status::ok && std::fseek(m_file, static_cast<long>(m_header.data_offset), SEEK_SET) != 0)
+			m_status = blob_status::truncated;
+
+		if (m_status != blob_status::ok)
+		{
+			std::fclose(m_file);
+			m_file = nullptr;
+			m_header.count = 0;
+		}
+
+		return m_status;
+	}
+
+	template <typename V>
+	size_t blob_reader<V>::read(V* out, const size_t& count)
+	{
+		if (!m_file || m_status != blob_status::ok)
+			return 0;
+
+		size_t n = std::min(count, remaining());
+		size_t got = std::fread(out, sizeof(V), n, m_file);
+
+		if (got < n)
+			m_status = blob_status::truncated;
+
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(out);
+
+		if (m_verify)
+			m_hash.update(bytes, got * sizeof(V));
+
+		if (!support::host_little_endian())
+		{
+			typedef typename support::blob_element<V>::component_type T;
+
+			support::swap_components(bytes, sizeof(T), got * sizeof(V) / sizeof(T));
+		}
+
+		m_read += got;
+
+		return got;
+	}
+
+	template <typename V>
+	blob_status blob_reader<V>::finish()
+	{
+		if (m_status == blob_status::ok && m_verify && remaining() == 0 && (m_header.flags & blob_header::HAS_CHECKSUM) && m_hash.finish() != m_header.checksum)
+			m_status = blob_status::checksum_mismatch;
+
+		close();
+
+		return m_status;
+	}
+
+	template <typename V>
+	void blob_reader<V>::close()
+	{
+		if (m_file)
+			std::fclose(m_file);
+
+		m_file = nullptr;
+	}
+
+	template <typename V>
+	blob_status mapped_blob<V>::open(const std::string& path, const bool& sequential)
+	{
+		close();
+
+		// the file holds little-endian components, a big-endian host has to go through blob_reader
+		if (!support::host_little_endian())
+			return blob_status::unsupported_host;
+
+		if (!m_file.open(path, sequential))
+			return blob_status::open_failed;
+
+		blob_status s = support::decode_blob_header(m_file.data(), m_file.size(), m_header);
+
+		if (s == blob_status::ok && !support::blob_same_type(m_header, support::blob_header_for<V>()))
+			s = blob_status::type_mismatch;
+
+		if (s == blob_status::ok && m_header.data_offset % alignof(V) != 0)
+			s = blob_status::bad_header;
+
+		if (s == blob_status::ok && (m_header.data_offset > m_file.size() || m_header.data_bytes > m_file.size() - m_header.data_offset))
+			s = blob_status::truncated;
+
+		if (s != blob_status::ok)
+		{
+			close();
+			return s;
+		}
+
+		m_data = reinterpret_cast<const V*>(m_file.data() + m_header.data_offset);
+
+		return blob_status::ok;
+	}
+
+	template <typename V>
+	void mapped_blob<V>::close()
+	{
+		m_file.close();
+		m_header = blob_header();
+		m_data = nullptr;
+	}
+
+	template <typename V>
+	blob_status mapped_blob<V>::verify(const bool& parallel) const
+	{
+		if (!m_data)
+			return blob_status::open_failed;
+
+		if (!(m_header.flags & blob_header::HAS_CHECKSUM))
+			return blob_status::ok;
+
+		const uint64_t h = support::blob_checksum::compute(reinterpret_cast<const unsigned char*>(m_data), static_cast<size_t>(m_header.data_bytes), parallel);
+
+		return h == m_header.checksum ? blob_status::ok : blob_status::checksum_mismatch;
+	}
+
+	template <typename V>
+	blob_status save_blob(const std::string& path, const V* data, const size_t& count, const blob_options& options)
+	{
+		blob_writer<V> writer;
+
+		if (writer.open(path, options) == blob_status::ok)
+			writer.write(data, count);
+
+		return writer.close();
+	}
+
+	template <typename V>
+	blob_status load_blob(const std::string& path, std::vector<V>& out, const bool& verify)
+	{
+		blob_reader<V> reader;
+		blob_status s = reader.open(path, verify);
+
+		out.clear();
+
+		if (s != blob_status::ok)
+			return s;
+
+		// open has checked the count against the file size, so this never allocates more than the file holds
+		out.resize(reader.remaining());
+		reader.read(out.data(), out.size());
+
+		s = reader.finish();
+
+		if (s != blob_status::ok)
+			out.clear();
+
+		return s;
+	}
+}
+
+#endif
@@ -0,0 +1,541 @@
+#ifndef _RM_SOLVE_H
+#define _RM_SOLVE_H
+
+#include <algorithm>
+#include <type_traits>
+
+#include "svd.h"
+#include "support/matrix.h"
+
+namespace react
+{
+	namespace support
+	{
+		// Calls f(std::integral_constant<size_t, I>()) for I in [BEGIN, END), expanded at compile time. Loops nested inside f
+		// see the index as a constant, so their bounds are known and the small solvers unroll completely.
+		template <size_t BEGIN, size_t END>
+		struct unroll
+		{
+			template <typename F>
+			static inline void apply(F&& f)
+			{
+				f(std::integral_constant<size_t, BEGIN>());
+				unroll<BEGIN + 1, END>::apply(f);
+			}
+		};
+
+		template <size_t END>
+		struct unroll<END, END>
+		{
+			template <typename F>
+			static inline void apply(F&&) {}
+		};
+	}
+
+	// Cholesky factorization A = L L^T of a small symmetric positive definite matrix, only the lower triangle of A is read.
+	template <size_t N, typename T>
+	class cholesky
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// constructors
+		explicit cholesky(const support::matrix<N, N, T>& a);
+
+		// Accessors
+
+		// false when A is not numerically positive definite, solve() must not be used then
+		inline const bool valid() const;
+
+		// Utility functions
+		const support::vector<N, T> solve(const support::vector<N, T>& b) const;
+
+		support::matrix<N, N, T> l;
+
+	private:
+		bool m_valid;
+	};
+
+	// LU factorization P A = L U of a small square matrix with partial pivoting
+	template <size_t N, typename T>
+	class lu
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// constructors
+		explicit lu(const support::matrix<N, N, T>& a);
+
+		// Accessors
+
+		// false when A is numerically singular, solve() must not be used then
+		inline const bool valid() const;
+
+		// Utility functions
+		const support::vector<N, T> solve(const support::vector<N, T>& b) const;
+		const T determinant() const;
+
+	private:
+		support::matrix<N, N, T> m_lu;
+		size_t m_pivot[N];
+		T m_sign;
+		bool m_valid;
+	};
+
+	// Householder QR factorization A = Q R of a matrix with at least as many rows as columns. Q is kept implicitly as the
+	// Householder reflections below the diagonal, R is upper triangular.
+	// credit Golub and Van Loan, Matrix Computations, 5.2
+	template <size_t M, size_t N, typename T>
+	class qr
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static_assert(N >= M, "'qr' needs at least as many rows as columns");
+
+		static const size_t ROWS = N;
+		static const size_t COLS = M;
+
+		// constructors
+		explicit qr(const support::matrix<M, N, T>& a);
+
+		// Accessors
+
+		// false when A does not have full column rank, solve() must not be used then. Without column pivoting QR does not
+		// reveal the rank reliably, so a diagonal of R below sqrt(epsilon) times the largest one already counts as deficient.
+		inline const bool valid() const;
+
+		// Thin factors, Q is ROWS x COLS with orthonormal columns and R is COLS x COLS
+		const support::matrix<M, N, T> q() const;
+		const support::matrix<M, M, T> r() const;
+
+		// Utility functions
+		const support::vector<N, T> apply_qt(const support::vector<N, T>& b) const;
+
+		// Least squares solution x minimizing |A x - b|
+		const support::vector<M, T> solve(const support::vector<N, T>& b) const;
+
+		// Moore-Penrose pseudo inverse R^-1 Q^T
+		const support::matrix<N, M, T> pseudo_inverse() const;
+
+	private:
+		support::matrix<M, N, T> m_qr;
+		T m_tau[M];
+		bool m_valid;
+	};
+
+	// Least squares solution of A x = b. Full rank overdetermined systems use QR, rank deficient and underdetermined
+	// systems take the minimum norm solution from the SVD.
+	template <size_t M, size_t N, typename T>
+	const support::vector<M, T> least_squares(const support::matrix<M, N, T>& a, const support::vector<N, T>& b);
+
+	// Moore-Penrose pseudo inverse, from QR when A has full column rank and from the SVD otherwise
+	template <size_t M, size_t N, typename T>
+	const support::matrix<N, M, T> pseudo_inverse(const support::matrix<M, N, T>& a);
+
+	template <size_t N, typename T>
+	cholesky<N, T>::cholesky(const support::matrix<N, N, T>& a) : l(static_cast<T>(0)), m_valid(true)
+	{
+		for (size_t j = 0; j < N; ++j)
+		{
+			T d = a.at(j, j);
+
+			for (size_t k = 0; k < j; ++k)
+				d -= l.at(j, k) * l.at(j, k);
+
+			if (!(d > 0))
+			{
+				m_valid = false;
+				return;
+			}
+
+			l.at(j, j) = sqrt(d);
+
+			for (size_t i = j + 1; i < N; ++i)
+			{
+				T s = a.at(i, j);
+
+				for (size_t k = 0; k < j; ++k)
+					s -= l.at(i, k) * l.at(j, k);
+
+				l.at(i, j) = s / l.at(j, j);
+			}
+		}
+	}
+
+	template <size_t N, typename T>
+	inline const bool cholesky<N, T>::valid() const
+	{
+		return m_valid;
+	}
+
+	template <size_t N, typename T>
+	const support::vector<N, T> cholesky<N, T>::solve(const support::vector<N, T>& b) const
+	{
+		support::vector<N, T> x = b;
+
+		// L y = b, then L^T x = y
+		for (size_t i = 0; i < N; ++i)
+		{
+			for (size_t k = 0; k < i; ++k)
+				x[i] -= l.at(i, k) * x[k];
+
+			x[i] /= l.at(i, i);
+		}
+
+		for (size_t i = N; i-- > 0;)
+		{
+			for (size_t k = i + 1; k < N; ++k)
+				x[i] -= l.at(k, i) * x[k];
+
+			x[i] /= l.at(i, i);
+		}
+
+		return x;
+	}
+
+	template <size_t N, typename T>
+	lu<N, T>::lu(const support::matrix<N, N, T>& a) : m_lu(a), m_sign(1), m_valid(true)
+	{
+		T largest = 0;
+
+		for (size_t i = 0; i < N * N; ++i)
+			largest = std::max(largest, std::abs(a.m_data[i]));
+
+		const T tiny = largest * std::numeric_limits<T>::epsilon() * static_cast<T>(N);
+
+		for (size_t i = 0; i < N; ++i)
+			m_pivot[i] = i;
+
+		for (size_t j = 0; j < N; ++j)
+		{
+			size_t p = j;
+
+			for (size_t i = j + 1; i < N; ++i)
+				if (std::abs(m_lu.at(i, j)) > std::abs(m_lu.at(p, j)))
+					p = i;
+
+			if (!(std::abs(m_lu.at(p, j)) > tiny))
+			{
+				m_valid = false;
+				return;
+			}
+
+			if (p != j)
+			{
+				m_lu.swap_row(p, j);
+				std::swap(m_pivot[p], m_pivot[j]);
+				m_sign = -m_sign;
+			}
+
+			for (size_t i = j + 1; i < N; ++i)
+			{
+				T f = m_lu.at(i, j) / m_lu.at(j, j);
+
+				m_lu.at(i, j) = f;
+
+				for (size_t k = j + 1; k < N; ++k)
+					m_lu.at(i, k) -= f * m_lu.at(j, k);
+			}
+		}
+	}
+
+	template <size_t N, typename T>
+	inline const bool lu<N, T>::valid() const
+	{
+		return m_valid;
+	}
+
+	template <size_t N, typename T>
+	const support::vector<N, T> lu<N, T>::solve(const support::vector<N, T>& b) const
+	{
+		support::vector<N, T> x;
+
+		// L y = P b with unit diagonal L, then U x = y
+		for (size_t i = 0; i < N; ++i)
+		{
+			x[i] = b[m_pivot[i]];
+
+			for (size_t k = 0; k < i; ++k)
+				x[i] -= m_lu.at(i, k) * x[k];
+		}
+
+		for (size_t i = N; i-- > 0;)
+		{
+			for (size_t k = i + 1; k < N; ++k)
+				x[i] -= m_lu.at(i, k) * x[k];
+
+			x[i] /= m_lu.at(i, i);
+		}
+
+		return x;
+	}
+
+	template <size_t N, typename T>
+	const T lu<N, T>::determinant() const
+	{
+		if (!m_valid)
+			return 0;
+
+		T det = m_sign;
+
+		for (size_t i = 0; i < N; ++i)
+			det *= m_lu.at(i, i);
+
+		return det;
+	}
+
+	template <size_t M, size_t N, typename T>
+	qr<M, N, T>::qr(const support::matrix<M, N, T>& a) : m_qr(a), m_valid(true)
+	{
+		T largest = 0;
+		T smallest = std::numeric_limits<T>::max();
+
+		support::unroll<0, M>::apply([&](auto index)
+		{
+			const size_t k = decltype(index)::value;
+
+			// reflect column k below the diagonal onto a multiple of e_k, v is scaled so that v_k = 1
+			T norm = 0;
+
+			for (size_t i = k; i < ROWS; ++i)
+				norm += m_qr.at(i, k) * m_qr.at(i, k);
+
+			norm = sqrt(norm);
+
+			const T x0 = m_qr.at(k, k);
+
+			if (norm <= 0)
+			{
+				m_tau[k] = 0;
+				smallest = 0;
+				return;
+			}
+
+			const T alpha = x0 >= 0 ? -norm : norm;
+			const T scale = static_cast<T>(1) / (x0 - alpha);
+
+			for (size_t i = k + 1; i < ROWS; ++i)
+				m_qr.at(i, k) *= scale;
+
+			m_tau[k] = (alpha - x0) / alpha;
+			m_qr.at(k, k) = alpha;
+
+			largest = std::max(largest, norm);
+			smallest = std::min(smallest, norm);
+
+			for (size_t j = k + 1; j < COLS; ++j)
+			{
+				T s = m_qr.at(k, j);
+
+				for (size_t i = k + 1; i < ROWS; ++i)
+					s += m_qr.at(i, k) * m_qr.at(i, j);
+
+				s *= m_tau[k];
+				m_qr.at(k, j) -= s;
+
+				for (size_t i = k + 1; i < ROWS; ++i)
+					m_qr.at(i, j) -= s * m_qr.at(i, k);
+			}
+		});
+
+		m_valid = smallest > largest * sqrt(std::numeric_limits<T>::epsilon());
+	}
+
+	template <size_t M, size_t N, typename T>
+	inline const bool qr<M, N, T>::valid() const
+	{
+		return m_valid;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::matrix<M, N, T> qr<M, N, T>::q() const
+	{
+		support::matrix<M, N, T> tmp(static_cast<T>(0));
+
+		for (size_t k = 0; k < COLS; ++k)
+			tmp.at(k, k) = 1;
+
+		// H_0 ... H_(COLS-1) applied to the first COLS columns of the identity
+		for (size_t k = COLS; k-- > 0;)
+		{
+			for (size_t j = k; j < COLS; ++j)
+			{
+				T s = tmp.at(k, j);
+
+				for (size_t i = k + 1; i < ROWS; ++i)
+					s += m_qr.at(i, k) * tmp.at(i, j);
+
+				s *= m_tau[k];
+				tmp.at(k, j) -= s;
+
+				for (size_t i = k + 1; i < ROWS; ++i)
+					tmp.at(i, j) -= s * m_qr.at(i, k);
+			}
+		}
+
+		return tmp;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::matrix<M, M, T> qr<M, N, T>::r() const
+	{
+		support::matrix<M, M, T> tmp(static_cast<T>(0));
+
+		for (size_t row = 0; row < COLS; ++row)
+			for (size_t col = row; col < COLS; ++col)
+				tmp.at(row, col) = m_qr.at(row, col);
+
+		return tmp;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::vector<N, T> qr<M, N, T>::apply_qt(const support::vector<N, T>& b) const
+	{
+		support::vector<N, T> y = b;
+
+		support::unroll<0, M>::apply([&](auto index)
+		{
+			const size_t k = decltype(index)::value;
+
+			T s = y[k];
+
+			for (size_t i = k + 1; i < ROWS; ++i)
+				s += m_qr.at(i, k) * y[i];
+
+			s *= m_tau[k];
+			y[k] -= s;
+
+			for (size_t i = k + 1; i < ROWS; ++i)
+				y[i] -= s * m_qr.at(i, k);
+		});
+
+		return y;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::vector<M, T> qr<M, N, T>::solve(const support::vector<N, T>& b) const
+	{
+		support::vector<N, T> y = apply_qt(b);
+		support::vector<M, T> x;
+
+		// R x = (Q^T b)[0, COLS)
+		for (size_t i = COLS; i-- > 0;)
+		{
+			T s = y[i];
+
+			for (size_t k = i + 1; k < COLS; ++k)
+				s -= m_qr.at(i, k) * x[k];
+
+			x[i] = s / m_qr.at(i, i);
+		}
+
+		return x;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::matrix<N, M, T> qr<M, N, T>::pseudo_inverse() const
+	{
+		const support::matrix<M, N, T> thin = q();
+		support::matrix<N, M, T> tmp;
+
+		// R X = Q^T, one back substitution per column of Q^T
+		for (size_t j = 0; j < ROWS; ++j)
+		{
+			for (size_t i = COLS; i-- > 0;)
+			{
+				T s = thin.at(j, i);
+
+				for (size_t k = i + 1; k < COLS; ++k)
+					s -= m_qr.at(i, k) * tmp.at(k, j);
+
+				tmp.at(i, j) = s / m_qr.at(i, i);
+			}
+		}
+
+		return tmp;
+	}
+
+	namespace support
+	{
+		template <size_t M, size_t N, typename T>
+		const matrix<N, M, T> svd_pseudo_inverse(const matrix<M, N, T>& a)
+		{
+			const svd<M, N, T> d(a);
+			const size_t rank = d.rank();
+			const size_t cols = M;
+			const size_t rows = N;
+
+			matrix<N, M, T> tmp(static_cast<T>(0));
+
+			// V diag(1 / values) U^T over the numerically non-zero singular values
+			for (size_t k = 0; k < rank; ++k)
+			{
+				const T inv = static_cast<T>(1) / d.values.m_data[k];
+
+				for (size_t row = 0; row < cols; ++row)
+					for (size_t col = 0; col < rows; ++col)
+						tmp.at(row, col) += d.v.at(row, k) * inv * d.u.at(col, k);
+			}
+
+			return tmp;
+		}
+
+		template <size_t M, size_t N, typename T>
+		const matrix<N, M, T> pseudo_inverse(const matrix<M, N, T>& a, std::true_type)
+		{
+			const qr<M, N, T> f(a);
+
+			if (f.valid())
+				return f.pseudo_inverse();
+
+			return svd_pseudo_inverse(a);
+		}
+
+		template <size_t M, size_t N, typename T>
+		const matrix<N, M, T> pseudo_inverse(const matrix<M, N, T>& a, std::false_type)
+		{
+			return svd_pseudo_inverse(a);
+		}
+
+		template <size_t M, size_t N, typename T>
+		const vector<M, T> least_squares(const matrix<M, N, T>& a, const vector<N, T>& b, std::true_type)
+		{
+			const qr<M, N, T> f(a);
+
+			if (f.valid())
+				return f.solve(b);
+
+			return least_squares(a, b, std::false_type());
+		}
+
+		template <size_t M, size_t N, typename T>
+		const vector<M, T> least_squares(const matrix<M, N, T>& a, const vector<N, T>& b, std::false_type)
+		{
+			const matrix<N, M, T> p = svd_pseudo_inverse(a);
+			vector<M, T> x;
+
+			for (size_t i = 0; i < M; ++i)
+				x[i] = p.row(i).dot(b);
+
+			return x;
+		}
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::vector<M, T> least_squares(const support::matrix<M, N, T>& a, const support::vector<N, T>& b)
+	{
+		return support::least_squares(a, b, std::integral_constant<bool, N >= M>());
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::matrix<N, M, T> pseudo_inverse(const support::matrix<M, N, T>& a)
+	{
+		return support::pseudo_inverse(a, std::integral_constant<bool, N >= M>());
+	}
+}
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef _RM_SPAN_H
+#define _RM_SPAN_H
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mat2.h"
+#include "mat3.h"
+#include "mat4.h"
+
+namespace react
+{
+	namespace support
+	{
+		// Memory we do not own is only read as V when V is exactly C tightly packed components of T
+		template <typename V, typename T, size_t C>
+		struct check_layout
+		{
+			static_assert(std::is_standard_layout<V>::value, "V must be standard layout");
+			static_assert(sizeof(V) == C * sizeof(T), "V must be tightly packed components");
+			static_assert(alignof(V) == alignof(T), "V must be aligned like its components");
+			using type = V;
+		};
+
+		template <typename V, typename T, size_t C>
+		inline V& layout_cast(T* data)
+		{
+			assert(reinterpret_cast<uintptr_t>(data) % alignof(T) == 0);
+
+			return *reinterpret_cast<typename check_layout<V, T, C>::type*>(data);
+		}
+
+		template <size_t S, typename T>
+		struct vec_span_element
+		{
+			typedef vector<S, T> type;
+		};
+
+		template <typename T>
+		struct vec_span_element<2, T>
+		{
+			typedef vec2<T> type;
+		};
+
+		template <typename T>
+		struct vec_span_element<3, T>
+		{
+			typedef vec3<T> type;
+		};
+
+		template <typename T>
+		struct vec_span_element<4, T>
+		{
+			typedef vec4<T> type;
+		};
+
+		// Read only view of count elements V, each C components of T, starting at data and 'stride' bytes apart.
+		// The elements are read in place, so a span over an interleaved vertex buffer or a mapped file needs no copy.
+		template <typename V, typename T, size_t C>
+		class strided_span
+		{
+			typedef typename check_layout<V, T, C>::type cl;
+
+		public:
+			typedef V value_type;
+			typedef T component_type;
+			static const size_t COMPONENTS = C;
+
+			// constructors
+			strided_span() : m_data(nullptr), m_size(0), m_stride(sizeof(V)) {}
+			strided_span(const T* data, const size_t& count, const size_t& stride);
+			strided_span(const V* data, const size_t& count);
+
+			// Accessors
+			inline const V& operator[](const size_t& index) const;
+			inline const T* data() const;
+			inline const size_t size() const;
+			inline const bool empty() const;
+
+			// stride between elements in bytes, and in components for the strided kernels
+			inline const size_t stride() const;
+			inline const size_t component_stride() const;
+
+		protected:
+			const T* m_data;
+			size_t m_size;
+			size_t m_stride;
+		};
+
+		template <typename V, typename T, size_t C>
+		strided_span<V, T, C>::strided_span(const T* data, const size_t& count, const size_t& stride) : m_data(data), m_size(count), m_stride(stride)
+		{
+			assert(stride % sizeof(T) == 0 && stride >= sizeof(V));
+			assert(reinterpret_cast<uintptr_t>(data) % alignof(T) == 0);
+		}
+
+		template <typename V, typename T, size_t C>
+		strided_span<V, T, C>::strided_span(const V* data, const size_t& count) : m_data(data ? data->m_data : nullptr), m_size(count), m_stride(sizeof(V))
+		{
+		}
+
+		template <typename V, typename T, size_t C>
+		inline const V& strided_span<V, T, C>::operator[](const size_t& index) const
+		{
+			assert(index < m_size);
+
+			return *reinterpret_cast<const V*>(reinterpret_cast<const char*>(m_data) + index * m_stride);
+		}
+
+		template <typename V, typename T, size_t C>
+		inline const T* strided_span<V, T, C>::data() const
+		{
+			return m_data;
+		}
+
+		template <typename V, typename T, size_t C>
+		inline const size_t strided_span<V, T, C>::size() const
+		{
+			return m_size;
+		}
+
+		template <typename V, typename T, size_t C>
+		inline const bool strided_span<V, T, C>::empty() const
+		{
+			return m_size == 0;
+		}
+
+		template <typename V, typename T, size_t C>
+		inline const size_t strided_span<V, T, C>::stride() const
+		{
+			return m_stride;
+		}
+
+		template <typename V, typename T, size_t C>
+		inline const size_t strided_span<V, T, C>::component_stride() const
+		{
+			return m_stride / sizeof(T);
+		}
+
+		// Writable view, derived from the read only span R so it converts to it (and deduces as it) where a kernel only reads
+		template <typename R, typename V, typename T>
+		class writable_span : public R
+		{
+		public:
+			// constructors
+			writable_span() : R() {}
+			writable_span(T* data, const size_t& count, const size_t& stride) : R(data, count, stride) {}
+			writable_span(V* data, const size_t& count) : R(data, count) {}
+
+			// Accessors
+			inline V& operator[](const size_t& index) const
+			{
+				return const_cast<V&>(R::operator[](index));
+			}
+
+			inline T* data() const
+			{
+				return const_cast<T*>(R::data());
+			}
+		};
+	}
+
+	// Strided views of vectors and matrices in memory owned elsewhere. vec_span<S, const T> reads, vec_span<S, T>
+	// also writes and converts to the read only span. The stride is in bytes and a multiple of sizeof(T), e.g.
+	//
+	//     vec_span<3, const float> positions(reinterpret_cast<const float*>(vertices), count, 32);
+	//     vec_span<3, const float> normals(reinterpret_cast<const float*>(vertices) + 3, count, 32);
+	//
+	// A span does not own its data, it must not outlive the buffer it views.
+	template <size_t S, typename T = float>
+	class vec_span;
+
+	template <size_t S, typename T>
+	class vec_span<S, const T> : public support::strided_span<typename support::vec_span_element<S, T>::type, T, S>
+	{
+	public:
+		typedef support::strided_span<typename support::vec_span_element<S, T>::type, T, S> base_type;
+
+		vec_span() : base_type() {}
+		vec_span(const T* data, const size_t& count, const size_t& stride) : base_type(data, count, stride) {}
+		vec_span(const support::vector<S, T>* data, const size_t& count) : base_type(static_cast<const typename base_type::value_type*>(data), count) {}
+	};
+
+	template <size_t S, typename T>
+	class vec_span : public support::writable_span<vec_span<S, const T>, typename support::vec_span_element<S, T>::type, T>
+	{
+	public:
+		typedef support::writable_span<vec_span<S, const T>, typename support::vec_span_element<S, T>::type, T> base_type;
+
+		vec_span() : base_type() {}
+		vec_span(T* data, const size_t& count, const size_t& stride) : base_type(data, count, stride) {}
+		vec_span(support::vector<S, T>* data, const size_t& count) : base_type(static_cast<typename support::vec_span_element<S, T>::type*>(data), count) {}
+	};
+
+	template <size_t M, size_t N, typename T = float>
+	class mat_span;
+
+	template <size_t M, size_t N, typename T>
+	class mat_span<M, N, const T> : public support::strided_span<support::matrix<M, N, T>, T, M * N>
+	{
+	public:
+		typedef support::strided_span<support::matrix<M, N, T>, T, M * N> base_type;
+
+		mat_span() : base_type() {}
+		mat_span(const T* data, const size_t& count, const size_t& stride) : base_type(data, count, stride) {}
+		mat_span(const support::matrix<M, N, T>* data, const size_t& count) : base_type(data, count) {}
+	};
+
+	template <size_t M, size_t N, typename T>
+	class mat_span : public support::writable_span<mat_span<M, N, const T>, support::matrix<M, N, T>, T>
+	{
+	public:
+		typedef support::writable_span<mat_span<M, N, const T>, support::matrix<M, N, T>, T> base_type;
+
+		mat_span() : base_type() {}
+		mat_span(T* data, const size_t& count, const size_t& stride) : base_type(data, count, stride) {}
+		mat_span(support::matrix<M, N, T>* data, const size_t& count) : base_type(data, count) {}
+	};
+
+	// In place reinterpretation of tightly packed components, e.g. as_vec3(p) = as_vec3(p) * 2.0f scales p[0..2]
+	template <typename T>
+	inline vec2<T>& as_vec2(T* data)
+	{
+		return support::layout_cast<vec2<T>, T, 2>(data);
+	}
+
+	template <typename T>
+	inline const vec2<T>& as_vec2(const T* data)
+	{
+		return support::layout_cast<const vec2<T>, const T, 2>(data);
+	}
+
+	template <typename T>
+	inline vec3<T>& as_vec3(T* data)
+	{
+		return support::layout_cast<vec3<T>, T, 3>(data);
+	}
+
+	template <typename T>
+	inline const vec3<T>& as_vec3(const T* data)
+	{
+		return support::layout_cast<const vec3<T>, const T, 3>(data);
+	}
+
+	template <typename T>
+	inline vec4<T>& as_vec4(T* data)
+	{
+		return support::layout_cast<vec4<T>, T, 4>(data);
+	}
+
+	template <typename T>
+	inline const vec4<T>& as_vec4(const T* data)
+	{
+		return support::layout_cast<const vec4<T>, const T, 4>(data);
+	}
+
+	// column major, as matrix stores them
+	template <typename T>
+	inline support::matrix<3, 3, T>& as_mat3(T* data)
+	{
+		return support::layout_cast<support::matrix<3, 3, T>, T, 9>(data);
+	}
+
+	template <typename T>
+	inline const support::matrix<3, 3, T>& as_mat3(const T* data)
+	{
+		return support::layout_cast<const support::matrix<3, 3, T>, const T, 9>(data);
+	}
+
+	template <typename T>
+	inline support::matrix<4, 4, T>& as_mat4(T* data)
+	{
+		return support::layout_cast<support::matrix<4, 4, T>, T, 16>(data);
+	}
+
+	template <typename T>
+	inline const support::matrix<4, 4, T>& as_mat4(const T* data)
+	{
+		return support::layout_cast<const support::matrix<4, 4, T>, const T, 16>(data);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef vec_span<2, float> vec2f_span;
+	typedef vec_span<3, float> vec3f_span;
+	typedef vec_span<4, float> vec4f_span;
+	typedef mat_span<3, 3, float> mat3f_span;
+	typedef mat_span<4, 4, float> mat4f_span;
+#endif
+}
+
+#endif
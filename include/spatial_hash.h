@@ -0,0 +1,558 @@
+#ifndef _RM_SPATIAL_HASH_H
+#define _RM_SPATIAL_HASH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "vec3.h"
+#include "aabb.h"
+#include "span.h"
+#include "support/csr.h"
+#include "support/parallel.h"
+
+namespace react
+{
+	// Uniform grid over 3D points, hashed into a table sized to the point count. Points are counting-sorted
+	// by cell into one contiguous array, so a cell is a range [cell_start[h], cell_start[h + 1]) and the
+	// structure holds no per-cell allocations.
+	template <typename T>
+	class spatial_hash
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static const uint32_t EMPTY = 0xffffffffu;
+
+		// constructors
+		spatial_hash() : m_cell_size(1), m_inv_cell_size(1) {}
+		explicit spatial_hash(const T& cell_size) : m_cell_size(cell_size), m_inv_cell_size(static_cast<T>(1) / cell_size) {}
+
+		// Modifiers
+		void build(const vec3<T>* points, const size_t& count, const bool& parallel = false);
+
+		// Re-bins moved points (same count as the last build). Keeps all allocations and only re-sorts when a point
+		// changed cell, returns whether it did.
+		const bool update(const vec3<T>* points, const bool& parallel = false);
+		void clear();
+
+		// Queries, report indices into the built point array
+		template <typename F>
+		void radius(const vec3<T>& center, const T& r, F&& f) const;
+		size_t radius(const vec3<T>& center, const T& r, std::vector<uint32_t>& indices) const;
+
+		// Batch radius query, results of query i are indices[offsets[i] .. offsets[i + 1]). The queries are an array or
+		// a strided span.
+		void radius(const vec3<T>* centers, const size_t& count, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel = false) const;
+		void radius(const vec_span<3, const T>& centers, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel = false) const;
+
+		// k nearest points sorted by distance, returns how many were found (< k only when there are fewer points)
+		size_t nearest(const vec3<T>& p, const size_t& k, uint32_t* indices, T* distances_squared = nullptr) const;
+
+		// Batch k nearest, k results per query, unused slots are EMPTY
+		void nearest(const vec3<T>* queries, const size_t& count, const size_t& k, uint32_t* indices, const bool& parallel = false) const;
+		void nearest(const vec_span<3, const T>& queries, const size_t& k, uint32_t* indices, const bool& parallel = false) const;
+
+		// Accessors
+		inline const T& cell_size() const;
+		inline const size_t size() const;
+		inline const size_t table_size() const;
+
+	private:
+		struct cell
+		{
+			int32_t x;
+			int32_t y;
+			int32_t z;
+		};
+
+		inline const cell cell_of(const vec3<T>& p) const;
+		inline const int32_t cell_coordinate(const T& x) const;
+		inline const uint32_t hash(const cell& c) const;
+		void sort(const vec3<T>* points, const bool& parallel);
+		void update_bounds();
+
+		template <typename F>
+		inline void visit_cell(const cell& c, const vec3<T>& center, const T& r2, F&& f) const;
+
+		template <typename F>
+		inline void visit_row(const int32_t& x0, const int32_t& x1, const int32_t& y, const int32_t& z, const vec3<T>& center, const T& r2, F&& f) const;
+
+		size_t nearest(const vec3<T>& p, const size_t& k, uint32_t* indices, T* distances_squared, std::vector<T>& scratch) const;
+
+		T m_cell_size;
+		T m_inv_cell_size;
+
+		cell m_min_cell = {};
+		cell m_max_cell = {};
+
+		std::vector<uint32_t> m_hashes;
+		std::vector<uint32_t> m_cell_start;
+		std::vector<uint32_t> m_indices;
+		std::vector<vec3<T>> m_points;
+	};
+
+	template <typename T>
+	inline const typename spatial_hash<T>::cell spatial_hash<T>::cell_of(const vec3<T>& p) const
+	{
+		return cell{ cell_coordinate(p.x()), cell_coordinate(p.y()), cell_coordinate(p.z()) };
+	}
+
+	// Clamped to +-2^29 cells, where the ring arithmetic in nearest still fits int32_t, instead of overflowing the
+	// cast. Points further out share the outermost cells, so queries stay exact and only get slower there. NaN lands
+	// in the lowest cell.
+	template <typename T>
+	inline const int32_t spatial_hash<T>::cell_coordinate(const T& x) const
+	{
+		const T bound = static_cast<T>(1 << 29);
+
+		return static_cast<int32_t>(std::min(bound, std::max(-bound, std::floor(x * m_inv_cell_size))));
+	}
+
+	// credit Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+	// x is added rather than multiplied, so a row of cells maps to consecutive slots and is scanned as one range
+	template <typename T>
+	inline const uint32_t spatial_hash<T>::hash(const cell& c) const
+	{
+		uint32_t h = static_cast<uint32_t>(c.x) + ((static_cast<uint32_t>(c.y) * 19349663u) ^ (static_cast<uint32_t>(c.z) * 83492791u));
+
+		return h & static_cast<uint32_t>(m_cell_start.size() - 2);
+	}
+
+	template <typename T>
+	void spatial_hash<T>::build(const vec3<T>* points, const size_t& count, const bool& parallel)
+	{
+		assert(count < EMPTY);
+
+		size_t table = 1;
+
+		// about two slots per point keeps the chains short
+		while (table < 2 * count)
+			table <<= 1;
+
+		m_cell_start.assign(table + 1, 0);
+		m_hashes.resize(count);
+		m_indices.resize(count);
+		m_points.resize(count);
+
+		auto hash_points = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				m_hashes[i] = hash(cell_of(points[i]));
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 14, hash_points);
+		else
+			hash_points(0, 0, count);
+
+		sort(points, parallel);
+	}
+
+	template <typename T>
+	const bool spatial_hash<T>::update(const vec3<T>* points, const bool& parallel)
+	{
+		std::atomic<bool> moved(false);
+
+		auto rehash = [&](size_t, size_t begin, size_t end)
+		{
+			bool changed = false;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				uint32_t h = hash(cell_of(points[i]));
+
+				changed |= h != m_hashes[i];
+				m_hashes[i] = h;
+			}
+
+			if (changed)
+				moved = true;
+		};
+
+		size_t count = m_hashes.size();
+
+		if (parallel)
+			support::parallel_for(count, 1 << 14, rehash);
+		else
+			rehash(0, 0, count);
+
+		if (moved)
+		{
+			std::fill(m_cell_start.begin(), m_cell_start.end(), 0);
+			sort(points, parallel);
+
+			return true;
+		}
+
+		// same cells, refresh the positions in sorted order
+		auto refresh = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				m_points[i] = points[m_indices[i]];
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 14, refresh);
+		else
+			refresh(0, 0, count);
+
+		// an unchanged hash can still be a different (colliding) cell
+		update_bounds();
+
+		return false;
+	}
+
+	template <typename T>
+	void spatial_hash<T>::sort(const vec3<T>* points, const bool& parallel)
+	{
+		size_t count = m_hashes.size();
+		size_t table = m_cell_start.size() - 1;
+
+		if (parallel && support::parallel_chunks(count, 1 << 14) > 1)
+		{
+			std::unique_ptr<std::atomic<uint32_t>[]> cursor(new std::atomic<uint32_t>[table]);
+
+			support::parallel_for(table, 1 << 14, [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					cursor[i].store(0, std::memory_order_relaxed);
+			});
+
+			support::parallel_for(count, 1 << 14, [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					cursor[m_hashes[i]].fetch_add(1, std::memory_order_relaxed);
+			});
+
+			uint32_t sum = 0;
+
+			for (size_t h = 0; h < table; ++h)
+			{
+				m_cell_start[h] = sum;
+				sum += cursor[h].load(std::memory_order_relaxed);
+				cursor[h].store(m_cell_start[h], std::memory_order_relaxed);
+			}
+
+			m_cell_start[table] = sum;
+
+			support::parallel_for(count, 1 << 14, [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					m_indices[cursor[m_hashes[i]].fetch_add(1, std::memory_order_relaxed)] = static_cast<uint32_t>(i);
+			});
+
+			// the scatter order inside a cell depends on scheduling, restore index order so results are deterministic
+			support::parallel_for(table, 1 << 14, [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t h = begin; h < end; ++h)
+					std::sort(m_indices.begin() + m_cell_start[h], m_indices.begin() + m_cell_start[h + 1]);
+			});
+		}
+		else
+		{
+			for (size_t i = 0; i < count; ++i)
+				++m_cell_start[m_hashes[i]];
+
+			uint32_t sum = 0;
+
+			for (size_t h = 0; h <= table; ++h)
+			{
+				uint32_t n = m_cell_start[h];
+				m_cell_start[h] = sum;
+				sum += n;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+				m_indices[m_cell_start[m_hashes[i]]++] = static_cast<uint32_t>(i);
+
+			// the scatter advanced every start to the next cell's start
+			for (size_t h = table; h > 0; --h)
+				m_cell_start[h] = m_cell_start[h - 1];
+
+			m_cell_start[0] = 0;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			m_points[i] = points[m_indices[i]];
+
+		update_bounds();
+	}
+
+	template <typename T>
+	void spatial_hash<T>::update_bounds()
+	{
+		cell lo = { std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max() };
+		cell hi = { std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min() };
+
+		for (const vec3<T>& p : m_points)
+		{
+			cell c = cell_of(p);
+
+			lo = cell{ std::min(lo.x, c.x), std::min(lo.y, c.y), std::min(lo.z, c.z) };
+			hi = cell{ std::max(hi.x, c.x), std::max(hi.y, c.y), std::max(hi.z, c.z) };
+		}
+
+		m_min_cell = lo;
+		m_max_cell = hi;
+	}
+
+	template <typename T>
+	void spatial_hash<T>::clear()
+	{
+		m_hashes.clear();
+		m_cell_start.clear();
+		m_indices.clear();
+		m_points.clear();
+	}
+
+	template <typename T>
+	template <typename F>
+	inline void spatial_hash<T>::visit_cell(const cell& c, const vec3<T>& center, const T& r2, F&& f) const
+	{
+		uint32_t h = hash(c);
+
+		for (uint32_t i = m_cell_start[h]; i < m_cell_start[h + 1]; ++i)
+		{
+			T d2 = m_points[i].distance_squared(center);
+
+			if (d2 > r2)
+				continue;
+
+			// other cells can hash to the same slot, only report a point from its own cell so it is seen once
+			cell pc = cell_of(m_points[i]);
+
+			if (pc.x == c.x && pc.y == c.y && pc.z == c.z)
+				f(m_indices[i], d2);
+		}
+	}
+
+	template <typename T>
+	template <typename F>
+	inline void spatial_hash<T>::visit_row(const int32_t& x0, const int32_t& x1, const int32_t& y, const int32_t& z, const vec3<T>& center, const T& r2, F&& f) const
+	{
+		uint32_t first = hash(cell{ x0, y, z });
+		uint32_t last = first + static_cast<uint32_t>(x1 - x0);
+
+		// the row wraps around the table, fall back to cell by cell
+		if (last + 1 >= m_cell_start.size())
+		{
+			for (int32_t x = x0; x <= x1; ++x)
+				visit_cell(cell{ x, y, z }, center, r2, f);
+
+			return;
+		}
+
+		for (uint32_t i = m_cell_start[first]; i < m_cell_start[last + 1]; ++i)
+		{
+			T d2 = m_points[i].distance_squared(center);
+
+			if (d2 > r2)
+				continue;
+
+			cell pc = cell_of(m_points[i]);
+
+			if (pc.y == y && pc.z == z && pc.x >= x0 && pc.x <= x1)
+				f(m_indices[i], d2);
+		}
+	}
+
+	template <typename T>
+	template <typename F>
+	void spatial_hash<T>::radius(const vec3<T>& center, const T& r, F&& f) const
+	{
+		if (m_indices.empty())
+			return;
+
+		cell lo = cell_of(center - vec3<T>(r));
+		cell hi = cell_of(center + vec3<T>(r));
+
+		lo = cell{ std::max(lo.x, m_min_cell.x), std::max(lo.y, m_min_cell.y), std::max(lo.z, m_min_cell.z) };
+		hi = cell{ std::min(hi.x, m_max_cell.x), std::min(hi.y, m_max_cell.y), std::min(hi.z, m_max_cell.z) };
+
+		if (lo.x > hi.x)
+			return;
+
+		T r2 = r * r;
+
+		for (int32_t z = lo.z; z <= hi.z; ++z)
+			for (int32_t y = lo.y; y <= hi.y; ++y)
+				visit_row(lo.x, hi.x, y, z, center, r2, f);
+	}
+
+	template <typename T>
+	size_t spatial_hash<T>::radius(const vec3<T>& center, const T& r, std::vector<uint32_t>& indices) const
+	{
+		size_t before = indices.size();
+
+		radius(center, r, [&](const uint32_t& index, const T&) { indices.push_back(index); });
+
+		return indices.size() - before;
+	}
+
+	template <typename T>
+	void spatial_hash<T>::radius(const vec3<T>* centers, const size_t& count, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel) const
+	{
+		radius(vec_span<3, const T>(centers, count), r, offsets, indices, parallel);
+	}
+
+	template <typename T>
+	void spatial_hash<T>::radius(const vec_span<3, const T>& centers, const T& r, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel) const
+	{
+		support::gather_rows(centers.size(), [&](const size_t& i, std::vector<uint32_t>& out) { radius(centers[i], r, out); }, offsets, indices, parallel);
+	}
+
+	template <typename T>
+	size_t spatial_hash<T>::nearest(const vec3<T>& p, const size_t& k, uint32_t* indices, T* distances_squared) const
+	{
+		std::vector<T> scratch;
+
+		return nearest(p, k, indices, distances_squared, scratch);
+	}
+
+	template <typename T>
+	size_t spatial_hash<T>::nearest(const vec3<T>& p, const size_t& k, uint32_t* indices, T* distances_squared, std::vector<T>& scratch) const
+	{
+		if (m_indices.empty() || k == 0)
+			return 0;
+
+		if (!distances_squared)
+		{
+			scratch.resize(k);
+			distances_squared = scratch.data();
+		}
+
+		// candidates kept sorted in the output arrays, nearest first and ties by index, a point tied with the last of
+		// k still displaces it when its index is lower
+		size_t found = 0;
+
+		auto before = [&](const T& d2, const uint32_t& index, const size_t& j)
+		{
+			return d2 < distances_squared[j] || (d2 == distances_squared[j] && index < indices[j]);
+		};
+
+		auto insert = [&](const uint32_t& index, const T& d2)
+		{
+			if (found == k && !before(d2, index, k - 1))
+				return;
+
+			size_t j = found < k ? found++ : k - 1;
+
+			for (; j > 0 && before(d2, index, j - 1); --j)
+			{
+				distances_squared[j] = distances_squared[j - 1];
+				indices[j] = indices[j - 1];
+			}
+
+			distances_squared[j] = d2;
+			indices[j] = index;
+		};
+
+		// once k candidates are known, only closer points can change the result
+		auto limit = [&]()
+		{
+			return found == k ? distances_squared[k - 1] : std::numeric_limits<T>::infinity();
+		};
+
+		cell c = cell_of(p);
+
+		int32_t max_ring = std::max({ c.x - m_min_cell.x, m_max_cell.x - c.x, c.y - m_min_cell.y, m_max_cell.y - c.y, c.z - m_min_cell.z, m_max_cell.z - c.z });
+
+		for (int32_t ring = 0; ring <= max_ring; ++ring)
+		{
+			// visit the shell of cells at Chebyshev distance 'ring' from the query cell, clipped to the occupied cells
+			int32_t z0 = std::max(c.z - ring, m_min_cell.z), z1 = std::min(c.z + ring, m_max_cell.z);
+			int32_t y0 = std::max(c.y - ring, m_min_cell.y), y1 = std::min(c.y + ring, m_max_cell.y);
+			int32_t x0 = std::max(c.x - ring, m_min_cell.x), x1 = std::min(c.x + ring, m_max_cell.x);
+
+			for (int32_t z = z0; z <= z1; ++z)
+			{
+				for (int32_t y = y0; y <= y1; ++y)
+				{
+					if (ring > 0 && z != c.z - ring && z != c.z + ring && y != c.y - ring && y != c.y + ring)
+					{
+						if (c.x - ring >= m_min_cell.x)
+							visit_cell(cell{ c.x - ring, y, z }, p, limit(), insert);
+
+						if (c.x + ring <= m_max_cell.x)
+							visit_cell(cell{ c.x + ring, y, z }, p, limit(), insert);
+
+						continue;
+					}
+
+					if (x0 <= x1)
+						visit_row(x0, x1, y, z, p, limit(), insert);
+				}
+			}
+
+			// everything outside the visited block is at least 'ring' cells away
+			T reach = static_cast<T>(ring) * m_cell_size;
+
+			if (found == k && distances_squared[k - 1] <= reach * reach)
+				break;
+		}
+
+		return found;
+	}
+
+	template <typename T>
+	void spatial_hash<T>::nearest(const vec3<T>* queries, const size_t& count, const size_t& k, uint32_t* indices, const bool& parallel) const
+	{
+		nearest(vec_span<3, const T>(queries, count), k, indices, parallel);
+	}
+
+	template <typename T>
+	void spatial_hash<T>::nearest(const vec_span<3, const T>& queries, const size_t& k, uint32_t* indices, const bool& parallel) const
+	{
+		const size_t count = queries.size();
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			std::vector<T> scratch;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				size_t found = nearest(queries[i], k, indices + i * k, nullptr, scratch);
+
+				for (size_t j = found; j < k; ++j)
+					indices[i * k + j] = EMPTY;
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 10, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	inline const T& spatial_hash<T>::cell_size() const
+	{
+		return m_cell_size;
+	}
+
+	template <typename T>
+	inline const size_t spatial_hash<T>::size() const
+	{
+		return m_indices.size();
+	}
+
+	template <typename T>
+	inline const size_t spatial_hash<T>::table_size() const
+	{
+		return m_cell_start.empty() ? 0 : m_cell_start.size() - 1;
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef spatial_hash<float> spatial_hashf;
+	typedef spatial_hash<double> spatial_hashd;
+#endif
+}
+
+#endif
@@ -0,0 +1,567 @@
+#ifndef _RM_STORAGE_H
+#define _RM_STORAGE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "span.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Compact scalar encodings for data that is stored far more than it is computed on. Each converts to float
+	// implicitly, so arithmetic on them is float arithmetic, and is assigned from float with rounding to nearest even.
+	//
+	//     half      IEEE 754 binary16, +-65504 with 11 significant bits, inf and nan kept
+	//     snorm16   [-1, 1] in 1 / 32767 steps, -32768 reads as -1
+	//     unorm8    [0, 1] in 1 / 255 steps
+	//
+	// Out of range values saturate, to inf for half and to the ends of the range for the normalized types.
+	namespace support
+	{
+		inline uint32_t float_bits(const float& f)
+		{
+			uint32_t u;
+			std::memcpy(&u, &f, sizeof(u));
+
+			return u;
+		}
+
+		inline float bits_float(const uint32_t& u)
+		{
+			float f;
+			std::memcpy(&f, &u, sizeof(f));
+
+			return f;
+		}
+
+		// credit https://gist.github.com/rygorous/2156668, the round to nearest even variant
+		inline uint16_t float_to_half_bits(const float& f)
+		{
+#ifdef _REACT_SIMD_F16C
+			return static_cast<uint16_t>(_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(f), 0), 0));
+#else
+			const uint32_t f16_max = (127 + 16) << 23;
+			const uint32_t denorm_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+			uint32_t u = float_bits(f);
+			uint32_t sign = u & 0x80000000u;
+			uint16_t h;
+
+			u ^= sign;
+
+			if (u >= f16_max)
+			{
+				// inf stays inf, nan becomes a quiet nan
+				h = u > 0x7f800000u ? 0x7e00 : 0x7c00;
+			}
+			else if (u < (113u << 23))
+			{
+				// subnormal or zero, let the float adder do the rounding
+				h = static_cast<uint16_t>(float_bits(bits_float(u) + bits_float(denorm_magic)) - denorm_magic);
+			}
+			else
+			{
+				uint32_t odd = (u >> 13) & 1u;
+
+				u += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu;
+				u += odd;
+				h = static_cast<uint16_t>(u >> 13);
+			}
+
+			return static_cast<uint16_t>(h | (sign >> 16));
+#endif
+		}
+
+		inline float half_bits_to_float(const uint16_t& h)
+		{
+#ifdef _REACT_SIMD_F16C
+			return _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(h)));
+#else
+			const uint32_t shifted_exp = 0x7c00u << 13;
+
+			uint32_t u = (h & 0x7fffu) << 13;
+			uint32_t exp = u & shifted_exp;
+
+			u += (127 - 15) << 23;
+
+			if (exp == shifted_exp)
+			{
+				u += (128 - 16) << 23;
+			}
+			else if (exp == 0)
+			{
+				// subnormal, renormalize through the float unit
+				u += 1 << 23;
+				u = float_bits(bits_float(u) - bits_float(113u << 23));
+			}
+
+			return bits_float(u | (static_cast<uint32_t>(h & 0x8000u) << 16));
+#endif
+		}
+	}
+
+	struct half
+	{
+		uint16_t bits;
+
+		half() : bits(0) {}
+		explicit half(const float& f) : bits(support::float_to_half_bits(f)) {}
+
+		half& operator=(const float& f)
+		{
+			bits = support::float_to_half_bits(f);
+
+			return *this;
+		}
+
+		operator float() const
+		{
+			return support::half_bits_to_float(bits);
+		}
+	};
+
+	struct snorm16
+	{
+		int16_t bits;
+
+		snorm16() : bits(0) {}
+		explicit snorm16(const float& f) : bits(encode(f)) {}
+
+		snorm16& operator=(const float& f)
+		{
+			bits = encode(f);
+
+			return *this;
+		}
+
+		operator float() const
+		{
+			float f = bits / 32767.0f;
+
+			return f > -1.0f ? f : -1.0f;
+		}
+
+		static int16_t encode(const float& f)
+		{
+			float x = f * 32767.0f;
+			x = x < 32767.0f ? x : 32767.0f;
+			x = x > -32767.0f ? x : -32767.0f;
+
+			return static_cast<int16_t>(support::round_nearest_even(x));
+		}
+	};
+
+	struct unorm8
+	{
+		uint8_t bits;
+
+		unorm8() : bits(0) {}
+		explicit unorm8(const float& f) : bits(encode(f)) {}
+
+		unorm8& operator=(const float& f)
+		{
+			bits = encode(f);
+
+			return *this;
+		}
+
+		operator float() const
+		{
+			return bits / 255.0f;
+		}
+
+		static uint8_t encode(const float& f)
+		{
+			float x = f * 255.0f;
+			x = x < 255.0f ? x : 255.0f;
+			x = x > 0.0f ? x : 0.0f;
+
+			return static_cast<uint8_t>(support::round_nearest_even(x));
+		}
+	};
+
+	namespace support
+	{
+		// Flat arrays of components to and from float. The SIMD bodies round exactly as the scalar conversions do.
+		template <typename E>
+		inline void storage_encode(const float* in, E* out, const size_t& begin, const size_t& end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				out[i] = in[i];
+		}
+
+		template <typename E>
+		inline void storage_decode(const E* in, float* out, const size_t& begin, const size_t& end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				out[i] = in[i];
+		}
+
+#ifdef _REACT_SIMD_F16C
+		inline void storage_encode(const float* in, half* out, const size_t& begin, const size_t& end)
+		{
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), 0));
+
+			storage_encode<half>(in, out, i, end);
+		}
+
+		inline void storage_decode(const half* in, float* out, const size_t& begin, const size_t& end)
+		{
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+
+			storage_decode<half>(in, out, i, end);
+		}
+#endif
+
+#ifdef _REACT_SIMD_SSE2
+		inline void storage_encode(const float* in, snorm16* out, const size_t& begin, const size_t& end)
+		{
+			const __m128 scale = _mm_set1_ps(32767.0f);
+			const __m128 bottom = _mm_set1_ps(-32767.0f);
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m128i a = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), scale), bottom));
+				__m128i b = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), scale), bottom));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+			}
+
+			storage_encode<snorm16>(in, out, i, end);
+		}
+
+		inline void storage_decode(const snorm16* in, float* out, const size_t& begin, const size_t& end)
+		{
+			const __m128 scale = _mm_set1_ps(32767.0f);
+			const __m128 bottom = _mm_set1_ps(-1.0f);
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+				// sign extend by shifting each word to the top of its lane and back
+				__m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(bits, bits), 16));
+				__m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(bits, bits), 16));
+
+				_mm_storeu_ps(out + i, _mm_max_ps(_mm_div_ps(lo, scale), bottom));
+				_mm_storeu_ps(out + i + 4, _mm_max_ps(_mm_div_ps(hi, scale), bottom));
+			}
+
+			storage_decode<snorm16>(in, out, i, end);
+		}
+
+		inline void storage_encode(const float* in, unorm8* out, const size_t& begin, const size_t& end)
+		{
+			const __m128 scale = _mm_set1_ps(255.0f);
+			const __m128 zero = _mm_setzero_ps();
+			size_t i = begin;
+
+			for (; i + 16 <= end; i += 16)
+			{
+				__m128i c[4];
+
+				for (int k = 0; k < 4; ++k)
+					c[k] = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4 * k), scale), scale), zero));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]), _mm_packs_epi32(c[2], c[3])));
+			}
+
+			storage_encode<unorm8>(in, out, i, end);
+		}
+
+		inline void storage_decode(const unorm8* in, float* out, const size_t& begin, const size_t& end)
+		{
+			const __m128 scale = _mm_set1_ps(255.0f);
+			const __m128i zero = _mm_setzero_si128();
+			size_t i = begin;
+
+			for (; i + 16 <= end; i += 16)
+			{
+				__m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+				__m128i lo = _mm_unpacklo_epi8(bits, zero);
+				__m128i hi = _mm_unpackhi_epi8(bits, zero);
+
+				_mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+				_mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+				_mm_storeu_ps(out + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+				_mm_storeu_ps(out + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+			}
+
+			storage_decode<unorm8>(in, out, i, end);
+		}
+#endif
+
+		// A vector of S encoded components. Reading one gives the float vector of the same size, and arithmetic goes
+		// through that, so storage vectors mix freely with vec3f and friends.
+		template <size_t S, typename E>
+		class storage_vector
+		{
+		private:
+			typedef typename check_vec_dimension<E, S>::type cd;
+
+		public:
+			static const size_t DIMENSION = S;
+			typedef E storage_type;
+			typedef typename vec_span_element<S, float>::type float_type;
+
+			// constructors
+			storage_vector() : m_data() {}
+			storage_vector(const vector<S, float>& v);
+
+			// Accessors
+			inline E& operator[](const size_t& index);
+			inline const E& operator[](const size_t& index) const;
+
+			inline const float_type get() const;
+
+			operator float_type() const
+			{
+				return get();
+			}
+
+			// Modifiers
+			inline void set(const vector<S, float>& v);
+
+			// Utility functions, in float
+			inline const float dot(const vector<S, float>& v) const;
+			inline const float length() const;
+			inline const float_type normalized() const;
+
+			friend float_type operator+(const storage_vector& a, const storage_vector& b) { return a.get() + b.get(); }
+			friend float_type operator+(const storage_vector& a, const vector<S, float>& b) { return a.get() + b; }
+			friend float_type operator+(const vector<S, float>& a, const storage_vector& b) { return b.get() + a; }
+
+			friend float_type operator-(const storage_vector& a, const storage_vector& b) { return a.get() - b.get(); }
+			friend float_type operator-(const storage_vector& a, const vector<S, float>& b) { return a.get() - b; }
+			friend float_type operator-(const vector<S, float>& a, const storage_vector& b) { return a - b.get(); }
+
+			friend float_type operator*(const storage_vector& a, const float& c) { return a.get() * c; }
+			friend float_type operator*(const float& c, const storage_vector& a) { return a.get() * c; }
+			friend float_type operator/(const storage_vector& a, const float& c) { return a.get() / c; }
+
+			friend std::ostream& operator<<(std::ostream& out, const storage_vector& v)
+			{
+				return out << v.get();
+			}
+
+		public:
+			E m_data[S];
+		};
+
+		template <size_t S, typename E>
+		storage_vector<S, E>::storage_vector(const vector<S, float>& v)
+		{
+			set(v);
+		}
+
+		template <size_t S, typename E>
+		inline E& storage_vector<S, E>::operator[](const size_t& index)
+		{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(index < S);
+#endif
+			return m_data[index];
+		}
+
+		template <size_t S, typename E>
+		inline const E& storage_vector<S, E>::operator[](const size_t& index) const
+		{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(index < S);
+#endif
+			return m_data[index];
+		}
+
+		template <size_t S, typename E>
+		inline const typename storage_vector<S, E>::float_type storage_vector<S, E>::get() const
+		{
+			float_type v;
+
+			for (size_t i = 0; i < S; ++i)
+				v.m_data[i] = m_data[i];
+
+			return v;
+		}
+
+		template <size_t S, typename E>
+		inline void storage_vector<S, E>::set(const vector<S, float>& v)
+		{
+			for (size_t i = 0; i < S; ++i)
+				m_data[i] = v.m_data[i];
+		}
+
+		template <size_t S, typename E>
+		inline const float storage_vector<S, E>::dot(const vector<S, float>& v) const
+		{
+			return get().dot(v);
+		}
+
+		template <size_t S, typename E>
+		inline const float storage_vector<S, E>::length() const
+		{
+			return get().length();
+		}
+
+		template <size_t S, typename E>
+		inline const typename storage_vector<S, E>::float_type storage_vector<S, E>::normalized() const
+		{
+			return get().normalized();
+		}
+	}
+
+	// Arrays of float vectors (vec3f, vector<3, float>, ...) to storage vectors and back, split over threads when
+	// 'parallel' is set
+	template <typename V, size_t S, typename E>
+	inline void storage_pack(const V* in, const size_t& count, support::storage_vector<S, E>* out, const bool& parallel = false)
+	{
+		typedef typename support::check_layout<V, float, S>::type cl;
+		typedef typename support::check_layout<support::storage_vector<S, E>, E, S>::type cs;
+
+		const float* from = reinterpret_cast<const float*>(static_cast<const cl*>(in));
+		E* to = reinterpret_cast<E*>(static_cast<cs*>(out));
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::storage_encode(from, to, begin, end);
+		};
+
+		if (parallel)
+			support::parallel_for(count * S, 1 << 16, kernel);
+		else
+			kernel(0, 0, count * S);
+	}
+
+	template <typename V, size_t S, typename E>
+	inline void storage_unpack(const support::storage_vector<S, E>* in, const size_t& count, V* out, const bool& parallel = false)
+	{
+		typedef typename support::check_layout<V, float, S>::type cl;
+		typedef typename support::check_layout<support::storage_vector<S, E>, E, S>::type cs;
+
+		const E* from = reinterpret_cast<const E*>(static_cast<const cs*>(in));
+		float* to = reinterpret_cast<float*>(static_cast<cl*>(out));
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::storage_decode(from, to, begin, end);
+		};
+
+		if (parallel)
+			support::parallel_for(count * S, 1 << 16, kernel);
+		else
+			kernel(0, 0, count * S);
+	}
+
+	// Strided spans, e.g. positions interleaved in a vertex buffer. A packed span takes the array path, any other
+	// stride is gathered (scattered) a block of 64 vectors at a time around the same encoder.
+	template <size_t S, typename E>
+	inline void storage_pack(const vec_span<S, const float>& in, support::storage_vector<S, E>* out, const bool& parallel = false)
+	{
+		typedef typename support::check_layout<support::storage_vector<S, E>, E, S>::type cs;
+
+		if (in.empty())
+			return;
+
+		if (in.stride() == S * sizeof(float))
+		{
+			storage_pack(&in[0], in.size(), out, parallel);
+			return;
+		}
+
+		const float* from = in.data();
+		const size_t stride = in.component_stride();
+		E* to = reinterpret_cast<E*>(static_cast<cs*>(out));
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			float block[64 * S];
+
+			for (size_t i = begin; i < end; i += 64)
+			{
+				const size_t m = std::min<size_t>(64, end - i);
+
+				for (size_t j = 0; j < m; ++j)
+					for (size_t c = 0; c < S; ++c)
+						block[j * S + c] = from[(i + j) * stride + c];
+
+				support::storage_encode(block, to + i * S, 0, m * S);
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(in.size(), 1 << 14, kernel);
+		else
+			kernel(0, 0, in.size());
+	}
+
+	template <size_t S, typename E>
+	inline void storage_unpack(const support::storage_vector<S, E>* in, const vec_span<S, float>& out, const bool& parallel = false)
+	{
+		typedef typename support::check_layout<support::storage_vector<S, E>, E, S>::type cs;
+
+		if (out.empty())
+			return;
+
+		if (out.stride() == S * sizeof(float))
+		{
+			storage_unpack(in, out.size(), &out[0], parallel);
+			return;
+		}
+
+		const E* from = reinterpret_cast<const E*>(static_cast<const cs*>(in));
+		float* to = out.data();
+		const size_t stride = out.component_stride();
+
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			float block[64 * S];
+
+			for (size_t i = begin; i < end; i += 64)
+			{
+				const size_t m = std::min<size_t>(64, end - i);
+
+				support::storage_decode(from + i * S, block, 0, m * S);
+
+				for (size_t j = 0; j < m; ++j)
+					for (size_t c = 0; c < S; ++c)
+						to[(i + j) * stride + c] = block[j * S + c];
+			}
+		};
+
+		if (parallel)
+			support::parallel_for(out.size(), 1 << 14, kernel);
+		else
+			kernel(0, 0, out.size());
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef support::storage_vector<2, half> vec2h;
+	typedef support::storage_vector<3, half> vec3h;
+	typedef support::storage_vector<4, half> vec4h;
+
+	typedef support::storage_vector<2, snorm16> vec2sn16;
+	typedef support::storage_vector<3, snorm16> vec3sn16;
+	typedef support::storage_vector<4, snorm16> vec4sn16;
+
+	typedef support::storage_vector<2, unorm8> vec2un8;
+	typedef support::storage_vector<3, unorm8> vec3un8;
+	typedef support::storage_vector<4, unorm8> vec4un8;
+#endif
+}
+
+#endif
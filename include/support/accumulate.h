@@ -0,0 +1,841 @@
+#ifndef _RM_ACCUMULATE_H
+#define _RM_ACCUMULATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "simd.h"
+
+namespace react
+{
+	// How a reduction of products (dot, length_squared, matrix multiply) sums its terms. native sums in T, in order
+	// for integers and short vectors and in 32 interleaved partial sums from 16 float or double terms. in_double
+	// sums float products in double, where they are exact, and rounds once at the end. compensated keeps a running
+	// Neumaier correction in T and, where the host has fma, the rounding error of each product too. pairwise sums
+	// in a balanced tree, error growing with log n rather than n. Each has SIMD bodies for float and integers
+	// always sum natively.
+	//
+	// With AVX2 and the data in cache (bench_accumulate), dots of 64-256 floats cost about 1.7x native in in_double,
+	// 3-4.7x compensated and 1.1-1.5x pairwise; 64 and 128 square matrix products 0.7-1.2x in_double, 1.6-2.5x
+	// compensated and 0.4-0.8x pairwise, the native product being the one loop not tiled over columns. in_double
+	// widens every float, one conversion per four, and the conversions all go to one port, while native retires
+	// eight fmas' worth of terms per load pair. compensated does about ten flops a term to native's one fma. Short pairwise
+	// dots wait on the latency of their few trees. Out of cache all of them approach native, which then waits on
+	// memory too. The precise modes are not all within 1.5x of native: in_double and compensated dots miss that
+	// target in cache, as do pairwise dots at the short end.
+	enum class accumulation
+	{
+		native,
+		in_double,
+		compensated,
+		pairwise
+	};
+
+	// The policy a vector or matrix type uses when a call does not name one. Specialize for a type to change it,
+	// e.g. for long feature vectors
+	//
+	//     template <> struct accumulation_traits<react::support::vector<128, float>>
+	//     {
+	//         static accumulation policy() { return accumulation::in_double; }
+	//     };
+	template <typename V>
+	struct accumulation_traits
+	{
+		static accumulation policy()
+		{
+			return accumulation::native;
+		}
+	};
+
+	namespace support
+	{
+		// float sums in double, everything else in itself
+		template <typename T>
+		struct accumulation_wide
+		{
+			typedef typename std::conditional<std::is_same<T, float>::value, double, T>::type type;
+		};
+
+		// From this many terms a native float or double reduction runs in INTERLEAVED_SUMS partial sums, term i
+		// into sum i % INTERLEAVED_SUMS, so the SIMD lanes and the several registers' dependency chains overlap
+		const size_t INTERLEAVED_MIN = 16;
+		const size_t INTERLEAVED_SUMS = 32;
+
+		struct product_term
+		{
+			template <typename L>
+			inline L operator()(const L& x, const L& y, const L& sum) const
+			{
+				return lane_fmadd(x, y, sum);
+			}
+		};
+
+		struct difference_term
+		{
+			template <typename L>
+			inline L operator()(const L& x, const L& y, const L& sum) const
+			{
+				const L d = x - y;
+
+				return lane_fmadd(d, d, sum);
+			}
+		};
+
+		// The partial sums s folded as (s[k] + s[k + 8]) + (s[k + 16] + s[k + 24]), then halved twice more
+		template <typename T>
+		inline T interleaved_fold(const T* s)
+		{
+			T t[8];
+
+			for (size_t k = 0; k < 8; ++k)
+				t[k] = (s[k] + s[k + 8]) + (s[k + 16] + s[k + 24]);
+
+			for (size_t k = 0; k < 4; ++k)
+				t[k] = t[k] + t[k + 4];
+
+			return (t[0] + t[2]) + (t[1] + t[3]);
+		}
+
+#ifdef _REACT_SIMD_SSE2
+		inline float interleaved_fold(const float4* s)
+		{
+			const __m128 lo = _mm_add_ps(_mm_add_ps(s[0].v, s[2].v), _mm_add_ps(s[4].v, s[6].v));
+			const __m128 hi = _mm_add_ps(_mm_add_ps(s[1].v, s[3].v), _mm_add_ps(s[5].v, s[7].v));
+
+			return lane_sum(float4(_mm_add_ps(lo, hi)));
+		}
+#endif
+
+#ifdef _REACT_SIMD_AVX2
+		inline float interleaved_fold(const float8* s)
+		{
+			const __m256 t = _mm256_add_ps(_mm256_add_ps(s[0].v, s[1].v), _mm256_add_ps(s[2].v, s[3].v));
+
+			return lane_sum(float8(t));
+		}
+#endif
+
+		// The whole groups of 8 terms go to the partial sums, folded as above, and the last n % 8 terms follow in
+		// order. The sums and the fold are the same at every lane width, so scalar, SSE2 and AVX2 builds with the
+		// same fma support agree bit for bit.
+		template <typename L, typename T, typename F>
+		inline T interleaved_sum_lanes(const T* a, const T* b, const size_t& n, const F& term)
+		{
+			const size_t W = lane_traits<L>::WIDTH;
+			const size_t R = INTERLEAVED_SUMS / W;
+
+			L sums[R];
+
+			for (size_t r = 0; r < R; ++r)
+				sums[r] = L(T(0));
+
+			const size_t blocks = n / INTERLEAVED_SUMS;
+			const size_t groups = (n % INTERLEAVED_SUMS) / 8;
+
+			for (size_t k = 0; k < blocks; ++k)
+			{
+				const T* pa = a + k * INTERLEAVED_SUMS;
+				const T* pb = b + k * INTERLEAVED_SUMS;
+
+				for (size_t r = 0; r < R; ++r)
+				{
+					L x, y;
+					lane_load(x, pa + r * W);
+					lane_load(y, pb + r * W);
+
+					sums[r] = term(x, y, sums[r]);
+				}
+			}
+
+			const size_t done = blocks * INTERLEAVED_SUMS;
+
+			for (size_t r = 0; r < groups * 8 / W; ++r)
+			{
+				L x, y;
+				lane_load(x, a + done + r * W);
+				lane_load(y, b + done + r * W);
+
+				sums[r] = term(x, y, sums[r]);
+			}
+
+			T total = interleaved_fold(sums);
+
+			const size_t begin = done + groups * 8;
+			const size_t count = n - begin;
+
+			for (size_t k = 0; k < count; ++k)
+				total = term(a[begin + k], b[begin + k], total);
+
+			return total;
+		}
+
+		template <typename T, typename F>
+		inline T interleaved_sum(const T* a, const T* b, const size_t& n, const F& term)
+		{
+			return interleaved_sum_lanes<T>(a, b, n, term);
+		}
+
+		template <typename F>
+		inline float interleaved_sum(const float* a, const float* b, const size_t& n, const F& term)
+		{
+#if defined(_REACT_SIMD_AVX2)
+			return interleaved_sum_lanes<float8>(a, b, n, term);
+#elif defined(_REACT_SIMD_SSE2)
+			return interleaved_sum_lanes<float4>(a, b, n, term);
+#else
+			return interleaved_sum_lanes<float>(a, b, n, term);
+#endif
+		}
+
+		// In order in T, as the plain loop always has, below INTERLEAVED_MIN terms or for integers
+		template <typename T>
+		inline T dot_native(const T* a, const T* b, const size_t& n)
+		{
+			if (std::is_floating_point<T>::value && n >= INTERLEAVED_MIN)
+				return interleaved_sum(a, b, n, product_term());
+
+			T tmp = 0;
+
+			for (size_t i = 0; i < n; ++i)
+				tmp += a[i] * b[i];
+
+			return tmp;
+		}
+
+		// The sum of (a[i] - b[i])^2, natively
+		template <typename T>
+		inline T distance_squared_native(const T* a, const T* b, const size_t& n)
+		{
+			if (std::is_floating_point<T>::value && n >= INTERLEAVED_MIN)
+				return interleaved_sum(a, b, n, difference_term());
+
+			T tmp = 0;
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				T d = a[i] - b[i];
+				tmp += d * d;
+			}
+
+			return tmp;
+		}
+
+		template <typename T>
+		inline T dot_in_double(const T* a, const T* b, const size_t& n)
+		{
+			typedef typename accumulation_wide<T>::type W;
+
+			W tmp = 0;
+
+			for (size_t i = 0; i < n; ++i)
+				tmp += static_cast<W>(a[i]) * static_cast<W>(b[i]);
+
+			return static_cast<T>(tmp);
+		}
+
+#ifdef _REACT_SIMD_SSE2
+		// Two float products are exact in double, so the order the lanes sum them in is the only difference from the
+		// scalar loop
+		inline float dot_in_double(const float* a, const float* b, const size_t& n)
+		{
+			size_t i = 0;
+			double tmp = 0.0;
+
+#ifdef _REACT_SIMD_AVX2
+			// eight chains, so the adds (or fmas) of one block do not wait on the previous block's
+			const size_t BLOCK = 32;
+			__m256d s[8];
+
+			for (size_t k = 0; k < 8; ++k)
+				s[k] = _mm256_setzero_pd();
+
+			for (; i + BLOCK <= n; i += BLOCK)
+			{
+				for (size_t k = 0; k < 4; ++k)
+				{
+					// four floats a load, widened straight from memory rather than extracted from a full register,
+					// which would put a shuffle beside every conversion on the one port they share
+					__m256d x0 = _mm256_cvtps_pd(_mm_loadu_ps(a + i + 8 * k));
+					__m256d x1 = _mm256_cvtps_pd(_mm_loadu_ps(a + i + 8 * k + 4));
+					__m256d y0 = _mm256_cvtps_pd(_mm_loadu_ps(b + i + 8 * k));
+					__m256d y1 = _mm256_cvtps_pd(_mm_loadu_ps(b + i + 8 * k + 4));
+
+#ifdef _REACT_SIMD_FMA
+					// the product is exact in double, so fusing it changes nothing but the instruction count
+					s[2 * k] = _mm256_fmadd_pd(x0, y0, s[2 * k]);
+					s[2 * k + 1] = _mm256_fmadd_pd(x1, y1, s[2 * k + 1]);
+#else
+					s[2 * k] = _mm256_add_pd(s[2 * k], _mm256_mul_pd(x0, y0));
+					s[2 * k + 1] = _mm256_add_pd(s[2 * k + 1], _mm256_mul_pd(x1, y1));
+#endif
+				}
+			}
+
+			alignas(32) double lanes[4];
+			_mm256_store_pd(lanes, _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(s[0], s[1]), _mm256_add_pd(s[2], s[3])),
+				_mm256_add_pd(_mm256_add_pd(s[4], s[5]), _mm256_add_pd(s[6], s[7]))));
+
+			tmp = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+			const size_t BLOCK = 8;
+			__m128d s[4] = { _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd() };
+
+			for (; i + BLOCK <= n; i += BLOCK)
+			{
+				__m128 a0 = _mm_loadu_ps(a + i);
+				__m128 a1 = _mm_loadu_ps(a + i + 4);
+				__m128 b0 = _mm_loadu_ps(b + i);
+				__m128 b1 = _mm_loadu_ps(b + i + 4);
+
+				s[0] = _mm_add_pd(s[0], _mm_mul_pd(_mm_cvtps_pd(a0), _mm_cvtps_pd(b0)));
+				s[1] = _mm_add_pd(s[1], _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a0, a0)), _mm_cvtps_pd(_mm_movehl_ps(b0, b0))));
+				s[2] = _mm_add_pd(s[2], _mm_mul_pd(_mm_cvtps_pd(a1), _mm_cvtps_pd(b1)));
+				s[3] = _mm_add_pd(s[3], _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a1, a1)), _mm_cvtps_pd(_mm_movehl_ps(b1, b1))));
+			}
+
+			alignas(16) double lanes[2];
+			_mm_store_pd(lanes, _mm_add_pd(_mm_add_pd(s[0], s[1]), _mm_add_pd(s[2], s[3])));
+
+			tmp = lanes[0] + lanes[1];
+#endif
+
+			// less than a block is left, a bound the compiler can see, or it assumes the tail may run off the array
+			const size_t rest = std::min(n - i, BLOCK - 1);
+
+			for (size_t k = 0; k < rest; ++k)
+				tmp += static_cast<double>(a[i + k]) * static_cast<double>(b[i + k]);
+
+			return static_cast<float>(tmp);
+		}
+#endif
+
+		// s + x as s, with the rounding error added to c. Knuth's two-sum, exact whichever operand is larger, so the
+		// error is the one Neumaier's comparison finds without the compare and selects. Lane for lane, so it works on
+		// registers and scalars alike.
+		template <typename L>
+		inline void lane_two_sum(L& s, L& c, const L& x)
+		{
+			const L t = s + x;
+			const L z = t - s;
+
+			c = c + ((s - (t - z)) + (x - z));
+			s = t;
+		}
+
+		// Products of a and b from i while a whole pair of registers is left, into the running sum and correction
+		template <typename L>
+		inline void dot_compensated_lanes(const float* a, const float* b, size_t& i, const size_t& n, float& sum, float& comp)
+		{
+			const size_t W = lane_traits<L>::WIDTH;
+			const L zero(0.0f);
+			L s[2] = { zero, zero };
+			L c[2] = { zero, zero };
+
+			if (n - i < 2 * W)
+				return;
+
+			for (; n - i >= 2 * W; i += 2 * W)
+			{
+				for (size_t k = 0; k < 2; ++k)
+				{
+					L x, y;
+
+					lane_load(x, a + i + k * W);
+					lane_load(y, b + i + k * W);
+
+					// the product's own rounding error, exact with fma and zero without
+					const L p = x * y;
+					const L e = lane_fmadd(x, y, -p);
+
+					lane_two_sum(s[k], c[k], p);
+					c[k] = c[k] + e;
+				}
+			}
+
+			// the two registers, then the lanes, folded as a tree so the scalar steps do not wait on each other
+			lane_two_sum(s[0], c[0], s[1]);
+			c[0] = c[0] + c[1];
+
+			float lanes_s[W];
+			float lanes_c[W];
+
+			lane_store(lanes_s, s[0]);
+			lane_store(lanes_c, c[0]);
+
+			for (size_t w = W / 2; w > 0; w /= 2)
+			{
+				for (size_t k = 0; k < w; ++k)
+				{
+					lane_two_sum(lanes_s[k], lanes_c[k], lanes_s[k + w]);
+					lanes_c[k] += lanes_c[k + w];
+				}
+			}
+
+			lane_two_sum(sum, comp, lanes_s[0]);
+			comp += lanes_c[0];
+		}
+
+		template <typename T>
+		inline T dot_compensated(const T* a, const T* b, const size_t& n)
+		{
+			T sum = 0;
+			T comp = 0;
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T p = a[i] * b[i];
+				const T e = lane_fmadd(a[i], b[i], -p);
+
+				lane_two_sum(sum, comp, p);
+				comp += e;
+			}
+
+			return sum + comp;
+		}
+
+		inline float dot_compensated(const float* a, const float* b, const size_t& n)
+		{
+			size_t i = 0;
+			float sum = 0.0f;
+			float comp = 0.0f;
+
+#ifdef _REACT_SIMD_AVX2
+			dot_compensated_lanes<float8>(a, b, i, n, sum, comp);
+#endif
+#ifdef _REACT_SIMD_SSE2
+			dot_compensated_lanes<float4>(a, b, i, n, sum, comp);
+
+			// less than two registers are left, a bound the compiler can see as in dot_in_double
+			const size_t rest = std::min<size_t>(n - i, 2 * lane_traits<float4>::WIDTH - 1);
+#else
+			const size_t rest = n;
+#endif
+			for (size_t k = 0; k < rest; ++k)
+			{
+				const float p = a[i + k] * b[i + k];
+				const float e = lane_fmadd(a[i + k], b[i + k], -p);
+
+				lane_two_sum(sum, comp, p);
+				comp += e;
+			}
+
+			return sum + comp;
+		}
+
+		// Sums pushed in equal blocks merged pairwise like a binary counter, so the tree stays balanced without
+		// recursion. 64 levels hold any size_t count of blocks. The levels are raw storage, written before they are
+		// read, so a stack of registers costs nothing to construct.
+		template <typename T>
+		class pairwise_sum
+		{
+		public:
+			pairwise_sum() : m_depth(0), m_blocks(0) {}
+
+			inline void push(T v)
+			{
+				for (size_t b = m_blocks++; b & 1; b >>= 1)
+					v = level(--m_depth) + v;
+
+				level(m_depth++) = v;
+			}
+
+			inline const T total() const
+			{
+				T v = T();
+
+				for (size_t k = m_depth; k-- > 0;)
+					v = level(k) + v;
+
+				return v;
+			}
+
+		private:
+			inline T& level(const size_t& k)
+			{
+				return *reinterpret_cast<T*>(&m_stack[k]);
+			}
+
+			inline const T& level(const size_t& k) const
+			{
+				return *reinterpret_cast<const T*>(&m_stack[k]);
+			}
+
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type m_stack[64];
+			size_t m_depth;
+			size_t m_blocks;
+		};
+
+		// Blocks of 8 registers of products summed as a tree, then across the lanes as a tree
+		template <typename L, typename T>
+		inline void dot_pairwise_lanes(const T* a, const T* b, size_t& i, const size_t& n, pairwise_sum<T>& sums)
+		{
+			const size_t W = lane_traits<L>::WIDTH;
+			const size_t blocks = (n - i) / (8 * W);
+
+			for (size_t done = 0; done < blocks; ++done, i += 8 * W)
+			{
+				L p[8];
+
+				for (size_t k = 0; k < 8; ++k)
+				{
+					L x, y;
+
+					lane_load(x, a + i + k * W);
+					lane_load(y, b + i + k * W);
+					p[k] = x * y;
+				}
+
+				const L sum = ((p[0] + p[1]) + (p[2] + p[3])) + ((p[4] + p[5]) + (p[6] + p[7]));
+				T lanes[W];
+
+				lane_store(lanes, sum);
+
+				for (size_t w = W / 2; w > 0; w /= 2)
+					for (size_t k = 0; k < w; ++k)
+						lanes[k] = lanes[k] + lanes[k + w];
+
+				sums.push(lanes[0]);
+			}
+		}
+
+		template <typename T>
+		inline T dot_pairwise_tail(const T* a, const T* b, const size_t& begin, const size_t& n, const pairwise_sum<T>& sums)
+		{
+			// fewer than 8 left
+			const size_t count = n - begin;
+			T tail = 0;
+
+			for (size_t i = 0; i < count; ++i)
+				tail += a[begin + i] * b[begin + i];
+
+			return sums.total() + tail;
+		}
+
+		template <typename T>
+		inline T dot_pairwise(const T* a, const T* b, const size_t& n)
+		{
+			pairwise_sum<T> sums;
+			size_t i = 0;
+
+			dot_pairwise_lanes<T>(a, b, i, n, sums);
+
+			return dot_pairwise_tail(a, b, i, n, sums);
+		}
+
+		inline float dot_pairwise(const float* a, const float* b, const size_t& n)
+		{
+			pairwise_sum<float> sums;
+			size_t i = 0;
+
+#ifdef _REACT_SIMD_AVX2
+			dot_pairwise_lanes<float8>(a, b, i, n, sums);
+#endif
+#ifdef _REACT_SIMD_SSE2
+			dot_pairwise_lanes<float4>(a, b, i, n, sums);
+#endif
+			dot_pairwise_lanes<float>(a, b, i, n, sums);
+
+			return dot_pairwise_tail(a, b, i, n, sums);
+		}
+
+		// The sum of a[i] * b[i] for i < n under 'policy'. Integers sum natively whatever it is.
+		template <typename T>
+		inline T accumulate_dot(const T* a, const T* b, const size_t& n, const accumulation& policy)
+		{
+			if (!std::is_floating_point<T>::value)
+				return dot_native(a, b, n);
+
+			switch (policy)
+			{
+			case accumulation::in_double:
+				return dot_in_double(a, b, n);
+			case accumulation::compensated:
+				return dot_compensated(a, b, n);
+			case accumulation::pairwise:
+				return dot_pairwise(a, b, n);
+			default:
+				return dot_native(a, b, n);
+			}
+		}
+
+		// Column sums for a matrix product, out = a x for a column-major 'rows' x 'inner' a and 'cols' columns of x, each
+		// 'inner' long, into columns of out 'rows' long. Each output row is a lane and sums down k, so a register holds
+		// several outputs and no horizontal reduction is needed. Tiles of a few columns share each load of a, and give
+		// the precise sums independent dependency chains to keep the pipeline full.
+		const size_t COLUMN_TILE = 4;
+
+		template <typename T>
+		inline void columns_native(const T* a, const size_t& rows, const size_t& inner, const T* x, const size_t& cols, T* out)
+		{
+			for (size_t q = 0; q < cols; ++q)
+			{
+				T* o = out + q * rows;
+
+				for (size_t j = 0; j < rows; ++j)
+					o[j] = 0;
+
+				for (size_t k = 0; k < inner; ++k)
+					for (size_t j = 0; j < rows; ++j)
+						o[j] += a[k * rows + j] * x[q * inner + k];
+			}
+		}
+
+		// R rows from j of C columns from q, the wide sums in registers when the compiler vectorizes over r
+		template <size_t R, size_t C, typename T>
+		inline void columns_in_double_tile(const T* a, const size_t& rows, const size_t& inner, const T* x, T* out, const size_t& j, const size_t& q)
+		{
+			typedef typename accumulation_wide<T>::type W;
+
+			W acc[C][R] = {};
+
+			for (size_t k = 0; k < inner; ++k)
+			{
+				const T* col = a + k * rows + j;
+
+				for (size_t c = 0; c < C; ++c)
+				{
+					const W xk = static_cast<W>(x[(q + c) * inner + k]);
+
+					for (size_t r = 0; r < R; ++r)
+						acc[c][r] += static_cast<W>(col[r]) * xk;
+				}
+			}
+
+			for (size_t c = 0; c < C; ++c)
+				for (size_t r = 0; r < R; ++r)
+					out[(q + c) * rows + j + r] = static_cast<T>(acc[c][r]);
+		}
+
+		template <size_t C, typename T>
+		inline void columns_in_double_block(const T* a, const size_t& rows, const size_t& inner, const T* x, T* out, const size_t& j, const size_t& q)
+		{
+			columns_in_double_tile<8, C>(a, rows, inner, x, out, j, q);
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		// 8 float rows from j of C columns from q, each column's sums in two registers of doubles. The products are
+		// exact in double, so these are the bits the scalar tile gives.
+		template <size_t C>
+		inline void columns_in_double_block(const float* a, const size_t& rows, const size_t& inner, const float* x, float* out, const size_t& j, const size_t& q)
+		{
+			__m256d lo[C];
+			__m256d hi[C];
+
+			for (size_t c = 0; c < C; ++c)
+				lo[c] = hi[c] = _mm256_setzero_pd();
+
+			for (size_t k = 0; k < inner; ++k)
+			{
+				const __m256 v = _mm256_loadu_ps(a + k * rows + j);
+				const __m256d v_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+				const __m256d v_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+
+				for (size_t c = 0; c < C; ++c)
+				{
+					const __m256d xk = _mm256_set1_pd(static_cast<double>(x[(q + c) * inner + k]));
+
+					lo[c] = _mm256_add_pd(lo[c], _mm256_mul_pd(v_lo, xk));
+					hi[c] = _mm256_add_pd(hi[c], _mm256_mul_pd(v_hi, xk));
+				}
+			}
+
+			for (size_t c = 0; c < C; ++c)
+			{
+				float* o = out + (q + c) * rows + j;
+
+				_mm_storeu_ps(o, _mm256_cvtpd_ps(lo[c]));
+				_mm_storeu_ps(o + 4, _mm256_cvtpd_ps(hi[c]));
+			}
+		}
+#endif
+
+		template <size_t C, typename T>
+		inline void columns_in_double_rows(const T* a, const size_t& rows, const size_t& inner, const T* x, T* out, const size_t& q)
+		{
+			const size_t blocks = rows / 8 * 8;
+
+			for (size_t j = 0; j < blocks; j += 8)
+				columns_in_double_block<C>(a, rows, inner, x, out, j, q);
+
+			for (size_t j = blocks; j < rows; ++j)
+				columns_in_double_tile<1, C>(a, rows, inner, x, out, j, q);
+		}
+
+		template <typename T>
+		inline void columns_in_double(const T* a, const size_t& rows, const size_t& inner, const T* x, const size_t& cols, T* out)
+		{
+			// whole tiles to a bound the compiler can see, or it assumes the tails may run off out
+			const size_t tiles = cols / COLUMN_TILE * COLUMN_TILE;
+
+			for (size_t q = 0; q < tiles; q += COLUMN_TILE)
+				columns_in_double_rows<COLUMN_TILE>(a, rows, inner, x, out, q);
+
+			for (size_t q = tiles; q < cols; ++q)
+				columns_in_double_rows<1>(a, rows, inner, x, out, q);
+		}
+
+		// A register of rows from j by C columns from q, each sum compensated as dot_compensated does
+		template <typename T>
+		struct columns_compensated_tile
+		{
+			static const size_t COLUMNS = 2;
+
+			template <typename L, size_t C>
+			static inline void run(const T* a, const size_t& rows, const size_t& inner, const T* x, T* out, const size_t& j, const size_t& q)
+			{
+				const L zero(static_cast<T>(0));
+				L s[C];
+				L c[C];
+
+				for (size_t t = 0; t < C; ++t)
+					s[t] = c[t] = zero;
+
+				for (size_t k = 0; k < inner; ++k)
+				{
+					L v;
+					lane_load(v, a + k * rows + j);
+
+					for (size_t t = 0; t < C; ++t)
+					{
+						const L xk(x[(q + t) * inner + k]);
+						const L p = v * xk;
+						const L e = lane_fmadd(v, xk, -p);
+
+						lane_two_sum(s[t], c[t], p);
+						c[t] = c[t] + e;
+					}
+				}
+
+				for (size_t t = 0; t < C; ++t)
+					lane_store(out + (q + t) * rows + j, s[t] + c[t]);
+			}
+		};
+
+		// A register of rows from j by C columns from q, blocks of 8 products summed as a tree and merged pairwise
+		template <typename T>
+		struct columns_pairwise_tile
+		{
+			static const size_t COLUMNS = 4;
+
+			template <typename L, size_t C>
+			static inline void run(const T* a, const size_t& rows, const size_t& inner, const T* x, T* out, const size_t& j, const size_t& q)
+			{
+				const size_t blocks = inner / 8;
+
+				pairwise_sum<L> sums[C];
+				size_t k = 0;
+
+				for (size_t done = 0; done < blocks; ++done, k += 8)
+				{
+					L v[8];
+
+					for (size_t i = 0; i < 8; ++i)
+						lane_load(v[i], a + (k + i) * rows + j);
+
+					for (size_t t = 0; t < C; ++t)
+					{
+						const T* xt = x + (q + t) * inner + k;
+						L p[8];
+
+						for (size_t i = 0; i < 8; ++i)
+							p[i] = v[i] * L(xt[i]);
+
+						sums[t].push(((p[0] + p[1]) + (p[2] + p[3])) + ((p[4] + p[5]) + (p[6] + p[7])));
+					}
+				}
+
+				// fewer than 8 left
+				L tail[C];
+
+				for (size_t t = 0; t < C; ++t)
+					tail[t] = L(static_cast<T>(0));
+
+				for (; k < inner; ++k)
+				{
+					L v;
+					lane_load(v, a + k * rows + j);
+
+					for (size_t t = 0; t < C; ++t)
+						tail[t] = tail[t] + v * L(x[(q + t) * inner + k]);
+				}
+
+				for (size_t t = 0; t < C; ++t)
+					lane_store(out + (q + t) * rows + j, sums[t].total() + tail[t]);
+			}
+		};
+
+		// Tile::run<L, C> over the rows from j that whole registers of L cover, COLUMN_TILE columns at a time and the
+		// rest one by one. j is left at the first row not done, for narrower lanes to finish.
+		template <typename Tile, typename L, typename T>
+		inline void columns_tiles(const T* a, const size_t& rows, const size_t& inner, const T* x, const size_t& cols, T* out, size_t& j)
+		{
+			const size_t W = lane_traits<L>::WIDTH;
+			const size_t end = j + (rows - j) / W * W;
+
+			for (size_t q = 0; q < cols; )
+			{
+				if (cols - q >= Tile::COLUMNS)
+				{
+					for (size_t r = j; r < end; r += W)
+						Tile::template run<L, Tile::COLUMNS>(a, rows, inner, x, out, r, q);
+
+					q += Tile::COLUMNS;
+				}
+				else
+				{
+					for (size_t r = j; r < end; r += W)
+						Tile::template run<L, 1>(a, rows, inner, x, out, r, q);
+
+					++q;
+				}
+			}
+
+			j = end;
+		}
+
+		template <typename Tile, typename T>
+		inline void columns_lanes(const T* a, const size_t& rows, const size_t& inner, const T* x, const size_t& cols, T* out)
+		{
+			size_t j = 0;
+
+			columns_tiles<Tile, T>(a, rows, inner, x, cols, out, j);
+		}
+
+		template <typename Tile>
+		inline void columns_lanes(const float* a, const size_t& rows, const size_t& inner, const float* x, const size_t& cols, float* out)
+		{
+			size_t j = 0;
+
+#ifdef _REACT_SIMD_AVX2
+			columns_tiles<Tile, float8>(a, rows, inner, x, cols, out, j);
+#endif
+#ifdef _REACT_SIMD_SSE2
+			columns_tiles<Tile, float4>(a, rows, inner, x, cols, out, j);
+#endif
+			columns_tiles<Tile, float>(a, rows, inner, x, cols, out, j);
+		}
+
+		template <typename T>
+		inline void accumulate_columns(const T* a, const size_t& rows, const size_t& inner, const T* x, const size_t& cols, T* out, const accumulation& policy)
+		{
+			if (!std::is_floating_point<T>::value)
+				return columns_native(a, rows, inner, x, cols, out);
+
+			switch (policy)
+			{
+			case accumulation::in_double:
+				return columns_in_double(a, rows, inner, x, cols, out);
+			case accumulation::compensated:
+				return columns_lanes<columns_compensated_tile<T>>(a, rows, inner, x, cols, out);
+			case accumulation::pairwise:
+				return columns_lanes<columns_pairwise_tile<T>>(a, rows, inner, x, cols, out);
+			default:
+				return columns_native(a, rows, inner, x, cols, out);
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef _RM_CSR_H
+#define _RM_CSR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "parallel.h"
+
+namespace react
+{
+	namespace support
+	{
+		// Runs query(i, out) for every i in [0, count), each appending its results to out, and gathers them as
+		// compressed sparse rows: the results of i are indices[offsets[i] .. offsets[i + 1]). In parallel every chunk
+		// appends to its own list with offsets relative to it, then the offsets are rebased while the lists are
+		// concatenated in chunk order, so the rows come out as the serial loop writes them.
+		template <typename F>
+		void gather_rows(const size_t& count, F&& query, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices, const bool& parallel = false)
+		{
+			offsets.assign(count + 1, 0);
+			indices.clear();
+
+			if (!parallel)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					query(i, indices);
+					offsets[i + 1] = static_cast<uint32_t>(indices.size());
+				}
+
+				return;
+			}
+
+			const size_t grain = 1 << 10;
+
+			std::vector<std::vector<uint32_t>> chunk_indices(parallel_chunks(count, grain));
+
+			parallel_for(count, grain, [&](size_t chunk, size_t begin, size_t end)
+			{
+				std::vector<uint32_t>& local = chunk_indices[chunk];
+
+				for (size_t i = begin; i < end; ++i)
+				{
+					query(i, local);
+					offsets[i + 1] = static_cast<uint32_t>(local.size());
+				}
+			});
+
+			uint32_t base = 0;
+
+			for (size_t chunk = 0, i = 0; chunk < chunk_indices.size(); ++chunk)
+			{
+				size_t end = count * (chunk + 1) / chunk_indices.size();
+
+				for (; i < end; ++i)
+					offsets[i + 1] += base;
+
+				indices.insert(indices.end(), chunk_indices[chunk].begin(), chunk_indices[chunk].end());
+				base = static_cast<uint32_t>(indices.size());
+			}
+		}
+	}
+}
+
+#endif
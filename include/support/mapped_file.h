@@ -0,0 +1,163 @@
+#ifndef _RM_MAPPED_FILE_H
+#define _RM_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace react
+{
+	namespace support
+	{
+		// Read only mapping of a whole file. Pages are faulted in as they are touched, so opening is O(1) whatever the
+		// size; 'sequential' tells the kernel the mapping will be read front to back so it reads ahead aggressively.
+		class mapped_file
+		{
+		public:
+			// constructors
+			mapped_file() : m_data(nullptr), m_size(0) {}
+			mapped_file(const mapped_file&) = delete;
+			mapped_file(mapped_file&& other) : m_data(other.m_data), m_size(other.m_size)
+			{
+				other.m_data = nullptr;
+				other.m_size = 0;
+			}
+
+			~mapped_file()
+			{
+				close();
+			}
+
+			mapped_file& operator=(const mapped_file&) = delete;
+			mapped_file& operator=(mapped_file&& other)
+			{
+				if (this != &other)
+				{
+					close();
+
+					m_data = other.m_data;
+					m_size = other.m_size;
+					other.m_data = nullptr;
+					other.m_size = 0;
+				}
+
+				return *this;
+			}
+
+			// Modifiers
+			inline const bool open(const std::string& path, const bool& sequential = false);
+			inline void close();
+
+			// Accessors
+			inline const unsigned char* data() const
+			{
+				return m_data;
+			}
+
+			inline const size_t size() const
+			{
+				return m_size;
+			}
+
+			inline const bool is_open() const
+			{
+				return m_data != nullptr;
+			}
+
+		private:
+			const unsigned char* m_data;
+			size_t m_size;
+		};
+
+		inline const bool mapped_file::open(const std::string& path, const bool& sequential)
+		{
+			close();
+
+#if defined(_WIN32)
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER size;
+
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+
+			if (!mapping)
+				return false;
+
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+
+			if (!view)
+				return false;
+
+			m_data = static_cast<const unsigned char*>(view);
+			m_size = static_cast<size_t>(size.QuadPart);
+#else
+			int fd = ::open(path.c_str(), O_RDONLY);
+
+			if (fd < 0)
+				return false;
+
+			struct stat st;
+
+			if (fstat(fd, &st) != 0 || st.st_size == 0)
+			{
+				::close(fd);
+				return false;
+			}
+
+			void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+
+			if (view == MAP_FAILED)
+				return false;
+
+			if (sequential)
+				madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+			m_data = static_cast<const unsigned char*>(view);
+			m_size = static_cast<size_t>(st.st_size);
+#endif
+
+			return true;
+		}
+
+		inline void mapped_file::close()
+		{
+			if (!m_data)
+				return;
+
+#if defined(_WIN32)
+			UnmapViewOfFile(m_data);
+#else
+			munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+
+			m_data = nullptr;
+			m_size = 0;
+		}
+	}
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define _RM_MATRIX_H
 
 #include "vector.h"
+#include "matrix_view.h"
 
 namespace react
 {
@@ -11,8 +12,8 @@ namespace react
 		class matrix
 		{
 		private:
-			typename check_mat_dimension<T, M, N>::type cd{};
-			typename check_type_arithmetic<T>::type ct{};
+			typedef typename check_mat_dimension<T, M, N>::type cd;
+			typedef typename check_type_arithmetic<T>::type ct;
 
 		public:
 			static const size_t ROWS = N;
@@ -23,6 +24,12 @@ namespace react
 			typedef vector<ROWS, T> row_type;
 			typedef vector<COLS, T> col_type;
 
+			// views over m_data, see matrix_view.h
+			typedef strided_view<T, COLS, ROWS> row_view;
+			typedef strided_view<const T, COLS, ROWS> const_row_view;
+			typedef strided_view<T, ROWS, 1> col_view;
+			typedef strided_view<const T, ROWS, 1> const_col_view;
+
 			template <typename TT>
 			using enable_if_square = typename std::enable_if<ROWS == COLS, TT>;
 
@@ -39,15 +46,30 @@ namespace react
 			// Accessors
 			inline T& at(const size_t& row_index, const size_t& col_index);
 			inline const T& at(const size_t& row_index, const size_t& col_index) const;
-			const vector<matrix<M, N, T>::COLS, T> row(const size_t& row_index) const;
-			const vector<matrix<M, N, T>::ROWS, T> col(const size_t& col_index) const;
+
+			// Views of an lvalue, copies of a temporary, so f().row(0) does not outlive f()'s result
+			inline row_view row(const size_t& row_index) &;
+			inline const_row_view row(const size_t& row_index) const &;
+			inline const vector<COLS, T> row(const size_t& row_index) const &&;
+			inline col_view col(const size_t& col_index) &;
+			inline const_col_view col(const size_t& col_index) const &;
+			inline const vector<ROWS, T> col(const size_t& col_index) const &&;
+
+			template <size_t MM, size_t NN>
+			inline block_view<T, MM, NN, N> block(const size_t& row_start, const size_t& col_start) &;
+
+			template <size_t MM, size_t NN>
+			inline block_view<const T, MM, NN, N> block(const size_t& row_start, const size_t& col_start) const &;
+
+			template <size_t MM, size_t NN>
+			inline const matrix<MM, NN, T> block(const size_t& row_start, const size_t& col_start) const &&;
 
 			// Utility functions
 			template <typename TT = enable_if_square<T>>
 			const T determinant() const;
 
 			template <size_t P>
-			const matrix<P, N, T> dot(const matrix<P, M, T>& m) const;
+			const matrix<P, N, T> dot(const matrix<P, M, T>& m, const accumulation& policy = accumulation_traits<matrix<M, N, T>>::policy()) const;
 
 			template <typename TT = enable_if_square<T>>
 			const matrix<M, N, T> inverse() const;
@@ -58,7 +80,10 @@ namespace react
 			const matrix<M, N, T> cofactors() const;
 
 			template <typename TT = enable_if_reducible<T>>
-			const matrix<M - 1, N - 1, T> reduce(const size_t &ignore_row, const size_t &ignore_col) const;
+			const minor_view<const T, M, N> reduce(const size_t &ignore_row, const size_t &ignore_col) const &;
+
+			template <typename TT = enable_if_reducible<T>>
+			const matrix<M - 1, N - 1, T> reduce(const size_t &ignore_row, const size_t &ignore_col) const &&;
 
 			template <size_t MM, size_t NN, typename TT>
 			const matrix<MM, NN, TT> sub_matrix(const size_t &row_start, const size_t& col_start) const;
@@ -84,7 +109,7 @@ namespace react
 			const static TT determinant(const matrix<NN, NN, TT>& m);
 
 			template <size_t MM, size_t NN, size_t PP, typename TT>
-			const static matrix<PP, NN, TT> dot(const matrix<MM, NN, TT>& a, const matrix<PP, MM, TT>& b);
+			const static matrix<PP, NN, TT> dot(const matrix<MM, NN, TT>& a, const matrix<PP, MM, TT>& b, const accumulation& policy = accumulation_traits<matrix<MM, NN, TT>>::policy());
 
 			template <size_t NN, typename TT>
 			const static matrix<NN, NN, TT> inverse(const matrix<NN, NN, TT>& m);
@@ -133,7 +158,7 @@ namespace react
 				for (int row_index = 0; row_index < m.ROWS; ++row_index)
 				{
 					for (int col_index = 0; col_index < m.COLS; ++col_index)
-						out << m(row_index, col_index) << ' ';
+						out << m.m_data[col_index * m.ROWS + row_index] << ' ';
 
 					if(row_index != m.ROWS - 1)
 						out << '\n';
@@ -206,33 +231,88 @@ namespace react
 		}
 
 		template <size_t M, size_t N, typename T>
-		const vector<matrix<M, N, T>::COLS, T> matrix<M, N, T>::row(const size_t& row_index) const
+		inline typename matrix<M, N, T>::row_view matrix<M, N, T>::row(const size_t& row_index) &
 		{
 #ifndef _REACT_NO_SAFE_ACCESSORS
-			assert(COLS > row_index);
+			assert(ROWS > row_index);
 #endif
 
-			vector<COLS, T> tmp;
+			return row_view(m_data + row_index);
+		}
 
-			for (int col_index = 0; col_index < COLS; ++col_index)
-				tmp[col_index] = at(row_index, col_index);
+		template <size_t M, size_t N, typename T>
+		inline typename matrix<M, N, T>::const_row_view matrix<M, N, T>::row(const size_t& row_index) const &
+		{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(ROWS > row_index);
+#endif
 
-			return tmp;
+			return const_row_view(m_data + row_index);
 		}
 
 		template <size_t M, size_t N, typename T>
-		const vector<matrix<M, N, T>::ROWS, T> matrix<M, N, T>::col(const size_t& col_index) const
+		inline const vector<matrix<M, N, T>::COLS, T> matrix<M, N, T>::row(const size_t& row_index) const &&
+		{
+			return static_cast<const matrix<M, N, T>&>(*this).row(row_index).get();
+		}
+
+		template <size_t M, size_t N, typename T>
+		inline typename matrix<M, N, T>::col_view matrix<M, N, T>::col(const size_t& col_index) &
 		{
 #ifndef _REACT_NO_SAFE_ACCESSORS
-			assert(ROWS > col_index);
+			assert(COLS > col_index);
 #endif
 
-			vector<ROWS, T> tmp;
+			return col_view(m_data + ROWS * col_index);
+		}
 
-			for (int row_index = 0; row_index < ROWS; ++row_index)
-				tmp[row_index] = at(row_index, col_index);
+		template <size_t M, size_t N, typename T>
+		inline typename matrix<M, N, T>::const_col_view matrix<M, N, T>::col(const size_t& col_index) const &
+		{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(COLS > col_index);
+#endif
 
-			return tmp;
+			return const_col_view(m_data + ROWS * col_index);
+		}
+
+		template <size_t M, size_t N, typename T>
+		inline const vector<matrix<M, N, T>::ROWS, T> matrix<M, N, T>::col(const size_t& col_index) const &&
+		{
+			return static_cast<const matrix<M, N, T>&>(*this).col(col_index).get();
+		}
+
+		template <size_t M, size_t N, typename T>
+		template <size_t MM, size_t NN>
+		inline block_view<T, MM, NN, N> matrix<M, N, T>::block(const size_t& row_start, const size_t& col_start) &
+		{
+			static_assert(MM <= M && NN <= N, "block larger than the matrix");
+
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(ROWS >= row_start + NN && COLS >= col_start + MM);
+#endif
+
+			return block_view<T, MM, NN, N>(m_data + row_start + ROWS * col_start);
+		}
+
+		template <size_t M, size_t N, typename T>
+		template <size_t MM, size_t NN>
+		inline block_view<const T, MM, NN, N> matrix<M, N, T>::block(const size_t& row_start, const size_t& col_start) const &
+		{
+			static_assert(MM <= M && NN <= N, "block larger than the matrix");
+
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(ROWS >= row_start + NN && COLS >= col_start + MM);
+#endif
+
+			return block_view<const T, MM, NN, N>(m_data + row_start + ROWS * col_start);
+		}
+
+		template <size_t M, size_t N, typename T>
+		template <size_t MM, size_t NN>
+		inline const matrix<MM, NN, T> matrix<M, N, T>::block(const size_t& row_start, const size_t& col_start) const &&
+		{
+			return static_cast<const matrix<M, N, T>&>(*this).template block<MM, NN>(row_start, col_start).get();
 		}
 
 		template <size_t M, size_t N, typename T>
@@ -267,20 +347,27 @@ namespace react
 		{
 			static_assert(std::numeric_limits<T>::is_iec559, "'determinant' only accepts floating-point inputs");
 
-			matrix<N, M, T> matrix = *this;
+			matrix<M, N, T> work = *this;
+
+			return determinant_in_place(work);
+		}
 
+		// Gaussian elimination with partial pivoting, overwrites m
+		template <size_t M, size_t N, typename T>
+		const T determinant_in_place(matrix<M, N, T>& m)
+		{
 			T det = static_cast<T>(1);
 
-			for (int i = 0; i < COLS; ++i)
+			for (int i = 0; i < m.COLS; ++i)
 			{
-				T pivotElement = matrix.at(i, i);
+				T pivotElement = m.at(i, i);
 				int pivotRow = i;
 
-				for (int row = i + 1; row < ROWS; ++row)
+				for (int row = i + 1; row < m.ROWS; ++row)
 				{
-					if (fabs(matrix.at(row, i)) > fabs(pivotElement))
+					if (fabs(m.at(row, i)) > fabs(pivotElement))
 					{
-						pivotElement = matrix.at(row, i);
+						pivotElement = m.at(row, i);
 						pivotRow = row;
 					}
 				}
@@ -290,25 +377,25 @@ namespace react
 
 				if (pivotRow != i)
 				{
-					matrix.swap_row(i, pivotRow);
+					m.swap_row(i, pivotRow);
 					det = -det;
 				}
 
-				if (fabs(pivotElement) < std::numeric_limits<T>::epsilon() * static_cast<T>(this->DIAG))
+				if (fabs(pivotElement) < std::numeric_limits<T>::epsilon() * static_cast<T>(m.DIAG))
 					return static_cast<T>(0);
 
 				det *= pivotElement;
 
-				for (int row = i + 1; row < ROWS; ++row)
+				for (int row = i + 1; row < m.ROWS; ++row)
 				{
-					for (int col = i + 1; col < COLS; ++col)
+					for (int col = i + 1; col < m.COLS; ++col)
 					{
-						matrix.at(row, col) -= (matrix.at(row, i) / pivotElement) * matrix.at(i, col);
+						m.at(row, col) -= (m.at(row, i) / pivotElement) * m.at(i, col);
 					}
 				}
 			}
 
-			if (fabs(det) < std::numeric_limits<T>::epsilon() * static_cast<T>(this->DIAG))
+			if (fabs(det) < std::numeric_limits<T>::epsilon() * static_cast<T>(m.DIAG))
 				return static_cast<T>(0);
 
 			return det;
@@ -316,14 +403,22 @@ namespace react
 
 		template <size_t M, size_t N, typename T>
 		template <size_t P>
-		const matrix<P, N, T> matrix<M, N, T>::dot(const matrix<P, M, T>& m) const
+		const matrix<P, N, T> matrix<M, N, T>::dot(const matrix<P, M, T>& m, const accumulation& policy) const
 		{
 			matrix<P, N, T> tmp(0);
 
-			for (int i = 0; i < tmp.COLS; ++i)
-				for (int j = 0; j < tmp.ROWS; ++j)
-					for (int k = 0; k < COLS; ++k)
-						tmp.at(j, i) += this->at(j, k) * m.at(k, i);
+			if (policy == accumulation::native)
+			{
+				for (int i = 0; i < tmp.COLS; ++i)
+					for (int j = 0; j < tmp.ROWS; ++j)
+						for (int k = 0; k < COLS; ++k)
+							tmp.at(j, i) += this->at(j, k) * m.at(k, i);
+
+				return tmp;
+			}
+
+			// this times the columns of m, a tile of them at a time
+			accumulate_columns(m_data, N, M, m.m_data, P, tmp.m_data, policy);
 
 			return tmp;
 		}
@@ -383,32 +478,20 @@ namespace react
 
 		template <size_t M, size_t N, typename T>
 		template <typename TT>
-		const matrix<M - 1, N - 1, T> matrix<M, N, T>::reduce(const size_t& ignore_row, const size_t& ignore_col) const
+		const minor_view<const T, M, N> matrix<M, N, T>::reduce(const size_t& ignore_row, const size_t& ignore_col) const &
 		{
-			matrix<M - 1, N - 1, T> sub_matrix = matrix<M - 1, N - 1, T>::ZERO;
-
-			int subi = 0;
-
-			for (int i = 0; i < ROWS; ++i)
-			{
-				int subj = 0;
-
-				if (i == ignore_row)
-					continue;
-
-				for (int j = 0; j < COLS; ++j)
-				{
-					if (j == ignore_col)
-						continue;
-
-					sub_matrix.at(subi, subj) = at(i, j);
-					++subj;
-				}
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(ROWS > ignore_row && COLS > ignore_col);
+#endif
 
-				++subi;
-			}
+			return minor_view<const T, M, N>(m_data, ignore_row, ignore_col);
+		}
 
-			return sub_matrix;
+		template <size_t M, size_t N, typename T>
+		template <typename TT>
+		const matrix<M - 1, N - 1, T> matrix<M, N, T>::reduce(const size_t& ignore_row, const size_t& ignore_col) const &&
+		{
+			return static_cast<const matrix<M, N, T>&>(*this).reduce(ignore_row, ignore_col).get();
 		}
 
 		template <size_t M, size_t N, typename T>
@@ -505,9 +588,9 @@ namespace react
 
 		template <size_t M, size_t N, typename T>
 		template <size_t MM, size_t NN, size_t PP, typename TT>
-		const matrix<PP, NN, TT> matrix<M, N, T>::dot(const matrix<MM, NN, TT>& a, const matrix<PP, MM, TT>& b)
+		const matrix<PP, NN, TT> matrix<M, N, T>::dot(const matrix<MM, NN, TT>& a, const matrix<PP, MM, TT>& b, const accumulation& policy)
 		{
-			return a.dot(b);
+			return a.dot(b, policy);
 		}
 
 		template <size_t M, size_t N, typename T>
@@ -0,0 +1,370 @@
+#ifndef _RM_MATRIX_VIEW_H
+#define _RM_MATRIX_VIEW_H
+
+#include <utility>
+
+#include "swizzle.h"
+
+namespace react
+{
+	namespace support
+	{
+		template <size_t M, size_t N, typename T>
+		class matrix;
+
+		template <size_t M, size_t N, typename T>
+		const T determinant_in_place(matrix<M, N, T>& m);
+
+		template <typename T, size_t STRIDE, typename Sequence>
+		struct make_strided_view;
+
+		template <typename T, size_t STRIDE, size_t... K>
+		struct make_strided_view<T, STRIDE, std::index_sequence<K...>>
+		{
+			typedef swizzle_view<T, (K * STRIDE)...> type;
+		};
+
+		// S components STRIDE apart, a swizzle with the offsets fixed at compile time. The rows and columns of a matrix.
+		template <typename T, size_t S, size_t STRIDE>
+		using strided_view = typename make_strided_view<T, STRIDE, std::make_index_sequence<S>>::type;
+
+		// An M column by N row block of a column major matrix whose columns are STRIDE apart, written in place.
+		// Like swizzle_view it does not own its data and must not outlive the matrix it was taken from.
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		class block_view
+		{
+		public:
+			static const size_t ROWS = N;
+			static const size_t COLS = M;
+
+			using type = typename std::remove_const<T>::type;
+			using matrix_type = matrix<M, N, type>;
+
+			// constructors
+			explicit block_view(T* data) : m_data(data) {}
+			block_view(const block_view<T, M, N, STRIDE>& b) = default;
+
+			// Accessors
+			inline T& at(const size_t& row_index, const size_t& col_index) const;
+			inline strided_view<T, M, STRIDE> row(const size_t& row_index) const;
+			inline strided_view<T, N, 1> col(const size_t& col_index) const;
+			const matrix_type get() const;
+
+			inline operator matrix_type() const;
+
+			// Utility functions
+			const type determinant() const;
+
+			// Operators
+			inline T& operator()(const size_t& row_index, const size_t& col_index) const;
+
+			block_view<T, M, N, STRIDE>& operator=(const matrix_type& m);
+			block_view<T, M, N, STRIDE>& operator=(const block_view<T, M, N, STRIDE>& b);
+
+			template <typename TT, size_t SS>
+			block_view<T, M, N, STRIDE>& operator=(const block_view<TT, M, N, SS>& b);
+
+			block_view<T, M, N, STRIDE>& operator+=(const matrix_type& m);
+			block_view<T, M, N, STRIDE>& operator-=(const matrix_type& m);
+			block_view<T, M, N, STRIDE>& operator*=(const type& c);
+			block_view<T, M, N, STRIDE>& operator/=(const type& c);
+
+			matrix_type operator+(const matrix_type& m) const;
+			matrix_type operator-(const matrix_type& m) const;
+			matrix_type operator*(const type& c) const;
+
+			template <size_t P>
+			matrix<P, N, type> operator*(const matrix<P, M, type>& m) const;
+
+			const bool operator==(const matrix_type& m) const;
+			const bool operator!=(const matrix_type& m) const;
+
+			friend std::ostream& operator<<(std::ostream& out, const block_view<T, M, N, STRIDE>& b)
+			{
+				return out << b.get();
+			}
+
+		private:
+			static void check_writable()
+			{
+				static_assert(!std::is_const<T>::value, "block of a const matrix is read only");
+			}
+
+			T* m_data;
+		};
+
+		// The M - 1 by N - 1 matrix left after removing one row and one column of an M by N matrix, read in place.
+		template <typename T, size_t M, size_t N>
+		class minor_view
+		{
+		public:
+			static const size_t ROWS = N - 1;
+			static const size_t COLS = M - 1;
+
+			using type = typename std::remove_const<T>::type;
+			using matrix_type = matrix<M - 1, N - 1, type>;
+
+			// constructors
+			minor_view(T* data, const size_t& ignore_row, const size_t& ignore_col) : m_data(data), m_row(ignore_row), m_col(ignore_col) {}
+
+			// Accessors
+			inline T& at(const size_t& row_index, const size_t& col_index) const;
+			const matrix_type get() const;
+
+			inline operator matrix_type() const;
+
+			// Utility functions
+			const type determinant() const;
+
+			// Operators
+			inline T& operator()(const size_t& row_index, const size_t& col_index) const;
+
+			const bool operator==(const matrix_type& m) const;
+			const bool operator!=(const matrix_type& m) const;
+
+			friend std::ostream& operator<<(std::ostream& out, const minor_view<T, M, N>& m)
+			{
+				return out << m.get();
+			}
+
+		private:
+			T* m_data;
+			size_t m_row;
+			size_t m_col;
+		};
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		inline T& block_view<T, M, N, STRIDE>::at(const size_t& row_index, const size_t& col_index) const
+		{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(ROWS > row_index && COLS > col_index);
+#endif
+
+			return m_data[row_index + STRIDE * col_index];
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		inline strided_view<T, M, STRIDE> block_view<T, M, N, STRIDE>::row(const size_t& row_index) const
+		{
+			return strided_view<T, M, STRIDE>(&at(row_index, 0));
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		inline strided_view<T, N, 1> block_view<T, M, N, STRIDE>::col(const size_t& col_index) const
+		{
+			return strided_view<T, N, 1>(&at(0, col_index));
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		const typename block_view<T, M, N, STRIDE>::matrix_type block_view<T, M, N, STRIDE>::get() const
+		{
+			matrix_type tmp;
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					tmp.at(row_index, col_index) = m_data[row_index + STRIDE * col_index];
+
+			return tmp;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		inline block_view<T, M, N, STRIDE>::operator matrix_type() const
+		{
+			return get();
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		const typename block_view<T, M, N, STRIDE>::type block_view<T, M, N, STRIDE>::determinant() const
+		{
+			static_assert(M == N, "'determinant' needs a square block");
+
+			matrix_type work = get();
+
+			return determinant_in_place(work);
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		inline T& block_view<T, M, N, STRIDE>::operator()(const size_t& row_index, const size_t& col_index) const
+		{
+			return at(row_index, col_index);
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator=(const matrix_type& m)
+		{
+			check_writable();
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					m_data[row_index + STRIDE * col_index] = m.at(row_index, col_index);
+
+			return *this;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator=(const block_view<T, M, N, STRIDE>& b)
+		{
+			// through a copy, the two blocks may overlap
+			return *this = b.get();
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		template <typename TT, size_t SS>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator=(const block_view<TT, M, N, SS>& b)
+		{
+			return *this = matrix_type(b.get());
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator+=(const matrix_type& m)
+		{
+			check_writable();
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					m_data[row_index + STRIDE * col_index] += m.at(row_index, col_index);
+
+			return *this;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator-=(const matrix_type& m)
+		{
+			check_writable();
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					m_data[row_index + STRIDE * col_index] -= m.at(row_index, col_index);
+
+			return *this;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator*=(const type& c)
+		{
+			check_writable();
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					m_data[row_index + STRIDE * col_index] *= c;
+
+			return *this;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		block_view<T, M, N, STRIDE>& block_view<T, M, N, STRIDE>::operator/=(const type& c)
+		{
+			check_writable();
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					m_data[row_index + STRIDE * col_index] /= c;
+
+			return *this;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		typename block_view<T, M, N, STRIDE>::matrix_type block_view<T, M, N, STRIDE>::operator+(const matrix_type& m) const
+		{
+			return get() + m;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		typename block_view<T, M, N, STRIDE>::matrix_type block_view<T, M, N, STRIDE>::operator-(const matrix_type& m) const
+		{
+			return get() - m;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		typename block_view<T, M, N, STRIDE>::matrix_type block_view<T, M, N, STRIDE>::operator*(const type& c) const
+		{
+			return get() * c;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		template <size_t P>
+		matrix<P, N, typename block_view<T, M, N, STRIDE>::type> block_view<T, M, N, STRIDE>::operator*(const matrix<P, M, type>& m) const
+		{
+			matrix<P, N, type> tmp(static_cast<type>(0));
+
+			for (size_t i = 0; i < P; ++i)
+				for (size_t k = 0; k < COLS; ++k)
+					for (size_t j = 0; j < ROWS; ++j)
+						tmp.at(j, i) += m_data[j + STRIDE * k] * m.at(k, i);
+
+			return tmp;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		const bool block_view<T, M, N, STRIDE>::operator==(const matrix_type& m) const
+		{
+			// the matrix comparison, so a block compares as the matrix it converts to
+			return get() == m;
+		}
+
+		template <typename T, size_t M, size_t N, size_t STRIDE>
+		const bool block_view<T, M, N, STRIDE>::operator!=(const matrix_type& m) const
+		{
+			return !(*this == m);
+		}
+
+		template <typename T, size_t M, size_t N>
+		inline T& minor_view<T, M, N>::at(const size_t& row_index, const size_t& col_index) const
+		{
+#ifndef _REACT_NO_SAFE_ACCESSORS
+			assert(ROWS > row_index && COLS > col_index);
+#endif
+
+			return m_data[(row_index + (row_index >= m_row)) + N * (col_index + (col_index >= m_col))];
+		}
+
+		template <typename T, size_t M, size_t N>
+		const typename minor_view<T, M, N>::matrix_type minor_view<T, M, N>::get() const
+		{
+			matrix_type tmp;
+
+			for (size_t col_index = 0; col_index < COLS; ++col_index)
+				for (size_t row_index = 0; row_index < ROWS; ++row_index)
+					tmp.at(row_index, col_index) = at(row_index, col_index);
+
+			return tmp;
+		}
+
+		template <typename T, size_t M, size_t N>
+		inline minor_view<T, M, N>::operator matrix_type() const
+		{
+			return get();
+		}
+
+		template <typename T, size_t M, size_t N>
+		const typename minor_view<T, M, N>::type minor_view<T, M, N>::determinant() const
+		{
+			static_assert(M == N, "'determinant' needs a square matrix");
+
+			// elimination needs a scratch copy, gathering the minor straight into it saves the second one
+			matrix_type work = get();
+
+			return determinant_in_place(work);
+		}
+
+		template <typename T, size_t M, size_t N>
+		inline T& minor_view<T, M, N>::operator()(const size_t& row_index, const size_t& col_index) const
+		{
+			return at(row_index, col_index);
+		}
+
+		template <typename T, size_t M, size_t N>
+		const bool minor_view<T, M, N>::operator==(const matrix_type& m) const
+		{
+			return get() == m;
+		}
+
+		template <typename T, size_t M, size_t N>
+		const bool minor_view<T, M, N>::operator!=(const matrix_type& m) const
+		{
+			return !(*this == m);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef _RM_MEMORY_H
+#define _RM_MEMORY_H
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace react
+{
+	namespace support
+	{
+		inline void* aligned_malloc(const size_t& size, const size_t& alignment)
+		{
+#if defined(_MSC_VER)
+			return _aligned_malloc(size, alignment);
+#else
+			void* ptr = nullptr;
+
+			if (posix_memalign(&ptr, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0)
+				return nullptr;
+
+			return ptr;
+#endif
+		}
+
+		inline void aligned_free(void* ptr)
+		{
+#if defined(_MSC_VER)
+			_aligned_free(ptr);
+#else
+			std::free(ptr);
+#endif
+		}
+
+		// Allocator for containers of over-aligned types (SIMD blocks, cache line sized nodes), which
+		// operator new does not honour before C++17.
+		template <typename T, size_t A = alignof(T)>
+		class aligned_allocator
+		{
+		public:
+			using value_type = T;
+
+			template <typename U>
+			struct rebind
+			{
+				using other = aligned_allocator<U, A>;
+			};
+
+			aligned_allocator() noexcept {}
+
+			template <typename U>
+			aligned_allocator(const aligned_allocator<U, A>&) noexcept {}
+
+			T* allocate(const size_t& n)
+			{
+				void* ptr = aligned_malloc(n * sizeof(T), A);
+
+				if (!ptr)
+					throw std::bad_alloc();
+
+				return static_cast<T*>(ptr);
+			}
+
+			void deallocate(T* ptr, const size_t&) noexcept
+			{
+				aligned_free(ptr);
+			}
+
+			template <typename U>
+			const bool operator==(const aligned_allocator<U, A>&) const noexcept { return true; }
+
+			template <typename U>
+			const bool operator!=(const aligned_allocator<U, A>&) const noexcept { return false; }
+		};
+
+		template <typename T, size_t A = alignof(T)>
+		using aligned_vector = std::vector<T, aligned_allocator<T, A>>;
+	}
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef _RM_PARALLEL_H
+#define _RM_PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace react
+{
+	namespace support
+	{
+		// Number of worker threads used by the batch kernels. Define _REACT_NO_THREADS to run everything on the calling thread.
+		inline size_t thread_count()
+		{
+#ifdef _REACT_NO_THREADS
+			return 1;
+#else
+			static const size_t count = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+			return count;
+#endif
+		}
+
+		// Number of chunks parallel_for splits [0, count) into, never less than 'grain' elements per chunk.
+		inline size_t parallel_chunks(const size_t& count, const size_t& grain)
+		{
+			size_t min_grain = std::max<size_t>(grain, 1);
+			size_t chunks = (count + min_grain - 1) / min_grain;
+
+			return std::max<size_t>(1, std::min(chunks, thread_count()));
+		}
+
+		// Runs f(chunk, begin, end) over contiguous ranges of [0, count), one thread per chunk.
+		// The calling thread processes chunk 0.
+		template <typename F>
+		void parallel_for(const size_t& count, const size_t& grain, F&& f)
+		{
+			size_t chunks = parallel_chunks(count, grain);
+
+			if (chunks == 1)
+			{
+				f(size_t(0), size_t(0), count);
+				return;
+			}
+
+			std::vector<std::thread> threads;
+			threads.reserve(chunks - 1);
+
+			for (size_t chunk = 1; chunk < chunks; ++chunk)
+			{
+				size_t begin = count * chunk / chunks;
+				size_t end = count * (chunk + 1) / chunks;
+
+				threads.emplace_back([&f, chunk, begin, end]() { f(chunk, begin, end); });
+			}
+
+			f(size_t(0), size_t(0), count / chunks);
+
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+	}
+}
+
+#endif
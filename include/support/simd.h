@@ -0,0 +1,475 @@
+#ifndef _RM_SIMD_H
+#define _RM_SIMD_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// SIMD paths are picked from the compiler's target flags (-mavx2, -march=native, /arch:AVX2).
+// Define _REACT_NO_SIMD to force the portable scalar paths.
+#ifndef _REACT_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _REACT_SIMD_SSE2
+#endif
+
+#if defined(__AVX2__)
+#define _REACT_SIMD_AVX2
+#endif
+
+#if defined(__FMA__)
+#define _REACT_SIMD_FMA
+#endif
+
+#if defined(__BMI2__)
+#define _REACT_SIMD_BMI2
+#endif
+
+// MSVC has no F16C macro, every AVX2 part has the instructions
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define _REACT_SIMD_F16C
+#endif
+#endif
+
+#if defined(_REACT_SIMD_SSE2) || defined(_REACT_SIMD_AVX2) || defined(_REACT_SIMD_BMI2) || defined(_REACT_SIMD_F16C)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace react
+{
+	namespace support
+	{
+		inline int popcount32(uint32_t v)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_popcount(v);
+#else
+			v = v - ((v >> 1) & 0x55555555u);
+			v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+			return static_cast<int>((((v + (v >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+#endif
+		}
+
+		// Rounds to nearest even, what cvtps_epi32 does under the default MXCSR, so scalar tails of a quantizing kernel
+		// give the same integers as its SSE body. For |x| < 2^22.
+		inline int32_t round_nearest_even(const float& x)
+		{
+#ifdef _REACT_SIMD_SSE2
+			return _mm_cvtss_si32(_mm_set_ss(x));
+#else
+			const float magic = 12582912.0f;
+
+			return static_cast<int32_t>((x + magic) - magic);
+#endif
+		}
+
+		inline int ctz32(uint32_t v)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_ctz(v);
+#elif defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, v);
+			return static_cast<int>(index);
+#else
+			int n = 0;
+
+			while (!(v & 1u))
+			{
+				v >>= 1;
+				++n;
+			}
+
+			return n;
+#endif
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		inline __m256 mm256_fmadd(const __m256& a, const __m256& b, const __m256& c)
+		{
+#ifdef _REACT_SIMD_FMA
+			return _mm256_fmadd_ps(a, b, c);
+#else
+			return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+		}
+
+		// Permutations that move the lanes selected by an 8-bit mask to the front of a register,
+		// used to write compacted index lists with a single store.
+		inline const __m256i& mm256_compress_permutation(const int& mask)
+		{
+			struct table
+			{
+				alignas(32) int32_t lanes[256][8];
+
+				table()
+				{
+					for (int mask = 0; mask < 256; ++mask)
+					{
+						int n = 0;
+
+						for (int lane = 0; lane < 8; ++lane)
+							if (mask & (1 << lane))
+								lanes[mask][n++] = lane;
+
+						while (n < 8)
+							lanes[mask][n++] = 0;
+					}
+				}
+			};
+
+			static const table t;
+
+			return *reinterpret_cast<const __m256i*>(t.lanes[mask]);
+		}
+
+		// Stores base + i for every lane i set in mask to out, packed. Always writes 8 values.
+		inline int mm256_store_compressed_indices(uint32_t* out, const uint32_t& base, const int& mask)
+		{
+			const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			__m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(base)), lanes);
+
+			indices = _mm256_permutevar8x32_epi32(indices, mm256_compress_permutation(mask));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), indices);
+
+			return popcount32(static_cast<uint32_t>(mask));
+		}
+
+		// Eight float lanes with arithmetic operators, so a branch free scalar kernel can be instantiated on a register.
+		// Comparisons return lane masks for lane_select.
+		struct float8
+		{
+			__m256 v;
+
+			float8() : v(_mm256_setzero_ps()) {}
+			explicit float8(const __m256& v) : v(v) {}
+			explicit float8(const float& a) : v(_mm256_set1_ps(a)) {}
+		};
+
+		inline float8 operator+(const float8& a, const float8& b) { return float8(_mm256_add_ps(a.v, b.v)); }
+		inline float8 operator-(const float8& a, const float8& b) { return float8(_mm256_sub_ps(a.v, b.v)); }
+		inline float8 operator*(const float8& a, const float8& b) { return float8(_mm256_mul_ps(a.v, b.v)); }
+		inline float8 operator/(const float8& a, const float8& b) { return float8(_mm256_div_ps(a.v, b.v)); }
+		inline float8 operator-(const float8& a) { return float8(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))); }
+		inline float8 operator<(const float8& a, const float8& b) { return float8(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)); }
+		inline float8 operator>(const float8& a, const float8& b) { return float8(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)); }
+
+		inline float8& operator+=(float8& a, const float8& b) { return a = a + b; }
+		inline float8& operator-=(float8& a, const float8& b) { return a = a - b; }
+		inline float8& operator*=(float8& a, const float8& b) { return a = a * b; }
+
+		inline float8 lane_select(const float8& mask, const float8& a, const float8& b)
+		{
+			return float8(_mm256_blendv_ps(b.v, a.v, mask.v));
+		}
+
+		inline float8 lane_sqrt(const float8& a)
+		{
+			return float8(_mm256_sqrt_ps(a.v));
+		}
+
+		// estimate refined with one Newton step, close to full float precision
+		inline float8 lane_rsqrt(const float8& a)
+		{
+			__m256 r = _mm256_rsqrt_ps(a.v);
+			__m256 h = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), a.v), r);
+
+			return float8(_mm256_mul_ps(r, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(h, r))));
+		}
+
+		inline float8 lane_abs(const float8& a)
+		{
+			return float8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v));
+		}
+
+		inline float8 lane_max(const float8& a, const float8& b)
+		{
+			return float8(_mm256_max_ps(a.v, b.v));
+		}
+
+		inline float8 lane_fmadd(const float8& a, const float8& b, const float8& c)
+		{
+			return float8(mm256_fmadd(a.v, b.v, c.v));
+		}
+
+		// nearest even, as round_nearest_even
+		inline float8 lane_round(const float8& a)
+		{
+			return float8(_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+		}
+
+		inline float8 lane_floor(const float8& a)
+		{
+			return float8(_mm256_floor_ps(a.v));
+		}
+
+		// the lanes summed as a tree, the halves first, as the float4 sum after that
+		inline float lane_sum(const float8& a)
+		{
+			__m128 u = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+			__m128 v = _mm_add_ps(u, _mm_movehl_ps(u, u));
+
+			return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+		}
+
+		// lane_sum of four registers at once, into out[0..3]
+		inline void lane_sum4(const float8& a, const float8& b, const float8& c, const float8& d, float* out)
+		{
+			__m128 ua = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+			__m128 ub = _mm_add_ps(_mm256_castps256_ps128(b.v), _mm256_extractf128_ps(b.v, 1));
+			__m128 uc = _mm_add_ps(_mm256_castps256_ps128(c.v), _mm256_extractf128_ps(c.v, 1));
+			__m128 ud = _mm_add_ps(_mm256_castps256_ps128(d.v), _mm256_extractf128_ps(d.v, 1));
+
+			__m128 ab = _mm_add_ps(_mm_unpacklo_ps(ua, ub), _mm_unpackhi_ps(ua, ub));
+			__m128 cd = _mm_add_ps(_mm_unpacklo_ps(uc, ud), _mm_unpackhi_ps(uc, ud));
+
+			_mm_storeu_ps(out, _mm_add_ps(_mm_movelh_ps(ab, cd), _mm_movehl_ps(cd, ab)));
+		}
+
+		inline void lane_load(float8& a, const float* p)
+		{
+			a = float8(_mm256_loadu_ps(p));
+		}
+
+		inline void lane_store(float* p, const float8& a)
+		{
+			_mm256_storeu_ps(p, a.v);
+		}
+#endif
+
+#ifdef _REACT_SIMD_SSE2
+		// Four float lanes, the SSE2 counterpart of float8 for targets without AVX2
+		struct float4
+		{
+			__m128 v;
+
+			float4() : v(_mm_setzero_ps()) {}
+			explicit float4(const __m128& v) : v(v) {}
+			explicit float4(const float& a) : v(_mm_set1_ps(a)) {}
+		};
+
+		inline float4 operator+(const float4& a, const float4& b) { return float4(_mm_add_ps(a.v, b.v)); }
+		inline float4 operator-(const float4& a, const float4& b) { return float4(_mm_sub_ps(a.v, b.v)); }
+		inline float4 operator*(const float4& a, const float4& b) { return float4(_mm_mul_ps(a.v, b.v)); }
+		inline float4 operator/(const float4& a, const float4& b) { return float4(_mm_div_ps(a.v, b.v)); }
+		inline float4 operator-(const float4& a) { return float4(_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))); }
+		inline float4 operator<(const float4& a, const float4& b) { return float4(_mm_cmplt_ps(a.v, b.v)); }
+		inline float4 operator>(const float4& a, const float4& b) { return float4(_mm_cmpgt_ps(a.v, b.v)); }
+
+		inline float4& operator+=(float4& a, const float4& b) { return a = a + b; }
+		inline float4& operator-=(float4& a, const float4& b) { return a = a - b; }
+		inline float4& operator*=(float4& a, const float4& b) { return a = a * b; }
+
+		// SSE2 has no blend, masks are all ones or all zeros per lane
+		inline float4 lane_select(const float4& mask, const float4& a, const float4& b)
+		{
+			return float4(_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)));
+		}
+
+		inline float4 lane_sqrt(const float4& a)
+		{
+			return float4(_mm_sqrt_ps(a.v));
+		}
+
+		// estimate refined with one Newton step, close to full float precision
+		inline float4 lane_rsqrt(const float4& a)
+		{
+			__m128 r = _mm_rsqrt_ps(a.v);
+			__m128 h = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), a.v), r);
+
+			return float4(_mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(h, r))));
+		}
+
+		inline float4 lane_abs(const float4& a)
+		{
+			return float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v));
+		}
+
+		inline float4 lane_max(const float4& a, const float4& b)
+		{
+			return float4(_mm_max_ps(a.v, b.v));
+		}
+
+		inline float4 lane_fmadd(const float4& a, const float4& b, const float4& c)
+		{
+#ifdef _REACT_SIMD_FMA
+			return float4(_mm_fmadd_ps(a.v, b.v, c.v));
+#else
+			return float4(_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v));
+#endif
+		}
+
+		// nearest even through the integer conversion, SSE2 has no round instruction. For |a| < 2^31.
+		inline float4 lane_round(const float4& a)
+		{
+			return float4(_mm_cvtepi32_ps(_mm_cvtps_epi32(a.v)));
+		}
+
+		inline float4 lane_floor(const float4& a)
+		{
+			__m128 r = _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v));
+
+			return float4(_mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, a.v), _mm_set1_ps(1.0f))));
+		}
+
+		// (a0 + a2) + (a1 + a3)
+		inline float lane_sum(const float4& a)
+		{
+			__m128 v = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+
+			return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+		}
+
+		// lane_sum of four registers at once, into out[0..3]
+		inline void lane_sum4(const float4& a, const float4& b, const float4& c, const float4& d, float* out)
+		{
+			// a0 + a2, b0 + b2, a1 + a3, b1 + b3
+			__m128 ab = _mm_add_ps(_mm_unpacklo_ps(a.v, b.v), _mm_unpackhi_ps(a.v, b.v));
+			__m128 cd = _mm_add_ps(_mm_unpacklo_ps(c.v, d.v), _mm_unpackhi_ps(c.v, d.v));
+
+			_mm_storeu_ps(out, _mm_add_ps(_mm_movelh_ps(ab, cd), _mm_movehl_ps(cd, ab)));
+		}
+
+		inline void lane_load(float4& a, const float* p)
+		{
+			a = float4(_mm_loadu_ps(p));
+		}
+
+		inline void lane_store(float* p, const float4& a)
+		{
+			_mm_storeu_ps(p, a.v);
+		}
+#endif
+
+		// Sets flush to zero and denormals are zero for the current thread while in scope. Iterative kernels whose terms
+		// decay towards zero otherwise slow down many times once they reach denormals.
+		class flush_denormals
+		{
+		public:
+#ifdef _REACT_SIMD_SSE2
+			flush_denormals() : m_csr(_mm_getcsr()) { _mm_setcsr(m_csr | 0x8040); }
+			~flush_denormals() { _mm_setcsr(m_csr); }
+
+		private:
+			unsigned int m_csr;
+#endif
+		};
+
+		// Scalar versions of the lane functions
+		template <typename T>
+		inline T lane_select(const bool& mask, const T& a, const T& b)
+		{
+			return mask ? a : b;
+		}
+
+		template <typename T>
+		inline T lane_sqrt(const T& a)
+		{
+			return std::sqrt(a);
+		}
+
+		template <typename T>
+		inline T lane_rsqrt(const T& a)
+		{
+			return static_cast<T>(1) / std::sqrt(a);
+		}
+
+		template <typename T>
+		inline T lane_abs(const T& a)
+		{
+			return std::abs(a);
+		}
+
+		template <typename T>
+		inline T lane_max(const T& a, const T& b)
+		{
+			return a > b ? a : b;
+		}
+
+		// a * b + c, fused exactly when the vector versions are, so a kernel rounds alike at every width whatever the
+		// compiler contracts
+		template <typename T>
+		inline T lane_fmadd(const T& a, const T& b, const T& c)
+		{
+#ifdef _REACT_SIMD_FMA
+			return std::fma(a, b, c);
+#else
+			return a * b + c;
+#endif
+		}
+
+		template <typename T>
+		inline T lane_round(const T& a)
+		{
+			return std::nearbyint(a);
+		}
+
+		inline float lane_round(const float& a)
+		{
+			return static_cast<float>(round_nearest_even(a));
+		}
+
+		template <typename T>
+		inline T lane_floor(const T& a)
+		{
+			return std::floor(a);
+		}
+
+		template <typename T>
+		inline T lane_sum(const T& a)
+		{
+			return a;
+		}
+
+		template <typename T>
+		inline void lane_sum4(const T& a, const T& b, const T& c, const T& d, T* out)
+		{
+			out[0] = a;
+			out[1] = b;
+			out[2] = c;
+			out[3] = d;
+		}
+
+		template <typename T>
+		inline void lane_load(T& a, const T* p)
+		{
+			a = *p;
+		}
+
+		template <typename T>
+		inline void lane_store(T* p, const T& a)
+		{
+			*p = a;
+		}
+
+		template <typename L>
+		struct lane_traits
+		{
+			typedef L scalar;
+			static const size_t WIDTH = 1;
+		};
+
+#ifdef _REACT_SIMD_AVX2
+		template <>
+		struct lane_traits<float8>
+		{
+			typedef float scalar;
+			static const size_t WIDTH = 8;
+		};
+#endif
+
+#ifdef _REACT_SIMD_SSE2
+		template <>
+		struct lane_traits<float4>
+		{
+			typedef float scalar;
+			static const size_t WIDTH = 4;
+		};
+#endif
+	}
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef _RM_SORT_H
+#define _RM_SORT_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.h"
+
+namespace react
+{
+	namespace support
+	{
+		// LSD radix sort of unsigned keys, 8 bits per pass, carrying a uint32_t value per key. Stable, passes where
+		// every key has the same digit are skipped. The parallel path builds per-chunk histograms so each thread
+		// scatters its own chunk to precomputed offsets.
+		template <typename K>
+		void radix_sort(K* keys, uint32_t* values, const size_t& count, const bool& parallel = false)
+		{
+			static_assert(std::is_unsigned<K>::value, "radix_sort needs unsigned keys");
+
+			const size_t grain = 1 << 16;
+			const size_t chunks = parallel ? parallel_chunks(count, grain) : 1;
+
+			std::vector<K> key_buffer(count);
+			std::vector<uint32_t> value_buffer(count);
+			std::vector<size_t> offsets(chunks * 256);
+
+			K* key_src = keys;
+			K* key_dst = key_buffer.data();
+			uint32_t* value_src = values;
+			uint32_t* value_dst = value_buffer.data();
+
+			// bits that differ somewhere, passes over constant digits are skipped
+			K all_or = 0;
+			K all_and = ~K(0);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				all_or |= keys[i];
+				all_and &= keys[i];
+			}
+
+			K varying = all_or ^ all_and;
+
+			for (size_t shift = 0; shift < sizeof(K) * 8; shift += 8)
+			{
+				if (((varying >> shift) & 0xff) == 0)
+					continue;
+
+				std::fill(offsets.begin(), offsets.end(), 0);
+
+				auto histogram = [&](size_t chunk, size_t begin, size_t end)
+				{
+					size_t* h = offsets.data() + chunk * 256;
+
+					for (size_t i = begin; i < end; ++i)
+						++h[(key_src[i] >> shift) & 0xff];
+				};
+
+				auto scatter = [&](size_t chunk, size_t begin, size_t end)
+				{
+					size_t* h = offsets.data() + chunk * 256;
+
+					for (size_t i = begin; i < end; ++i)
+					{
+						size_t& slot = h[(key_src[i] >> shift) & 0xff];
+
+						key_dst[slot] = key_src[i];
+						value_dst[slot] = value_src[i];
+						++slot;
+					}
+				};
+
+				if (chunks > 1)
+					parallel_for(count, grain, histogram);
+				else
+					histogram(0, 0, count);
+
+				// exclusive prefix over (digit, chunk), so each chunk writes after the earlier chunks' equal digits
+				size_t sum = 0;
+
+				for (size_t digit = 0; digit < 256; ++digit)
+				{
+					for (size_t chunk = 0; chunk < chunks; ++chunk)
+					{
+						size_t n = offsets[chunk * 256 + digit];
+						offsets[chunk * 256 + digit] = sum;
+						sum += n;
+					}
+				}
+
+				if (chunks > 1)
+					parallel_for(count, grain, scatter);
+				else
+					scatter(0, 0, count);
+
+				std::swap(key_src, key_dst);
+				std::swap(value_src, value_dst);
+			}
+
+			if (key_src != keys)
+			{
+				std::memcpy(keys, key_src, count * sizeof(K));
+				std::memcpy(values, value_src, count * sizeof(uint32_t));
+			}
+		}
+
+		// out[i] = in[order[i]]
+		template <typename V>
+		void gather(const V* in, const uint32_t* order, const size_t& count, V* out, const bool& parallel = false)
+		{
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					out[i] = in[order[i]];
+			};
+
+			if (parallel)
+				parallel_for(count, 1 << 16, kernel);
+			else
+				kernel(0, 0, count);
+		}
+
+		// In place data[i] = data[order[i]], through a temporary copy
+		template <typename V>
+		void permute(V* data, const uint32_t* order, const size_t& count, const bool& parallel = false)
+		{
+			std::vector<V> copy(data, data + count);
+
+			gather(copy.data(), order, count, data, parallel);
+		}
+	}
+}
+
+#endif
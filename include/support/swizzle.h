@@ -0,0 +1,325 @@
+#ifndef _RM_SWIZZLE_H
+#define _RM_SWIZZLE_H
+
+#include <initializer_list>
+#include <iostream>
+#include <type_traits>
+
+namespace react
+{
+	namespace support
+	{
+		template <size_t S, typename T>
+		class vector;
+
+		template <size_t... I>
+		constexpr bool swizzle_distinct()
+		{
+			const size_t index[] = { I... };
+
+			for (size_t a = 0; a < sizeof...(I); ++a)
+				for (size_t b = a + 1; b < sizeof...(I); ++b)
+					if (index[a] == index[b])
+						return false;
+
+			return true;
+		}
+
+		template <size_t... I>
+		constexpr size_t swizzle_max()
+		{
+			const size_t index[] = { I... };
+			size_t m = 0;
+
+			for (size_t a = 0; a < sizeof...(I); ++a)
+				m = index[a] > m ? index[a] : m;
+
+			return m;
+		}
+
+		// A view of the components I... of a vector, in that order. Reads go straight to the viewed vector and
+		// the index pattern is a compile time constant, so a swizzle costs the same as naming the components by hand.
+		// T is const for views of const vectors. Views of mutable vectors with distinct components are write masks,
+		// v.xz() = w writes w[0] to x and w[1] to z and leaves y alone. Writes read their operand into a copy first,
+		// so it may be the viewed vector or another view of it.
+		// A view does not own its data, it must not outlive the vector it was taken from.
+		template <typename T, size_t... I>
+		class swizzle_view
+		{
+		public:
+			static const size_t DIMENSION = sizeof...(I);
+			using type = typename std::remove_const<T>::type;
+			using vector_type = vector<DIMENSION, type>;
+
+			// constructors
+			explicit swizzle_view(T* data) : m_data(data) {}
+			swizzle_view(const swizzle_view<T, I...>& s) = default;
+
+			// Accessors
+			inline T& operator[](const size_t& index) const;
+			inline const vector_type get() const;
+
+			inline operator vector_type() const;
+
+			// Utility functions
+			const type dot(const vector_type& v) const;
+			const type length_squared() const;
+			const type length() const;
+
+			// Operators
+			swizzle_view<T, I...>& operator=(const vector_type& v);
+			swizzle_view<T, I...>& operator=(const swizzle_view<T, I...>& s);
+
+			template <typename TT, size_t... J>
+			swizzle_view<T, I...>& operator=(const swizzle_view<TT, J...>& s);
+
+			swizzle_view<T, I...>& operator+=(const vector_type& v);
+			swizzle_view<T, I...>& operator-=(const vector_type& v);
+			swizzle_view<T, I...>& operator*=(const vector_type& v);
+			swizzle_view<T, I...>& operator/=(const vector_type& v);
+
+			swizzle_view<T, I...>& operator*=(const type& c);
+			swizzle_view<T, I...>& operator/=(const type& c);
+
+			vector_type operator+(const vector_type& v) const;
+			vector_type operator-(const vector_type& v) const;
+			vector_type operator*(const vector_type& v) const;
+			vector_type operator/(const vector_type& v) const;
+
+			vector_type operator*(const type& c) const;
+			vector_type operator/(const type& c) const;
+
+			const bool operator==(const vector_type& v) const;
+			const bool operator!=(const vector_type& v) const;
+
+			friend std::ostream& operator<<(std::ostream& out, const swizzle_view<T, I...>& s)
+			{
+				return out << s.get();
+			}
+
+		private:
+			void check_writable() const
+			{
+				static_assert(!std::is_const<T>::value, "swizzle of a const vector is read only");
+				static_assert(swizzle_distinct<I...>(), "swizzle writes need distinct components");
+			}
+
+			// calls f(component, k) for each component k of the view, unrolled with the offsets as constants.
+			// A loop over an index table gets vectorized into gathers and scatters.
+			template <typename F>
+			inline void each(F&& f) const
+			{
+				size_t k = 0;
+				(void)std::initializer_list<int>{ (f(m_data[I], k++), 0)... };
+			}
+
+			static constexpr size_t INDEX[DIMENSION] = { I... };
+
+			T* m_data;
+		};
+
+		template <typename T, size_t... I>
+		constexpr size_t swizzle_view<T, I...>::INDEX[];
+
+		template <typename T, size_t... I>
+		inline T& swizzle_view<T, I...>::operator[](const size_t& index) const
+		{
+			return m_data[INDEX[index]];
+		}
+
+		template <typename T, size_t... I>
+		inline const typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::get() const
+		{
+			vector_type tmp;
+
+			each([&](const T& c, const size_t& k) { tmp.m_data[k] = c; });
+
+			return tmp;
+		}
+
+		template <typename T, size_t... I>
+		inline swizzle_view<T, I...>::operator vector_type() const
+		{
+			return get();
+		}
+
+		template <typename T, size_t... I>
+		const typename swizzle_view<T, I...>::type swizzle_view<T, I...>::dot(const vector_type& v) const
+		{
+			type sum = static_cast<type>(0);
+
+			each([&](const T& c, const size_t& k) { sum += c * v.m_data[k]; });
+
+			return sum;
+		}
+
+		template <typename T, size_t... I>
+		const typename swizzle_view<T, I...>::type swizzle_view<T, I...>::length_squared() const
+		{
+			type sum = static_cast<type>(0);
+
+			each([&](const T& c, const size_t&) { sum += c * c; });
+
+			return sum;
+		}
+
+		template <typename T, size_t... I>
+		const typename swizzle_view<T, I...>::type swizzle_view<T, I...>::length() const
+		{
+			return sqrt(length_squared());
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator=(const vector_type& v)
+		{
+			check_writable();
+
+			// from a copy, v may be the vector the view writes to, as in a.yx() = a
+			const vector_type tmp(v);
+
+			each([&](T& c, const size_t& k) { c = tmp.m_data[k]; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator=(const swizzle_view<T, I...>& s)
+		{
+			return *this = s.get();
+		}
+
+		template <typename T, size_t... I>
+		template <typename TT, size_t... J>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator=(const swizzle_view<TT, J...>& s)
+		{
+			static_assert(sizeof...(J) == DIMENSION, "swizzle dimensions must match");
+
+			return *this = vector_type(s.get());
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator+=(const vector_type& v)
+		{
+			check_writable();
+
+			const vector_type tmp(v);
+
+			each([&](T& c, const size_t& k) { c += tmp.m_data[k]; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator-=(const vector_type& v)
+		{
+			check_writable();
+
+			const vector_type tmp(v);
+
+			each([&](T& c, const size_t& k) { c -= tmp.m_data[k]; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator*=(const vector_type& v)
+		{
+			check_writable();
+
+			const vector_type tmp(v);
+
+			each([&](T& c, const size_t& k) { c *= tmp.m_data[k]; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator/=(const vector_type& v)
+		{
+			check_writable();
+
+			const vector_type tmp(v);
+
+			each([&](T& c, const size_t& k) { c /= tmp.m_data[k]; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator*=(const type& c)
+		{
+			check_writable();
+
+			each([&](T& x, const size_t&) { x *= c; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		swizzle_view<T, I...>& swizzle_view<T, I...>::operator/=(const type& c)
+		{
+			check_writable();
+
+			each([&](T& x, const size_t&) { x /= c; });
+
+			return *this;
+		}
+
+		template <typename T, size_t... I>
+		typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::operator+(const vector_type& v) const
+		{
+			return get() + v;
+		}
+
+		template <typename T, size_t... I>
+		typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::operator-(const vector_type& v) const
+		{
+			return get() - v;
+		}
+
+		template <typename T, size_t... I>
+		typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::operator*(const vector_type& v) const
+		{
+			return get() * v;
+		}
+
+		template <typename T, size_t... I>
+		typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::operator/(const vector_type& v) const
+		{
+			return get() / v;
+		}
+
+		template <typename T, size_t... I>
+		typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::operator*(const type& c) const
+		{
+			return get() * c;
+		}
+
+		template <typename T, size_t... I>
+		typename swizzle_view<T, I...>::vector_type swizzle_view<T, I...>::operator/(const type& c) const
+		{
+			return get() / c;
+		}
+
+		template <typename T, size_t... I>
+		inline typename swizzle_view<T, I...>::vector_type operator*(const typename swizzle_view<T, I...>::type& c, const swizzle_view<T, I...>& s)
+		{
+			return s * c;
+		}
+
+		template <typename T, size_t... I>
+		const bool swizzle_view<T, I...>::operator==(const vector_type& v) const
+		{
+			// the vector comparison, so v.xy() == w agrees with vector_type(v.xy()) == w
+			return get() == v;
+		}
+
+		template <typename T, size_t... I>
+		const bool swizzle_view<T, I...>::operator!=(const vector_type& v) const
+		{
+			return !(*this == v);
+		}
+	}
+}
+
+#endif
@@ -8,7 +8,9 @@
 #include <cassert>
 #include <algorithm>
 
+#include "accumulate.h"
 #include "common.h"
+#include "swizzle.h"
 
 namespace react
 {
@@ -18,8 +20,8 @@ namespace react
 		class vector
 		{
 		private:
-			typename check_vec_dimension<T, S>::type cd{};
-			typename check_type_arithmetic<T>::type ct{};
+			typedef typename check_vec_dimension<T, S>::type cd;
+			typedef typename check_type_arithmetic<T>::type ct;
 
 		public:
 			static const size_t DIMENSION = S;
@@ -89,12 +91,59 @@ namespace react
 			template <typename TT = enable_from_vec4<T>>
 			inline const T& a() const;
 
+			// swizzle accessors, views of the components in the order named. v.swizzle<2, 0, 1>() for any other pattern.
+			// Views of an lvalue, copies of a temporary, so (a + b).xy() does not outlive a + b
+			template <size_t... I>
+			inline swizzle_view<T, I...> swizzle() &;
+
+			template <size_t... I>
+			inline swizzle_view<const T, I...> swizzle() const &;
+
+			template <size_t... I>
+			inline const typename swizzle_view<T, I...>::vector_type swizzle() const &&;
+
+#define _RM_SWIZZLE2(a, b, i, j) \
+			inline swizzle_view<T, i, j> a##b() & { return swizzle<i, j>(); } \
+			inline swizzle_view<const T, i, j> a##b() const & { return swizzle<i, j>(); } \
+			inline const vector<2, T> a##b() const && { return swizzle<i, j>().get(); }
+
+#define _RM_SWIZZLE3(a, b, c, i, j, k) \
+			inline swizzle_view<T, i, j, k> a##b##c() & { return swizzle<i, j, k>(); } \
+			inline swizzle_view<const T, i, j, k> a##b##c() const & { return swizzle<i, j, k>(); } \
+			inline const vector<3, T> a##b##c() const && { return swizzle<i, j, k>().get(); }
+
+#define _RM_SWIZZLE2_ROW(a, i) \
+			_RM_SWIZZLE2(a, x, i, 0) _RM_SWIZZLE2(a, y, i, 1) _RM_SWIZZLE2(a, z, i, 2) _RM_SWIZZLE2(a, w, i, 3)
+
+#define _RM_SWIZZLE3_ROW2(a, b, i, j) \
+			_RM_SWIZZLE3(a, b, x, i, j, 0) _RM_SWIZZLE3(a, b, y, i, j, 1) _RM_SWIZZLE3(a, b, z, i, j, 2) _RM_SWIZZLE3(a, b, w, i, j, 3)
+
+#define _RM_SWIZZLE3_ROW(a, i) \
+			_RM_SWIZZLE3_ROW2(a, x, i, 0) _RM_SWIZZLE3_ROW2(a, y, i, 1) _RM_SWIZZLE3_ROW2(a, z, i, 2) _RM_SWIZZLE3_ROW2(a, w, i, 3)
+
+			_RM_SWIZZLE2_ROW(x, 0)
+			_RM_SWIZZLE2_ROW(y, 1)
+			_RM_SWIZZLE2_ROW(z, 2)
+			_RM_SWIZZLE2_ROW(w, 3)
+
+			_RM_SWIZZLE3_ROW(x, 0)
+			_RM_SWIZZLE3_ROW(y, 1)
+			_RM_SWIZZLE3_ROW(z, 2)
+			_RM_SWIZZLE3_ROW(w, 3)
+
+#undef _RM_SWIZZLE3_ROW
+#undef _RM_SWIZZLE3_ROW2
+#undef _RM_SWIZZLE2_ROW
+#undef _RM_SWIZZLE3
+#undef _RM_SWIZZLE2
+
 			// Utility functions
 			const T angle(const vector<S, T>& b) const;
-			const T dot(const vector<S, T>& v) const;
+			const T dot(const vector<S, T>& v, const accumulation& policy = accumulation_traits<vector<S, T>>::policy()) const;
 			const T distance(const vector<S, T>& v) const;
-			const T length_squared() const;
-			const T length() const;
+			const T distance_squared(const vector<S, T>& v) const;
+			const T length_squared(const accumulation& policy = accumulation_traits<vector<S, T>>::policy()) const;
+			const T length(const accumulation& policy = accumulation_traits<vector<S, T>>::policy()) const;
 			const vector<S, T> lerp(const vector<S, T>& b, const T& t) const;
 			const vector<S, T> normalized() const;
 			const vector<S, T> project(const vector<S, T>& v) const;
@@ -104,14 +153,16 @@ namespace react
 
 			// Static utility functions
 			static const T angle(const vector<S, T>& a, const vector<S, T>& b);
-			const static T dot(const vector<S, T>& a, const vector<S, T>& b);
+			const static T dot(const vector<S, T>& a, const vector<S, T>& b, const accumulation& policy = accumulation_traits<vector<S, T>>::policy());
 			const static T distance(const vector<S, T>& a, const vector<S, T>& b);
-			const static T length_squared(const vector<S, T>& v);
-			const static T length(const vector<S, T>& v);
+			const static T distance_squared(const vector<S, T>& a, const vector<S, T>& b);
+			const static T length_squared(const vector<S, T>& v, const accumulation& policy = accumulation_traits<vector<S, T>>::policy());
+			const static T length(const vector<S, T>& v, const accumulation& policy = accumulation_traits<vector<S, T>>::policy());
 			const static vector<S, T> lerp(const vector<S, T>& a, const vector<S, T>& b, const T& t);
 			const static vector<S, T> max(const vector<S, T>& a, const vector<S, T>& b);
 			const static vector<S, T> min(const vector<S, T>& a, const vector<S, T>& b);
 			const static vector<S, T> normalized(const vector<S, T>& a);
+			static void normalize(const vector<S, T>& v, vector<S, T>& out);
 			const static vector<S, T> project(const vector<S, T>& a, const vector<S, T>& b);
 			const static vector<S, T> random(const T& min, const T& max);
 
@@ -150,7 +201,7 @@ namespace react
 
 			friend std::ostream& operator<<(std::ostream& out, const vector<S, T>& v)
 			{
-				for (int i = 0; i < v.DIMENSION; ++i)
+				for (size_t i = 0; i < v.DIMENSION; ++i)
 					out << v.m_data[i] << ' ';
 
 				return out;
@@ -169,7 +220,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>::vector(const T& a)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] = a;
 		}
 
@@ -189,10 +240,35 @@ namespace react
 		{
 			size_t MIN_DIMENSION = std::min(DIMENSION, v.DIMENSION);
 
-			for (int i = 0; i < MIN_DIMENSION; ++i)
+			for (size_t i = 0; i < MIN_DIMENSION; ++i)
 				m_data[i] = v[i];
 		}
 
+		template <size_t S, typename T>
+		template <size_t... I>
+		inline swizzle_view<T, I...> vector<S, T>::swizzle() &
+		{
+			static_assert(swizzle_max<I...>() < S, "swizzle component out of range");
+
+			return swizzle_view<T, I...>(m_data);
+		}
+
+		template <size_t S, typename T>
+		template <size_t... I>
+		inline swizzle_view<const T, I...> vector<S, T>::swizzle() const &
+		{
+			static_assert(swizzle_max<I...>() < S, "swizzle component out of range");
+
+			return swizzle_view<const T, I...>(m_data);
+		}
+
+		template <size_t S, typename T>
+		template <size_t... I>
+		inline const typename swizzle_view<T, I...>::vector_type vector<S, T>::swizzle() const &&
+		{
+			return static_cast<const vector<S, T>&>(*this).template swizzle<I...>().get();
+		}
+
 		template <size_t S, typename T>
 		inline T& vector<S, T>::x()
 		{
@@ -331,7 +407,7 @@ namespace react
 				return false;
 
 #ifndef _REACT_EXACT_COMPARISON
-			for (int i = 0; i < DIMENSION; ++i)
+			for (size_t i = 0; i < DIMENSION; ++i)
 				if (fabs(m_data[i] - other.m_data[i]) > std::numeric_limits<T>::epsilon())
 					return false;
 
@@ -351,7 +427,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator++()
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i]++;
 
 			return *this;
@@ -360,7 +436,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator--()
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i]--;
 
 			return *this;
@@ -369,7 +445,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator+=(const vector<S, T>& v)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] += v.m_data[i];
 
 			return *this;
@@ -378,7 +454,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator-=(const vector<S, T>& v)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] -= v.m_data[i];
 
 			return *this;
@@ -387,7 +463,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator*=(const vector<S, T>& v)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] *= v.m_data[i];
 
 			return *this;
@@ -396,7 +472,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator/=(const vector<S, T>& v)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] /= v.m_data[i];
 
 			return *this;
@@ -405,7 +481,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator*=(const T& c)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] *= c;
 
 			return *this;
@@ -414,7 +490,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator/=(const T& c)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] /= c;
 
 			return *this;
@@ -423,7 +499,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator+=(const T& c)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] += c;
 
 			return *this;
@@ -432,7 +508,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::operator-=(const T& c)
 		{
-			for (int i = 0; i < this->DIMENSION; ++i)
+			for (size_t i = 0; i < this->DIMENSION; ++i)
 				m_data[i] -= c;
 
 			return *this;
@@ -481,7 +557,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < v.DIMENSION; ++i)
+			for (size_t i = 0; i < v.DIMENSION; ++i)
 				tmp[i] = c / v[i];
 
 			return tmp;
@@ -492,7 +568,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < v.DIMENSION; ++i)
+			for (size_t i = 0; i < v.DIMENSION; ++i)
 				tmp[i] = c + v[i];
 
 			return tmp;
@@ -503,7 +579,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < v.DIMENSION; ++i)
+			for (size_t i = 0; i < v.DIMENSION; ++i)
 				tmp[i] = c - v[i];
 
 			return tmp;
@@ -548,9 +624,9 @@ namespace react
 		}
 
 		template <size_t S, typename T>
-		const T vector<S, T>::dot(const vector& v) const
+		const T vector<S, T>::dot(const vector& v, const accumulation& policy) const
 		{
-			return dot(*this, v);
+			return dot(*this, v, policy);
 		}
 
 		template <size_t S, typename T>
@@ -560,15 +636,21 @@ namespace react
 		}
 
 		template <size_t S, typename T>
-		const T vector<S, T>::length_squared() const
+		const T vector<S, T>::distance_squared(const vector<S, T>& v) const
 		{
-			return length_squared(*this);
+			return distance_squared(*this, v);
 		}
 
 		template <size_t S, typename T>
-		const T vector<S, T>::length() const
+		const T vector<S, T>::length_squared(const accumulation& policy) const
 		{
-			return length(*this);
+			return length_squared(*this, policy);
+		}
+
+		template <size_t S, typename T>
+		const T vector<S, T>::length(const accumulation& policy) const
+		{
+			return length(*this, policy);
 		}
 
 		template <size_t S, typename T>
@@ -592,11 +674,7 @@ namespace react
 		template <size_t S, typename T>
 		vector<S, T>& vector<S, T>::normalize()
 		{
-			T len = length();
-
-			for (int i = 0; i < this->DIMENSION; ++i)
-				m_data[i] /= len;
-
+			normalize(*this, *this);
 			return *this;
 		}
 
@@ -609,37 +687,33 @@ namespace react
 		}
 
 		template <size_t S, typename T>
-		const T vector<S, T>::dot(const vector<S, T>& a, const vector<S, T>& b)
+		const T vector<S, T>::dot(const vector<S, T>& a, const vector<S, T>& b, const accumulation& policy)
 		{
-			T tmp = 0;
-
-			for (int i = 0; i < a.DIMENSION; ++i)
-				tmp += a.m_data[i] * b.m_data[i];
-
-			return tmp;
+			return accumulate_dot(a.m_data, b.m_data, S, policy);
 		}
 
 		template <size_t S, typename T>
 		const T vector<S, T>::distance(const vector<S, T>& a, const vector<S, T>& b)
 		{
-			return (a - b).length();
+			return sqrt(distance_squared(a, b));
 		}
 
 		template <size_t S, typename T>
-		const T vector<S, T>::length_squared(const vector<S, T>& v)
+		const T vector<S, T>::distance_squared(const vector<S, T>& a, const vector<S, T>& b)
 		{
-			T tmp = 0;
-
-			for (int i = 0; i < v.DIMENSION; ++i)
-				tmp += v.m_data[i] * v.m_data[i];
+			return distance_squared_native(a.m_data, b.m_data, S);
+		}
 
-			return tmp;
+		template <size_t S, typename T>
+		const T vector<S, T>::length_squared(const vector<S, T>& v, const accumulation& policy)
+		{
+			return accumulate_dot(v.m_data, v.m_data, S, policy);
 		}
 
 		template <size_t S, typename T>
-		const T vector<S, T>::length(const vector<S, T>& v)
+		const T vector<S, T>::length(const vector<S, T>& v, const accumulation& policy)
 		{
-			return sqrt(length_squared(v));
+			return sqrt(length_squared(v, policy));
 		}
 
 		template <size_t S, typename T>
@@ -647,7 +721,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < a.DIMENSION; ++i)
+			for (size_t i = 0; i < a.DIMENSION; ++i)
 				tmp[i] = a.m_data[i] + t * (b.m_data[i] - a.m_data[i]);
 
 			return tmp;
@@ -658,7 +732,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < a.DIMENSION; ++i)
+			for (size_t i = 0; i < a.DIMENSION; ++i)
 				tmp.m_data[i] = a.m_data[i] > b.m_data[i] ? a.m_data[i] : b.m_data[i];
 
 			return tmp;
@@ -669,7 +743,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < a.DIMENSION; ++i)
+			for (size_t i = 0; i < a.DIMENSION; ++i)
 				tmp.m_data[i] = a.m_data[i] < b.m_data[i] ? a.m_data[i] : b.m_data[i];
 
 			return tmp;
@@ -678,7 +752,30 @@ namespace react
 		template <size_t S, typename T>
 		const vector<S, T> vector<S, T>::normalized(const vector<S, T>& a)
 		{
-			return a / a.length();
+			vector<S, T> tmp;
+			normalize(a, tmp);
+			return tmp;
+		}
+
+		template <size_t S, typename T>
+		void vector<S, T>::normalize(const vector<S, T>& v, vector<S, T>& out)
+		{
+			T len = v.length();
+
+			// one division and S multiplies for long vectors, in the same pass as the copy. Short ones keep their
+			// exact quotients.
+			if (S >= INTERLEAVED_MIN && std::is_floating_point<T>::value)
+			{
+				const T inv = T(1) / len;
+
+				for (size_t i = 0; i < S; ++i)
+					out.m_data[i] = v.m_data[i] * inv;
+			}
+			else
+			{
+				for (size_t i = 0; i < S; ++i)
+					out.m_data[i] = v.m_data[i] / len;
+			}
 		}
 
 		template <size_t S, typename T>
@@ -692,7 +789,7 @@ namespace react
 		{
 			vector<S, T> tmp;
 
-			for (int i = 0; i < tmp.DIMENSION; ++i)
+			for (size_t i = 0; i < tmp.DIMENSION; ++i)
 				tmp[i] = react::math::random(min, max);
 
 			return tmp;			
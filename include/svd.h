@@ -0,0 +1,850 @@
+#ifndef _RM_SVD_H
+#define _RM_SVD_H
+
+#include <algorithm>
+
+#include "vec3.h"
+#include "mat3.h"
+#include "quat.h"
+#include "span.h"
+#include "support/matrix.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Thin singular value decomposition A = U diag(values) V^T of a general matrix by one-sided Jacobi rotations.
+	// Singular values are non-negative and sorted in descending order, U and V have orthonormal columns.
+	template <size_t M, size_t N, typename T>
+	class svd
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static const size_t ROWS = N;
+		static const size_t COLS = M;
+		static const size_t RANK = ROWS < COLS ? ROWS : COLS;
+		static const int MAX_SWEEPS = 32;
+
+		// constructors
+		explicit svd(const support::matrix<M, N, T>& a);
+
+		// Utility functions
+		const support::matrix<M, N, T> reconstruct() const;
+
+		// Number of singular values above tolerance * the largest one
+		const size_t rank(const T& tolerance = std::numeric_limits<T>::epsilon() * static_cast<T>(ROWS > COLS ? ROWS : COLS)) const;
+
+		// Ratio of the largest to the smallest singular value, infinite when singular
+		const T condition() const;
+
+		support::matrix<RANK, ROWS, T> u;
+		support::vector<RANK, T> values;
+		support::matrix<RANK, COLS, T> v;
+	};
+
+	// Fast 3x3 singular value decomposition A = U diag(values) V^T with U and V proper rotations. To keep them rotations the
+	// last singular value carries the sign of det(A). Runs a fixed number of approximate Jacobi sweeps without branches,
+	// so batches are evaluated 8 matrices at a time when AVX2 is available.
+	template <typename T>
+	class svd3
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		static const int SWEEPS = sizeof(T) > sizeof(float) ? 8 : 6;
+
+		// constructors
+		svd3() : u(), values(static_cast<T>(0)), v() {}
+		explicit svd3(const mat3<T>& a);
+
+		// Utility functions
+		const mat3<T> reconstruct() const;
+
+		// Static utility functions
+		static void compute(const mat3<T>* matrices, const size_t& count, svd3<T>* out, const bool& parallel = false);
+		static void compute(const mat_span<3, 3, const T>& matrices, svd3<T>* out, const bool& parallel = false);
+
+		mat3<T> u;
+		vec3<T> values;
+		mat3<T> v;
+	};
+
+	// Polar decomposition A = R S into a rotation and a symmetric stretch, from the 3x3 SVD: R = U V^T, S = V diag(values) V^T.
+	// For an inverted A (det < 0) R is still a proper rotation and S takes the reflection.
+	template <typename T>
+	class polar3
+	{
+	private:
+		typedef typename support::check_type_floating<T>::type ctf;
+
+	public:
+		// constructors
+		polar3() : rotation(), stretch() {}
+		explicit polar3(const mat3<T>& a);
+		explicit polar3(const svd3<T>& s);
+
+		// Static utility functions
+		static void compute(const mat3<T>* matrices, const size_t& count, polar3<T>* out, const bool& parallel = false);
+		static void compute(const mat_span<3, 3, const T>& matrices, polar3<T>* out, const bool& parallel = false);
+
+		// Rotations only, as needed for shape matching and deformation gradients
+		static void rotations(const mat3<T>* matrices, const size_t& count, quat<T>* out, const bool& parallel = false);
+		static void rotations(const mat_span<3, 3, const T>& matrices, quat<T>* out, const bool& parallel = false);
+
+		quat<T> rotation;
+		mat3<T> stretch;
+	};
+
+	namespace support
+	{
+		// Orthogonalizes the columns of the column major rows x cols matrix 'a' (rows >= cols) in place, accumulating the
+		// rotations into the cols x cols matrix 'v', which should start as the identity.
+		// credit Hestenes, "Inversion of Matrices by Biorthogonalization and Related Results"
+		template <typename T>
+		void one_sided_jacobi(T* a, const size_t& rows, const size_t& cols, T* v, const int max_sweeps)
+		{
+			const T tolerance = std::numeric_limits<T>::epsilon();
+
+			for (int sweep = 0; sweep < max_sweeps; ++sweep)
+			{
+				bool rotated = false;
+
+				for (size_t p = 0; p + 1 < cols; ++p)
+				{
+					for (size_t q = p + 1; q < cols; ++q)
+					{
+						T* ap = a + p * rows;
+						T* aq = a + q * rows;
+						T alpha = 0, beta = 0, gamma = 0;
+
+						for (size_t i = 0; i < rows; ++i)
+						{
+							alpha += ap[i] * ap[i];
+							beta += aq[i] * aq[i];
+							gamma += ap[i] * aq[i];
+						}
+
+						if (gamma == 0 || std::abs(gamma) <= tolerance * sqrt(alpha * beta))
+							continue;
+
+						rotated = true;
+
+						T zeta = (beta - alpha) / (2 * gamma);
+						T t = (zeta >= 0 ? static_cast<T>(1) : static_cast<T>(-1)) / (std::abs(zeta) + sqrt(zeta * zeta + 1));
+						T c = 1 / sqrt(t * t + 1);
+						T s = c * t;
+
+						for (size_t i = 0; i < rows; ++i)
+						{
+							T x = ap[i];
+							T y = aq[i];
+
+							ap[i] = c * x - s * y;
+							aq[i] = s * x + c * y;
+						}
+
+						T* vp = v + p * cols;
+						T* vq = v + q * cols;
+
+						for (size_t i = 0; i < cols; ++i)
+						{
+							T x = vp[i];
+							T y = vq[i];
+
+							vp[i] = c * x - s * y;
+							vq[i] = s * x + c * y;
+						}
+					}
+				}
+
+				if (!rotated)
+					break;
+			}
+		}
+
+		// Normalizes the (already orthogonal) columns of the rows x cols matrix 'a' into 'out' in the given order. Columns
+		// with no length are completed from the standard basis so 'out' always has orthonormal columns.
+		template <typename T>
+		void orthonormal_columns(const T* a, const size_t& rows, const size_t& cols, const size_t* order, const T* lengths, const T& tiny, T* out)
+		{
+			for (size_t j = 0; j < cols; ++j)
+			{
+				T* column = out + j * rows;
+				const T* source = a + order[j] * rows;
+
+				if (lengths[order[j]] > tiny)
+				{
+					for (size_t i = 0; i < rows; ++i)
+						column[i] = source[i] / lengths[order[j]];
+
+					continue;
+				}
+
+				// the basis vector with the largest part orthogonal to the columns so far
+				T best = -1;
+
+				for (size_t e = 0; e < rows; ++e)
+				{
+					T residual = 1;
+
+					for (size_t k = 0; k < j; ++k)
+						residual -= out[e + k * rows] * out[e + k * rows];
+
+					if (residual <= best)
+						continue;
+
+					best = residual;
+
+					for (size_t i = 0; i < rows; ++i)
+					{
+						column[i] = static_cast<T>(i == e ? 1 : 0);
+
+						for (size_t k = 0; k < j; ++k)
+							column[i] -= out[e + k * rows] * out[i + k * rows];
+					}
+				}
+
+				T length = 0;
+
+				for (size_t i = 0; i < rows; ++i)
+					length += column[i] * column[i];
+
+				length = sqrt(length);
+
+				for (size_t i = 0; i < rows; ++i)
+					column[i] /= length;
+			}
+		}
+
+		// credit McAdams et al., "Computing the Singular Value Decomposition of 3x3 matrices with minimal branching and
+		// elementary floating point operations". L is a scalar or a SIMD lane type, every step is branch free.
+		template <typename L>
+		inline void svd3_approximate_givens(const L& a11, const L& a12, const L& a22, L& ch, L& sh)
+		{
+			typedef typename lane_traits<L>::scalar S;
+
+			const L gamma(static_cast<S>(5.82842712474619009760)); // 3 + 2 sqrt(2)
+			const L cstar(static_cast<S>(0.92387953251128675613)); // cos(pi / 8)
+			const L sstar(static_cast<S>(0.38268343236508977173)); // sin(pi / 8)
+
+			ch = L(static_cast<S>(2)) * (a11 - a22);
+			sh = a12;
+
+			auto b = gamma * sh * sh < ch * ch;
+			L w = lane_rsqrt(ch * ch + sh * sh);
+
+			ch = lane_select(b, w * ch, cstar);
+			sh = lane_select(b, w * sh, sstar);
+		}
+
+		// One Jacobi rotation on the (1, 2) block of the symmetric s, accumulated into q. The entries are cycled
+		// afterwards so the next call works on the next pair; (x, y, z) is the matching quaternion axis order.
+		template <typename L>
+		inline void svd3_jacobi_conjugation(const int& x, const int& y, const int& z, L(&s)[6], L(&q)[4])
+		{
+			typedef typename lane_traits<L>::scalar S;
+
+			// s is s11 s21 s22 s31 s32 s33
+			L ch, sh;
+			svd3_approximate_givens(s[0], s[1], s[2], ch, sh);
+
+			L scale = L(static_cast<S>(1)) / (ch * ch + sh * sh);
+			L a = (ch * ch - sh * sh) * scale;
+			L b = L(static_cast<S>(2)) * sh * ch * scale;
+
+			L s11 = a * (a * s[0] + b * s[1]) + b * (a * s[1] + b * s[2]);
+			L s21 = a * (-b * s[0] + a * s[1]) + b * (-b * s[1] + a * s[2]);
+			L s22 = -b * (-b * s[0] + a * s[1]) + a * (-b * s[1] + a * s[2]);
+			L s31 = a * s[3] + b * s[4];
+			L s32 = -b * s[3] + a * s[4];
+			L s33 = s[5];
+
+			L tmp[3] = { q[0] * sh, q[1] * sh, q[2] * sh };
+			sh = sh * q[3];
+
+			for (int i = 0; i < 4; ++i)
+				q[i] = q[i] * ch;
+
+			q[z] += sh;
+			q[3] -= tmp[z];
+			q[x] += tmp[y];
+			q[y] -= tmp[x];
+
+			s[0] = s22;
+			s[1] = s32;
+			s[2] = s33;
+			s[3] = s21;
+			s[4] = s31;
+			s[5] = s11;
+		}
+
+		// Swaps X and Y when c, negating the one moved into Y
+		template <typename L, typename C>
+		inline void svd3_cond_neg_swap(const C& c, L& x, L& y)
+		{
+			L t = -x;
+			x = lane_select(c, y, x);
+			y = lane_select(c, t, y);
+		}
+
+		template <typename L>
+		inline void svd3_qr_givens(const L& a1, const L& a2, L& ch, L& sh)
+		{
+			typedef typename lane_traits<L>::scalar S;
+
+			const L epsilon(static_cast<S>(sizeof(S) > sizeof(float) ? 1e-15 : 1e-6));
+			const L zero(static_cast<S>(0));
+
+			L rho = lane_sqrt(a1 * a1 + a2 * a2);
+
+			sh = lane_select(rho > epsilon, a2, zero);
+			ch = lane_abs(a1) + lane_max(rho, epsilon);
+
+			auto b = a1 < zero;
+			L t = sh;
+			sh = lane_select(b, ch, sh);
+			ch = lane_select(b, t, ch);
+
+			L w = lane_rsqrt(ch * ch + sh * sh);
+			ch = ch * w;
+			sh = sh * w;
+		}
+
+		// a, u and v are row major 3x3, s the diagonal
+		template <typename L>
+		inline void svd3_kernel(const L(&in)[9], const int sweeps, L(&u)[9], L(&s)[3], L(&v)[9])
+		{
+			typedef typename lane_traits<L>::scalar S;
+
+			const L zero(static_cast<S>(0));
+			const L one(static_cast<S>(1));
+			const L two(static_cast<S>(2));
+
+			// work on a copy scaled to unit size, so the fixed epsilons hold for any magnitude
+			L scale = zero;
+
+			for (int i = 0; i < 9; ++i)
+				scale = lane_max(scale, lane_abs(in[i]));
+
+			scale = lane_select(scale > zero, scale, one);
+
+			L inv = one / scale;
+			L a[9];
+
+			for (int i = 0; i < 9; ++i)
+				a[i] = in[i] * inv;
+
+			// eigenvectors of A^T A give V
+			L ata[6] =
+			{
+				a[0] * a[0] + a[3] * a[3] + a[6] * a[6],
+				a[0] * a[1] + a[3] * a[4] + a[6] * a[7],
+				a[1] * a[1] + a[4] * a[4] + a[7] * a[7],
+				a[0] * a[2] + a[3] * a[5] + a[6] * a[8],
+				a[1] * a[2] + a[4] * a[5] + a[7] * a[8],
+				a[2] * a[2] + a[5] * a[5] + a[8] * a[8]
+			};
+
+			L q[4] = { zero, zero, zero, one };
+
+			for (int sweep = 0; sweep < sweeps; ++sweep)
+			{
+				svd3_jacobi_conjugation(0, 1, 2, ata, q);
+				svd3_jacobi_conjugation(1, 2, 0, ata, q);
+				svd3_jacobi_conjugation(2, 0, 1, ata, q);
+			}
+
+			L n = lane_rsqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+			for (int i = 0; i < 4; ++i)
+				q[i] = q[i] * n;
+
+			L xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+			L xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+			L wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+			v[0] = one - two * (yy + zz);
+			v[1] = two * (xy - wz);
+			v[2] = two * (xz + wy);
+			v[3] = two * (xy + wz);
+			v[4] = one - two * (xx + zz);
+			v[5] = two * (yz - wx);
+			v[6] = two * (xz - wy);
+			v[7] = two * (yz + wx);
+			v[8] = one - two * (xx + yy);
+
+			// B = A V, its columns are ordered by decreasing length
+			L b[9];
+
+			for (int row = 0; row < 3; ++row)
+				for (int col = 0; col < 3; ++col)
+					b[row * 3 + col] = a[row * 3] * v[col] + a[row * 3 + 1] * v[3 + col] + a[row * 3 + 2] * v[6 + col];
+
+			L rho[3];
+
+			for (int col = 0; col < 3; ++col)
+				rho[col] = b[col] * b[col] + b[3 + col] * b[3 + col] + b[6 + col] * b[6 + col];
+
+			static const int pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+			for (const auto& pair : pairs)
+			{
+				auto c = rho[pair[0]] < rho[pair[1]];
+
+				for (int row = 0; row < 3; ++row)
+				{
+					svd3_cond_neg_swap(c, b[row * 3 + pair[0]], b[row * 3 + pair[1]]);
+					svd3_cond_neg_swap(c, v[row * 3 + pair[0]], v[row * 3 + pair[1]]);
+				}
+
+				L t = rho[pair[0]];
+				rho[pair[0]] = lane_select(c, rho[pair[1]], rho[pair[0]]);
+				rho[pair[1]] = lane_select(c, t, rho[pair[1]]);
+			}
+
+			// QR of B by three Givens rotations, U = Q and R is diagonal up to round off
+			L ch1, sh1, ch2, sh2, ch3, sh3;
+			L r[9];
+
+			svd3_qr_givens(b[0], b[3], ch1, sh1);
+			L ca = one - two * sh1 * sh1;
+			L cb = two * ch1 * sh1;
+
+			for (int col = 0; col < 3; ++col)
+			{
+				r[col] = ca * b[col] + cb * b[3 + col];
+				r[3 + col] = -cb * b[col] + ca * b[3 + col];
+				r[6 + col] = b[6 + col];
+			}
+
+			svd3_qr_givens(r[0], r[6], ch2, sh2);
+			ca = one - two * sh2 * sh2;
+			cb = two * ch2 * sh2;
+
+			for (int col = 0; col < 3; ++col)
+			{
+				b[col] = ca * r[col] + cb * r[6 + col];
+				b[3 + col] = r[3 + col];
+				b[6 + col] = -cb * r[col] + ca * r[6 + col];
+			}
+
+			svd3_qr_givens(b[4], b[7], ch3, sh3);
+			ca = one - two * sh3 * sh3;
+			cb = two * ch3 * sh3;
+
+			s[0] = b[0] * scale;
+			s[1] = (ca * b[4] + cb * b[7]) * scale;
+			s[2] = (-cb * b[5] + ca * b[8]) * scale;
+
+			L sh12 = sh1 * sh1;
+			L sh22 = sh2 * sh2;
+			L sh32 = sh3 * sh3;
+			L four(static_cast<S>(4));
+			L eight(static_cast<S>(8));
+
+			u[0] = (two * sh12 - one) * (two * sh22 - one);
+			u[1] = four * ch2 * ch3 * (two * sh12 - one) * sh2 * sh3 + two * ch1 * sh1 * (two * sh32 - one);
+			u[2] = four * ch1 * ch3 * sh1 * sh3 - two * ch2 * (two * sh12 - one) * sh2 * (two * sh32 - one);
+			u[3] = two * ch1 * sh1 * (one - two * sh22);
+			u[4] = -eight * ch1 * ch2 * ch3 * sh1 * sh2 * sh3 + (two * sh12 - one) * (two * sh32 - one);
+			u[5] = -two * ch3 * sh3 + four * sh1 * (ch3 * sh1 * sh3 + ch1 * ch2 * sh2 * (two * sh32 - one));
+			u[6] = two * ch2 * sh2;
+			u[7] = two * ch3 * (one - two * sh22) * sh3;
+			u[8] = (two * sh22 - one) * (two * sh32 - one);
+
+			// Columns were ordered by length before the QR, which for a nearly singular A need not leave the two
+			// smallest values in order. Swap them by magnitude, negating a moved column of U and V to keep both
+			// rotations, then move a negative sign from the middle value onto the last one.
+			auto c = lane_abs(s[1]) < lane_abs(s[2]);
+			L t = s[1];
+
+			s[1] = lane_select(c, s[2], s[1]);
+			s[2] = lane_select(c, t, s[2]);
+
+			for (int row = 0; row < 3; ++row)
+			{
+				svd3_cond_neg_swap(c, u[row * 3 + 1], u[row * 3 + 2]);
+				svd3_cond_neg_swap(c, v[row * 3 + 1], v[row * 3 + 2]);
+			}
+
+			auto negative = s[1] < zero;
+
+			s[1] = lane_select(negative, -s[1], s[1]);
+			s[2] = lane_select(negative, -s[2], s[2]);
+
+			for (int row = 0; row < 3; ++row)
+			{
+				u[row * 3 + 1] = lane_select(negative, -u[row * 3 + 1], u[row * 3 + 1]);
+				u[row * 3 + 2] = lane_select(negative, -u[row * 3 + 2], u[row * 3 + 2]);
+			}
+		}
+
+		template <typename T>
+		inline void svd3_range(const mat3<T>* matrices, const size_t& begin, const size_t& end, svd3<T>* out)
+		{
+			for (size_t i = begin; i < end; ++i)
+				out[i] = svd3<T>(matrices[i]);
+		}
+
+#ifdef _REACT_SIMD_AVX2
+		inline void svd3_range(const mat3<float>* matrices, const size_t& begin, const size_t& end, svd3<float>* out)
+		{
+			flush_denormals ftz;
+
+			size_t i = begin;
+
+			for (; i + 8 <= end; i += 8)
+			{
+				alignas(32) float lanes[9][8];
+
+				for (int k = 0; k < 8; ++k)
+					for (int row = 0; row < 3; ++row)
+						for (int col = 0; col < 3; ++col)
+							lanes[row * 3 + col][k] = matrices[i + k].at(row, col);
+
+				float8 a[9], u[9], s[3], v[9];
+
+				for (int e = 0; e < 9; ++e)
+					a[e] = float8(_mm256_load_ps(lanes[e]));
+
+				svd3_kernel(a, svd3<float>::SWEEPS, u, s, v);
+
+				alignas(32) float ru[9][8], rs[3][8], rv[9][8];
+
+				for (int e = 0; e < 9; ++e)
+				{
+					_mm256_store_ps(ru[e], u[e].v);
+					_mm256_store_ps(rv[e], v[e].v);
+				}
+
+				for (int e = 0; e < 3; ++e)
+					_mm256_store_ps(rs[e], s[e].v);
+
+				for (int k = 0; k < 8; ++k)
+				{
+					svd3<float>& o = out[i + k];
+
+					for (int row = 0; row < 3; ++row)
+					{
+						for (int col = 0; col < 3; ++col)
+						{
+							o.u.at(row, col) = ru[row * 3 + col][k];
+							o.v.at(row, col) = rv[row * 3 + col][k];
+						}
+
+						o.values.m_data[row] = rs[row][k];
+					}
+				}
+			}
+
+			for (; i < end; ++i)
+				out[i] = svd3<float>(matrices[i]);
+		}
+#endif
+	}
+
+	template <size_t M, size_t N, typename T>
+	svd<M, N, T>::svd(const support::matrix<M, N, T>& a)
+	{
+		// work on A, or on A^T when it is wide, so there are never more columns than rows
+		const bool tall = ROWS >= COLS;
+		const size_t rows = tall ? ROWS : COLS;
+		const size_t cols = RANK;
+
+		T work[ROWS * COLS];
+		T w[RANK * RANK] = {};
+
+		for (size_t i = 0; i < RANK; ++i)
+			w[i + i * RANK] = 1;
+
+		for (size_t row = 0; row < ROWS; ++row)
+			for (size_t col = 0; col < COLS; ++col)
+				work[tall ? row + col * rows : col + row * rows] = a.at(row, col);
+
+		support::one_sided_jacobi(work, rows, cols, w, MAX_SWEEPS);
+
+		T lengths[RANK];
+		size_t order[RANK];
+
+		for (size_t j = 0; j < RANK; ++j)
+		{
+			T length = 0;
+
+			for (size_t i = 0; i < rows; ++i)
+				length += work[i + j * rows] * work[i + j * rows];
+
+			lengths[j] = sqrt(length);
+			order[j] = j;
+		}
+
+		std::sort(order, order + RANK, [&](const size_t& i, const size_t& j) { return lengths[i] > lengths[j]; });
+
+		for (size_t j = 0; j < RANK; ++j)
+			values.m_data[j] = lengths[order[j]];
+
+		// the orthogonalized columns give the singular vectors on the long side, the rotations those on the short side
+		T tiny = values.m_data[0] * std::numeric_limits<T>::epsilon() * static_cast<T>(rows);
+		T vectors[ROWS * COLS];
+
+		support::orthonormal_columns(work, rows, cols, order, lengths, tiny, vectors);
+
+		support::matrix<RANK, RANK, T> rotations;
+
+		for (size_t j = 0; j < RANK; ++j)
+			for (size_t i = 0; i < RANK; ++i)
+				rotations.at(i, j) = w[i + order[j] * RANK];
+
+		if (tall)
+		{
+			u.set(vectors, ROWS * RANK);
+			v = support::matrix<RANK, COLS, T>(rotations);
+		}
+		else
+		{
+			u = support::matrix<RANK, ROWS, T>(rotations);
+			v.set(vectors, COLS * RANK);
+		}
+	}
+
+	template <size_t M, size_t N, typename T>
+	const support::matrix<M, N, T> svd<M, N, T>::reconstruct() const
+	{
+		support::matrix<M, N, T> tmp(static_cast<T>(0));
+
+		for (size_t row = 0; row < ROWS; ++row)
+			for (size_t col = 0; col < COLS; ++col)
+				for (size_t k = 0; k < RANK; ++k)
+					tmp.at(row, col) += u.at(row, k) * values.m_data[k] * v.at(col, k);
+
+		return tmp;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const size_t svd<M, N, T>::rank(const T& tolerance) const
+	{
+		size_t count = 0;
+
+		while (count < RANK && values.m_data[count] > tolerance * values.m_data[0])
+			++count;
+
+		return count;
+	}
+
+	template <size_t M, size_t N, typename T>
+	const T svd<M, N, T>::condition() const
+	{
+		if (values.m_data[RANK - 1] <= 0)
+			return std::numeric_limits<T>::infinity();
+
+		return values.m_data[0] / values.m_data[RANK - 1];
+	}
+
+	template <typename T>
+	svd3<T>::svd3(const mat3<T>& a)
+	{
+		T in[9], ru[9], rs[3], rv[9];
+
+		support::flush_denormals ftz;
+
+		for (int row = 0; row < 3; ++row)
+			for (int col = 0; col < 3; ++col)
+				in[row * 3 + col] = a.at(row, col);
+
+		support::svd3_kernel(in, SWEEPS, ru, rs, rv);
+
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int col = 0; col < 3; ++col)
+			{
+				u.at(row, col) = ru[row * 3 + col];
+				v.at(row, col) = rv[row * 3 + col];
+			}
+
+			values.m_data[row] = rs[row];
+		}
+	}
+
+	template <typename T>
+	const mat3<T> svd3<T>::reconstruct() const
+	{
+		mat3<T> tmp(static_cast<T>(0));
+
+		for (int row = 0; row < 3; ++row)
+			for (int col = 0; col < 3; ++col)
+				for (int k = 0; k < 3; ++k)
+					tmp.at(row, col) += u.at(row, k) * values.m_data[k] * v.at(col, k);
+
+		return tmp;
+	}
+
+	namespace support
+	{
+		// svd3 of matrices[first, first + count) into out[0, count), at most 64 at a time. Strided matrices are gathered
+		// into a packed block first so the SIMD path reads them with plain loads.
+		template <typename T>
+		inline void svd3_block(const mat3<T>* matrices, const size_t& first, const size_t& count, svd3<T>* out)
+		{
+			svd3_range(matrices + first, 0, count, out);
+		}
+
+		template <typename T>
+		inline void svd3_block(const mat_span<3, 3, const T>& matrices, const size_t& first, const size_t& count, svd3<T>* out)
+		{
+			mat3<T> packed[64];
+
+			for (size_t k = 0; k < count; ++k)
+				packed[k] = matrices[first + k];
+
+			svd3_range(packed, 0, count, out);
+		}
+
+		// M is an array of mat3 or a span
+		template <typename T, typename M>
+		void polar3_batch(const M& matrices, const size_t& count, polar3<T>* out, const bool& parallel)
+		{
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				svd3<T> block[64];
+
+				for (size_t i = begin; i < end; i += 64)
+				{
+					size_t n = std::min<size_t>(64, end - i);
+
+					svd3_block(matrices, i, n, block);
+
+					for (size_t k = 0; k < n; ++k)
+						out[i + k] = polar3<T>(block[k]);
+				}
+			};
+
+			if (parallel)
+				parallel_for(count, 1 << 12, kernel);
+			else
+				kernel(0, 0, count);
+		}
+
+		template <typename T, typename M>
+		void polar3_rotations(const M& matrices, const size_t& count, quat<T>* out, const bool& parallel)
+		{
+			auto kernel = [&](size_t, size_t begin, size_t end)
+			{
+				svd3<T> block[64];
+
+				for (size_t i = begin; i < end; i += 64)
+				{
+					size_t n = std::min<size_t>(64, end - i);
+
+					svd3_block(matrices, i, n, block);
+
+					for (size_t k = 0; k < n; ++k)
+					{
+						mat3<T> r(static_cast<T>(0));
+
+						for (int row = 0; row < 3; ++row)
+							for (int col = 0; col < 3; ++col)
+								for (int j = 0; j < 3; ++j)
+									r.at(row, col) += block[k].u.at(row, j) * block[k].v.at(col, j);
+
+						out[i + k] = quat<T>(r).normalized();
+					}
+				}
+			};
+
+			if (parallel)
+				parallel_for(count, 1 << 12, kernel);
+			else
+				kernel(0, 0, count);
+		}
+	}
+
+	template <typename T>
+	void svd3<T>::compute(const mat3<T>* matrices, const size_t& count, svd3<T>* out, const bool& parallel)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			support::svd3_range(matrices, begin, end, out);
+		};
+
+		if (parallel)
+			support::parallel_for(count, 1 << 12, kernel);
+		else
+			kernel(0, 0, count);
+	}
+
+	template <typename T>
+	void svd3<T>::compute(const mat_span<3, 3, const T>& matrices, svd3<T>* out, const bool& parallel)
+	{
+		auto kernel = [&](size_t, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i += 64)
+				support::svd3_block(matrices, i, std::min<size_t>(64, end - i), out + i);
+		};
+
+		if (parallel)
+			support::parallel_for(matrices.size(), 1 << 12, kernel);
+		else
+			kernel(0, 0, matrices.size());
+	}
+
+	template <typename T>
+	polar3<T>::polar3(const mat3<T>& a) : polar3(svd3<T>(a))
+	{
+	}
+
+	template <typename T>
+	polar3<T>::polar3(const svd3<T>& s) : stretch(static_cast<T>(0))
+	{
+		mat3<T> r(static_cast<T>(0));
+
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int col = 0; col < 3; ++col)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					r.at(row, col) += s.u.at(row, k) * s.v.at(col, k);
+					stretch.at(row, col) += s.v.at(row, k) * s.values.m_data[k] * s.v.at(col, k);
+				}
+			}
+		}
+
+		rotation = quat<T>(r).normalized();
+	}
+
+	template <typename T>
+	void polar3<T>::compute(const mat3<T>* matrices, const size_t& count, polar3<T>* out, const bool& parallel)
+	{
+		support::polar3_batch(matrices, count, out, parallel);
+	}
+
+	template <typename T>
+	void polar3<T>::compute(const mat_span<3, 3, const T>& matrices, polar3<T>* out, const bool& parallel)
+	{
+		support::polar3_batch(matrices, matrices.size(), out, parallel);
+	}
+
+	template <typename T>
+	void polar3<T>::rotations(const mat3<T>* matrices, const size_t& count, quat<T>* out, const bool& parallel)
+	{
+		support::polar3_rotations(matrices, count, out, parallel);
+	}
+
+	template <typename T>
+	void polar3<T>::rotations(const mat_span<3, 3, const T>& matrices, quat<T>* out, const bool& parallel)
+	{
+		support::polar3_rotations(matrices, matrices.size(), out, parallel);
+	}
+
+#ifndef _REACT_NO_TYPEDEFS
+	typedef svd3<float> svd3f;
+	typedef svd3<double> svd3d;
+
+	typedef polar3<float> polar3f;
+	typedef polar3<double> polar3d;
+#endif
+}
+
+#endif
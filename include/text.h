@@ -0,0 +1,731 @@
+#ifndef _RM_TEXT_H
+#define _RM_TEXT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "quat.h"
+
+// Scalars go through std::to_chars / std::from_chars when the standard library has them (C++17 and up), which gives
+// the shortest text that reads back to the same value. Under C++14 the same interface falls back to snprintf /
+// strtod, still round-tripping but not always shortest, and slower. Define _REACT_NO_CHARCONV to force the fallback.
+// Either way the text uses '.', whatever LC_NUMERIC the program set: the fallback runs in the "C" locale. Both paths
+// read the same text: decimal numbers and inf / nan spellings, no hex and no sign after the optional '+'.
+#if !defined(_REACT_NO_CHARCONV) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define _REACT_TEXT_CHARCONV
+#endif
+#endif
+#if __has_include(<string_view>)
+#include <string_view>
+#define _REACT_TEXT_STRING_VIEW
+#endif
+#endif
+#endif
+
+#ifndef _REACT_TEXT_CHARCONV
+#include <clocale>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#endif
+
+namespace react
+{
+	// Plain text for vector<S, T>, matrix<M, N, T> and quat<T>: the components separated by a single character,
+	// matrices row by row, quaternions as x y z w. Reading accepts any run of whitespace, ',' or ';' between
+	// components, so the same parser takes whitespace separated logs and CSV.
+	enum class text_status
+	{
+		ok,
+		bad_value,
+		truncated
+	};
+
+	namespace support
+	{
+		// the most characters one scalar can take, sign, digits, point and exponent included
+		template <typename T, bool FLOATING = std::is_floating_point<T>::value>
+		struct text_chars
+		{
+			static const size_t value = std::numeric_limits<T>::max_digits10 + 8;
+		};
+
+		template <typename T>
+		struct text_chars<T, false>
+		{
+			static const size_t value = std::numeric_limits<T>::digits10 + 3;
+		};
+
+		template <typename V>
+		struct text_element;
+
+		template <size_t S, typename T>
+		struct text_element<vector<S, T>>
+		{
+			typedef T component_type;
+			static const size_t COUNT = S;
+
+			static T& component(vector<S, T>& v, const size_t& i)
+			{
+				return v.m_data[i];
+			}
+
+			static const T& component(const vector<S, T>& v, const size_t& i)
+			{
+				return v.m_data[i];
+			}
+		};
+
+		template <typename T>
+		struct text_element<vec2<T>> : text_element<vector<2, T>> {};
+
+		template <typename T>
+		struct text_element<vec3<T>> : text_element<vector<3, T>> {};
+
+		template <typename T>
+		struct text_element<vec4<T>> : text_element<vector<4, T>> {};
+
+		// row by row, the order a matrix is read in, component i is at row i / M, column i % M
+		template <size_t M, size_t N, typename T>
+		struct text_element<matrix<M, N, T>>
+		{
+			typedef T component_type;
+			static const size_t COUNT = M * N;
+
+			static T& component(matrix<M, N, T>& m, const size_t& i)
+			{
+				return m.m_data[(i % M) * N + i / M];
+			}
+
+			static const T& component(const matrix<M, N, T>& m, const size_t& i)
+			{
+				return m.m_data[(i % M) * N + i / M];
+			}
+		};
+
+		template <typename T>
+		struct text_element<quat<T>>
+		{
+			typedef T component_type;
+			static const size_t COUNT = 4;
+
+			static T& component(quat<T>& q, const size_t& i)
+			{
+				return q.m_data[i];
+			}
+
+			static const T& component(const quat<T>& q, const size_t& i)
+			{
+				return q.m_data[i];
+			}
+		};
+
+		inline const bool is_text_separator(const char& c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ';' || c == '\f' || c == '\v';
+		}
+
+#ifndef _REACT_TEXT_CHARCONV
+#if defined(_WIN32)
+		// snprintf and strtod follow the global LC_NUMERIC, which a program may have set to a decimal comma. MSVC has
+		// _l variants that take a locale, created once and kept for the life of the program.
+		inline _locale_t text_c_locale()
+		{
+			static const _locale_t c = _create_locale(LC_NUMERIC, "C");
+
+			return c;
+		}
+
+		inline int text_print(char* buffer, const size_t& size, const float& v, const int& precision)
+		{
+			return _snprintf_l(buffer, size, "%.*g", text_c_locale(), precision, static_cast<double>(v));
+		}
+
+		inline int text_print(char* buffer, const size_t& size, const double& v, const int& precision)
+		{
+			return _snprintf_l(buffer, size, "%.*g", text_c_locale(), precision, v);
+		}
+
+		inline int text_print(char* buffer, const size_t& size, const long double& v, const int& precision)
+		{
+			return _snprintf_l(buffer, size, "%.*Lg", text_c_locale(), precision, v);
+		}
+
+		inline void text_scan(const char* text, char** end, float& v)
+		{
+			v = _strtof_l(text, end, text_c_locale());
+		}
+
+		inline void text_scan(const char* text, char** end, double& v)
+		{
+			v = _strtod_l(text, end, text_c_locale());
+		}
+
+		inline void text_scan(const char* text, char** end, long double& v)
+		{
+			v = _strtold_l(text, end, text_c_locale());
+		}
+#else
+		// snprintf and strtod follow the LC_NUMERIC of the thread, which a program may have set to a decimal comma.
+		// POSIX has no portable _l variants of them, so the thread is switched to a "C" locale, created once and kept
+		// for the life of the program, for the length of each call.
+		class text_c_locale
+		{
+		public:
+			text_c_locale() : m_previous(uselocale(c_locale())) {}
+			~text_c_locale() { uselocale(m_previous); }
+
+			text_c_locale(const text_c_locale&) = delete;
+			text_c_locale& operator=(const text_c_locale&) = delete;
+
+		private:
+			static locale_t c_locale()
+			{
+				static const locale_t c = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+
+				return c;
+			}
+
+			locale_t m_previous;
+		};
+
+		inline int text_print(char* buffer, const size_t& size, const float& v, const int& precision)
+		{
+			text_c_locale c;
+
+			return std::snprintf(buffer, size, "%.*g", precision, static_cast<double>(v));
+		}
+
+		inline int text_print(char* buffer, const size_t& size, const double& v, const int& precision)
+		{
+			text_c_locale c;
+
+			return std::snprintf(buffer, size, "%.*g", precision, v);
+		}
+
+		inline int text_print(char* buffer, const size_t& size, const long double& v, const int& precision)
+		{
+			text_c_locale c;
+
+			return std::snprintf(buffer, size, "%.*Lg", precision, v);
+		}
+
+		inline void text_scan(const char* text, char** end, float& v)
+		{
+			text_c_locale c;
+
+			v = std::strtof(text, end);
+		}
+
+		inline void text_scan(const char* text, char** end, double& v)
+		{
+			text_c_locale c;
+
+			v = std::strtod(text, end);
+		}
+
+		inline void text_scan(const char* text, char** end, long double& v)
+		{
+			text_c_locale c;
+
+			v = std::strtold(text, end);
+		}
+#endif
+#endif
+
+		// Writes v at out, which must have room for text_chars<T>::value characters, and returns the end
+		template <typename T>
+		inline char* format_scalar(char* out, const T& v, std::true_type)
+		{
+#ifdef _REACT_TEXT_CHARCONV
+			return std::to_chars(out, out + text_chars<T>::value, v).ptr;
+#else
+			// values that fit in digits10 come out short ("0.1"), everything else takes max_digits10, which always
+			// reads back but is not always the shortest text that would
+			char buffer[64];
+			int n = text_print(buffer, sizeof(buffer), v, std::numeric_limits<T>::digits10);
+
+			T back;
+			text_scan(buffer, nullptr, back);
+
+			if (back != v && v == v)
+				n = text_print(buffer, sizeof(buffer), v, std::numeric_limits<T>::max_digits10);
+
+			std::memcpy(out, buffer, n);
+
+			return out + n;
+#endif
+		}
+
+		template <typename T>
+		inline char* format_scalar(char* out, const T& v, std::false_type)
+		{
+#ifdef _REACT_TEXT_CHARCONV
+			return std::to_chars(out, out + text_chars<T>::value, v).ptr;
+#else
+			typedef typename std::make_unsigned<T>::type U;
+
+			char buffer[32];
+			char* p = buffer + sizeof(buffer);
+			U u = static_cast<U>(v);
+
+			if (v < 0)
+				u = static_cast<U>(U(0) - u);
+
+			do
+			{
+				*--p = static_cast<char>('0' + u % 10);
+				u /= 10;
+			} while (u);
+
+			if (v < 0)
+				*--p = '-';
+
+			size_t n = buffer + sizeof(buffer) - p;
+			std::memcpy(out, p, n);
+
+			return out + n;
+#endif
+		}
+
+		template <typename T>
+		inline char* format_scalar(char* out, const T& v)
+		{
+			return format_scalar(out, v, std::is_floating_point<T>());
+		}
+
+		// Reads one scalar from the start of [first, last), returning the end of it or nullptr if there is no valid
+		// number there. A leading '+' is accepted, but not followed by another sign.
+		template <typename T>
+		inline const char* parse_scalar(const char* first, const char* last, T& v, std::true_type)
+		{
+#ifdef _REACT_TEXT_CHARCONV
+			std::from_chars_result r = std::from_chars(first, last, v);
+
+			return r.ec == std::errc() ? r.ptr : nullptr;
+#else
+			// strtod needs a terminated string and the text may run straight into the next value, copy the token,
+			// to the heap when it is too long for the stack buffer so no digits are dropped
+			char local[64];
+			std::string heap;
+			size_t n = 0;
+
+			while (first + n != last && !is_text_separator(first[n]) && first[n] != '#')
+				++n;
+
+			char* buffer = local;
+
+			if (n + 1 > sizeof(local))
+			{
+				heap.resize(n + 1);
+				buffer = &heap[0];
+			}
+
+			std::memcpy(buffer, first, n);
+			buffer[n] = '\0';
+
+			// strtod also takes a second sign and hex, from_chars does not: refuse the sign and end hex text after its
+			// leading 0 as from_chars does. Leading whitespace never gets here, it is all separators.
+			if (buffer[0] == '+')
+				return nullptr;
+
+			size_t digits = buffer[0] == '-' ? 1 : 0;
+
+			if (buffer[digits] == '0' && (buffer[digits + 1] == 'x' || buffer[digits + 1] == 'X'))
+				buffer[digits + 1] = '\0';
+
+			char* end = buffer;
+			errno = 0;
+			text_scan(buffer, &end, v);
+
+			// overflow and underflow to zero are errors as with from_chars, subnormal results are kept
+			if (end == buffer || (errno == ERANGE && (std::isinf(v) || v == 0)))
+				return nullptr;
+
+			return first + (end - buffer);
+#endif
+		}
+
+		template <typename T>
+		inline const char* parse_scalar(const char* first, const char* last, T& v, std::false_type)
+		{
+#ifdef _REACT_TEXT_CHARCONV
+			std::from_chars_result r = std::from_chars(first, last, v);
+
+			return r.ec == std::errc() ? r.ptr : nullptr;
+#else
+			typedef typename std::make_unsigned<T>::type U;
+
+			const char* p = first;
+			bool negative = false;
+
+			if (p != last && *p == '-' && std::is_signed<T>::value)
+			{
+				negative = true;
+				++p;
+			}
+
+			const U limit = negative ? static_cast<U>(U(0) - static_cast<U>(std::numeric_limits<T>::min())) : static_cast<U>(std::numeric_limits<T>::max());
+			const char* digits = p;
+			U u = 0;
+
+			for (; p != last && *p >= '0' && *p <= '9'; ++p)
+			{
+				U d = static_cast<U>(*p - '0');
+
+				if (u > (limit - d) / 10)
+					return nullptr;
+
+				u = static_cast<U>(u * 10 + d);
+			}
+
+			if (p == digits)
+				return nullptr;
+
+			v = negative ? static_cast<T>(U(0) - u) : static_cast<T>(u);
+
+			return p;
+#endif
+		}
+
+		template <typename T>
+		inline const char* parse_scalar(const char* first, const char* last, T& v)
+		{
+			if (first != last && *first == '+' && ++first != last && *first == '-')
+				return nullptr;
+
+			return parse_scalar(first, last, v, std::is_floating_point<T>());
+		}
+
+		inline const char* skip_text_separators(const char* first, const char* last)
+		{
+			while (first != last && is_text_separator(*first))
+				++first;
+
+			return first;
+		}
+	}
+
+	// The most characters format_to writes for one V, so an array of n fits in n * text_capacity<V>::value
+	template <typename V>
+	struct text_capacity
+	{
+		static const size_t value = support::text_element<V>::COUNT * (support::text_chars<typename support::text_element<V>::component_type>::value + 1);
+	};
+
+	// Writes v at out without bounds checks and returns the end, no terminator is written
+	template <typename V>
+	inline char* format_to(char* out, const V& v, const char& separator = ' ')
+	{
+		typedef support::text_element<V> element;
+
+		for (size_t i = 0; i < element::COUNT; ++i)
+		{
+			if (i)
+				*out++ = separator;
+
+			out = support::format_scalar(out, element::component(v, i));
+		}
+
+		return out;
+	}
+
+	// One element per line into a buffer of at least count * text_capacity<V>::value characters. 'data' is a
+	// pointer or a span.
+	template <typename P>
+	inline char* format_array(char* out, const P& data, const size_t& count, const char& separator = ' ', const char& terminator = '\n')
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			out = format_to(out, data[i], separator);
+			*out++ = terminator;
+		}
+
+		return out;
+	}
+
+	// Reads the components of v from the start of [first, last), skipping separators before each. Returns the end of
+	// the last component, or nullptr if the text runs out or a component is not a number.
+	template <typename V>
+	inline const char* parse(const char* first, const char* last, V& v)
+	{
+		typedef support::text_element<V> element;
+
+		for (size_t i = 0; i < element::COUNT; ++i)
+		{
+			first = support::skip_text_separators(first, last);
+			first = support::parse_scalar(first, last, element::component(v, i));
+
+			if (!first)
+				return nullptr;
+		}
+
+		return first;
+	}
+
+	// The whole of 'text' is one V, nothing but separators may follow it
+#ifdef _REACT_TEXT_STRING_VIEW
+	template <typename V>
+	inline const bool parse(std::string_view text, V& v)
+#else
+	template <typename V>
+	inline const bool parse(const std::string& text, V& v)
+#endif
+	{
+		const char* last = text.data() + text.size();
+		const char* end = parse(text.data(), last, v);
+
+		return end && support::skip_text_separators(end, last) == last;
+	}
+
+	// Streams an array of V out of text, in memory or from a std::istream read through a fixed buffer. Lines starting
+	// with '#' are skipped, and elements do not need to be one to a line.
+	template <typename V>
+	class text_reader
+	{
+	public:
+		typedef typename support::text_element<V>::component_type component_type;
+
+		// constructors
+		explicit text_reader(std::istream& in, const size_t& buffer_size = 1 << 16);
+		text_reader(const char* first, const char* last);
+
+		text_reader(const text_reader&) = delete;
+		text_reader& operator=(const text_reader&) = delete;
+
+		// Modifiers
+		inline const size_t read(V* out, const size_t& count);
+		inline const bool skip_line();
+
+		// Accessors
+		inline const text_status status() const
+		{
+			return m_status;
+		}
+
+		// the line the reader is on, from 1
+		inline const size_t line() const
+		{
+			return m_line;
+		}
+
+	private:
+		// the smallest buffer holds 4 tokens this long, it grows for anything longer
+		static const size_t TOKEN = 64;
+
+		inline void fill();
+		inline const bool next();
+
+		std::istream* m_in;
+		std::vector<char> m_buffer;
+		const char* m_pos;
+		const char* m_end;
+		size_t m_line;
+		text_status m_status;
+	};
+
+	template <typename V>
+	text_reader<V>::text_reader(std::istream& in, const size_t& buffer_size)
+		: m_in(&in), m_buffer(std::max<size_t>(buffer_size, 4 * TOKEN)), m_pos(m_buffer.data()), m_end(m_buffer.data()), m_line(1), m_status(text_status::ok)
+	{
+	}
+
+	template <typename V>
+	text_reader<V>::text_reader(const char* first, const char* last)
+		: m_in(nullptr), m_pos(first), m_end(last), m_line(1), m_status(text_status::ok)
+	{
+	}
+
+	template <typename V>
+	inline void text_reader<V>::fill()
+	{
+		if (!m_in || !*m_in)
+			return;
+
+		// keep the unread tail, then top the buffer up behind it
+		size_t tail = m_end - m_pos;
+		std::memmove(m_buffer.data(), m_pos, tail);
+
+		m_in->read(m_buffer.data() + tail, m_buffer.size() - tail);
+
+		m_pos = m_buffer.data();
+		m_end = m_pos + tail + static_cast<size_t>(m_in->gcount());
+	}
+
+	// Moves past separators and comments to the next token, false at the end of the text
+	template <typename V>
+	inline const bool text_reader<V>::next()
+	{
+		for (;;)
+		{
+			while (m_pos != m_end && support::is_text_separator(*m_pos))
+			{
+				if (*m_pos == '\n')
+					++m_line;
+
+				++m_pos;
+			}
+
+			if (m_pos == m_end)
+			{
+				fill();
+
+				if (m_pos == m_end)
+					return false;
+
+				continue;
+			}
+
+			if (*m_pos != '#')
+				break;
+
+			if (!skip_line())
+				return false;
+		}
+
+		// the token has to be whole in the buffer, a number cut off at m_end would read as two
+		size_t scanned = 0;
+
+		for (;;)
+		{
+			const char* p = m_pos + scanned;
+
+			while (p != m_end && !support::is_text_separator(*p) && *p != '#')
+				++p;
+
+			if (p != m_end || !m_in || !*m_in)
+				break;
+
+			scanned = p - m_pos;
+
+			if (m_pos == m_buffer.data() && m_end == m_buffer.data() + m_buffer.size())
+			{
+				m_buffer.resize(2 * m_buffer.size());
+				m_pos = m_buffer.data();
+				m_end = m_pos + scanned;
+			}
+
+			fill();
+		}
+
+		return true;
+	}
+
+	template <typename V>
+	inline const bool text_reader<V>::skip_line()
+	{
+		for (;;)
+		{
+			const char* newline = static_cast<const char*>(std::memchr(m_pos, '\n', m_end - m_pos));
+
+			if (newline)
+			{
+				m_pos = newline + 1;
+				++m_line;
+
+				return true;
+			}
+
+			m_pos = m_end;
+			fill();
+
+			if (m_pos == m_end)
+				return false;
+		}
+	}
+
+	template <typename V>
+	inline const size_t text_reader<V>::read(V* out, const size_t& count)
+	{
+		typedef support::text_element<V> element;
+
+		size_t n = 0;
+
+		for (; n < count && m_status == text_status::ok; ++n)
+		{
+			for (size_t i = 0; i < element::COUNT; ++i)
+			{
+				if (!next())
+				{
+					if (i)
+						m_status = text_status::truncated;
+
+					return n;
+				}
+
+				const char* end = support::parse_scalar(m_pos, m_end, element::component(out[n], i));
+
+				// a number has to end at a separator, "1.5x" is not 1.5
+				if (!end || (end != m_end && !support::is_text_separator(*end) && *end != '#'))
+				{
+					m_status = text_status::bad_value;
+
+					return n;
+				}
+
+				m_pos = end;
+			}
+		}
+
+		return n;
+	}
+
+	// Reads every element of 'in' onto the end of 'out'
+	template <typename V>
+	inline text_status read_text(std::istream& in, std::vector<V>& out)
+	{
+		text_reader<V> reader(in);
+		V chunk[256];
+
+		while (size_t n = reader.read(chunk, 256))
+			out.insert(out.end(), chunk, chunk + n);
+
+		return reader.status();
+	}
+
+	// Writes one element per line to 'out' through a fixed buffer. 'data' is a pointer or a span.
+	template <typename P>
+	inline const bool write_text(std::ostream& out, const P& data, const size_t& count, const char& separator = ' ')
+	{
+		typedef typename std::decay<decltype(data[0])>::type V;
+
+		const size_t capacity = text_capacity<V>::value;
+		std::vector<char> buffer(std::max<size_t>(1 << 16, capacity + 1));
+		char* end = buffer.data();
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (static_cast<size_t>(buffer.data() + buffer.size() - end) < capacity + 1)
+			{
+				out.write(buffer.data(), end - buffer.data());
+				end = buffer.data();
+			}
+
+			end = format_to(end, data[i], separator);
+			*end++ = '\n';
+		}
+
+		out.write(buffer.data(), end - buffer.data());
+
+		return static_cast<bool>(out);
+	}
+}
+
+#endif
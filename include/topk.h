@@ -0,0 +1,390 @@
+#ifndef _RM_TOPK_H
+#define _RM_TOPK_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "span.h"
+#include "support/vector.h"
+#include "support/parallel.h"
+#include "support/simd.h"
+
+namespace react
+{
+	// Brute force top k over arrays of support::vector<S, T>, by largest dot product or smallest squared distance.
+	//
+	// The database is cut into blocks of about TOPK_BLOCK_BYTES, which stay in L2 while every query is scored
+	// against them, three queries by four database vectors at a time so each register load feeds several sums. Each
+	// pair has its own register of running sums, so its score does not depend on the tile it lands in, and may
+	// differ from vector::dot in the last bits. Ties go to the lower index, which with the fixed scores makes the
+	// results the same whatever the thread count. A NaN score, a dot product of -inf or an infinite distance is
+	// never selected. Integer vectors work too, their scores exact as long as they do not overflow T.
+	//
+	// 'parallel' splits the database over threads. Each thread keeps up to 2k candidates per query, so memory is
+	// threads x queries x 2k x 8 bytes, and the threads' lists are merged at the end.
+	const uint32_t TOPK_EMPTY = 0xffffffffu;
+	const size_t TOPK_BLOCK_BYTES = 1 << 17;
+
+	namespace support
+	{
+		// float in the widest lanes the target has, everything else scalar
+		template <typename T>
+		struct topk_lanes
+		{
+			typedef T type;
+		};
+
+#if defined(_REACT_SIMD_AVX2)
+		template <>
+		struct topk_lanes<float>
+		{
+			typedef float8 type;
+		};
+#elif defined(_REACT_SIMD_SSE2)
+		template <>
+		struct topk_lanes<float>
+		{
+			typedef float4 type;
+		};
+#endif
+
+		// below every key that can be selected, -inf where T has it and its lowest value otherwise
+		template <typename T>
+		inline const T topk_floor()
+		{
+			return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+		}
+
+		// The k largest keys pushed, ties going to the lower index. Candidates that beat the current k-th best collect
+		// unsorted and are cut back to k with nth_element once 2k have built up, so a push is a compare and a store
+		// and there is no heap to keep in order. Pushes must come in increasing index order, or as another
+		// selection's finished list of later indices, for a key equal to the k-th best to be dropped safely.
+		template <typename T>
+		class topk_selection
+		{
+		public:
+			struct entry
+			{
+				T key;
+				uint32_t index;
+			};
+
+			// Modifiers
+			void reset(const size_t& k)
+			{
+				m_k = k;
+				m_size = 0;
+				m_threshold = topk_floor<T>();
+				m_entries.resize(2 * k);
+			}
+
+			inline void push(const T& key, const uint32_t& index)
+			{
+				if (!(key > m_threshold))
+					return;
+
+				m_entries[m_size].key = key;
+				m_entries[m_size].index = index;
+
+				if (++m_size == m_entries.size())
+					cut();
+			}
+
+			// keys[j] for index first + j, a group of 8 at a time skipped when none of it beats the k-th best
+			inline void push(const T* keys, const size_t& count, const uint32_t& first)
+			{
+				const size_t groups = count / 8;
+
+				for (size_t g = 0; g < groups; ++g)
+				{
+					const T* key = keys + g * 8;
+					bool any = false;
+
+					for (size_t j = 0; j < 8; ++j)
+						any |= key[j] > m_threshold;
+
+					if (any)
+						for (size_t j = 0; j < 8; ++j)
+							push(key[j], first + static_cast<uint32_t>(g * 8 + j));
+				}
+
+				for (size_t j = groups * 8; j < count; ++j)
+					push(keys[j], first + static_cast<uint32_t>(j));
+			}
+
+			// sorts the best k first
+			void finish()
+			{
+				if (m_size > m_k)
+					cut();
+
+				std::sort(m_entries.begin(), m_entries.begin() + m_size, better);
+			}
+
+			// Accessors
+			inline const size_t& size() const { return m_size; }
+			inline const entry& operator[](const size_t& i) const { return m_entries[i]; }
+
+		private:
+			static bool better(const entry& a, const entry& b)
+			{
+				return a.key > b.key || (a.key == b.key && a.index < b.index);
+			}
+
+			void cut()
+			{
+				std::nth_element(m_entries.begin(), m_entries.begin() + (m_k - 1), m_entries.begin() + m_size, better);
+
+				m_size = m_k;
+				m_threshold = m_entries[m_k - 1].key;
+			}
+
+			size_t m_k;
+			size_t m_size;
+			T m_threshold;
+			std::vector<entry> m_entries;
+		};
+
+		// each register's lanes summed, four at once with lane_sum4 where the tile is four wide
+		template <typename L, typename T, size_t D>
+		inline void topk_lane_sums(const L (&sums)[D], T* totals)
+		{
+			for (size_t j = 0; j < D; ++j)
+				totals[j] = lane_sum(sums[j]);
+		}
+
+		template <typename L, typename T>
+		inline void topk_lane_sums(const L (&sums)[4], T* totals)
+		{
+			lane_sum4(sums[0], sums[1], sums[2], sums[3], totals);
+		}
+
+		// Q queries against D database vectors, sign * the sum of term over each pair into keys[q * ld + j]. A
+		// register of running sums per pair, the lanes summed as lane_sum does and the last S % W components after.
+		template <typename L, size_t Q, size_t D, size_t S, typename T, typename F>
+		inline void topk_tile(const vector<S, T>* queries, const vector<S, T>* db, const F& term, const T& sign, T* keys, const size_t& ld)
+		{
+			const size_t W = lane_traits<L>::WIDTH;
+			const size_t LANES = S / W * W;
+
+			L sums[Q][D];
+
+			for (size_t q = 0; q < Q; ++q)
+				for (size_t j = 0; j < D; ++j)
+					sums[q][j] = L(T(0));
+
+			for (size_t i = 0; i < LANES; i += W)
+			{
+				L y[D];
+
+				for (size_t j = 0; j < D; ++j)
+					lane_load(y[j], db[j].m_data + i);
+
+				for (size_t q = 0; q < Q; ++q)
+				{
+					L x;
+					lane_load(x, queries[q].m_data + i);
+
+					for (size_t j = 0; j < D; ++j)
+						sums[q][j] = term(x, y[j], sums[q][j]);
+				}
+			}
+
+			for (size_t q = 0; q < Q; ++q)
+			{
+				T totals[D];
+				topk_lane_sums(sums[q], totals);
+
+				for (size_t j = 0; j < D; ++j)
+				{
+					T total = totals[j];
+
+					for (size_t i = LANES; i < S; ++i)
+						total = term(queries[q].m_data[i], db[j].m_data[i], total);
+
+					keys[q * ld + j] = sign * total;
+				}
+			}
+		}
+
+		// Q queries against 'rows' database vectors, D at a time and the rest one by one
+		template <typename L, size_t Q, size_t D, size_t S, typename T, typename F>
+		inline void topk_block(const vector<S, T>* queries, const vector<S, T>* db, const size_t& rows, const F& term, const T& sign, T* keys, const size_t& ld)
+		{
+			const size_t tiles = rows / D;
+
+			for (size_t t = 0; t < tiles; ++t)
+				topk_tile<L, Q, D>(queries, db + t * D, term, sign, keys + t * D, ld);
+
+			for (size_t j = tiles * D; j < rows; ++j)
+				topk_tile<L, Q, 1>(queries, db + j, term, sign, keys + j, ld);
+		}
+
+		// k best per query by sign * the sum of term, into k slots per query with unused ones TOPK_EMPTY and, for
+		// floating point, a NaN score. Strided spans are gathered into packed copies, the queries once and the
+		// database a block at a time, so the tiles always read consecutive vectors.
+		template <size_t S, typename T, typename F>
+		void topk_search(const vec_span<S, const T>& query_span, const vec_span<S, const T>& db_span, const size_t& k, const F& term, const T& sign, uint32_t* indices, T* scores, const bool& parallel)
+		{
+			static_assert(std::is_signed<T>::value, "topk needs a signed type to negate distances");
+
+			const size_t count = query_span.size();
+			const size_t n = db_span.size();
+			const bool packed_db = db_span.stride() == sizeof(vector<S, T>);
+
+			std::vector<vector<S, T>> query_copy;
+			const vector<S, T>* queries = count ? &query_span[0] : nullptr;
+			const vector<S, T>* db = packed_db && n ? &db_span[0] : nullptr;
+
+			if (query_span.stride() != sizeof(vector<S, T>))
+			{
+				query_copy.assign(count, vector<S, T>());
+
+				for (size_t q = 0; q < count; ++q)
+					query_copy[q] = query_span[q];
+
+				queries = query_copy.data();
+			}
+
+			typedef typename topk_lanes<T>::type L;
+
+			// queries by database vectors, twelve registers of sums and the loads within the 16 AVX2 has
+			const size_t TILE_QUERIES = 3;
+			const size_t TILE_ROWS = 4;
+
+			assert(n < TOPK_EMPTY);
+
+			if (k == 0 || count == 0)
+				return;
+
+			const size_t rows = std::max<size_t>(64, TOPK_BLOCK_BYTES / sizeof(vector<S, T>));
+			const size_t chunks = parallel ? parallel_chunks(n, rows) : 1;
+
+			std::vector<std::vector<topk_selection<T>>> selections(chunks, std::vector<topk_selection<T>>(count));
+
+			auto kernel = [&](size_t chunk, size_t begin, size_t end)
+			{
+				std::vector<topk_selection<T>>& selection = selections[chunk];
+				std::vector<T> keys(TILE_QUERIES * rows);
+				std::vector<vector<S, T>> db_copy(packed_db ? 0 : rows);
+
+				for (topk_selection<T>& s : selection)
+					s.reset(k);
+
+				for (size_t block = begin; block < end; block += rows)
+				{
+					const size_t m = std::min(rows, end - block);
+					const size_t groups = count / TILE_QUERIES;
+					const vector<S, T>* rows_in = db + block;
+
+					if (!packed_db)
+					{
+						for (size_t j = 0; j < m; ++j)
+							db_copy[j] = db_span[block + j];
+
+						rows_in = db_copy.data();
+					}
+
+					for (size_t g = 0; g < groups; ++g)
+					{
+						topk_block<L, TILE_QUERIES, TILE_ROWS>(queries + g * TILE_QUERIES, rows_in, m, term, sign, keys.data(), rows);
+
+						for (size_t q = 0; q < TILE_QUERIES; ++q)
+							selection[g * TILE_QUERIES + q].push(keys.data() + q * rows, m, static_cast<uint32_t>(block));
+					}
+
+					for (size_t q = groups * TILE_QUERIES; q < count; ++q)
+					{
+						topk_block<L, 1, 4>(queries + q, rows_in, m, term, sign, keys.data(), rows);
+
+						selection[q].push(keys.data(), m, static_cast<uint32_t>(block));
+					}
+				}
+
+				for (topk_selection<T>& s : selection)
+					s.finish();
+			};
+
+			if (parallel)
+				parallel_for(n, rows, kernel);
+			else
+				kernel(0, 0, n);
+
+			for (size_t q = 0; q < count; ++q)
+			{
+				topk_selection<T>& best = selections[0][q];
+
+				// later chunks hold later indices, pushed best first so ties still go to the lower index
+				if (chunks > 1)
+				{
+					for (size_t c = 1; c < chunks; ++c)
+						for (size_t i = 0; i < selections[c][q].size(); ++i)
+							best.push(selections[c][q][i].key, selections[c][q][i].index);
+
+					best.finish();
+				}
+
+				for (size_t i = 0; i < k; ++i)
+				{
+					const bool found = i < best.size();
+
+					indices[q * k + i] = found ? best[i].index : TOPK_EMPTY;
+
+					if (scores)
+						scores[q * k + i] = found ? sign * best[i].key : std::numeric_limits<T>::quiet_NaN();
+				}
+			}
+		}
+	}
+
+	// The k database vectors with the largest dot product with 'query', best first. Returns how many were found,
+	// fewer than k only when there are fewer vectors. 'scores', when given, has k slots for the dot products.
+	template <size_t S, typename T>
+	size_t topk_dot(const support::vector<S, T>& query, const support::vector<S, T>* db, const size_t& n, const size_t& k, uint32_t* indices, typename support::vector<S, T>::type* scores = nullptr, const bool& parallel = false)
+	{
+		support::topk_search(vec_span<S, const T>(&query, 1), vec_span<S, const T>(db, n), k, support::product_term(), T(1), indices, scores, parallel);
+
+		return std::find(indices, indices + k, TOPK_EMPTY) - indices;
+	}
+
+	// Batch, k results per query in query order with unused slots TOPK_EMPTY. The queries and the database are arrays
+	// or strided spans.
+	template <size_t S, typename T>
+	void topk_dot(const support::vector<S, T>* queries, const size_t& count, const support::vector<S, T>* db, const size_t& n, const size_t& k, uint32_t* indices, typename support::vector<S, T>::type* scores = nullptr, const bool& parallel = false)
+	{
+		support::topk_search(vec_span<S, const T>(queries, count), vec_span<S, const T>(db, n), k, support::product_term(), T(1), indices, scores, parallel);
+	}
+
+	template <size_t S, typename T>
+	void topk_dot(const vec_span<S, const T>& queries, const vec_span<S, const T>& db, const size_t& k, uint32_t* indices, typename support::vector<S, T>::type* scores = nullptr, const bool& parallel = false)
+	{
+		support::topk_search(queries, db, k, support::product_term(), T(1), indices, scores, parallel);
+	}
+
+	// The k database vectors nearest 'query', best first, with their squared distances in 'scores'
+	template <size_t S, typename T>
+	size_t topk_l2(const support::vector<S, T>& query, const support::vector<S, T>* db, const size_t& n, const size_t& k, uint32_t* indices, typename support::vector<S, T>::type* scores = nullptr, const bool& parallel = false)
+	{
+		support::topk_search(vec_span<S, const T>(&query, 1), vec_span<S, const T>(db, n), k, support::difference_term(), T(-1), indices, scores, parallel);
+
+		return std::find(indices, indices + k, TOPK_EMPTY) - indices;
+	}
+
+	template <size_t S, typename T>
+	void topk_l2(const support::vector<S, T>* queries, const size_t& count, const support::vector<S, T>* db, const size_t& n, const size_t& k, uint32_t* indices, typename support::vector<S, T>::type* scores = nullptr, const bool& parallel = false)
+	{
+		support::topk_search(vec_span<S, const T>(queries, count), vec_span<S, const T>(db, n), k, support::difference_term(), T(-1), indices, scores, parallel);
+	}
+
+	template <size_t S, typename T>
+	void topk_l2(const vec_span<S, const T>& queries, const vec_span<S, const T>& db, const size_t& k, uint32_t* indices, typename support::vector<S, T>::type* scores = nullptr, const bool& parallel = false)
+	{
+		support::topk_search(queries, db, k, support::difference_term(), T(-1), indices, scores, parallel);
+	}
+}
+
+#endif
@@ -17,6 +17,9 @@ namespace react
 		template <size_t SS, typename TT>
 		vec2(const support::vector<SS, TT>& v) : support::vector<2, T>(v) {}
 
+		template <typename TT, size_t... I>
+		vec2(const support::swizzle_view<TT, I...>& s) : support::vector<2, T>(s.get()) {}
+
 		static const vec2<T> UP;
 		static const vec2<T> DOWN;
 		static const vec2<T> LEFT;
@@ -48,6 +51,9 @@ namespace react
 	typedef vec2<int> vec2i;
 	typedef vec2<double> vec2d;
 #endif
+
+	static_assert(sizeof(vec2<float>) == 2 * sizeof(float), "vec2<float> holds only its components");
+	static_assert(sizeof(vec2<double>) == 2 * sizeof(double), "vec2<double> holds only its components");
 }
 
 #endif
\ No newline at end of file
@@ -17,6 +17,9 @@ namespace react
 		template <size_t SS, typename TT>
 		vec3(const support::vector<SS, TT>& v) : support::vector<3, T>(v) {}
 
+		template <typename TT, size_t... I>
+		vec3(const support::swizzle_view<TT, I...>& s) : support::vector<3, T>(s.get()) {}
+
 		// Utility functions
 		const vec3<T> cross(const vec3<T>& v) const;
 		const vec3<T> project_on_plane(const vec3<T>& normal) const;
@@ -122,6 +125,11 @@ namespace react
 	typedef vec3<int> vec3i;
 	typedef vec3<double> vec3d;
 #endif
+
+	// Vectors and matrices hold only their components, so arrays of them can be read as arrays of T (vec_span,
+	// as_vec, blobs) and sizeof is part of the layout
+	static_assert(sizeof(vec3<float>) == 3 * sizeof(float), "vec3<float> holds only its components");
+	static_assert(sizeof(vec3<double>) == 3 * sizeof(double), "vec3<double> holds only its components");
 }
 
 #endif
\ No newline at end of file
@@ -17,6 +17,9 @@ namespace react
 
 		template <size_t SS, typename TT>
 		vec4(const support::vector<SS, TT>& v) : support::vector<4, T>(v) {}
+
+		template <typename TT, size_t... I>
+		vec4(const support::swizzle_view<TT, I...>& s) : support::vector<4, T>(s.get()) {}
 	};
 
 	template <typename T>
@@ -42,6 +45,9 @@ namespace react
 	typedef vec4<int> vec4i;
 	typedef vec4<double> vec4d;
 #endif
+
+	static_assert(sizeof(vec4<float>) == 4 * sizeof(float), "vec4<float> holds only its components");
+	static_assert(sizeof(vec4<double>) == 4 * sizeof(double), "vec4<double> holds only its components");
 }
 
 #endif
\ No newline at end of file
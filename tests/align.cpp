@@ -0,0 +1,152 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+#include "test_points.h"
+
+static const float tolerence = 1e-4f;
+
+BOOST_AUTO_TEST_SUITE(align)
+
+BOOST_AUTO_TEST_CASE(align_rigid_transform, *boost::unit_test::tolerance(tolerence))
+{
+	react::rigid_transformf A(react::quatf(react::vec3f(1.0f, 2.0f, -1.0f), 0.8f), react::vec3f(1.0f, -2.0f, 3.0f), 2.0f);
+	react::rigid_transformf B(react::quatf(react::vec3f(0.0f, 1.0f, 0.0f), -1.3f), react::vec3f(0.5f, 0.0f, 4.0f));
+	react::vec3f p(0.3f, -1.2f, 2.5f);
+
+	react::vec3f ab = (A * B).apply(p);
+	react::vec3f a_b = A.apply(B.apply(p));
+	react::vec3f back = A.inverse().apply(A.apply(p));
+
+	for (size_t k = 0; k < 3; ++k)
+	{
+		BOOST_TEST(ab[k] == a_b[k]);
+		BOOST_TEST(back[k] == p[k]);
+	}
+
+	std::vector<react::vec3f> points = test_points(100, react::vec3f(0.0f), react::vec3f(4.0f, 2.0f, 1.0f));
+	std::vector<react::vec3f> out(points.size());
+
+	react::rigid_transformf::apply(A, points.data(), points.size(), out.data(), true);
+
+	for (size_t i = 0; i < points.size(); ++i)
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(out[i][k] == A.apply(points[i])[k]);
+}
+
+BOOST_AUTO_TEST_CASE(align_rigid_points, *boost::unit_test::tolerance(tolerence))
+{
+	react::quatf truth(react::vec3f(0.3f, -1.0f, 0.6f), 2.4f);
+	react::vec3f offset(-20.0f, 5.0f, 12.0f);
+
+	// far from the origin, so the sums would cancel badly without the blockwise accumulation
+	std::vector<react::vec3f> a = test_points(10007, react::vec3f(1000.0f, -500.0f, 250.0f), react::vec3f(4.0f, 2.0f, 1.0f));
+	std::vector<react::vec3f> b;
+
+	for (const react::vec3f& p : a)
+		b.push_back(truth.rotate(p) + offset);
+
+	for (bool parallel : { false, true })
+	{
+		react::rigid_transformf T = react::align_rigid(a.data(), b.data(), a.size(), false, parallel);
+
+		BOOST_TEST(std::abs(T.rotation.dot(truth)) == 1.0f);
+		BOOST_TEST(T.scale == 1.0f);
+
+		for (size_t i = 0; i < a.size(); i += 101)
+			for (size_t k = 0; k < 3; ++k)
+				BOOST_TEST(T.apply(a[i])[k] == b[i][k], boost::test_tools::tolerance(1e-5f));
+	}
+
+	// with a scale
+	std::vector<react::vec3f> c;
+
+	for (const react::vec3f& p : a)
+		c.push_back(truth.rotate(p) * 0.25f + offset);
+
+	react::cross_covariance3f C;
+	C.add(a.data(), c.data(), a.size());
+
+	react::rigid_transformf S = C.solve(true);
+
+	BOOST_TEST(S.scale == 0.25f);
+	BOOST_TEST(std::abs(S.rotation.dot(truth)) == 1.0f);
+	BOOST_TEST(C.residual(S) == 0.0f, boost::test_tools::tolerance(1e-4f));
+	BOOST_TEST(C.residual(react::rigid_transformf()) > 1.0f);
+
+	// a mirrored set still gives a proper rotation
+	std::vector<react::vec3f> m;
+
+	for (const react::vec3f& p : a)
+		m.push_back(react::vec3f(p.x(), p.y(), -p.z()));
+
+	react::rigid_transformf M = react::align_rigid(a.data(), m.data(), a.size());
+
+	BOOST_TEST(M.rotation.length() == 1.0f);
+	BOOST_TEST(M.rotation.toMat3().determinant() == 1.0f);
+
+	// onto a single point the best scale is 0, which has no inverse, and from a single point it stays 1
+	std::vector<react::vec3f> single(a.size(), offset);
+
+	BOOST_TEST(react::align_rigid(a.data(), single.data(), a.size(), true).scale == 0.0f);
+	BOOST_TEST(react::align_rigid(single.data(), a.data(), a.size(), true).scale == 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(align_rigid_weighted, *boost::unit_test::tolerance(tolerence))
+{
+	react::quatf truth(react::vec3f(1.0f, 1.0f, 0.0f), -0.9f);
+	react::vec3f offset(3.0f, 0.0f, -1.0f);
+
+	std::vector<react::vec3f> a = test_points(3000, react::vec3f(0.0f), react::vec3f(4.0f, 2.0f, 1.0f));
+	std::vector<react::vec3f> b;
+	std::vector<float> weights;
+
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		// every 7th pair is an outlier with no weight
+		bool outlier = i % 7 == 3;
+
+		b.push_back(outlier ? react::vec3f(100.0f, 50.0f, -80.0f) : truth.rotate(a[i]) + offset);
+		weights.push_back(outlier ? 0.0f : 1.0f + static_cast<float>(i % 3));
+	}
+
+	for (bool parallel : { false, true })
+	{
+		react::rigid_transformf T = react::align_rigid(a.data(), b.data(), weights.data(), a.size(), false, parallel);
+
+		BOOST_TEST(std::abs(T.rotation.dot(truth)) == 1.0f);
+
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(T.translation[k] == offset[k]);
+	}
+
+	// batch weighted sums agree with adding pairs one at a time
+	react::cross_covariance3f batch;
+	react::cross_covariance3f single;
+
+	batch.add(a.data(), b.data(), weights.data(), a.size());
+
+	for (size_t i = 0; i < a.size(); ++i)
+		single.add(a[i], b[i], weights[i]);
+
+	BOOST_TEST(batch.weight() == single.weight());
+
+	react::mat3f H1 = batch.covariance();
+	react::mat3f H2 = single.covariance();
+
+	for (size_t k = 0; k < 9; ++k)
+		BOOST_TEST(H1.m_data[k] == H2.m_data[k]);
+
+	// the means are near zero, compare them shifted away from it
+	react::vec3f shift(10.0f);
+
+	for (size_t k = 0; k < 3; ++k)
+	{
+		BOOST_TEST((batch.mean_a() + shift)[k] == (single.mean_a() + shift)[k]);
+		BOOST_TEST((batch.mean_b() + shift)[k] == (single.mean_b() + shift)[k]);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,289 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <React-Math.h>
+
+// n x n grid of quads in the xz plane with a height bump, two triangles per quad
+static void bvh_test_grid(const int& n, const float& bump, std::vector<react::vec3f>& vertices, std::vector<uint32_t>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	for (int z = 0; z <= n; ++z)
+	{
+		for (int x = 0; x <= n; ++x)
+		{
+			float fx = static_cast<float>(x) - n / 2.0f;
+			float fz = static_cast<float>(z) - n / 2.0f;
+
+			vertices.push_back(react::vec3f(fx, bump * sin(fx * 0.5f) * cos(fz * 0.5f), fz));
+		}
+	}
+
+	for (int z = 0; z < n; ++z)
+	{
+		for (int x = 0; x < n; ++x)
+		{
+			uint32_t i = static_cast<uint32_t>(z * (n + 1) + x);
+
+			indices.insert(indices.end(), { i, i + 1, i + n + 2, i, i + n + 2, i + n + 1 });
+		}
+	}
+}
+
+static std::vector<react::rayf> bvh_test_rays(const size_t& count)
+{
+	std::vector<react::rayf> rays;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float a = static_cast<float>(i) * 0.731f;
+		react::vec3f origin(7.0f * cos(a), 10.0f + static_cast<float>(i % 5), 7.0f * sin(a * 1.3f));
+		react::vec3f target(static_cast<float>(i % 13) - 6.3f, 0.0f, static_cast<float>(i % 11) - 5.2f);
+
+		rays.push_back(react::rayf(origin, (target - origin).normalized()));
+	}
+
+	return rays;
+}
+
+BOOST_AUTO_TEST_SUITE(bvh)
+
+BOOST_AUTO_TEST_CASE(bvh_empty)
+{
+	react::bvhf A;
+
+	react::ray_hit<float> hit;
+
+	BOOST_CHECK(A.intersect(react::rayf(), hit) == false);
+	BOOST_CHECK(A.occluded(react::rayf()) == false);
+	BOOST_CHECK(A.node_count() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(bvh_bounds)
+{
+	std::vector<react::vec3f> vertices;
+	std::vector<uint32_t> indices;
+	bvh_test_grid(16, 0.0f, vertices, indices);
+
+	react::bvhf A(react::triangle_mesh<float>{ vertices.data(), indices.data(), indices.size() / 3 });
+
+	react::aabbf truth(react::vec3f(-8.0f, 0.0f, -8.0f), react::vec3f(8.0f, 0.0f, 8.0f));
+
+	BOOST_TEST(A.bounds().min == truth.min);
+	BOOST_TEST(A.bounds().max == truth.max);
+	BOOST_CHECK(A.primitive_count() == indices.size() / 3);
+	BOOST_CHECK(reinterpret_cast<uintptr_t>(A.nodes()) % 32 == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(bvh_closest_hit)
+{
+	std::vector<react::vec3f> vertices;
+	std::vector<uint32_t> indices;
+	bvh_test_grid(24, 1.5f, vertices, indices);
+
+	react::triangle_mesh<float> mesh = { vertices.data(), indices.data(), indices.size() / 3 };
+
+	react::bvhf A(mesh);
+	react::bvhf B(mesh, true);
+
+	std::vector<react::rayf> rays = bvh_test_rays(200);
+	std::vector<react::ray_hit<float>> truth(rays.size()), hits(rays.size()), hits_parallel(rays.size());
+
+	react::intersect_triangles(rays.data(), rays.size(), mesh, truth.data());
+	A.intersect(rays.data(), rays.size(), hits.data());
+	B.intersect(rays.data(), rays.size(), hits_parallel.data(), true);
+
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		BOOST_CHECK(hits[i].hit() == truth[i].hit());
+		BOOST_CHECK(hits_parallel[i].hit() == truth[i].hit());
+		BOOST_TEST(hits[i].t == truth[i].t, boost::test_tools::tolerance(1e-4f));
+		BOOST_TEST(hits_parallel[i].t == truth[i].t, boost::test_tools::tolerance(1e-4f));
+
+		BOOST_CHECK(A.occluded(rays[i]) == truth[i].hit());
+		BOOST_CHECK(A.occluded(rays[i], truth[i].t * 0.99f) == false);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bvh_small_triangle)
+{
+	// edges of 2e-4, hit through the middle however small the determinant
+	std::vector<react::vec3f> vertices = { react::vec3f(-1e-4f, -1e-4f, -5.0f), react::vec3f(1e-4f, -1e-4f, -5.0f), react::vec3f(0.0f, 1e-4f, -5.0f) };
+	std::vector<uint32_t> indices = { 0, 1, 2 };
+
+	react::bvhf A(react::triangle_mesh<float>{ vertices.data(), indices.data(), 1 });
+
+	react::ray_hit<float> hit;
+
+	BOOST_CHECK(A.intersect(react::rayf(react::vec3f(0.0f, 0.0f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f)), hit) == true);
+	BOOST_TEST(hit.t == 5.0f);
+}
+
+BOOST_AUTO_TEST_CASE(bvh_lbvh)
+{
+	std::vector<react::vec3f> vertices;
+	std::vector<uint32_t> indices;
+	bvh_test_grid(40, 1.5f, vertices, indices);
+
+	react::triangle_mesh<float> mesh = { vertices.data(), indices.data(), indices.size() / 3 };
+
+	react::bvhf A;
+	react::bvhf B;
+	A.build_lbvh(mesh);
+	B.build_lbvh(mesh, true);
+
+	BOOST_TEST(A.primitive_count() == mesh.triangle_count);
+	BOOST_TEST(A.node_count() == B.node_count());
+
+	std::vector<react::rayf> rays = bvh_test_rays(200);
+	std::vector<react::ray_hit<float>> truth(rays.size()), hits(rays.size()), hits_parallel(rays.size());
+
+	react::intersect_triangles(rays.data(), rays.size(), mesh, truth.data());
+	A.intersect(rays.data(), rays.size(), hits.data());
+	B.intersect(rays.data(), rays.size(), hits_parallel.data(), true);
+
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		BOOST_CHECK(hits[i].hit() == truth[i].hit());
+		BOOST_CHECK(hits_parallel[i].hit() == truth[i].hit());
+		BOOST_TEST(hits[i].t == truth[i].t, boost::test_tools::tolerance(1e-4f));
+		BOOST_TEST(hits_parallel[i].t == truth[i].t, boost::test_tools::tolerance(1e-4f));
+	}
+}
+
+// deepest inner node below index in the collapsed tree, the root counts as 1
+static size_t bvh_test_depth(const react::bvhd& A, const uint32_t& index)
+{
+	const react::bvhd::node& n = A.nodes()[index];
+	size_t depth = 0;
+
+	for (size_t s = 0; s < react::bvhd::WIDTH; ++s)
+		if (n.child[s] != react::bvhd::EMPTY && n.count[s] == 0)
+			depth = std::max(depth, bvh_test_depth(A, n.child[s]));
+
+	return depth + 1;
+}
+
+BOOST_AUTO_TEST_CASE(bvh_degenerate)
+{
+	// collinear triangles at powers of two along x, each SAH split peels off one, and a stack of coincident ones
+	std::vector<react::vec3d> vertices;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		double x = std::ldexp(1.0, i);
+
+		vertices.push_back(react::vec3d(x, -0.5, -0.5));
+		vertices.push_back(react::vec3d(x, 0.5, -0.5));
+		vertices.push_back(react::vec3d(x, 0.0, 0.5));
+	}
+
+	for (int i = 0; i < 600; ++i)
+	{
+		vertices.push_back(react::vec3d(-1.0, -0.5, -0.5));
+		vertices.push_back(react::vec3d(-1.0, 0.5, -0.5));
+		vertices.push_back(react::vec3d(-1.0, 0.0, 0.5));
+	}
+
+	react::triangle_mesh<double> mesh = { vertices.data(), nullptr, vertices.size() / 3 };
+
+	react::bvhd A(mesh);
+	react::bvhd B;
+	B.build_lbvh(mesh);
+
+	for (const react::bvhd* tree : { &A, &B })
+	{
+		BOOST_TEST(tree->primitive_count() == mesh.triangle_count);
+		BOOST_TEST(bvh_test_depth(*tree, 0) <= size_t(react::bvhd::MAX_DEPTH));
+
+		// the nearest hit is the coincident stack, the farthest triangle is still reached
+		react::ray_hit<double> hit;
+
+		BOOST_CHECK(tree->intersect(react::rayd(react::vec3d(-2.0, 0.0, 0.0), react::vec3d(1.0, 0.0, 0.0)), hit));
+		BOOST_TEST(hit.t == 1.0);
+		BOOST_TEST(hit.primitive >= 1000u);
+
+		BOOST_CHECK(tree->occluded(react::rayd(react::vec3d(std::ldexp(1.5, 998), 0.0, 0.0), react::vec3d(1.0, 0.0, 0.0))));
+
+		std::vector<uint32_t> found;
+		tree->overlap(react::aabbd(react::vec3d(-2.0, -1.0, -1.0), react::vec3d(std::ldexp(1.0, 1000), 1.0, 1.0)), found);
+
+		BOOST_TEST(found.size() == mesh.triangle_count);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bvh_overlap)
+{
+	std::vector<react::vec3f> vertices;
+	std::vector<uint32_t> indices;
+	bvh_test_grid(20, 1.0f, vertices, indices);
+
+	react::triangle_mesh<float> mesh = { vertices.data(), indices.data(), indices.size() / 3 };
+	react::bvhf A(mesh);
+
+	react::aabbf box(react::vec3f(-2.5f, -0.2f, 1.1f), react::vec3f(3.2f, 0.4f, 4.7f));
+
+	std::vector<uint32_t> found;
+	A.overlap(box, found);
+	std::sort(found.begin(), found.end());
+
+	std::vector<uint32_t> truth;
+
+	for (size_t i = 0; i < mesh.triangle_count; ++i)
+	{
+		react::vec3f v0, v1, v2;
+		mesh.triangle(i, v0, v1, v2);
+
+		react::aabbf b(v0, v0);
+		b.expand(v1).expand(v2);
+
+		if (b.intersects(box))
+			truth.push_back(static_cast<uint32_t>(i));
+	}
+
+	BOOST_CHECK(truth.size() > 0u);
+	BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), truth.begin(), truth.end());
+}
+
+BOOST_AUTO_TEST_CASE(bvh_refit)
+{
+	std::vector<react::vec3f> vertices;
+	std::vector<uint32_t> indices;
+	bvh_test_grid(16, 0.0f, vertices, indices);
+
+	react::triangle_mesh<float> mesh = { vertices.data(), indices.data(), indices.size() / 3 };
+	react::bvhf A(mesh);
+
+	std::vector<react::vec3f> deformed;
+	bvh_test_grid(16, 2.0f, deformed, indices);
+
+	for (react::vec3f& v : deformed)
+		v.y() += 3.0f;
+
+	react::triangle_mesh<float> deformed_mesh = { deformed.data(), indices.data(), indices.size() / 3 };
+	A.refit(deformed_mesh);
+
+	react::aabbf truth = react::aabbf::from_points(deformed.data(), deformed.size());
+
+	BOOST_TEST(A.bounds().min == truth.min);
+	BOOST_TEST(A.bounds().max == truth.max);
+
+	std::vector<react::rayf> rays = bvh_test_rays(100);
+	std::vector<react::ray_hit<float>> expected(rays.size());
+
+	react::intersect_triangles(rays.data(), rays.size(), deformed_mesh, expected.data());
+
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		react::ray_hit<float> hit;
+
+		BOOST_CHECK(A.intersect(rays[i], hit) == expected[i].hit());
+		BOOST_TEST(hit.t == expected[i].t, boost::test_tools::tolerance(1e-4f));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+static react::mat4f frustum_test_perspective()
+{
+	// 90 degree vertical fov, square aspect, near 1, far 100
+	react::mat4f m(0.0f);
+	m(0, 0) = 1.0f;
+	m(1, 1) = 1.0f;
+	m(2, 2) = -101.0f / 99.0f;
+	m(2, 3) = -200.0f / 99.0f;
+	m(3, 2) = -1.0f;
+
+	return m;
+}
+
+BOOST_AUTO_TEST_SUITE(frustum)
+
+BOOST_AUTO_TEST_CASE(frustum_identity_planes)
+{
+	react::frustumf A(react::mat4f::IDENTITY);
+	// clip cube, -1 <= x, y, z <= 1
+
+	BOOST_TEST(A.plane(react::frustumf::PLANE_LEFT) == react::vec4f(1.0f, 0.0f, 0.0f, 1.0f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_RIGHT) == react::vec4f(-1.0f, 0.0f, 0.0f, 1.0f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_BOTTOM) == react::vec4f(0.0f, 1.0f, 0.0f, 1.0f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_TOP) == react::vec4f(0.0f, -1.0f, 0.0f, 1.0f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_NEAR) == react::vec4f(0.0f, 0.0f, 1.0f, 1.0f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_FAR) == react::vec4f(0.0f, 0.0f, -1.0f, 1.0f));
+
+	react::frustumf B(react::mat4f::IDENTITY, true);
+	// 0 <= z <= 1
+
+	BOOST_TEST(B.plane(react::frustumf::PLANE_NEAR) == react::vec4f(0.0f, 0.0f, 1.0f, 0.0f));
+}
+
+BOOST_AUTO_TEST_CASE(frustum_perspective_planes)
+{
+	react::frustumf A(frustum_test_perspective());
+
+	BOOST_TEST(A.plane(react::frustumf::PLANE_NEAR).w() == -1.0f, boost::test_tools::tolerance(1e-5f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_FAR).w() == 100.0f, boost::test_tools::tolerance(1e-5f));
+	BOOST_TEST(A.plane(react::frustumf::PLANE_LEFT).x() == 0.70710678f, boost::test_tools::tolerance(1e-5f));
+}
+
+BOOST_AUTO_TEST_CASE(frustum_contains)
+{
+	react::frustumf A(frustum_test_perspective());
+
+	BOOST_CHECK(A.contains(react::vec3f(0.0f, 0.0f, -10.0f)) == true);
+	BOOST_CHECK(A.contains(react::vec3f(9.0f, -9.0f, -10.0f)) == true);
+	BOOST_CHECK(A.contains(react::vec3f(11.0f, 0.0f, -10.0f)) == false);
+	BOOST_CHECK(A.contains(react::vec3f(0.0f, 0.0f, 10.0f)) == false);
+	BOOST_CHECK(A.contains(react::vec3f(0.0f, 0.0f, -0.5f)) == false);
+	BOOST_CHECK(A.contains(react::vec3f(0.0f, 0.0f, -101.0f)) == false);
+}
+
+BOOST_AUTO_TEST_CASE(frustum_intersects_sphere_and_aabb)
+{
+	react::frustumf A(frustum_test_perspective());
+
+	BOOST_CHECK(A.intersects(react::vec3f(11.0f, 0.0f, -10.0f), 1.0f) == true);
+	BOOST_CHECK(A.intersects(react::vec3f(12.0f, 0.0f, -10.0f), 1.0f) == false);
+	BOOST_CHECK(A.intersects(react::vec3f(0.0f, 0.0f, 1.5f), 1.0f) == false);
+
+	react::aabbf B(react::vec3f(10.5f, -1.0f, -11.0f), react::vec3f(12.0f, 1.0f, -9.0f));
+	react::aabbf C(react::vec3f(11.5f, -1.0f, -10.5f), react::vec3f(12.0f, 1.0f, -10.0f));
+
+	BOOST_CHECK(A.intersects(B) == true);
+	BOOST_CHECK(A.intersects(C) == false);
+}
+
+BOOST_AUTO_TEST_CASE(frustum_batch_cull)
+{
+	react::frustumf A(frustum_test_perspective());
+
+	const size_t count = 1003;
+
+	std::vector<float> x(count), y(count), z(count), r(count);
+	std::vector<float> min_x(count), min_y(count), min_z(count), max_x(count), max_y(count), max_z(count);
+
+	std::vector<uint32_t> sphere_truth, aabb_truth;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		// off-grid values, so no object sits exactly on a plane and fused multiply-adds cannot flip a result
+		x[i] = static_cast<float>((i * 37) % 101) * 1.013f - 50.0f;
+		y[i] = static_cast<float>((i * 53) % 89) * 0.987f - 44.0f;
+		z[i] = -static_cast<float>((i * 29) % 131) * 1.007f + 10.0f;
+		r[i] = static_cast<float>(i % 7) * 0.503f;
+
+		min_x[i] = x[i] - r[i]; max_x[i] = x[i] + r[i];
+		min_y[i] = y[i] - r[i]; max_y[i] = y[i] + r[i];
+		min_z[i] = z[i] - r[i]; max_z[i] = z[i] + r[i];
+
+		if (A.intersects(react::vec3f(x[i], y[i], z[i]), r[i]))
+			sphere_truth.push_back(static_cast<uint32_t>(i));
+
+		if (A.intersects(react::aabbf(react::vec3f(min_x[i], min_y[i], min_z[i]), react::vec3f(max_x[i], max_y[i], max_z[i]))))
+			aabb_truth.push_back(static_cast<uint32_t>(i));
+	}
+
+	react::sphere_soa<float> spheres = { x.data(), y.data(), z.data(), r.data(), count };
+	react::aabb_soa<float> boxes = { min_x.data(), min_y.data(), min_z.data(), max_x.data(), max_y.data(), max_z.data(), count };
+
+	std::vector<uint32_t> visible(count);
+
+	size_t n = A.cull(spheres, visible.data());
+	BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.begin() + n, sphere_truth.begin(), sphere_truth.end());
+
+	n = A.cull(spheres, visible.data(), true);
+	BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.begin() + n, sphere_truth.begin(), sphere_truth.end());
+
+	n = A.cull(boxes, visible.data());
+	BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.begin() + n, aabb_truth.begin(), aabb_truth.end());
+
+	n = A.cull(boxes, visible.data(), true);
+	BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.begin() + n, aabb_truth.begin(), aabb_truth.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
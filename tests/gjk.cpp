@@ -0,0 +1,279 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-4f;
+
+static std::vector<react::vec3f> gjk_cube_points()
+{
+	std::vector<react::vec3f> points;
+
+	for (int i = 0; i < 8; ++i)
+		points.push_back(react::vec3f(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+
+	// interior points only cost search time
+	for (int i = 0; i < 29; ++i)
+		points.push_back(react::vec3f(0.9f * sin(i * 1.3f), 0.9f * cos(i * 0.7f), 0.9f * sin(i * 2.9f)));
+
+	return points;
+}
+
+BOOST_AUTO_TEST_SUITE(gjk)
+
+BOOST_AUTO_TEST_CASE(gjk_spheres, *boost::unit_test::tolerance(tolerence))
+{
+	react::spheref a(react::vec3f(0.0f), 1.0f);
+	react::spheref b(react::vec3f(3.0f, 0.0f, 0.0f), 0.5f);
+
+	react::gjk_result<float> d = react::gjk_distance(a, b);
+
+	BOOST_TEST(!d.intersecting);
+	BOOST_TEST(d.distance == 1.5f);
+	BOOST_TEST(d.point_a.x() == 1.0f);
+	BOOST_TEST(d.point_b.x() == 2.5f);
+	BOOST_TEST(!react::gjk_intersect(a, b));
+
+	// shallow overlap is resolved on the cores, without EPA
+	b.center = react::vec3f(1.2f, 0.0f, 0.0f);
+
+	react::contactf c = react::collide(a, b);
+
+	BOOST_TEST(c.intersecting);
+	BOOST_TEST(c.separation == -0.3f);
+	BOOST_TEST(c.normal.x() == 1.0f);
+	BOOST_TEST(c.point_a.x() == 1.0f);
+	BOOST_TEST(c.point_b.x() == 0.7f);
+	BOOST_TEST(react::gjk_intersect(a, b));
+
+	// concentric, the depth is the sum of the radii along any axis
+	b.center = a.center;
+	c = react::collide(a, b);
+
+	BOOST_TEST(c.separation == -1.5f);
+	BOOST_TEST(c.normal.length() == 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(gjk_boxes, *boost::unit_test::tolerance(tolerence))
+{
+	react::aabbf a(react::vec3f(-1.0f), react::vec3f(1.0f));
+	react::aabbf b(react::vec3f(2.5f, -0.5f, -0.5f), react::vec3f(3.5f, 0.5f, 0.5f));
+
+	react::contactf c = react::collide(a, b);
+
+	BOOST_TEST(!c.intersecting);
+	BOOST_TEST(c.separation == 1.5f);
+	BOOST_TEST(c.normal.x() == 1.0f);
+	BOOST_TEST(c.point_a.x() == 1.0f);
+	BOOST_TEST(c.point_b.x() == 2.5f);
+
+	// overlapping, the smallest overlap is along x
+	b = react::aabbf(react::vec3f(0.5f, -0.8f, -0.9f), react::vec3f(2.5f, 1.2f, 1.1f));
+	c = react::collide(a, b);
+
+	BOOST_TEST(c.intersecting);
+	BOOST_TEST(c.separation == -0.5f);
+	BOOST_TEST(c.normal.x() == 1.0f);
+	BOOST_TEST(c.point_a.x() - c.point_b.x() == 0.5f);
+
+	// a box turned 45 degrees about z poking a corner into a
+	react::mat3f axes = react::quatf(react::vec3f(0.0f, 0.0f, 1.0f), 3.14159265f / 4.0f).toMat3();
+	react::obbf o(react::vec3f(2.2f, 0.0f, 0.0f), axes, react::vec3f(1.0f));
+	react::obbf box(react::vec3f(0.0f), react::mat3f(), react::vec3f(1.0f));
+
+	c = react::collide(box, o);
+
+	BOOST_TEST(c.intersecting);
+	BOOST_TEST(c.separation == 2.2f - std::sqrt(2.0f) - 1.0f);
+	BOOST_TEST(c.normal.x() == 1.0f);
+
+	o.center = react::vec3f(3.0f, 0.0f, 0.0f);
+
+	react::gjk_result<float> d = react::gjk_distance(box, o);
+
+	BOOST_TEST(d.distance == 2.0f - std::sqrt(2.0f));
+	BOOST_TEST(d.point_b.x() == 3.0f - std::sqrt(2.0f));
+}
+
+BOOST_AUTO_TEST_CASE(gjk_capsules, *boost::unit_test::tolerance(tolerence))
+{
+	react::capsulef a(react::vec3f(-1.0f, 0.0f, 0.0f), react::vec3f(1.0f, 0.0f, 0.0f), 0.5f);
+	react::spheref s(react::vec3f(0.3f, 2.0f, 0.0f), 0.5f);
+
+	react::gjk_result<float> d = react::gjk_distance(a, s);
+
+	BOOST_TEST(d.distance == 1.0f);
+	BOOST_TEST(d.point_a.x() == 0.3f);
+	BOOST_TEST(d.point_a.y() == 0.5f);
+	BOOST_TEST(d.point_b.y() == 1.5f);
+
+	// crossing capsules, the cores are apart
+	react::capsulef b(react::vec3f(0.0f, 0.6f, -1.0f), react::vec3f(0.0f, 0.6f, 1.0f), 0.5f);
+	react::contactf c = react::collide(a, b);
+
+	BOOST_TEST(c.intersecting);
+	BOOST_TEST(c.separation == -0.4f);
+	BOOST_TEST(c.normal.y() == 1.0f);
+
+	// the cores cross, their difference is flat and all of the depth comes from the radii
+	b = react::capsulef(react::vec3f(0.0f, 0.0f, -1.0f), react::vec3f(0.0f, 0.0f, 1.0f), 0.5f);
+	c = react::collide(a, b);
+
+	BOOST_TEST(c.separation == -1.0f);
+	BOOST_TEST(std::abs(c.normal.y()) == 1.0f);
+
+	// a capsule against a box
+	react::aabbf box(react::vec3f(-1.0f, -3.0f, -1.0f), react::vec3f(1.0f, -1.0f, 1.0f));
+	c = react::collide(a, box);
+
+	BOOST_TEST(!c.intersecting);
+	BOOST_TEST(c.separation == 0.5f);
+	BOOST_TEST(c.normal.y() == -1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(gjk_hulls, *boost::unit_test::tolerance(tolerence))
+{
+	std::vector<react::vec3f> points = gjk_cube_points();
+	react::convex_hullf hull(points.data(), points.size());
+
+	BOOST_TEST(hull.size() == points.size());
+
+	// the SIMD search agrees with a scalar scan
+	for (int i = 0; i < 50; ++i)
+	{
+		react::vec3f d(sin(i * 0.37f), cos(i * 1.91f), sin(i * 0.83f + 1.0f));
+
+		float best = points[0].dot(d);
+
+		for (const react::vec3f& p : points)
+			best = std::max(best, p.dot(d));
+
+		BOOST_TEST(hull.support(d).dot(d) == best);
+	}
+
+	// a transformed cube hull matches the box with the same pose
+	for (int i = 0; i < 20; ++i)
+	{
+		react::quatf r(react::vec3f(sin(i * 1.1f), cos(i * 0.5f), 1.0f), i * 0.4f);
+		react::vec3f t(1.0f + 0.15f * i, 0.5f * sin(i * 1.7f), 0.3f * cos(i * 2.3f));
+
+		react::transformed_shape<react::convex_hullf, float> moved(hull, react::rigid_transformf(r, t));
+		react::obbf box(t, r.toMat3(), react::vec3f(1.0f));
+		react::obbf origin(react::vec3f(0.0f), react::mat3f(), react::vec3f(1.0f));
+
+		react::contactf from_hull = react::collide(origin, moved);
+		react::contactf from_box = react::collide(origin, box);
+
+		BOOST_TEST(from_hull.intersecting == from_box.intersecting);
+		BOOST_TEST(from_hull.separation + 4.0f == from_box.separation + 4.0f);
+		BOOST_TEST(react::gjk_intersect(origin, moved) == from_box.intersecting);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gjk_dense_hulls)
+{
+	// dense spheres pushed deep into each other run EPA out of face space, the reported face must still be the closest
+	std::vector<react::vec3f> points;
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		float z = 1.0f - (2.0f * i + 1.0f) / 20000.0f;
+		float r = std::sqrt(1.0f - z * z);
+		float phi = i * 2.39996323f;
+
+		points.push_back(react::vec3f(r * cos(phi), r * sin(phi), z));
+	}
+
+	react::convex_hullf hull(points.data(), points.size());
+	react::transformed_shape<react::convex_hullf, float> a(hull, react::rigid_transformf());
+
+	for (int i = 0; i < 200; ++i)
+	{
+		float offset = 0.3f + 1.2f * i / 199.0f;
+		react::vec3f axis = react::vec3f(sin(i * 0.77f), cos(i * 1.31f), sin(i * 2.03f) + 0.1f).normalized();
+
+		react::transformed_shape<react::convex_hullf, float> b(hull, react::rigid_transformf(react::quatf(), axis * offset));
+		react::contactf c = react::collide(a, b);
+
+		BOOST_TEST(c.intersecting);
+		BOOST_TEST(std::abs(c.separation - (offset - 2.0f)) < 0.02f);
+		BOOST_TEST(c.normal.dot(axis) > 0.8f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(gjk_warm_start, *boost::unit_test::tolerance(tolerence))
+{
+	std::vector<react::vec3f> points = gjk_cube_points();
+	react::convex_hullf hull(points.data(), points.size());
+
+	react::gjk_cachef cache;
+	int cold = 0, warm = 0;
+
+	for (int i = 0; i < 30; ++i)
+	{
+		// a slowly moving pair
+		react::quatf r(react::vec3f(0.2f, 1.0f, 0.4f), 0.6f + i * 0.01f);
+		react::transformed_shape<react::convex_hullf, float> a(hull, react::rigid_transformf());
+		react::transformed_shape<react::convex_hullf, float> b(hull, react::rigid_transformf(r, react::vec3f(3.0f + i * 0.01f, 0.7f, 0.2f)));
+
+		react::gjk_result<float> fresh = react::gjk_distance(a, b);
+		react::gjk_result<float> cached = react::gjk_distance(a, b, &cache);
+
+		BOOST_TEST(cached.distance == fresh.distance);
+
+		if (i > 0)
+		{
+			cold += fresh.iterations;
+			warm += cached.iterations;
+		}
+	}
+
+	BOOST_TEST(warm < cold);
+}
+
+BOOST_AUTO_TEST_CASE(gjk_batch)
+{
+	std::vector<react::vec3f> points = gjk_cube_points();
+	react::convex_hullf hull(points.data(), points.size());
+
+	std::vector<react::transformed_shape<react::convex_hullf, float>> shapes;
+
+	for (int i = 0; i < 200; ++i)
+	{
+		react::quatf r(react::vec3f(sin(i * 0.9f), cos(i * 1.3f), sin(i * 2.1f)), i * 0.7f);
+		react::vec3f t(8.0f * sin(i * 0.31f), 8.0f * cos(i * 0.57f), 8.0f * sin(i * 0.13f));
+
+		shapes.push_back(react::transformed_shape<react::convex_hullf, float>(hull, react::rigid_transformf(r, t, 1.0f + 0.5f * sin(i * 1.7f))));
+	}
+
+	std::vector<uint32_t> pairs;
+
+	for (uint32_t i = 0; i < 200; ++i)
+		for (uint32_t j = i + 1; j < 200; j += 7)
+			pairs.push_back(i), pairs.push_back(j);
+
+	size_t count = pairs.size() / 2;
+	std::vector<react::contactf> out(count);
+	std::vector<react::gjk_cachef> caches(count);
+
+	react::collide(shapes.data(), shapes.data(), pairs.data(), count, out.data(), caches.data(), true);
+
+	size_t intersecting = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::contactf c = react::collide(shapes[pairs[2 * i]], shapes[pairs[2 * i + 1]]);
+
+		BOOST_TEST(out[i].intersecting == c.intersecting);
+		BOOST_TEST(out[i].separation + 20.0f == c.separation + 20.0f, boost::test_tools::tolerance(tolerence));
+		BOOST_TEST(caches[i].count > 0);
+
+		intersecting += c.intersecting;
+	}
+
+	BOOST_TEST(intersecting > 0u);
+	BOOST_TEST(intersecting < count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+#include "test_points.h"
+
+// Samples of a curved height field, curved enough in both directions that all six degrees of freedom are constrained
+static std::vector<react::vec3f> icp_test_surface(const size_t& resolution, const float& extent)
+{
+	std::vector<react::vec3f> points;
+
+	for (size_t i = 0; i < resolution; ++i)
+	{
+		for (size_t j = 0; j < resolution; ++j)
+		{
+			float x = extent * (2.0f * i / (resolution - 1) - 1.0f);
+			float y = extent * (2.0f * j / (resolution - 1) - 1.0f);
+
+			points.push_back(react::vec3f(x, y, 0.6f * sin(x * 1.1f) * cos(y * 0.8f) + 0.1f * x * y));
+		}
+	}
+
+	return points;
+}
+
+BOOST_AUTO_TEST_SUITE(icp)
+
+BOOST_AUTO_TEST_CASE(icp_normals, *boost::unit_test::tolerance(1e-4f))
+{
+	std::vector<react::vec3f> plane;
+
+	for (int i = 0; i < 20; ++i)
+		for (int j = 0; j < 20; ++j)
+			plane.push_back(react::vec3f(i * 0.1f, j * 0.1f, 2.0f));
+
+	react::kd_tree3f tree(plane.data(), plane.size());
+	std::vector<react::vec3f> normals(plane.size());
+
+	react::estimate_normals(tree, plane.data(), plane.size(), 8, normals.data(), true);
+
+	for (const react::vec3f& n : normals)
+		BOOST_TEST(std::abs(n.z()) == 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(icp_point_to_point)
+{
+	// a scattered volume, every other point moved away from the target and a few wild points that have to be rejected
+	std::vector<react::vec3f> target = test_points(4000, react::vec3f(0.0f), react::vec3f(2.0f, 2.0f, 1.5f));
+
+	react::rigid_transformf truth(react::quatf(react::vec3f(0.3f, -0.5f, 1.0f), 0.1f), react::vec3f(0.1f, -0.05f, 0.08f));
+	std::vector<react::vec3f> source;
+
+	for (size_t i = 0; i < target.size(); i += 2)
+		source.push_back(truth.inverse().apply(target[i]));
+
+	for (size_t i = 0; i < source.size(); i += 97)
+		source[i] = source[i] + react::vec3f(0.0f, 0.0f, 5.0f);
+
+	react::icpf engine(target.data(), target.size());
+	react::icpf::settings settings;
+	settings.max_iterations = 100;
+	settings.parallel = true;
+
+	BOOST_TEST(!react::icpf::settings().parallel);
+
+	react::rigid_transformf result = engine.align(source.data(), source.size(), react::rigid_transformf(), settings);
+
+	BOOST_TEST(engine.converged());
+	BOOST_TEST(!engine.iterations().empty());
+
+	// the rotation angle between the result and the truth
+	float angle = 2.0f * std::asin(std::min(1.0f, (result.rotation * truth.rotation.conjugate()).xyz().length()));
+
+	BOOST_TEST(angle < 1e-4f);
+	BOOST_TEST((result.translation - truth.translation).length() < 1e-4f);
+
+	const react::icpf::iteration& last = engine.iterations().back();
+
+	BOOST_TEST(last.rms < 1e-4f);
+	BOOST_TEST(last.rms < engine.iterations().front().rms);
+	BOOST_TEST(last.correspondences < source.size());
+	BOOST_TEST(last.correspondences > source.size() * 9 / 10);
+	BOOST_TEST(last.total_ms >= last.search_ms);
+
+	// subsampled and serial
+	settings.sample_stride = 3;
+	settings.parallel = false;
+
+	result = engine.align(source.data(), source.size(), react::rigid_transformf(), settings);
+
+	BOOST_TEST((result.translation - truth.translation).length() < 1e-4f);
+	BOOST_TEST(engine.iterations().back().correspondences <= (source.size() + 2) / 3);
+}
+
+BOOST_AUTO_TEST_CASE(icp_empty_source)
+{
+	std::vector<react::vec3f> target = test_points(100, react::vec3f(0.0f), react::vec3f(1.0f));
+
+	react::icpf engine(target.data(), target.size());
+	react::rigid_transformf initial(react::quatf(react::vec3f(0.0f, 0.0f, 1.0f), 0.2f), react::vec3f(1.0f, 2.0f, 3.0f));
+
+	react::rigid_transformf result = engine.align(target.data(), 0, initial);
+
+	BOOST_TEST(!engine.converged());
+	BOOST_TEST(engine.iterations().empty());
+	BOOST_TEST(result.translation == initial.translation);
+	BOOST_TEST(result.rotation == initial.rotation);
+}
+
+BOOST_AUTO_TEST_CASE(icp_point_to_plane)
+{
+	std::vector<react::vec3f> target = icp_test_surface(120, 3.0f);
+
+	// the source samples the middle of the surface on a different grid, so no source point lies exactly on a target point
+	react::rigid_transformf truth(react::quatf(react::vec3f(0.3f, -0.5f, 1.0f), 0.12f), react::vec3f(0.15f, -0.1f, 0.08f));
+	std::vector<react::vec3f> source = icp_test_surface(45, 2.2f);
+
+	for (react::vec3f& p : source)
+		p = truth.inverse().apply(p);
+
+	for (size_t i = 0; i < source.size(); i += 97)
+		source[i] = source[i] + react::vec3f(0.0f, 0.0f, 5.0f);
+
+	react::icpf engine(target.data(), target.size());
+	react::icpf::settings settings;
+	settings.mode = react::icpf::POINT_TO_PLANE;
+
+	react::rigid_transformf result = engine.align(source.data(), source.size(), react::rigid_transformf(), settings);
+
+	BOOST_TEST(engine.converged());
+	BOOST_TEST(engine.normals().size() == target.size());
+
+	float angle = 2.0f * std::asin(std::min(1.0f, (result.rotation * truth.rotation.conjugate()).xyz().length()));
+
+	BOOST_TEST(angle < 1e-3f);
+	BOOST_TEST((result.translation - truth.translation).length() < 1e-3f);
+	BOOST_TEST(engine.iterations().back().correspondences > source.size() * 9 / 10);
+
+	size_t plane_iterations = engine.iterations().size();
+
+	// point to point slides along a smooth surface and needs far more iterations
+	engine.align(source.data(), source.size());
+
+	BOOST_TEST(plane_iterations < engine.iterations().size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "test_points.h"
+
+BOOST_AUTO_TEST_SUITE(kd_tree)
+
+BOOST_AUTO_TEST_CASE(kd_tree_empty)
+{
+	react::kd_tree3f A;
+	A.build(static_cast<const react::vec3f*>(nullptr), 0);
+
+	uint32_t nearest[4];
+	std::vector<uint32_t> found;
+
+	BOOST_TEST(A.size() == 0);
+	BOOST_TEST(A.node_count() == 0);
+	BOOST_TEST(A.nearest(react::vec3f(), 4, nearest) == 0);
+	BOOST_TEST(A.radius(react::vec3f(), 1.0f, found) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_nearest)
+{
+	// every tree shape from a single leaf up to a few levels
+	for (size_t count : { 1, 5, 8, 9, 17, 100, 2000 })
+	{
+		std::vector<react::support::vector<3, float>> points = test_vectors<3>(count, 10.0f);
+
+		react::kd_tree3f A(points.data(), count);
+
+		BOOST_TEST(A.size() == count);
+
+		for (size_t q = 0; q < 40; ++q)
+		{
+			react::vec3f p(sin(q * 0.37f) * 12.0f, cos(q * 0.53f) * 12.0f, sin(q * 0.71f + 0.4f) * 12.0f);
+
+			const size_t k = 6;
+			uint32_t found[k];
+			float d2[k];
+
+			size_t n = A.nearest(p, k, found, d2);
+
+			std::vector<std::pair<float, uint32_t>> truth = brute_sorted(points, react::support::vector<3, float>(p));
+
+			BOOST_TEST(n == std::min(k, count));
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				BOOST_TEST(d2[i] == truth[i].first);
+				BOOST_TEST(points[found[i]].distance_squared(p) == d2[i]);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_nearest_ties)
+{
+	// every shell around a lattice point ties
+	std::vector<react::vec3f> lattice = test_lattice(4);
+	std::vector<react::support::vector<3, float>> points(lattice.begin(), lattice.end());
+
+	react::kd_tree3f A(points.data(), points.size());
+
+	for (size_t k : { 1, 4, 7, 12, 19, 30 })
+	{
+		for (const react::vec3f& p : { react::vec3f(0.0f), react::vec3f(1.0f, -2.0f, 3.0f), react::vec3f(0.5f, 0.5f, 0.0f) })
+		{
+			std::vector<uint32_t> found(k);
+			std::vector<uint32_t> truth = brute_nearest(points, react::support::vector<3, float>(p), k);
+
+			BOOST_TEST(A.nearest(p, k, found.data()) == k);
+			BOOST_TEST(found == truth, boost::test_tools::per_element());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_nearest_high_dimension)
+{
+	std::vector<react::support::vector<6, float>> points = test_vectors<6>(1500, 5.0f);
+	std::vector<react::support::vector<6, float>> queries = test_vectors<6>(50, 6.0f);
+
+	react::kd_tree<6, float> A(points.data(), points.size());
+
+	const size_t k = 4;
+	std::vector<uint32_t> found(queries.size() * k);
+
+	A.nearest(queries.data(), queries.size(), k, found.data(), true);
+
+	for (size_t q = 0; q < queries.size(); ++q)
+	{
+		std::vector<std::pair<float, uint32_t>> truth = brute_sorted(points, queries[q]);
+
+		for (size_t i = 0; i < k; ++i)
+			BOOST_TEST(points[found[q * k + i]].distance_squared(queries[q]) == truth[i].first);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_nearest_approximate)
+{
+	std::vector<react::support::vector<3, float>> points = test_vectors<3>(5000, 10.0f);
+
+	react::kd_tree3f A(points.data(), points.size());
+
+	const float epsilon = 0.5f;
+
+	for (size_t q = 0; q < 50; ++q)
+	{
+		react::vec3f p(sin(q * 0.91f) * 9.0f, cos(q * 0.23f) * 9.0f, sin(q * 0.47f) * 9.0f);
+
+		const size_t k = 3;
+		uint32_t found[k];
+		float d2[k];
+
+		BOOST_TEST(A.nearest(p, k, found, d2, epsilon) == k);
+
+		std::vector<std::pair<float, uint32_t>> truth = brute_sorted(points, react::support::vector<3, float>(p));
+
+		for (size_t i = 0; i < k; ++i)
+			BOOST_TEST(d2[i] <= truth[i].first * (1 + epsilon) * (1 + epsilon));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_radius)
+{
+	std::vector<react::support::vector<3, float>> points = test_vectors<3>(3000, 10.0f);
+	std::vector<react::support::vector<3, float>> centers = test_vectors<3>(200, 11.0f);
+
+	react::kd_tree3f A(points.data(), points.size());
+
+	const float r = 1.8f;
+
+	for (bool parallel : { false, true })
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> indices;
+
+		A.radius(centers.data(), centers.size(), r, offsets, indices, parallel);
+
+		BOOST_TEST(offsets.back() == indices.size());
+
+		for (size_t q = 0; q < centers.size(); ++q)
+		{
+			std::vector<uint32_t> found(indices.begin() + offsets[q], indices.begin() + offsets[q + 1]);
+			std::sort(found.begin(), found.end());
+
+			std::vector<uint32_t> truth;
+
+			for (size_t i = 0; i < points.size(); ++i)
+				if (points[i].distance_squared(centers[q]) <= r * r)
+					truth.push_back(static_cast<uint32_t>(i));
+
+			BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), truth.begin(), truth.end());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_span_batch)
+{
+	std::vector<react::support::vector<3, float>> points = test_vectors<3>(3000, 10.0f);
+	std::vector<react::support::vector<3, float>> queries = test_vectors<3>(200, 11.0f);
+
+	react::kd_tree3f A(points.data(), points.size());
+
+	// the queries five floats apart
+	std::vector<float> data(queries.size() * 5, -3.0f);
+	react::vec_span<3, const float> strided(data.data(), queries.size(), 5 * sizeof(float));
+
+	for (size_t i = 0; i < queries.size(); ++i)
+		std::copy(queries[i].m_data, queries[i].m_data + 3, data.begin() + i * 5);
+
+	const size_t k = 7;
+
+	for (bool parallel : { false, true })
+	{
+		std::vector<uint32_t> nearest(queries.size() * k), span_nearest(queries.size() * k);
+
+		A.nearest(queries.data(), queries.size(), k, nearest.data(), parallel);
+		A.nearest(strided, k, span_nearest.data(), parallel);
+
+		BOOST_TEST(span_nearest == nearest);
+
+		std::vector<uint32_t> offsets, indices, span_offsets, span_indices;
+
+		A.radius(queries.data(), queries.size(), 1.8f, offsets, indices, parallel);
+		A.radius(strided, 1.8f, span_offsets, span_indices, parallel);
+
+		BOOST_TEST(span_offsets == offsets);
+		BOOST_TEST(span_indices == indices);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(kd_tree_parallel_build)
+{
+	std::vector<react::vec3f> points;
+
+	for (size_t i = 0; i < 50000; ++i)
+		points.push_back(react::vec3f(sin(i * 1.13f) * 40.0f, cos(i * 0.71f) * 40.0f, sin(i * 0.29f + 2.0f) * 40.0f));
+
+	react::kd_tree3f A(points.data(), points.size());
+	react::kd_tree3f B(points.data(), points.size(), true);
+
+	BOOST_TEST(A.node_count() == B.node_count());
+
+	for (size_t i = 0; i < A.node_count(); ++i)
+	{
+		BOOST_TEST(A.nodes()[i].split == B.nodes()[i].split);
+		BOOST_TEST(A.nodes()[i].axis == B.nodes()[i].axis);
+	}
+
+	// duplicates of the first points, the nearest is always the point itself at distance 0
+	uint32_t found[1];
+	float d2[1];
+
+	for (size_t i = 0; i < 100; ++i)
+	{
+		B.nearest(points[i * 487], 1, found, d2);
+		BOOST_TEST(d2[0] == 0.0f);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -227,6 +227,79 @@ BOOST_AUTO_TEST_CASE(matrix_product3_mat3x4)
 	BOOST_CHECK(C == truth);
 }
 
+BOOST_AUTO_TEST_CASE(matrix_multiply_accumulation)
+{
+	react::mat3x4f A({ 1.0f, 2.0f, 3.0f,4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f });
+	react::mat4x3f B({ 12.0f, 11.0f, 10.0f, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f });
+
+	// small whole numbers are exact under every policy
+	BOOST_TEST((A.dot(B, react::accumulation::in_double) == A * B));
+	BOOST_TEST((A.dot(B, react::accumulation::compensated) == A * B));
+	BOOST_TEST((react::mat3x4f::dot(A, B, react::accumulation::pairwise) == A * B));
+
+	// 3 x 256 times 256 x 2, the first row cancels 1e8 and the ones vanish next to it in a float running sum
+	react::support::matrix<256, 3, float> C(1.0f);
+	react::support::matrix<2, 256, float> D(1.0f);
+
+	C.at(0, 0) = 1e8f;
+	C.at(0, 2) = -1e8f;
+	C.at(2, 5) = 3.0f;
+
+	react::support::matrix<2, 3, float> native = C * D;
+	react::support::matrix<2, 3, float> wide = C.dot(D, react::accumulation::in_double);
+	react::support::matrix<2, 3, float> compensated = C.dot(D, react::accumulation::compensated);
+
+	BOOST_TEST(native.at(0, 1) == 253.0f);
+	BOOST_TEST(wide.at(0, 1) == 254.0f);
+	BOOST_TEST(compensated.at(0, 0) == 254.0f);
+	BOOST_TEST(wide.at(1, 0) == 256.0f);
+	BOOST_TEST(compensated.at(2, 1) == 258.0f);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_multiply_accumulation_tiles)
+{
+	// 37 x 29 times 29 x 11, so the products leave partial register rows and partial tiles of columns
+	react::support::matrix<29, 37, float> A;
+	react::support::matrix<11, 29, float> B;
+
+	for (size_t k = 0; k < 29 * 37; ++k)
+		A.m_data[k] = static_cast<float>((k * 7919) % 1000) / 997.0f - 0.5f;
+
+	for (size_t k = 0; k < 11 * 29; ++k)
+		B.m_data[k] = static_cast<float>((k * 104729) % 1000) / 991.0f - 0.5f;
+
+	const react::accumulation policies[] = { react::accumulation::in_double, react::accumulation::compensated, react::accumulation::pairwise };
+
+	for (const react::accumulation& policy : policies)
+	{
+		react::support::matrix<11, 37, float> C = A.dot(B, policy);
+
+		// a column at a time gives the same bits as the tiles
+		for (size_t j = 0; j < 11; ++j)
+		{
+			float column[37];
+
+			react::support::accumulate_columns(A.m_data, 37, 29, B.m_data + j * 29, 1, column, policy);
+
+			for (size_t i = 0; i < 37; ++i)
+				BOOST_TEST(C.at(i, j) == column[i]);
+		}
+
+		for (size_t i = 0; i < 37; ++i)
+		{
+			for (size_t j = 0; j < 11; ++j)
+			{
+				double truth = 0.0;
+
+				for (size_t k = 0; k < 29; ++k)
+					truth += static_cast<double>(A.at(i, k)) * B.at(k, j);
+
+				BOOST_TEST(std::abs(C.at(i, j) - truth) <= 1e-5);
+			}
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE(matrix_determinant_mat3)
 {
 	react::mat3f A({ 6.0f, 4.0f, 2.0f, 1.0f, -2.0f, 8.0f, 1.0f, 5.0f, 7.0f });
@@ -552,6 +625,109 @@ BOOST_AUTO_TEST_CASE(matrix_col)
 	BOOST_CHECK_EQUAL_COLLECTIONS(C.m_data, C.m_data + 3, C_truth, C_truth + 3);
 }
 
+BOOST_AUTO_TEST_CASE(matrix_row_col_views)
+{
+	react::mat3f A({ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f });
+	// 1  4  7
+	// 2  5  8
+	// 3  6  9
+
+	// views write through to the matrix
+	A.row(1) = react::vec3f(-1.0f, -2.0f, -3.0f);
+	A.col(2) *= 2.0f;
+
+	react::mat3f A_truth({ 1.0f, -1.0f, 3.0f, 4.0f, -2.0f, 6.0f, 14.0f, -6.0f, 18.0f });
+	// 1   4  14
+	// -1 -2  -6
+	// 3   6  18
+
+	BOOST_TEST(A == A_truth);
+	BOOST_TEST(A.row(0).dot(A.col(0)) == 1.0f - 4.0f + 42.0f);
+
+	// swapping two columns through a copy
+	react::vec3f c0 = A.col(0);
+	A.col(0) = A.col(1);
+	A.col(1) = c0;
+
+	BOOST_TEST(A.at(0, 0) == 4.0f);
+	BOOST_TEST(A.at(2, 1) == 3.0f);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_block)
+{
+	react::mat4f A;
+	react::mat3f R({ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 10.0f });
+
+	A.block<3, 3>(0, 0) = R;
+	A.col(3) = react::vec4f(5.0f, 6.0f, 7.0f, 1.0f);
+
+	react::mat4f A_truth({ 1.0f, 2.0f, 3.0f, 0.0f, 4.0f, 5.0f, 6.0f, 0.0f, 7.0f, 8.0f, 10.0f, 0.0f, 5.0f, 6.0f, 7.0f, 1.0f });
+	// 1  4   7  5
+	// 2  5   8  6
+	// 3  6  10  7
+	// 0  0   0  1
+
+	BOOST_TEST(A == A_truth);
+	BOOST_TEST((A.block<3, 3>(0, 0) == R));
+	BOOST_TEST((A.block<3, 3>(0, 0).determinant() == R.determinant()));
+
+	// a block of a block, and a block against a matrix product
+	const react::mat4f& C = A;
+	react::mat2f B = C.block<2, 2>(1, 2);
+	react::mat2f B_truth({ 8.0f, 10.0f, 6.0f, 7.0f });
+
+	BOOST_TEST(B == B_truth);
+	BOOST_TEST((C.block<3, 3>(0, 0) * R == R * R));
+
+	A.block<2, 2>(2, 2) += react::mat2f::ONE;
+
+	BOOST_TEST(A.at(3, 3) == 2.0f);
+	BOOST_TEST(A.at(2, 2) == 11.0f);
+
+	// of a temporary, copies rather than views of a matrix that is gone
+	auto D = (A * 1.0f).block<2, 2>(2, 2);
+	auto E = (A * 1.0f).row(2);
+	auto F = (A * 1.0f).col(3);
+
+	BOOST_TEST((std::is_same<decltype(D), react::support::matrix<2, 2, float>>::value));
+	BOOST_TEST((std::is_same<decltype(E), react::support::vector<4, float>>::value));
+	BOOST_TEST((std::is_same<decltype(F), react::support::vector<4, float>>::value));
+	BOOST_TEST(D.at(0, 0) == 11.0f);
+	BOOST_TEST(E[3] == 8.0f);
+	BOOST_TEST(F[0] == 5.0f);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_reduce)
+{
+	react::mat4f A({ 2.0f, 0.0f, 1.0f, 3.0f, 1.0f, 1.0f, 0.0f, 2.0f, 4.0f, 1.0f, 3.0f, 0.0f, 1.0f, 2.0f, 1.0f, 1.0f });
+
+	react::mat3f B = A.reduce(1, 2);
+	react::mat3f B_truth({ 2.0f, 1.0f, 3.0f, 1.0f, 0.0f, 2.0f, 1.0f, 1.0f, 1.0f });
+
+	BOOST_TEST(B == B_truth);
+	BOOST_TEST(A.reduce(1, 2).determinant() == B_truth.determinant());
+
+	auto C = (A * 2.0f).reduce(1, 2);
+
+	BOOST_TEST((std::is_same<decltype(C), react::support::matrix<3, 3, float>>::value));
+	BOOST_TEST(C == B_truth * 2.0f);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_view_compare)
+{
+	react::mat2f A({ 0.5f, 0.25f, 0.125f, 1.0f });
+	react::mat2f B({ 0.50000006f, 0.25f, 0.125f, 1.0f });
+	react::mat3f C;
+
+	C.block<2, 2>(0, 0) = A;
+
+	// views compare as the matrices they convert to, within epsilon
+	BOOST_TEST(A == B);
+	BOOST_TEST((C.block<2, 2>(0, 0) == B));
+	BOOST_TEST(C.reduce(2, 2) == B);
+	BOOST_TEST((C.block<2, 2>(1, 1) != B));
+}
+
 BOOST_AUTO_TEST_CASE(matrix_invertible)
 {
 	react::mat3f A({ 1.0f, -2.0f, 1.0f, 2.0f, 0.0f, -1.0f, -1.0f, 1.0f, 0.0f });
@@ -0,0 +1,184 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "test_points.h"
+
+BOOST_AUTO_TEST_SUITE(morton)
+
+BOOST_AUTO_TEST_CASE(morton_encode_bits)
+{
+	BOOST_TEST(react::support::morton_encode30(1, 0, 0) == 1u);
+	BOOST_TEST(react::support::morton_encode30(0, 1, 0) == 2u);
+	BOOST_TEST(react::support::morton_encode30(0, 0, 1) == 4u);
+	BOOST_TEST(react::support::morton_encode30(3, 5, 6) == 0x1abu);
+	BOOST_TEST(react::support::morton_encode30(1023, 1023, 1023) == 0x3fffffffu);
+	BOOST_TEST(react::support::morton_encode63(0x1fffff, 0x1fffff, 0x1fffff) == 0x7fffffffffffffffull);
+	BOOST_TEST(react::support::morton_encode63(0x100000, 0, 0) == (uint64_t(1) << 60));
+
+	// the pdep and magic bits paths agree, and decoding inverts both
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		uint32_t x = (i * 7919u) & 1023u;
+		uint32_t y = (i * 104729u) & 1023u;
+		uint32_t z = (i * 31u + 17u) & 1023u;
+
+		uint32_t code = react::support::morton_encode30(x, y, z);
+
+		BOOST_TEST(code == (react::support::morton_expand10(x) | (react::support::morton_expand10(y) << 1) | (react::support::morton_expand10(z) << 2)));
+
+		uint32_t dx, dy, dz;
+		react::support::morton_decode30(code, dx, dy, dz);
+
+		BOOST_TEST(dx == x);
+		BOOST_TEST(dy == y);
+		BOOST_TEST(dz == z);
+
+		uint64_t lx = uint64_t(x) * 2047u, ly = uint64_t(y) * 1999u, lz = uint64_t(z) * 2039u;
+		uint64_t long_code = react::support::morton_encode63(lx, ly, lz);
+
+		BOOST_TEST(long_code == (react::support::morton_expand21(lx) | (react::support::morton_expand21(ly) << 1) | (react::support::morton_expand21(lz) << 2)));
+
+		uint64_t ex, ey, ez;
+		react::support::morton_decode63(long_code, ex, ey, ez);
+
+		BOOST_TEST(ex == lx);
+		BOOST_TEST(ey == ly);
+		BOOST_TEST(ez == lz);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(morton_encode_points)
+{
+	react::aabbf bounds(react::vec3f(-1.0f, -1.0f, -1.0f), react::vec3f(1.0f, 1.0f, 1.0f));
+
+	BOOST_TEST(react::morton_encode(react::vec3f(-1.0f, -1.0f, -1.0f), bounds) == 0u);
+	BOOST_TEST(react::morton_encode(react::vec3f(1.0f, 1.0f, 1.0f), bounds) == 0x3fffffffu);
+	BOOST_TEST(react::morton_encode63(react::vec3f(1.0f, 1.0f, 1.0f), bounds) == 0x7fffffffffffffffull);
+
+	// outside the bounds and NaN clamp to the edges
+	BOOST_TEST(react::morton_encode(react::vec3f(-5.0f, 9.0f, 0.0f), bounds) == react::support::morton_encode30(0, 1023, 512));
+	BOOST_TEST(react::morton_encode(react::vec3f(std::numeric_limits<float>::quiet_NaN(), -1.0f, -1.0f), bounds) == 0u);
+
+	// the first split of the curve is the highest z bit
+	BOOST_TEST(react::morton_encode(react::vec3f(0.9f, 0.9f, -0.1f), bounds) < react::morton_encode(react::vec3f(-0.9f, -0.9f, 0.1f), bounds));
+}
+
+BOOST_AUTO_TEST_CASE(morton_encode_batch)
+{
+	std::vector<react::vec3f> points = test_points(1003, react::vec3f(0.0f, 3.0f, 0.0f), react::vec3f(20.0f, 5.0f, 11.0f));
+	react::aabbf bounds = react::aabbf::from_points(points.data(), points.size());
+
+	// slightly smaller bounds so some points clamp
+	bounds.max -= react::vec3f(0.5f);
+
+	std::vector<float> x, y, z;
+
+	for (const react::vec3f& p : points)
+	{
+		x.push_back(p.x());
+		y.push_back(p.y());
+		z.push_back(p.z());
+	}
+
+	for (bool parallel : { false, true })
+	{
+		std::vector<uint32_t> aos(points.size()), soa(points.size());
+		std::vector<uint64_t> aos63(points.size()), soa63(points.size());
+
+		react::morton_encode(points.data(), points.size(), bounds, aos.data(), parallel);
+		react::morton_encode(x.data(), y.data(), z.data(), points.size(), bounds, soa.data(), parallel);
+		react::morton_encode63(points.data(), points.size(), bounds, aos63.data(), parallel);
+		react::morton_encode63(x.data(), y.data(), z.data(), points.size(), bounds, soa63.data(), parallel);
+
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			BOOST_TEST(aos[i] == react::morton_encode(points[i], bounds));
+			BOOST_TEST(soa[i] == aos[i]);
+			BOOST_TEST(aos63[i] == react::morton_encode63(points[i], bounds));
+			BOOST_TEST(soa63[i] == aos63[i]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(morton_radix_sort)
+{
+	std::vector<uint32_t> keys32;
+	std::vector<uint64_t> keys64;
+
+	for (uint32_t i = 0; i < 200000; ++i)
+	{
+		keys32.push_back((i * 2654435761u) >> 3);
+		keys64.push_back(uint64_t(i % 977) << 40 | ((i * 40503u) & 0xffff));
+	}
+
+	for (bool parallel : { false, true })
+	{
+		std::vector<uint32_t> k32(keys32);
+		std::vector<uint64_t> k64(keys64);
+		std::vector<uint32_t> v32(k32.size()), v64(k64.size());
+
+		for (uint32_t i = 0; i < v32.size(); ++i)
+			v32[i] = v64[i] = i;
+
+		react::support::radix_sort(k32.data(), v32.data(), k32.size(), parallel);
+		react::support::radix_sort(k64.data(), v64.data(), k64.size(), parallel);
+
+		BOOST_TEST(std::is_sorted(k32.begin(), k32.end()));
+		BOOST_TEST(std::is_sorted(k64.begin(), k64.end()));
+
+		for (size_t i = 0; i < k32.size(); ++i)
+		{
+			BOOST_TEST(keys32[v32[i]] == k32[i]);
+			BOOST_TEST(keys64[v64[i]] == k64[i]);
+
+			// stable, equal keys keep their input order
+			if (i > 0 && k64[i] == k64[i - 1])
+				BOOST_TEST(v64[i] > v64[i - 1]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(morton_order_points)
+{
+	std::vector<react::vec3f> points = test_points(5000, react::vec3f(0.0f, 3.0f, 0.0f), react::vec3f(20.0f, 5.0f, 11.0f));
+
+	std::vector<uint32_t> order(points.size());
+	react::morton_order(points.data(), points.size(), order.data(), true);
+
+	// a permutation of the input
+	std::vector<uint32_t> sorted(order);
+	std::sort(sorted.begin(), sorted.end());
+
+	for (uint32_t i = 0; i < sorted.size(); ++i)
+		BOOST_TEST(sorted[i] == i);
+
+	std::vector<react::vec3f> reordered(points);
+	react::support::permute(reordered.data(), order.data(), reordered.size());
+
+	react::aabbf bounds = react::aabbf::from_points(points.data(), points.size());
+
+	for (size_t i = 1; i < reordered.size(); ++i)
+		BOOST_TEST(react::morton_encode63(reordered[i - 1], bounds) <= react::morton_encode63(reordered[i], bounds));
+
+	// SoA gives the same order
+	std::vector<float> x, y, z;
+
+	for (const react::vec3f& p : points)
+	{
+		x.push_back(p.x());
+		y.push_back(p.y());
+		z.push_back(p.z());
+	}
+
+	std::vector<uint32_t> soa_order(points.size());
+	react::morton_order(x.data(), y.data(), z.data(), points.size(), soa_order.data());
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), soa_order.begin(), soa_order.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-4f;
+
+BOOST_AUTO_TEST_SUITE(obb)
+
+BOOST_AUTO_TEST_CASE(obb_basics, *boost::unit_test::tolerance(tolerence))
+{
+	react::obbf A(react::aabbf(react::vec3f(-1.0f, 0.0f, 2.0f), react::vec3f(3.0f, 2.0f, 3.0f)));
+
+	BOOST_TEST(A.center == react::vec3f(1.0f, 1.0f, 2.5f));
+	BOOST_TEST(A.extents == react::vec3f(2.0f, 1.0f, 0.5f));
+	BOOST_TEST(A.volume() == 8.0f);
+	BOOST_TEST(A.surface_area() == 28.0f);
+	BOOST_TEST(A.corner(0) == react::vec3f(-1.0f, 0.0f, 2.0f));
+	BOOST_TEST(A.corner(7) == react::vec3f(3.0f, 2.0f, 3.0f));
+	BOOST_TEST(A.contains(react::vec3f(2.9f, 0.1f, 2.9f)));
+	BOOST_TEST(!A.contains(react::vec3f(3.1f, 1.0f, 2.5f)));
+
+	// rotated 45 degrees about y, the world bounds grow
+	react::obbf B(react::vec3f(0.0f), react::quatf(react::vec3f::UP, 0.78539816f).toMat3(), react::vec3f(1.0f, 1.0f, 1.0f));
+	react::aabbf b = B.bounds();
+
+	BOOST_TEST(b.max.x() == 1.41421356f);
+	BOOST_TEST(b.max.y() == 1.0f);
+	BOOST_TEST(b.max.z() == 1.41421356f);
+
+	for (size_t i = 0; i < 8; ++i)
+		BOOST_TEST(B.contains(B.corner(i) * 0.999f));
+}
+
+BOOST_AUTO_TEST_CASE(obb_fit, *boost::unit_test::tolerance(1e-3f))
+{
+	react::mat3f axes = react::quatf(react::vec3f(1.0f, 2.0f, 0.5f), 1.1f).toMat3();
+	react::vec3f center(10.0f, -4.0f, 7.0f);
+	react::vec3f half(5.0f, 2.0f, 0.5f);
+
+	// the corners of a box plus points spread inside it
+	std::vector<react::vec3f> points;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		react::vec3f local((i & 1 ? 1.0f : -1.0f) * half.x(), (i & 2 ? 1.0f : -1.0f) * half.y(), (i & 4 ? 1.0f : -1.0f) * half.z());
+		points.push_back(center + react::vec3f(axes.col(0)) * local.x() + react::vec3f(axes.col(1)) * local.y() + react::vec3f(axes.col(2)) * local.z());
+	}
+
+	// mirrored on every axis, so the spread is exactly aligned with the box
+	for (int i = 0; i < 60; ++i)
+	{
+		float a = static_cast<float>(i);
+
+		for (int j = 0; j < 8; ++j)
+		{
+			react::vec3f local((j & 1 ? 1.0f : -1.0f) * half.x() * sin(a * 1.3f), (j & 2 ? 1.0f : -1.0f) * half.y() * cos(a * 0.7f), (j & 4 ? 1.0f : -1.0f) * half.z() * sin(a * 0.31f));
+			points.push_back(center + react::vec3f(axes.col(0)) * local.x() + react::vec3f(axes.col(1)) * local.y() + react::vec3f(axes.col(2)) * local.z());
+		}
+	}
+
+	react::obbf box = react::obbf::fit(points.data(), points.size());
+
+	for (const react::vec3f& p : points)
+		BOOST_TEST(box.contains(p + (p - box.center) * -1e-4f));
+
+	BOOST_TEST(box.volume() == 8.0f * half.x() * half.y() * half.z());
+
+	for (size_t k = 0; k < 3; ++k)
+		BOOST_TEST(std::abs(box.axis(k).dot(react::vec3f(axes.col(k)))) == 1.0f);
+
+	// batch over clusters matches one by one
+	std::vector<uint32_t> offsets = { 0, 8, 8, 200, static_cast<uint32_t>(points.size()) };
+	std::vector<react::obbf> boxes(offsets.size() - 1);
+
+	react::obbf::fit(points.data(), offsets.data(), boxes.size(), boxes.data(), true);
+
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		react::obbf single = react::obbf::fit(points.data() + offsets[i], offsets[i + 1] - offsets[i]);
+
+		BOOST_TEST(boxes[i].center == single.center);
+		BOOST_TEST(boxes[i].extents == single.extents);
+	}
+
+	BOOST_TEST(boxes[1].volume() == 0.0f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
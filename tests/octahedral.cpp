@@ -0,0 +1,215 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include <React-Math.h>
+
+// the axes, the diagonals between hemispheres, and a spread of directions
+static std::vector<react::vec3f> octahedral_test_normals(const size_t& count)
+{
+	std::vector<react::vec3f> n = {
+		react::vec3f(1.0f, 0.0f, 0.0f),
+		react::vec3f(-1.0f, 0.0f, 0.0f),
+		react::vec3f(0.0f, 1.0f, 0.0f),
+		react::vec3f(0.0f, -1.0f, 0.0f),
+		react::vec3f(0.0f, 0.0f, 1.0f),
+		react::vec3f(0.0f, 0.0f, -1.0f),
+		react::vec3f(0.70710678f, 0.0f, -0.70710678f),
+		react::vec3f(-0.57735027f, -0.57735027f, -0.57735027f)
+	};
+
+	for (size_t i = n.size(); i < count; ++i)
+	{
+		float a = static_cast<float>(i);
+		react::vec3f v(sin(a * 1.37f), cos(a * 0.71f), sin(a * 2.3f + 1.0f));
+
+		n.push_back(v.normalized());
+	}
+
+	return n;
+}
+
+static double octahedral_test_angle(const react::vec3f& a, const react::vec3f& b)
+{
+	double chord = sqrt((double(a.x()) - b.x()) * (double(a.x()) - b.x()) + (double(a.y()) - b.y()) * (double(a.y()) - b.y()) + (double(a.z()) - b.z()) * (double(a.z()) - b.z()));
+
+	return 2.0 * asin(std::min(1.0, chord * 0.5)) * 180.0 / 3.14159265358979323846;
+}
+
+template <typename P>
+static void octahedral_test_axes()
+{
+	const react::octahedral_mode modes[] = { react::octahedral_mode::fast, react::octahedral_mode::precise };
+
+	for (react::octahedral_mode mode : modes)
+	{
+		for (size_t i = 0; i < 6; ++i)
+		{
+			const react::vec3f axis = octahedral_test_normals(6)[i];
+			P p;
+			react::vec3f back;
+
+			react::normal_pack(axis, p, mode);
+			react::normal_unpack(p, back);
+
+			BOOST_TEST((back == axis));
+		}
+	}
+
+	P p;
+	react::vec3f back;
+
+	react::normal_pack(react::vec3f(0.0f), p);
+	react::normal_unpack(p, back);
+
+	BOOST_TEST((back == react::vec3f(0.0f, 0.0f, 1.0f)));
+}
+
+BOOST_AUTO_TEST_SUITE(octahedral)
+
+BOOST_AUTO_TEST_CASE(octahedral_axes)
+{
+	BOOST_TEST(sizeof(react::packed_normal16) == 2u);
+	BOOST_TEST(sizeof(react::packed_normal24) == 3u);
+	BOOST_TEST(sizeof(react::packed_normal32) == 4u);
+
+	octahedral_test_axes<react::packed_normal16>();
+	octahedral_test_axes<react::packed_normal24>();
+	octahedral_test_axes<react::packed_normal32>();
+
+	// the 12 bit fields sign extend, -x is u = -2047 in the lower hemisphere fold
+	react::packed_normal24 p;
+	react::normal_pack(react::vec3f(-1.0f, 0.0f, 0.0f), p);
+
+	BOOST_TEST(p.bits[0] == 0x01);
+	BOOST_TEST(p.bits[1] == 0x08);
+	BOOST_TEST(p.bits[2] == 0x00);
+}
+
+template <typename P>
+static void octahedral_test_error(const std::vector<react::vec3f>& n, const double& fast_bound, const double& precise_bound)
+{
+	double fast_worst = 0.0;
+	double precise_worst = 0.0;
+	bool closer = true;
+
+	for (const react::vec3f& v : n)
+	{
+		P fast, precise;
+		react::vec3f a, b;
+
+		react::normal_pack(v, fast, react::octahedral_mode::fast);
+		react::normal_pack(v, precise, react::octahedral_mode::precise);
+		react::normal_unpack(fast, a);
+		react::normal_unpack(precise, b);
+
+		double fast_error = octahedral_test_angle(v, a);
+		double precise_error = octahedral_test_angle(v, b);
+
+		fast_worst = std::max(fast_worst, fast_error);
+		precise_worst = std::max(precise_worst, precise_error);
+
+		// precise never does worse, beyond float noise in the comparison
+		closer = closer && precise_error <= fast_error + 1e-4;
+	}
+
+	BOOST_TEST(fast_worst < fast_bound);
+	BOOST_TEST(precise_worst < precise_bound);
+	BOOST_TEST(closer);
+}
+
+BOOST_AUTO_TEST_CASE(octahedral_error)
+{
+	std::vector<react::vec3f> n = octahedral_test_normals(200000);
+
+	// degrees
+	octahedral_test_error<react::packed_normal16>(n, 1.2, 0.8);
+	octahedral_test_error<react::packed_normal24>(n, 0.07, 0.05);
+	octahedral_test_error<react::packed_normal32>(n, 0.005, 0.0035);
+
+	// double vectors encode through float
+	react::packed_normal32 p;
+	react::vec3d back;
+
+	react::normal_pack(react::vec3d(0.0, 0.6, -0.8), p, react::octahedral_mode::precise);
+	react::normal_unpack(p, back);
+
+	BOOST_TEST(std::abs(back.z() + 0.8) < 1e-4);
+}
+
+template <typename P>
+static void octahedral_test_batch(const std::vector<react::vec3f>& n, const react::octahedral_mode& mode)
+{
+	const size_t count = n.size();
+	std::vector<P> single(count), batch(count), threaded(count), soa(count), strided(count);
+	std::vector<float> x(count), y(count), z(count);
+	std::vector<float> interleaved(count * 8);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::normal_pack(n[i], single[i], mode);
+
+		x[i] = n[i].x();
+		y[i] = n[i].y();
+		z[i] = n[i].z();
+
+		// normals at offset 3 of a 32 byte vertex
+		interleaved[i * 8 + 3] = x[i];
+		interleaved[i * 8 + 4] = y[i];
+		interleaved[i * 8 + 5] = z[i];
+	}
+
+	react::normal_pack(n.data(), count, batch.data(), mode);
+	react::normal_pack(n.data(), count, threaded.data(), mode, true);
+	react::normal_pack(x.data(), y.data(), z.data(), count, soa.data(), mode);
+	react::normal_pack(react::vec_span<3, const float>(interleaved.data() + 3, count, 32), strided.data(), mode);
+
+	const size_t bytes = count * sizeof(P);
+
+	BOOST_TEST(std::memcmp(single.data(), batch.data(), bytes) == 0);
+	BOOST_TEST(std::memcmp(single.data(), threaded.data(), bytes) == 0);
+	BOOST_TEST(std::memcmp(single.data(), soa.data(), bytes) == 0);
+	BOOST_TEST(std::memcmp(single.data(), strided.data(), bytes) == 0);
+
+	std::vector<react::vec3f> back(count);
+	std::vector<float> bx(count), by(count), bz(count);
+
+	react::normal_unpack(single.data(), count, back.data(), true);
+	react::normal_unpack(single.data(), count, bx.data(), by.data(), bz.data());
+
+	bool same = true;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		react::vec3f one;
+		react::normal_unpack(single[i], one);
+
+		same = same && std::memcmp(&one, &back[i], sizeof(one)) == 0;
+		same = same && one.x() == bx[i] && one.y() == by[i] && one.z() == bz[i];
+	}
+
+	BOOST_TEST(same);
+}
+
+BOOST_AUTO_TEST_CASE(octahedral_batch)
+{
+	// not a multiple of the block or any SIMD width, and some vectors not of unit length
+	std::vector<react::vec3f> n = octahedral_test_normals(100003);
+
+	for (size_t i = 0; i < n.size(); i += 7)
+		n[i] = n[i] * 3.5f;
+
+	n[10] = react::vec3f(0.0f);
+
+	const react::octahedral_mode modes[] = { react::octahedral_mode::fast, react::octahedral_mode::precise };
+
+	for (react::octahedral_mode mode : modes)
+	{
+		octahedral_test_batch<react::packed_normal16>(n, mode);
+		octahedral_test_batch<react::packed_normal24>(n, mode);
+		octahedral_test_batch<react::packed_normal32>(n, mode);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
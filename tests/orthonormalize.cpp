@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-5f;
+
+// a rotation with every element perturbed by up to drift
+template <typename T>
+static react::support::matrix<3, 3, T> orthonormalize_drifted(const int& seed, const T& drift)
+{
+	react::support::matrix<3, 3, T> m(react::quat<T>(react::vec3<T>(sin(seed * 1.3f), cos(seed * 0.7f), 0.5f), static_cast<T>(seed * 0.37f)).toMat3());
+
+	for (int k = 0; k < 9; ++k)
+		m.m_data[k] += drift * static_cast<T>(sin(seed * 3.1f + k * 1.7f));
+
+	return m;
+}
+
+template <size_t N, typename T>
+static void orthonormalize_check(const react::support::matrix<N, N, T>& m, const T& tolerance)
+{
+	// shifted away from zero for the relative tolerance
+	for (size_t i = 0; i < 3; ++i)
+		for (size_t j = 0; j < 3; ++j)
+			BOOST_TEST(m.col(i).dot(m.col(j)) + (i == j ? 0 : 1) == static_cast<T>(1), boost::test_tools::tolerance(tolerance));
+
+	const react::support::matrix<3, 3, T> r(m);
+
+	BOOST_TEST(r.determinant() == static_cast<T>(1), boost::test_tools::tolerance(tolerance));
+}
+
+BOOST_AUTO_TEST_SUITE(orthonormalize)
+
+BOOST_AUTO_TEST_CASE(orthonormalize_gram_schmidt, *boost::unit_test::tolerance(tolerence))
+{
+	react::mat3f A = orthonormalize_drifted(3, 0.05f);
+	react::mat3f B = A;
+
+	react::orthonormalize(B);
+
+	orthonormalize_check(B, tolerence);
+
+	// the first column keeps its direction
+	react::vec3f a(A.col(0));
+
+	BOOST_TEST(react::vec3f(B.col(0)).dot(a.normalized()) == 1.0f);
+
+	react::mat3d C = orthonormalize_drifted(5, 0.05);
+
+	react::orthonormalize(C);
+
+	orthonormalize_check(C, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(orthonormalize_symmetric, *boost::unit_test::tolerance(tolerence))
+{
+	// one step removes small drift to second order
+	react::mat3f A = orthonormalize_drifted(7, 1e-3f);
+
+	react::orthonormalize_fast(A);
+
+	orthonormalize_check(A, tolerence);
+
+	// and repeated steps converge on larger drift, to the same rotation as the polar decomposition
+	react::mat3d B = orthonormalize_drifted(9, 0.05);
+	react::polar3d P(B);
+
+	for (int i = 0; i < 6; ++i)
+		react::orthonormalize_fast(B);
+
+	orthonormalize_check(B, 1e-12);
+
+	react::mat3d R = P.rotation.toMat3();
+
+	for (int k = 0; k < 9; ++k)
+		BOOST_TEST(B.m_data[k] + 2.0 == R.m_data[k] + 2.0, boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(orthonormalize_mat4, *boost::unit_test::tolerance(tolerence))
+{
+	react::mat3f A = orthonormalize_drifted(11, 2e-3f);
+	react::mat4f M(0.0f);
+
+	for (size_t row = 0; row < 3; ++row)
+		for (size_t col = 0; col < 3; ++col)
+			M.at(row, col) = A.at(row, col);
+
+	M.at(0, 3) = 5.0f;
+	M.at(1, 3) = -2.0f;
+	M.at(2, 3) = 1.0f;
+	M.at(3, 3) = 1.0f;
+
+	react::mat4f N = M;
+
+	react::orthonormalize(M);
+	react::orthonormalize_fast(N);
+
+	orthonormalize_check(M, tolerence);
+	orthonormalize_check(N, 1e-4f);
+
+	// the translation and the last row are left alone
+	for (size_t k = 0; k < 4; ++k)
+	{
+		BOOST_TEST(M.at(k, 3) == N.at(k, 3));
+		BOOST_TEST(M.at(3, k) == N.at(3, k));
+	}
+
+	BOOST_TEST(M.at(0, 3) == 5.0f);
+	BOOST_TEST(M.at(3, 3) == 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(orthonormalize_batch, *boost::unit_test::tolerance(tolerence))
+{
+	// batches, with a tail that is not a multiple of the SIMD width
+	std::vector<react::mat3f> batch;
+	std::vector<react::mat4f> batch4;
+
+	for (int i = 0; i < 37; ++i)
+	{
+		batch.push_back(orthonormalize_drifted(i, 1e-3f));
+		batch4.push_back(react::mat4f(batch.back()));
+	}
+
+	for (bool fast : { false, true })
+	{
+		std::vector<react::mat3f> a = batch;
+		std::vector<react::mat3f> b = batch;
+		std::vector<react::mat4f> c = batch4;
+
+		for (react::mat3f& m : a)
+			fast ? react::orthonormalize_fast(m) : react::orthonormalize(m);
+
+		if (fast)
+		{
+			react::orthonormalize_fast(b.data(), b.size(), true);
+			react::orthonormalize_fast(c.data(), c.size());
+		}
+		else
+		{
+			react::orthonormalize(b.data(), b.size(), true);
+			react::orthonormalize(c.data(), c.size());
+		}
+
+		for (size_t i = 0; i < batch.size(); ++i)
+		{
+			orthonormalize_check(b[i], tolerence);
+			orthonormalize_check(c[i], tolerence);
+
+			for (size_t row = 0; row < 3; ++row)
+			{
+				for (size_t col = 0; col < 3; ++col)
+				{
+					BOOST_TEST(b[i].at(row, col) + 2.0f == a[i].at(row, col) + 2.0f);
+					BOOST_TEST(c[i].at(row, col) + 2.0f == a[i].at(row, col) + 2.0f);
+				}
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
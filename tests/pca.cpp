@@ -0,0 +1,175 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+#include "test_points.h"
+
+static const float tolerence = 1e-4f;
+
+// Points spread along a rotated, anisotropic ellipsoid around 'center'
+static std::vector<react::vec3f> pca_test_points(const size_t& count, const react::vec3f& center, const react::mat3f& axes, const react::vec3f& spread)
+{
+	std::vector<react::vec3f> points = test_points(count, react::vec3f(0.0f), spread);
+
+	for (react::vec3f& p : points)
+		p = center + react::vec3f(axes.col(0)) * p.x() + react::vec3f(axes.col(1)) * p.y() + react::vec3f(axes.col(2)) * p.z();
+
+	return points;
+}
+
+BOOST_AUTO_TEST_SUITE(pca)
+
+BOOST_AUTO_TEST_CASE(pca_symmetric_eigen3, *boost::unit_test::tolerance(1e-9))
+{
+	react::mat3d A({ 4.0, 1.0, -2.0, 1.0, 2.0, 0.5, -2.0, 0.5, 3.0 });
+
+	react::symmetric_eigen3d E(A);
+
+	BOOST_TEST(E.values.x() >= E.values.y());
+	BOOST_TEST(E.values.y() >= E.values.z());
+
+	// trace and determinant are preserved
+	BOOST_TEST(E.values.x() + E.values.y() + E.values.z() == 9.0);
+	BOOST_TEST(E.values.x() * E.values.y() * E.values.z() == A.determinant());
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		react::vec3d v = E.vector(i);
+		react::vec3d Av(A.row(0).dot(v), A.row(1).dot(v), A.row(2).dot(v));
+
+		BOOST_TEST(v.length() == 1.0);
+
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(Av[k] == E.values[i] * v[k]);
+	}
+
+	// right handed orthonormal basis
+	BOOST_TEST(E.vectors.determinant() == 1.0);
+	BOOST_TEST(E.vector(0).dot(E.vector(1)) == 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(pca_symmetric_eigen3_degenerate, *boost::unit_test::tolerance(tolerence))
+{
+	react::mat3f D({ 2.0f, 0.0f, 0.0f, 0.0f, 5.0f, 0.0f, 0.0f, 0.0f, 2.0f });
+	react::symmetric_eigen3f E(D);
+
+	BOOST_TEST(E.values.x() == 5.0f);
+	BOOST_TEST(E.values.y() == 2.0f);
+	BOOST_TEST(E.values.z() == 2.0f);
+	BOOST_TEST(std::abs(E.vector(0).y()) == 1.0f);
+	BOOST_TEST(E.vectors.determinant() == 1.0f);
+
+	react::symmetric_eigen3f Z(react::mat3f(0.0f));
+
+	BOOST_TEST(Z.values.x() == 0.0f);
+	BOOST_TEST(Z.vectors.determinant() == 1.0f);
+
+	// batch agrees with the scalar version
+	std::vector<react::mat3f> matrices = { D, react::mat3f(), react::mat3f({ 1.0f, 2.0f, 3.0f, 2.0f, 4.0f, 5.0f, 3.0f, 5.0f, 6.0f }) };
+	std::vector<react::symmetric_eigen3f> out(matrices.size());
+
+	react::symmetric_eigen3f::compute(matrices.data(), matrices.size(), out.data(), true);
+
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		react::symmetric_eigen3f e(matrices[i]);
+
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(out[i].values[k] == e.values[k]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(pca_covariance, *boost::unit_test::tolerance(tolerence))
+{
+	react::mat3f axes = react::quatf(react::vec3f(0.3f, 1.0f, -0.2f), 0.7f).toMat3();
+	std::vector<react::vec3f> points = pca_test_points(5003, react::vec3f(1000.0f, -250.0f, 40.0f), axes, react::vec3f(6.0f, 2.0f, 0.5f));
+
+	// reference in double, two pass
+	react::vec3d mean(0.0);
+
+	for (const react::vec3f& p : points)
+		mean += react::vec3d(p);
+
+	mean /= static_cast<double>(points.size());
+
+	react::mat3d truth(0.0);
+
+	for (const react::vec3f& p : points)
+	{
+		react::vec3d d = react::vec3d(p) - mean;
+		truth = truth + react::mat3d::outer_product(d, d);
+	}
+
+	truth /= static_cast<double>(points.size());
+
+	std::vector<float> x, y, z;
+
+	for (const react::vec3f& p : points)
+	{
+		x.push_back(p.x());
+		y.push_back(p.y());
+		z.push_back(p.z());
+	}
+
+	react::covariance3f single;
+
+	for (const react::vec3f& p : points)
+		single.add(p);
+
+	react::covariance3f batch(points.data(), points.size());
+	react::covariance3f threaded(points.data(), points.size(), true);
+	react::covariance3f soa;
+	soa.add(x.data(), y.data(), z.data(), points.size());
+
+	// split in two and merged
+	react::covariance3f merged(points.data(), 1234);
+	merged.merge(react::covariance3f(points.data() + 1234, points.size() - 1234));
+
+	for (const react::covariance3f* c : { &single, &batch, &threaded, &soa, &merged })
+	{
+		BOOST_TEST(c->weight() == static_cast<double>(points.size()));
+
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(c->mean()[k] == static_cast<float>(mean[k]));
+
+		react::mat3f C = c->covariance();
+
+		for (size_t row = 0; row < 3; ++row)
+			for (size_t col = 0; col < 3; ++col)
+				BOOST_TEST(C(row, col) == static_cast<float>(truth(row, col)), boost::test_tools::tolerance(1e-3f));
+	}
+
+	// principal axes recover the generating axes up to sign
+	react::symmetric_eigen3f E = batch.principal_axes();
+
+	for (size_t k = 0; k < 3; ++k)
+		BOOST_TEST(std::abs(E.vector(k).dot(react::vec3f(axes.col(k)))) == 1.0f, boost::test_tools::tolerance(1e-3f));
+}
+
+BOOST_AUTO_TEST_CASE(pca_covariance_weighted, *boost::unit_test::tolerance(1e-9))
+{
+	// weight 2 is the same as adding a point twice
+	react::covariance3d A;
+	react::covariance3d B;
+
+	for (int i = 0; i < 20; ++i)
+	{
+		react::vec3d p(sin(i * 1.3), cos(i * 0.7) * 2.0, i * 0.1);
+
+		A.add(p, i % 2 ? 2.0 : 1.0);
+		B.add(p);
+
+		if (i % 2)
+			B.add(p);
+	}
+
+	BOOST_TEST(A.weight() == B.weight());
+
+	for (size_t row = 0; row < 3; ++row)
+		for (size_t col = 0; col < 3; ++col)
+			BOOST_TEST(A.covariance()(row, col) == B.covariance()(row, col));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 #include <React-Math.h>
 
 BOOST_AUTO_TEST_SUITE(quat)
@@ -94,6 +96,13 @@ BOOST_AUTO_TEST_CASE(quat_matrix_constructor)
 
 	BOOST_TEST(C == C_truth);
 	BOOST_TEST(D == D_truth);
+
+	// negative trace with the largest diagonal entry on y
+	react::quatf E_truth(react::vec3f(0.2f, 1.0f, -0.1f), 3.0f);
+	react::quatf E(E_truth.toMat3());
+
+	for (int i = 0; i < 4; ++i)
+		BOOST_TEST(E[i] == E_truth[i], boost::test_tools::tolerance(1e-5f));
 }
 
 BOOST_AUTO_TEST_CASE(quat_compare)
@@ -120,6 +129,12 @@ BOOST_AUTO_TEST_CASE(quat_xyz)
 	react::vec3f truth(1.0f, 2.0f, 3.0f);
 
 	BOOST_TEST(quat.xyz() == truth);
+
+	// a temporary's vector part is copied out of it
+	auto axis = react::quatf(1.0f, 2.0f, 3.0f, 4.0f).xyz();
+
+	BOOST_TEST((std::is_same<decltype(axis), react::vec3f>::value));
+	BOOST_TEST(axis == truth);
 }
 
 BOOST_AUTO_TEST_CASE(quat_conjugate)
@@ -314,4 +329,37 @@ BOOST_AUTO_TEST_CASE(quat_to_matrix)
 	BOOST_TEST(B_out == B_truth);
 }
 
+BOOST_AUTO_TEST_CASE(quat_renormalize_fast, *boost::unit_test::tolerance(1e-6f))
+{
+	react::quatf A = react::quatf(react::vec3f(1.0f, 2.0f, -1.0f), 0.7f) * 1.002f;
+	react::quatf B = A.normalized();
+
+	A.renormalize_fast();
+
+	// the error is second order in the drift
+	BOOST_TEST(std::abs(A.length() - 1.0f) < 1e-5f);
+	BOOST_TEST(A.dot(B) == 1.0f, boost::test_tools::tolerance(1e-5f));
+
+	// batches, with a tail that is not a multiple of the SIMD width
+	std::vector<react::quatf> batch;
+
+	for (int i = 0; i < 37; ++i)
+		batch.push_back(react::quatf(react::vec3f(sin(i * 1.0f), cos(i * 2.0f), 1.0f), i * 0.1f) * (1.0f + 0.001f * sin(i * 3.0f)));
+
+	std::vector<react::quatf> serial = batch;
+
+	for (react::quatf& q : serial)
+		q.renormalize_fast();
+
+	react::quatf::renormalize_fast(batch.data(), batch.size(), true);
+
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		BOOST_TEST(std::abs(batch[i].length() - 1.0f) < 1e-5f);
+
+		for (int k = 0; k < 4; ++k)
+			BOOST_TEST(batch[i][k] + 2.0f == serial[i][k] + 2.0f); // shifted away from zero for the relative tolerance
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
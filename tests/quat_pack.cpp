@@ -0,0 +1,157 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <React-Math.h>
+
+// a spread of unit quaternions, both signs of w, and the ties and axis cases smallest three has to pick an index for
+static std::vector<react::quatf> quat_pack_test_rotations(const size_t& count)
+{
+	std::vector<react::quatf> q = {
+		react::quatf(0.0f, 0.0f, 0.0f, 1.0f),
+		react::quatf(0.0f, 0.0f, 0.0f, -1.0f),
+		react::quatf(-1.0f, 0.0f, 0.0f, 0.0f),
+		react::quatf(0.5f, 0.5f, 0.5f, 0.5f),
+		react::quatf(-0.5f, 0.5f, -0.5f, 0.5f),
+		react::quatf(0.70710678f, 0.0f, -0.70710678f, 0.0f)
+	};
+
+	for (size_t i = q.size(); i < count; ++i)
+	{
+		float a = static_cast<float>(i);
+		react::quatf r(sin(a * 1.37f), cos(a * 0.71f), sin(a * 2.3f + 1.0f), cos(a * 0.13f));
+
+		q.push_back(r * (1.0f / r.length()));
+	}
+
+	return q;
+}
+
+// the rotation angle between a and b from the chord to the nearer of b and -b, acos of the dot product would be
+// swamped by the float rounding of the lengths
+static double quat_pack_test_angle(const react::quatf& a, const react::quatf& b)
+{
+	double plus = 0.0;
+	double minus = 0.0;
+
+	for (int k = 0; k < 4; ++k)
+	{
+		plus += (double(a.m_data[k]) - b.m_data[k]) * (double(a.m_data[k]) - b.m_data[k]);
+		minus += (double(a.m_data[k]) + b.m_data[k]) * (double(a.m_data[k]) + b.m_data[k]);
+	}
+
+	return 4.0 * asin(std::min(1.0, sqrt(std::min(plus, minus)) * 0.5));
+}
+
+template <typename P>
+static void quat_pack_test_format()
+{
+	std::vector<react::quatf> q = quat_pack_test_rotations(10003);
+	std::vector<P> batch(q.size());
+	std::vector<P> threaded(q.size());
+	std::vector<react::quatf> decoded(q.size());
+
+	react::quat_pack(q.data(), q.size(), batch.data());
+	react::quat_pack(q.data(), q.size(), threaded.data(), true);
+	react::quat_unpack(batch.data(), batch.size(), decoded.data());
+
+	bool same_bits = std::memcmp(batch.data(), threaded.data(), batch.size() * sizeof(P)) == 0;
+	bool same_decode = true;
+	double worst = 0.0;
+
+	for (size_t i = 0; i < q.size(); ++i)
+	{
+		// the SSE batch and the scalar single encode agree bit for bit
+		P one;
+		react::quat_pack(q[i], one);
+		same_bits = same_bits && std::memcmp(&one, &batch[i], sizeof(P)) == 0;
+
+		react::quatf back;
+		react::quat_unpack(one, back);
+		same_decode = same_decode && quat_pack_test_angle(back, decoded[i]) < 1e-5;
+
+		worst = std::max(worst, quat_pack_test_angle(q[i], decoded[i]));
+	}
+
+	// a strided span of x, y, z, w six floats apart encodes and decodes as the array does
+	std::vector<float> interleaved(q.size() * 6, 2.0f);
+	react::vec_span<4, float> strided(interleaved.data(), q.size(), 6 * sizeof(float));
+	std::vector<P> from_span(q.size());
+
+	for (size_t i = 0; i < q.size(); ++i)
+		strided[i] = react::vec4f(q[i].x(), q[i].y(), q[i].z(), q[i].w());
+
+	react::quat_pack(strided, from_span.data(), true);
+	std::fill(interleaved.begin(), interleaved.end(), 2.0f);
+	react::quat_unpack(batch.data(), strided);
+
+	same_bits = same_bits && std::memcmp(from_span.data(), batch.data(), batch.size() * sizeof(P)) == 0;
+
+	for (size_t i = 0; i < q.size(); ++i)
+	{
+		same_decode = same_decode && std::memcmp(&strided[i], &decoded[i], sizeof(react::quatf)) == 0;
+		same_decode = same_decode && interleaved[i * 6 + 4] == 2.0f && interleaved[i * 6 + 5] == 2.0f;
+	}
+
+	BOOST_TEST(same_bits);
+	BOOST_TEST(same_decode);
+	BOOST_TEST(worst <= P::max_angle());
+
+	// double quaternions encode through float to the same bits
+	react::quatd qd(q[1234].x(), q[1234].y(), q[1234].z(), q[1234].w());
+	P pd;
+	react::quat_pack(qd, pd);
+
+	BOOST_TEST(std::memcmp(&pd, &batch[1234], sizeof(P)) == 0);
+}
+
+BOOST_AUTO_TEST_SUITE(quat_pack)
+
+BOOST_AUTO_TEST_CASE(quat_pack_sizes)
+{
+	BOOST_TEST(sizeof(react::packed_quat32) == 4u);
+	BOOST_TEST(sizeof(react::packed_quat48) == 6u);
+	BOOST_TEST(sizeof(react::packed_quat64) == 8u);
+
+	BOOST_TEST(react::packed_quat32::max_angle() > react::packed_quat48::max_angle());
+}
+
+BOOST_AUTO_TEST_CASE(quat_pack_smallest_three)
+{
+	quat_pack_test_format<react::packed_quat32>();
+	quat_pack_test_format<react::packed_quat48>();
+
+	// identity drops w, and its three zeros sit at the middle of the code range
+	react::packed_quat32 p;
+	react::quat_pack(react::quatf::IDENTITY, p);
+
+	BOOST_TEST((p.bits >> 30) == 3u);
+	BOOST_TEST(((p.bits >> 20) & 0x3ffu) == 512u);
+
+	react::quatf q;
+	react::quat_unpack(p, q);
+
+	BOOST_TEST(quat_pack_test_angle(q, react::quatf::IDENTITY) <= react::packed_quat32::max_angle());
+
+	// -q packs as q
+	react::packed_quat32 negated;
+	react::quat_pack(react::quatf(-0.1f, 0.2f, -0.3f, -0.92736185f), p);
+	react::quat_pack(react::quatf(0.1f, -0.2f, 0.3f, 0.92736185f), negated);
+
+	BOOST_TEST(p.bits == negated.bits);
+}
+
+BOOST_AUTO_TEST_CASE(quat_pack_snorm16)
+{
+	quat_pack_test_format<react::packed_quat64>();
+
+	react::packed_quat64 p;
+	react::quat_pack(react::quatf(0.0f, -1.0f, 0.0f, 0.0f), p);
+
+	BOOST_TEST(p.bits[1] == -32767);
+	BOOST_TEST(p.bits[3] == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,266 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <React-Math.h>
+
+BOOST_AUTO_TEST_SUITE(ray)
+
+BOOST_AUTO_TEST_CASE(ray_at)
+{
+	react::rayf A(react::vec3f(1.0f, 2.0f, 3.0f), react::vec3f(0.0f, 0.0f, -1.0f));
+
+	react::vec3f truth(1.0f, 2.0f, -2.0f);
+
+	BOOST_TEST(A.at(5.0f) == truth);
+}
+
+BOOST_AUTO_TEST_CASE(ray_triangle)
+{
+	react::vec3f v0(-1.0f, -1.0f, -5.0f), v1(1.0f, -1.0f, -5.0f), v2(0.0f, 1.0f, -5.0f);
+
+	react::rayf A(react::vec3f(0.0f, 0.0f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f));
+	react::rayf B(react::vec3f(2.0f, 0.0f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f));
+	react::rayf C(react::vec3f(0.0f, 0.0f, 0.0f), react::vec3f(0.0f, 0.0f, 1.0f));
+
+	float t = 0.0f, u = 0.0f, v = 0.0f;
+
+	BOOST_CHECK(A.intersects(v0, v1, v2, t, u, v) == true);
+	BOOST_TEST(t == 5.0f);
+	BOOST_TEST(u == 0.25f);
+	BOOST_TEST(v == 0.5f);
+
+	BOOST_CHECK(A.intersects(v0, v1, v2, t, u, v, 4.0f) == false);
+	BOOST_CHECK(B.intersects(v0, v1, v2, t, u, v) == false);
+	BOOST_CHECK(C.intersects(v0, v1, v2, t, u, v) == false);
+}
+
+BOOST_AUTO_TEST_CASE(ray_aabb)
+{
+	react::aabbf box(react::vec3f(-1.0f, -1.0f, -6.0f), react::vec3f(1.0f, 1.0f, -4.0f));
+
+	react::rayf A(react::vec3f(0.0f, 0.0f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f));
+	react::rayf B(react::vec3f(0.0f, 2.0f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f));
+	react::rayf C(react::vec3f(0.0f, 0.0f, -5.0f), react::vec3f(1.0f, 0.0f, 0.0f));
+
+	float t_near = 0.0f, t_far = 0.0f;
+
+	BOOST_CHECK(A.intersects(box, t_near, t_far) == true);
+	BOOST_TEST(t_near == 4.0f);
+	BOOST_TEST(t_far == 6.0f);
+
+	BOOST_CHECK(B.intersects(box, t_near, t_far) == false);
+	BOOST_CHECK(A.intersects(box, t_near, t_far, 3.0f) == false);
+
+	BOOST_CHECK(C.intersects(box, t_near, t_far) == true);
+	BOOST_TEST(t_near == -1.0f);
+	BOOST_TEST(t_far == 1.0f);
+}
+
+template <typename T, size_t W>
+static void ray_check_packet()
+{
+	react::vec3<T> v0(-1, -1, -5), v1(1, -1, -5), v2(0, 1, -5);
+	react::aabb<T> box(react::vec3<T>(-1, -1, -6), react::vec3<T>(1, 1, -4));
+
+	react::ray<T> rays[W];
+
+	for (size_t i = 0; i < W; ++i)
+		rays[i] = react::ray<T>(react::vec3<T>(static_cast<T>(i) * static_cast<T>(0.3), 0, 0), react::vec3<T>(0, 0, -1));
+
+	react::ray_packet<T, W> packet;
+	packet.load(rays, W);
+
+	T t[W], u[W], v[W], t_max[W], t_near[W];
+
+	for (size_t i = 0; i < W; ++i)
+	{
+		t[i] = t_max[i] = std::numeric_limits<T>::infinity();
+		u[i] = v[i] = t_near[i] = 0;
+	}
+
+	int triangle_mask = react::intersect(packet, v0, v1, v2, t, u, v);
+	int box_mask = react::intersect(packet, box, t_max, t_near);
+
+	for (size_t i = 0; i < W; ++i)
+	{
+		T tt = 0, uu = 0, vv = 0, t0 = 0, t1 = 0;
+
+		bool triangle_hit = rays[i].intersects(v0, v1, v2, tt, uu, vv);
+		bool box_hit = rays[i].intersects(box, t0, t1);
+
+		BOOST_CHECK(((triangle_mask >> i) & 1) == triangle_hit);
+		BOOST_CHECK(((box_mask >> i) & 1) == box_hit);
+
+		if (triangle_hit)
+		{
+			BOOST_TEST(t[i] == tt, boost::test_tools::tolerance(static_cast<T>(1e-5)));
+			BOOST_TEST(u[i] == uu, boost::test_tools::tolerance(static_cast<T>(1e-5)));
+		}
+
+		if (box_hit)
+			BOOST_TEST(t_near[i] == t0, boost::test_tools::tolerance(static_cast<T>(1e-5)));
+	}
+}
+
+// rays in the planes of the faces, from inside, behind and exactly t_max short of the box: each lane of the packet
+// hits, and enters, exactly where the scalar test does
+template <typename T, size_t W>
+static void ray_check_packet_slab()
+{
+	react::aabb<T> box(react::vec3<T>(-1, -1, -1), react::vec3<T>(1, 1, 1));
+
+	const react::ray<T> cases[] = {
+		react::ray<T>(react::vec3<T>(1, 0, 5), react::vec3<T>(0, 0, -1)),
+		react::ray<T>(react::vec3<T>(-1, 0, 5), react::vec3<T>(0, 0, -1)),
+		react::ray<T>(react::vec3<T>(1, 1, 5), react::vec3<T>(-static_cast<T>(0), -static_cast<T>(0), -1)),
+		react::ray<T>(react::vec3<T>(0, 0, 0), react::vec3<T>(0, 1, 0)),
+		react::ray<T>(react::vec3<T>(0, 0, 5), react::vec3<T>(0, 0, 1)),
+		react::ray<T>(react::vec3<T>(0, 0, 5), react::vec3<T>(0, 0, -1)),
+		react::ray<T>(react::vec3<T>(2, 0, 5), react::vec3<T>(0, 0, -1)),
+		react::ray<T>(react::vec3<T>(0, 0, 1), react::vec3<T>(0, 0, 1))
+	};
+
+	const bool truth[] = { true, true, true, true, false, false, false, true };
+	const size_t count = sizeof(cases) / sizeof(cases[0]);
+
+	for (size_t first = 0; first < count; first += W)
+	{
+		react::ray_packet<T, W> packet;
+		packet.load(cases + first, std::min(W, count - first));
+
+		T t_max[W], t_near[W];
+
+		for (size_t i = 0; i < W; ++i)
+		{
+			// the sixth ray enters at exactly 4, which t_max excludes
+			t_max[i] = first + i == 5 ? static_cast<T>(4) : std::numeric_limits<T>::infinity();
+			t_near[i] = 0;
+		}
+
+		int mask = react::intersect(packet, box, t_max, t_near);
+
+		for (size_t i = 0; i < W && first + i < count; ++i)
+		{
+			T t0 = 0, t1 = 0;
+			bool hit = cases[first + i].intersects(box, t0, t1, t_max[i]);
+
+			BOOST_TEST(hit == truth[first + i]);
+			BOOST_TEST(((mask >> i) & 1) == int(hit));
+
+			if (hit)
+				BOOST_TEST(t_near[i] == t0);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ray_packets)
+{
+	ray_check_packet<float, 4>();
+	ray_check_packet<float, 8>();
+	ray_check_packet<double, 4>();
+}
+
+BOOST_AUTO_TEST_CASE(ray_packet_slab)
+{
+	ray_check_packet_slab<float, 4>();
+	ray_check_packet_slab<float, 8>();
+	ray_check_packet_slab<double, 4>();
+}
+
+template <size_t W>
+static void ray_check_packet_scale(const react::vec3f& v0, const react::vec3f& v1, const react::vec3f& v2, const react::rayf& r, const bool& hit)
+{
+	react::rayf rays[W];
+
+	for (size_t i = 0; i < W; ++i)
+		rays[i] = r;
+
+	react::ray_packet<float, W> packet;
+	packet.load(rays, W);
+
+	float t[W], u[W], v[W];
+
+	for (size_t i = 0; i < W; ++i)
+	{
+		t[i] = std::numeric_limits<float>::infinity();
+		u[i] = v[i] = 0.0f;
+	}
+
+	BOOST_TEST(react::intersect(packet, v0, v1, v2, t, u, v) == (hit ? (1 << W) - 1 : 0));
+}
+
+BOOST_AUTO_TEST_CASE(ray_triangle_scale)
+{
+	// edges of 2e-4, the determinant is far below epsilon but the ray goes straight through the middle
+	react::vec3f v0(-1e-4f, -1e-4f, -5.0f), v1(1e-4f, -1e-4f, -5.0f), v2(0.0f, 1e-4f, -5.0f);
+	react::rayf A(react::vec3f(0.0f, 0.0f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f));
+
+	float t = 0.0f, u = 0.0f, v = 0.0f;
+
+	BOOST_CHECK(A.intersects(v0, v1, v2, t, u, v) == true);
+	BOOST_TEST(t == 5.0f);
+
+	ray_check_packet_scale<4>(v0, v1, v2, A, true);
+	ray_check_packet_scale<8>(v0, v1, v2, A, true);
+
+	// edges of 2e3 and a ray within 1e-8 of their plane, the determinant is large but the ray is parallel
+	react::vec3f w0(-1e3f, -1e3f, -5.0f), w1(1e3f, -1e3f, -5.0f), w2(0.0f, 1e3f, -5.0f);
+	react::rayf B(react::vec3f(-1e3f, 0.0f, -5.0f + 1e-5f), react::vec3f(1.0f, 0.0f, -1e-8f));
+
+	BOOST_CHECK(B.intersects(w0, w1, w2, t, u, v) == false);
+
+	ray_check_packet_scale<4>(w0, w1, w2, B, false);
+	ray_check_packet_scale<8>(w0, w1, w2, B, false);
+}
+
+BOOST_AUTO_TEST_CASE(ray_batch_closest_hit)
+{
+	// a stack of quads along -z, each made of two triangles
+	std::vector<react::vec3f> vertices;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		float z = -2.0f - 2.0f * static_cast<float>((i * 3) % 4);
+
+		vertices.push_back(react::vec3f(-2.0f, -2.0f, z));
+		vertices.push_back(react::vec3f(2.0f, -2.0f, z));
+		vertices.push_back(react::vec3f(2.0f, 2.0f, z));
+
+		vertices.push_back(react::vec3f(-2.0f, -2.0f, z));
+		vertices.push_back(react::vec3f(2.0f, 2.0f, z));
+		vertices.push_back(react::vec3f(-2.0f, 2.0f, z));
+	}
+
+	react::triangle_mesh<float> mesh = { vertices.data(), nullptr, vertices.size() / 3 };
+
+	std::vector<react::rayf> rays;
+
+	for (int i = 0; i < 37; ++i)
+		rays.push_back(react::rayf(react::vec3f(static_cast<float>(i % 6) - 2.6f, static_cast<float>(i % 5) - 2.2f, 0.0f), react::vec3f(0.0f, 0.0f, -1.0f)));
+
+	std::vector<react::ray_hit<float>> hits(rays.size());
+	std::vector<react::ray_hit<float>> hits_threaded(rays.size());
+
+	react::intersect_triangles(rays.data(), rays.size(), mesh, hits.data());
+	react::intersect_triangles(rays.data(), rays.size(), mesh, hits_threaded.data(), true);
+
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		bool inside = fabs(rays[i].origin.x()) < 2.0f && fabs(rays[i].origin.y()) < 2.0f;
+
+		BOOST_CHECK(hits[i].hit() == inside);
+		BOOST_CHECK(hits_threaded[i].hit() == inside);
+
+		if (inside)
+		{
+			BOOST_TEST(hits[i].t == 2.0f);
+			BOOST_CHECK(hits[i].primitive / 2 == 0u);
+			BOOST_CHECK(hits_threaded[i].primitive == hits[i].primitive);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <boost/test/unit_test.hpp>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-4f;
+
+BOOST_AUTO_TEST_SUITE(rigid_body)
+
+BOOST_AUTO_TEST_CASE(rigid_body_linear, *boost::unit_test::tolerance(tolerence))
+{
+	react::rigid_body_statef state;
+	state.gravity = react::vec3f(0.0f, -10.0f, 0.0f);
+
+	react::rigid_bodyf body;
+	body.position = react::vec3f(1.0f, 2.0f, 3.0f);
+	body.linear_velocity = react::vec3f(2.0f, 0.0f, -1.0f);
+	body.inverse_mass = 0.5f;
+
+	react::rigid_bodyf fixed = body;
+	fixed.inverse_mass = 0.0f;
+	fixed.linear_velocity = react::vec3f(0.0f);
+
+	size_t a = state.add(body);
+	size_t b = state.add(fixed);
+
+	BOOST_TEST(state.size() == 2u);
+
+	// semi-implicit Euler, the velocity is updated before the position
+	state.apply_force(a, react::vec3f(4.0f, 0.0f, 0.0f));
+	state.integrate(0.1f);
+
+	react::rigid_bodyf A = state.get(a);
+
+	BOOST_TEST(A.linear_velocity.x() == 2.2f);
+	BOOST_TEST(A.linear_velocity.y() == -1.0f);
+	BOOST_TEST(A.position.x() == 1.22f);
+	BOOST_TEST(A.position.y() == 1.9f);
+	BOOST_TEST(A.position.z() == 2.9f);
+
+	// forces are cleared by the step
+	state.integrate(0.1f);
+
+	BOOST_TEST(state.get(a).linear_velocity.x() == 2.2f);
+	BOOST_TEST(state.get(a).linear_velocity.y() == -2.0f);
+
+	// static bodies ignore gravity and forces
+	state.apply_force(b, react::vec3f(100.0f, 0.0f, 0.0f));
+	state.integrate(0.1f);
+
+	BOOST_TEST(state.get(b).position.x() == 1.0f);
+	BOOST_TEST(state.get(b).position.y() == 2.0f);
+}
+
+BOOST_AUTO_TEST_CASE(rigid_body_angular, *boost::unit_test::tolerance(tolerence))
+{
+	react::rigid_body_stated state;
+
+	// spinning freely at a constant rate about a fixed axis
+	react::rigid_bodyd body;
+	react::vec3d axis = react::vec3d(1.0, 2.0, -0.5).normalized();
+	body.angular_velocity = axis * 2.0;
+
+	state.add(body);
+
+	for (int i = 0; i < 1000; ++i)
+		state.integrate(0.001);
+
+	react::quatd expected(axis, 2.0);
+	react::quatd q = state.get(0).orientation;
+
+	BOOST_TEST(std::abs(q.dot(expected)) == 1.0, boost::test_tools::tolerance(1e-6));
+	BOOST_TEST(q.length() == 1.0, boost::test_tools::tolerance(1e-12));
+
+	// torque is mapped through the inertia tensor rotated into world space
+	react::rigid_bodyd turned;
+	turned.orientation = react::quatd(react::vec3d(0.3, 1.0, 0.2), 0.8);
+	turned.inverse_inertia = react::vec3d(1.0, 0.25, 0.5);
+
+	size_t b = state.add(turned);
+	react::vec3d torque(1.0, -2.0, 0.5);
+
+	react::mat3d inertia = state.world_inverse_inertia(b);
+	react::vec3d expected_w(inertia.row(0).dot(torque), inertia.row(1).dot(torque), inertia.row(2).dot(torque));
+
+	state.apply_torque(b, torque);
+	state.integrate(0.01);
+
+	react::vec3d w = state.get(b).angular_velocity;
+
+	for (size_t k = 0; k < 3; ++k)
+		BOOST_TEST(w[k] == 0.01 * expected_w[k], boost::test_tools::tolerance(1e-12));
+
+	// a force off the centre of mass adds the torque arm x force
+	react::rigid_body_stated pushed;
+	pushed.add(react::rigid_bodyd());
+	pushed.apply_force(0, react::vec3d(0.0, 1.0, 0.0), react::vec3d(1.0, 0.0, 0.0));
+	pushed.integrate(1.0);
+
+	BOOST_TEST(pushed.get(0).angular_velocity.z() == 1.0, boost::test_tools::tolerance(1e-12));
+	BOOST_TEST(pushed.get(0).linear_velocity.y() == 1.0, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(rigid_body_batch, *boost::unit_test::tolerance(tolerence))
+{
+	// the SIMD and threaded batch agrees with bodies integrated one at a time
+	react::rigid_body_statef state;
+	state.gravity = react::vec3f(0.0f, -9.81f, 0.0f);
+
+	std::vector<react::rigid_body_statef> single(37);
+
+	for (size_t i = 0; i < single.size(); ++i)
+	{
+		react::rigid_bodyf body;
+		body.position = react::vec3f(sin(i * 1.0f), cos(i * 2.0f), i * 0.1f);
+		body.orientation = react::quatf(react::vec3f(sin(i * 3.0f), 1.0f, cos(i * 1.5f)), i * 0.2f);
+		body.linear_velocity = react::vec3f(cos(i * 0.5f), 1.0f, 0.0f);
+		body.angular_velocity = react::vec3f(sin(i * 0.7f), cos(i * 0.9f), 0.5f) * 3.0f;
+		body.inverse_mass = i % 5 == 0 ? 0.0f : 1.0f / (1.0f + i);
+		body.inverse_inertia = react::vec3f(1.0f, 0.5f, 2.0f);
+
+		state.add(body);
+		single[i].gravity = state.gravity;
+		single[i].add(body);
+	}
+
+	for (int step = 0; step < 10; ++step)
+	{
+		for (size_t i = 0; i < single.size(); ++i)
+		{
+			react::vec3f torque(1.0f, step * 0.1f, -0.5f);
+
+			state.apply_torque(i, torque);
+			single[i].apply_torque(0, torque);
+			single[i].integrate(1.0f / 60.0f);
+		}
+
+		state.integrate(1.0f / 60.0f, true);
+	}
+
+	for (size_t i = 0; i < single.size(); ++i)
+	{
+		react::rigid_bodyf a = state.get(i);
+		react::rigid_bodyf b = single[i].get(0);
+
+		// shifted away from zero for the relative tolerance
+		for (size_t k = 0; k < 3; ++k)
+		{
+			BOOST_TEST(a.position[k] + 10.0f == b.position[k] + 10.0f);
+			BOOST_TEST(a.linear_velocity[k] + 10.0f == b.linear_velocity[k] + 10.0f);
+			BOOST_TEST(a.angular_velocity[k] + 10.0f == b.angular_velocity[k] + 10.0f);
+		}
+
+		for (size_t k = 0; k < 4; ++k)
+			BOOST_TEST(a.orientation[k] + 2.0f == b.orientation[k] + 2.0f);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
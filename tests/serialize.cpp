@@ -0,0 +1,275 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include <React-Math.h>
+
+static const char* serialize_test_path = "react_serialize_test.blob";
+
+static std::vector<react::quatf> serialize_test_rotations(const size_t& count)
+{
+	std::vector<react::quatf> q;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float a = static_cast<float>(i);
+
+		q.push_back(react::quatf(react::vec3f(sin(a * 1.3f), cos(a * 0.7f), 0.5f), a * 0.01f));
+	}
+
+	return q;
+}
+
+BOOST_AUTO_TEST_SUITE(serialize)
+
+BOOST_AUTO_TEST_CASE(serialize_round_trip)
+{
+	std::vector<react::mat4f> m(1000);
+
+	for (size_t i = 0; i < m.size(); ++i)
+		for (size_t k = 0; k < 16; ++k)
+			m[i].m_data[k] = static_cast<float>(i * 16 + k);
+
+	BOOST_TEST((react::save_blob(serialize_test_path, m.data(), m.size()) == react::blob_status::ok));
+
+	std::vector<react::mat4f> loaded;
+
+	BOOST_TEST((react::load_blob(serialize_test_path, loaded) == react::blob_status::ok));
+	BOOST_TEST(loaded.size() == m.size());
+	BOOST_TEST((loaded == m));
+
+	// the element type is part of the header
+	std::vector<react::mat4d> wrong_scalar;
+	std::vector<react::mat3f> wrong_shape;
+	std::vector<react::quatf> wrong_kind;
+
+	BOOST_TEST((react::load_blob(serialize_test_path, wrong_scalar) == react::blob_status::type_mismatch));
+	BOOST_TEST((react::load_blob(serialize_test_path, wrong_shape) == react::blob_status::type_mismatch));
+	BOOST_TEST((react::load_blob(serialize_test_path, wrong_kind) == react::blob_status::type_mismatch));
+	BOOST_TEST((react::load_blob("react_serialize_missing.blob", loaded) == react::blob_status::open_failed));
+
+	// dimensions past 255 survive the header
+	typedef react::support::vector<300, float> wide;
+	std::vector<wide> w(7);
+
+	for (size_t i = 0; i < w.size(); ++i)
+		for (size_t k = 0; k < 300; ++k)
+			w[i][k] = static_cast<float>(i * 300 + k);
+
+	BOOST_TEST((react::save_blob(serialize_test_path, w.data(), w.size()) == react::blob_status::ok));
+
+	std::vector<wide> wide_loaded;
+	std::vector<react::support::vector<44, float>> wrapped;
+
+	BOOST_TEST((react::load_blob(serialize_test_path, wide_loaded) == react::blob_status::ok));
+	BOOST_TEST((wide_loaded == w));
+	BOOST_TEST((react::load_blob(serialize_test_path, wrapped) == react::blob_status::type_mismatch));
+
+	std::remove(serialize_test_path);
+}
+
+BOOST_AUTO_TEST_CASE(serialize_bad_sizes)
+{
+	// a well formed header whose data would run past the end of the address space
+	react::blob_header h = react::support::blob_header_for<react::vec4f>();
+	h.data_offset = 64;
+	h.count = (std::numeric_limits<uint64_t>::max() - 32) / 16;
+	h.data_bytes = h.count * 16;
+
+	unsigned char bytes[react::blob_header::SIZE];
+	react::support::encode_blob_header(h, bytes);
+
+	react::blob_header decoded;
+
+	BOOST_TEST((react::support::decode_blob_header(bytes, sizeof(bytes), decoded) == react::blob_status::bad_header));
+
+	// one that fits the arithmetic but not the file
+	h.count = 1000;
+	h.data_bytes = h.count * 16;
+	react::support::encode_blob_header(h, bytes);
+
+	std::FILE* f = std::fopen(serialize_test_path, "wb");
+	std::fwrite(bytes, 1, sizeof(bytes), f);
+	std::fclose(f);
+
+	react::mapped_blob<react::vec4f> mapped;
+
+	BOOST_TEST((mapped.open(serialize_test_path) == react::blob_status::truncated));
+
+	mapped.close();
+
+	// the reader refuses it before allocating, even for a count far beyond memory
+	h.count = uint64_t(1) << 40;
+	h.data_bytes = h.count * 16;
+	react::support::encode_blob_header(h, bytes);
+
+	f = std::fopen(serialize_test_path, "wb");
+	std::fwrite(bytes, 1, sizeof(bytes), f);
+	std::fclose(f);
+
+	std::vector<react::vec4f> loaded(3);
+
+	BOOST_TEST((react::load_blob(serialize_test_path, loaded) == react::blob_status::truncated));
+	BOOST_TEST(loaded.empty());
+
+	std::remove(serialize_test_path);
+}
+
+BOOST_AUTO_TEST_CASE(serialize_mapped)
+{
+	std::vector<react::quatf> q = serialize_test_rotations(5000);
+
+	react::blob_options options;
+	options.alignment = 4096;
+
+	BOOST_TEST((react::save_blob(serialize_test_path, q.data(), q.size(), options) == react::blob_status::ok));
+
+	{
+		react::mapped_blob<react::quatf> mapped;
+
+		BOOST_TEST((mapped.open(serialize_test_path) == react::blob_status::ok));
+		BOOST_TEST(mapped.size() == q.size());
+		BOOST_TEST(mapped.header().data_offset == 4096u);
+		BOOST_TEST(reinterpret_cast<uintptr_t>(mapped.data()) % 4096 == 0u);
+		BOOST_TEST((mapped[1234] == q[1234]));
+		BOOST_TEST((mapped.verify() == react::blob_status::ok));
+		BOOST_TEST((mapped.verify(true) == react::blob_status::ok));
+
+		react::mapped_blob<react::vec4f> wrong;
+
+		BOOST_TEST((wrong.open(serialize_test_path) == react::blob_status::type_mismatch));
+	}
+
+	// flip one bit of the data, the header still reads but the checksum fails
+	std::FILE* f = std::fopen(serialize_test_path, "r+b");
+	std::fseek(f, 4096 + 777, SEEK_SET);
+	int c = std::fgetc(f);
+	std::fseek(f, 4096 + 777, SEEK_SET);
+	std::fputc(c ^ 4, f);
+	std::fclose(f);
+
+	react::mapped_blob<react::quatf> mapped;
+
+	BOOST_TEST((mapped.open(serialize_test_path) == react::blob_status::ok));
+	BOOST_TEST((mapped.verify(true) == react::blob_status::checksum_mismatch));
+
+	std::vector<react::quatf> loaded;
+
+	BOOST_TEST((react::load_blob(serialize_test_path, loaded) == react::blob_status::checksum_mismatch));
+	BOOST_TEST((react::load_blob(serialize_test_path, loaded, false) == react::blob_status::ok));
+
+	mapped.close();
+
+	// a damaged header is refused outright
+	f = std::fopen(serialize_test_path, "r+b");
+	std::fseek(f, 16, SEEK_SET);
+	std::fputc(0x55, f);
+	std::fclose(f);
+
+	BOOST_TEST((mapped.open(serialize_test_path) == react::blob_status::bad_header));
+
+	std::remove(serialize_test_path);
+}
+
+BOOST_AUTO_TEST_CASE(serialize_streaming)
+{
+	// positions of an interleaved buffer, written from a span in pieces that do not line up with checksum blocks
+	const size_t count = 300000;
+	std::vector<float> vertices(count * 8);
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+		vertices[i] = static_cast<float>(i % 1013) * 0.25f;
+
+	react::vec_span<3, const float> positions(vertices.data(), count, 8 * sizeof(float));
+
+	react::blob_writer<react::vec3f> writer;
+
+	BOOST_TEST((writer.open(serialize_test_path) == react::blob_status::ok));
+
+	for (size_t i = 0; i < count; i += 70001)
+	{
+		size_t n = std::min<size_t>(70001, count - i);
+
+		BOOST_TEST((writer.write(react::vec_span<3, const float>(positions.data() + 8 * i, n, positions.stride())) == react::blob_status::ok));
+	}
+
+	BOOST_TEST(writer.count() == count);
+	BOOST_TEST((writer.close() == react::blob_status::ok));
+
+	react::blob_reader<react::vec3f> reader;
+	std::vector<react::vec3f> chunk(12345);
+	size_t read = 0;
+	bool same = true;
+
+	BOOST_TEST((reader.open(serialize_test_path, true) == react::blob_status::ok));
+	BOOST_TEST(reader.remaining() == count);
+
+	while (size_t n = reader.read(chunk.data(), chunk.size()))
+	{
+		for (size_t k = 0; k < n; ++k)
+			same = same && chunk[k] == positions[read + k];
+
+		read += n;
+	}
+
+	BOOST_TEST(same);
+	BOOST_TEST(read == count);
+	BOOST_TEST((reader.finish() == react::blob_status::ok));
+
+	// the streamed checksum is the one computed over the mapped data
+	react::mapped_blob<react::vec3f> mapped;
+
+	BOOST_TEST((mapped.open(serialize_test_path, true) == react::blob_status::ok));
+	BOOST_TEST((mapped.verify(true) == react::blob_status::ok));
+
+	std::remove(serialize_test_path);
+}
+
+BOOST_AUTO_TEST_CASE(serialize_octahedral)
+{
+	std::vector<react::vec3f> n;
+
+	for (size_t i = 0; i < 3000; ++i)
+	{
+		float a = static_cast<float>(i);
+
+		n.push_back(react::vec3f(sin(a * 1.3f), cos(a * 0.7f), sin(a * 0.2f) - 0.5f).normalized());
+	}
+
+	std::vector<react::packed_normal24> packed(n.size());
+	react::normal_pack(n.data(), n.size(), packed.data(), react::octahedral_mode::precise);
+
+	BOOST_TEST((react::save_blob(serialize_test_path, packed.data(), packed.size()) == react::blob_status::ok));
+
+	react::mapped_blob<react::packed_normal24> mapped;
+
+	BOOST_TEST((mapped.open(serialize_test_path) == react::blob_status::ok));
+	BOOST_TEST((mapped.verify() == react::blob_status::ok));
+	BOOST_TEST(mapped.size() == packed.size());
+
+	std::vector<react::vec3f> back(n.size());
+	react::normal_unpack(mapped.data(), mapped.size(), back.data());
+
+	bool close = true;
+
+	for (size_t i = 0; i < n.size(); ++i)
+		close = close && (back[i] - n[i]).length() < 1e-3f;
+
+	BOOST_TEST(close);
+
+	// the three formats are told apart by their storage
+	std::vector<react::packed_normal16> narrow;
+	std::vector<react::packed_normal32> wide;
+	std::vector<react::vec3<uint8_t>> bytes;
+
+	BOOST_TEST((react::load_blob(serialize_test_path, narrow) == react::blob_status::type_mismatch));
+	BOOST_TEST((react::load_blob(serialize_test_path, wide) == react::blob_status::type_mismatch));
+	BOOST_TEST((react::load_blob(serialize_test_path, bytes) == react::blob_status::type_mismatch));
+
+	mapped.close();
+	std::remove(serialize_test_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
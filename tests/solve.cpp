@@ -0,0 +1,193 @@
+#include <boost/test/unit_test.hpp>
+
+#include <React-Math.h>
+
+BOOST_AUTO_TEST_SUITE(solve)
+
+BOOST_AUTO_TEST_CASE(solve_cholesky, *boost::unit_test::tolerance(1e-9))
+{
+	// symmetric positive definite
+	react::mat4d A({ 4.0, 1.0, -1.0, 0.5, 1.0, 3.0, 0.2, 0.0, -1.0, 0.2, 5.0, 1.0, 0.5, 0.0, 1.0, 2.0 });
+	react::vec4d b(1.0, -2.0, 0.5, 3.0);
+
+	react::cholesky<4, double> C(A);
+
+	BOOST_TEST(C.valid());
+
+	react::vec4d x(C.solve(b));
+
+	for (size_t row = 0; row < 4; ++row)
+		BOOST_TEST(react::vec4d(A.row(row)).dot(x) == b[row]);
+
+	// L L^T reproduces A
+	react::mat4d LLt = C.l.dot(C.l.transpose());
+
+	for (size_t k = 0; k < 16; ++k)
+		BOOST_TEST(LLt.m_data[k] == A.m_data[k]);
+
+	// indefinite matrices are rejected
+	react::mat3d B({ 1.0, 2.0, 0.0, 2.0, 1.0, 0.0, 0.0, 0.0, 1.0 });
+
+	react::cholesky<3, double> indefinite(B);
+
+	BOOST_TEST(!indefinite.valid());
+}
+
+BOOST_AUTO_TEST_CASE(solve_lu, *boost::unit_test::tolerance(1e-9))
+{
+	// needs pivoting, the first diagonal entry is zero
+	react::mat4d A({ 0.0, 2.0, 1.0, -1.0, 3.0, 1.0, 0.0, 2.0, 1.0, -1.0, 4.0, 0.5, 2.0, 0.0, 1.0, 1.0 });
+	react::vec4d b(1.0, 2.0, 3.0, 4.0);
+
+	react::lu<4, double> L(A);
+
+	BOOST_TEST(L.valid());
+	BOOST_TEST(L.determinant() == A.determinant());
+
+	react::vec4d x(L.solve(b));
+
+	for (size_t row = 0; row < 4; ++row)
+		BOOST_TEST(react::vec4d(A.row(row)).dot(x) == b[row]);
+
+	react::mat3d S({ 1.0, 2.0, 3.0, 2.0, 4.0, 6.0, 0.0, 1.0, 1.0 });
+
+	react::lu<3, double> singular(S);
+
+	BOOST_TEST(!singular.valid());
+	BOOST_TEST(singular.determinant() == 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(solve_qr, *boost::unit_test::tolerance(1e-9))
+{
+	// 12 x 6
+	react::support::matrix<6, 12, double> A;
+
+	for (size_t row = 0; row < 12; ++row)
+		for (size_t col = 0; col < 6; ++col)
+			A.at(row, col) = sin(row * 1.7 + col * 0.9) + (row == col ? 2.0 : 0.0);
+
+	react::qr<6, 12, double> f(A);
+
+	BOOST_TEST(f.valid());
+
+	react::support::matrix<6, 12, double> Q = f.q();
+	react::support::matrix<6, 6, double> R = f.r();
+	react::support::matrix<6, 6, double> QtQ = Q.transpose().dot(Q);
+	react::support::matrix<6, 12, double> QR = Q.dot(R);
+
+	for (size_t row = 0; row < 6; ++row)
+	{
+		for (size_t col = 0; col < 6; ++col)
+		{
+			// shifted away from zero for the relative tolerance
+			BOOST_TEST(QtQ.at(row, col) + 1.0 == (row == col ? 2.0 : 1.0));
+
+			if (col < row)
+				BOOST_TEST(R.at(row, col) + 1.0 == 1.0);
+		}
+	}
+
+	for (size_t k = 0; k < 72; ++k)
+		BOOST_TEST(QR.m_data[k] + 10.0 == A.m_data[k] + 10.0);
+
+	// repeated columns are rank deficient
+	react::support::matrix<3, 5, double> B;
+
+	for (size_t row = 0; row < 5; ++row)
+		B.set_row(react::vec3d(row + 1.0, 2.0 * row + 2.0, 1.0), row);
+
+	react::qr<3, 5, double> g(B);
+
+	BOOST_TEST(!g.valid());
+}
+
+BOOST_AUTO_TEST_CASE(solve_least_squares, *boost::unit_test::tolerance(1e-9))
+{
+	// fit the plane z = 0.5 x - 2 y + 3 to 30 points with a little deterministic noise
+	react::support::matrix<3, 30, double> A;
+	react::support::vector<30, double> b;
+
+	for (size_t i = 0; i < 30; ++i)
+	{
+		double x = sin(i * 0.7) * 4.0;
+		double y = cos(i * 1.3) * 3.0;
+
+		A.set_row(react::vec3d(x, y, 1.0), i);
+		b[i] = 0.5 * x - 2.0 * y + 3.0 + 0.01 * sin(i * 5.1);
+	}
+
+	react::vec3d x(react::least_squares(A, b));
+
+	// the normal equations give the same answer on this well conditioned system
+	react::mat3d AtA(A.transpose().dot(A));
+	react::support::vector<3, double> Atb;
+
+	for (size_t i = 0; i < 3; ++i)
+		Atb[i] = A.col(i).dot(b);
+
+	react::vec3d y(react::lu<3, double>(AtA).solve(Atb));
+
+	BOOST_TEST(x[0] == y[0]);
+	BOOST_TEST(x[1] == y[1]);
+	BOOST_TEST(x[2] == y[2]);
+
+	BOOST_TEST(x[0] == 0.5, boost::test_tools::tolerance(1e-2));
+	BOOST_TEST(x[1] == -2.0, boost::test_tools::tolerance(1e-2));
+	BOOST_TEST(x[2] == 3.0, boost::test_tools::tolerance(1e-2));
+
+	// underdetermined, the minimum norm solution of x + y + z = 3, x - y = 0 is (1, 1, 1)
+	react::support::matrix<3, 2, double> C({ 1.0, 1.0, 1.0, -1.0, 1.0, 0.0 });
+	react::vec2d c(3.0, 0.0);
+
+	react::vec3d z(react::least_squares(C, c));
+
+	BOOST_TEST(z[0] == 1.0);
+	BOOST_TEST(z[1] == 1.0);
+	BOOST_TEST(z[2] == 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(solve_pseudo_inverse, *boost::unit_test::tolerance(1e-9))
+{
+	// full column rank, tall and wide, and rank deficient all satisfy the Penrose conditions A P A = A and P A P = P
+	react::support::matrix<4, 7, double> tall;
+	react::support::matrix<5, 3, double> wide;
+	react::support::matrix<3, 4, double> deficient;
+
+	for (size_t k = 0; k < 28; ++k)
+		tall.m_data[k] = sin(k * k * 0.37 + k);
+
+	for (size_t k = 0; k < 15; ++k)
+		wide.m_data[k] = cos(k * k * 0.53 + 0.2 * k);
+
+	for (size_t row = 0; row < 4; ++row)
+		deficient.set_row(react::vec3d(row + 1.0, 1.0 - row, 2.0), row);
+
+	react::support::matrix<7, 4, double> P = react::pseudo_inverse(tall);
+	react::support::matrix<4, 4, double> PA = P.dot(tall);
+
+	for (size_t row = 0; row < 4; ++row)
+		for (size_t col = 0; col < 4; ++col)
+			BOOST_TEST(PA.at(row, col) + 1.0 == (row == col ? 2.0 : 1.0));
+
+	react::support::matrix<3, 5, double> W = react::pseudo_inverse(wide);
+	react::support::matrix<5, 3, double> AWA = wide.dot(W).dot(wide);
+	react::support::matrix<3, 5, double> WAW = W.dot(wide).dot(W);
+
+	for (size_t k = 0; k < 15; ++k)
+	{
+		BOOST_TEST(AWA.m_data[k] + 10.0 == wide.m_data[k] + 10.0);
+		BOOST_TEST(WAW.m_data[k] + 10.0 == W.m_data[k] + 10.0);
+	}
+
+	react::support::matrix<4, 3, double> D = react::pseudo_inverse(deficient);
+	react::support::matrix<3, 4, double> ADA = deficient.dot(D).dot(deficient);
+	react::support::matrix<4, 3, double> DAD = D.dot(deficient).dot(D);
+
+	for (size_t k = 0; k < 12; ++k)
+	{
+		BOOST_TEST(ADA.m_data[k] + 10.0 == deficient.m_data[k] + 10.0);
+		BOOST_TEST(DAD.m_data[k] + 10.0 == D.m_data[k] + 10.0);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,215 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-4f;
+
+// position, normal and uv packed at a 32 byte stride, as a renderer would upload them
+struct span_test_vertex
+{
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+static std::vector<span_test_vertex> span_test_vertices(const size_t& count)
+{
+	std::vector<span_test_vertex> vertices(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float a = static_cast<float>(i);
+		react::vec3f p(3.0f * sin(a * 1.731f), 2.0f * cos(a * 0.917f + 0.3f) + 1.0f, sin(a * 0.377f + 1.1f) - 4.0f);
+		react::vec3f n(sin(a * 0.7f), cos(a * 1.3f), 0.5f);
+		n.normalize();
+
+		vertices[i] = { { p.x(), p.y(), p.z() }, { n.x(), n.y(), n.z() }, { a, -a } };
+	}
+
+	return vertices;
+}
+
+static std::vector<react::vec3f> span_test_positions(const std::vector<span_test_vertex>& vertices)
+{
+	std::vector<react::vec3f> positions;
+
+	for (const span_test_vertex& v : vertices)
+		positions.push_back(react::vec3f(v.position[0], v.position[1], v.position[2]));
+
+	return positions;
+}
+
+BOOST_AUTO_TEST_SUITE(span)
+
+BOOST_AUTO_TEST_CASE(span_layout)
+{
+	BOOST_TEST(sizeof(react::vec2f) == 2 * sizeof(float));
+	BOOST_TEST(sizeof(react::vec3f) == 3 * sizeof(float));
+	BOOST_TEST(sizeof(react::vec4d) == 4 * sizeof(double));
+	BOOST_TEST(sizeof(react::mat3f) == 9 * sizeof(float));
+	BOOST_TEST(sizeof(react::mat4f) == 16 * sizeof(float));
+	BOOST_TEST(sizeof(react::quatf) == 4 * sizeof(float));
+
+	float data[9] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f };
+
+	react::as_vec3(data + 3) *= 2.0f;
+
+	BOOST_TEST(data[2] == 3.0f);
+	BOOST_TEST(data[3] == 8.0f);
+	BOOST_TEST(data[5] == 12.0f);
+	BOOST_TEST(data[6] == 7.0f);
+
+	const float* read = data;
+
+	BOOST_TEST(react::as_vec3(read).dot(react::vec3f(1.0f, 0.0f, 0.0f)) == 1.0f);
+	BOOST_TEST(react::as_vec2(read + 7) == react::vec2f(8.0f, 9.0f));
+	BOOST_TEST(react::as_mat3(read).at(0, 1) == 8.0f);
+	BOOST_TEST(react::as_mat3(read).col(2) == react::vec3f(7.0f, 8.0f, 9.0f));
+}
+
+BOOST_AUTO_TEST_CASE(span_interleaved)
+{
+	std::vector<span_test_vertex> vertices = span_test_vertices(50);
+
+	float* base = vertices[0].position;
+	react::vec_span<3, float> positions(base, vertices.size(), sizeof(span_test_vertex));
+	react::vec_span<3, const float> normals(base + 3, vertices.size(), sizeof(span_test_vertex));
+	react::vec_span<2, const float> uvs(base + 6, vertices.size(), sizeof(span_test_vertex));
+
+	BOOST_TEST(positions.size() == 50u);
+	BOOST_TEST(positions.stride() == 32u);
+	BOOST_TEST(positions.component_stride() == 8u);
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		BOOST_TEST(positions[i].y() == vertices[i].position[1]);
+		BOOST_TEST(normals[i].z() == vertices[i].normal[2]);
+		BOOST_TEST(uvs[i].y() == -static_cast<float>(i));
+	}
+
+	// writes go to the buffer and leave the other attributes alone
+	positions[4] = react::vec3f(1.0f, 2.0f, 3.0f);
+	positions[5].x() += 1.0f;
+
+	BOOST_TEST(vertices[4].position[2] == 3.0f);
+	BOOST_TEST(vertices[4].normal[0] == normals[4].x());
+	BOOST_TEST(vertices[5].uv[0] == 5.0f);
+
+	// a writable span reads as a const one, and a packed array is a span at its natural stride
+	react::vec_span<3, const float> read = positions;
+
+	BOOST_TEST(read[4] == react::vec3f(1.0f, 2.0f, 3.0f));
+
+	std::vector<react::vec3f> packed = span_test_positions(vertices);
+	react::vec_span<3, const float> packed_span(packed.data(), packed.size());
+
+	BOOST_TEST(packed_span.stride() == sizeof(react::vec3f));
+	BOOST_TEST(packed_span[7] == packed[7]);
+}
+
+BOOST_AUTO_TEST_CASE(span_kernels, *boost::unit_test::tolerance(tolerence))
+{
+	std::vector<span_test_vertex> vertices = span_test_vertices(3000);
+	std::vector<react::vec3f> packed = span_test_positions(vertices);
+
+	react::vec_span<3, float> positions(vertices[0].position, vertices.size(), sizeof(span_test_vertex));
+
+	react::aabbf box = react::aabbf::from_points(positions);
+	react::aabbf packed_box = react::aabbf::from_points(packed.data(), packed.size());
+
+	BOOST_TEST((box.min == packed_box.min && box.max == packed_box.max));
+
+	react::covariance3f c(positions, true);
+	react::covariance3f packed_c(packed.data(), packed.size());
+
+	for (size_t k = 0; k < 3; ++k)
+		BOOST_TEST(c.mean()[k] == packed_c.mean()[k]);
+
+	for (size_t k = 0; k < 9; ++k)
+		BOOST_TEST(c.covariance().m_data[k] == packed_c.covariance().m_data[k]);
+
+	std::vector<uint32_t> codes(packed.size()), packed_codes(packed.size());
+
+	react::morton_encode(positions, box, codes.data(), true);
+	react::morton_encode(packed.data(), packed.size(), box, packed_codes.data());
+
+	BOOST_TEST(codes == packed_codes);
+
+	react::obbf fitted = react::obbf::fit(positions);
+	react::obbf packed_fitted = react::obbf::fit(packed.data(), packed.size());
+
+	BOOST_TEST(fitted.volume() == packed_fitted.volume());
+
+	// transform the positions in place, then align the packed copy onto them
+	react::rigid_transformf A(react::quatf(react::vec3f(1.0f, 2.0f, -1.0f), 0.8f), react::vec3f(1.0f, -2.0f, 3.0f));
+
+	react::rigid_transformf::apply(A, positions, positions, true);
+
+	for (size_t i = 0; i < packed.size(); i += 97)
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(positions[i][k] == A.apply(packed[i])[k]);
+
+	react::rigid_transformf found = react::align_rigid(react::vec_span<3, const float>(packed.data(), packed.size()), positions);
+
+	for (size_t k = 0; k < 3; ++k)
+		BOOST_TEST(found.apply(packed[11])[k] == positions[11][k]);
+}
+
+BOOST_AUTO_TEST_CASE(span_matrices, *boost::unit_test::tolerance(tolerence))
+{
+	// mat3 rotations interleaved with a per instance scalar
+	struct instance
+	{
+		float rotation[9];
+		float weight;
+	};
+
+	std::vector<instance> instances(40);
+	std::vector<react::mat3f> packed;
+
+	for (size_t i = 0; i < instances.size(); ++i)
+	{
+		react::mat3f m = react::quatf(react::vec3f(1.0f, static_cast<float>(i), 2.0f), 0.1f * static_cast<float>(i)).toMat3();
+
+		m.at(0, 1) += 0.01f;
+		m.at(2, 0) -= 0.02f;
+
+		packed.push_back(m);
+		std::copy(m.m_data, m.m_data + 9, instances[i].rotation);
+		instances[i].weight = static_cast<float>(i);
+	}
+
+	react::mat_span<3, 3, float> rotations(instances[0].rotation, instances.size(), sizeof(instance));
+
+	std::vector<react::svd3f> svd(instances.size()), packed_svd(instances.size());
+
+	react::svd3f::compute(rotations, svd.data());
+	react::svd3f::compute(packed.data(), packed.size(), packed_svd.data());
+
+	for (size_t i = 0; i < svd.size(); ++i)
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(svd[i].values[k] == packed_svd[i].values[k]);
+
+	std::vector<react::quatf> q(instances.size()), packed_q(instances.size());
+
+	react::polar3f::rotations(rotations, q.data(), true);
+	react::polar3f::rotations(packed.data(), packed.size(), packed_q.data());
+
+	react::orthonormalize(rotations, true);
+	react::orthonormalize(packed.data(), packed.size());
+
+	for (size_t i = 0; i < instances.size(); ++i)
+	{
+		BOOST_TEST(instances[i].weight == static_cast<float>(i));
+
+		for (size_t k = 0; k < 9; ++k)
+		{
+			BOOST_TEST(rotations[i].m_data[k] == packed[i].m_data[k]);
+			BOOST_TEST(q[i].toMat3().m_data[k] == packed_q[i].toMat3().m_data[k]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,272 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <React-Math.h>
+
+#include "test_points.h"
+
+BOOST_AUTO_TEST_SUITE(spatial_hash)
+
+BOOST_AUTO_TEST_CASE(spatial_hash_empty)
+{
+	react::spatial_hashf A(1.0f);
+	A.build(nullptr, 0);
+
+	std::vector<uint32_t> found;
+	uint32_t nearest[2];
+
+	BOOST_TEST(A.size() == 0);
+	BOOST_TEST(A.radius(react::vec3f(), 5.0f, found) == 0);
+	BOOST_TEST(A.nearest(react::vec3f(), 2, nearest) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_radius)
+{
+	std::vector<react::vec3f> points = test_points(2000, react::vec3f(0.0f), react::vec3f(10.0f));
+
+	react::spatial_hashf A(1.5f);
+	A.build(points.data(), points.size());
+
+	BOOST_TEST(A.size() == points.size());
+	BOOST_TEST(A.table_size() >= 2 * points.size());
+
+	for (size_t q = 0; q < 50; ++q)
+	{
+		react::vec3f c = points[q * 37] + react::vec3f(0.3f, -0.2f, 0.1f);
+		float r = 0.5f + static_cast<float>(q % 7) * 0.6f;
+
+		std::vector<uint32_t> found;
+		A.radius(c, r, found);
+		std::sort(found.begin(), found.end());
+
+		std::vector<uint32_t> truth = brute_radius(points, c, r);
+
+		BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), truth.begin(), truth.end());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_radius_batch)
+{
+	std::vector<react::vec3f> points = test_points(3000, react::vec3f(0.0f), react::vec3f(8.0f));
+	std::vector<react::vec3f> centers = test_points(500, react::vec3f(0.0f), react::vec3f(9.0f));
+
+	react::spatial_hashf A(1.0f);
+	A.build(points.data(), points.size());
+
+	for (bool parallel : { false, true })
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> indices;
+
+		A.radius(centers.data(), centers.size(), 1.2f, offsets, indices, parallel);
+
+		BOOST_TEST(offsets.size() == centers.size() + 1);
+		BOOST_TEST(offsets.back() == indices.size());
+
+		for (size_t i = 0; i < centers.size(); ++i)
+		{
+			std::vector<uint32_t> found(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+			std::sort(found.begin(), found.end());
+
+			std::vector<uint32_t> truth = brute_radius(points, centers[i], 1.2f);
+
+			BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), truth.begin(), truth.end());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_nearest)
+{
+	std::vector<react::vec3f> points = test_points(2000, react::vec3f(0.0f), react::vec3f(10.0f));
+	std::vector<react::vec3f> queries = test_points(100, react::vec3f(0.0f), react::vec3f(14.0f));
+
+	react::spatial_hashf A(0.8f);
+	A.build(points.data(), points.size());
+
+	const size_t k = 8;
+
+	for (const react::vec3f& q : queries)
+	{
+		uint32_t found[k];
+		float d2[k];
+
+		BOOST_TEST(A.nearest(q, k, found, d2) == k);
+
+		std::vector<uint32_t> truth = brute_nearest(points, q, k);
+
+		BOOST_CHECK_EQUAL_COLLECTIONS(found, found + k, truth.begin(), truth.end());
+		BOOST_TEST(std::is_sorted(d2, d2 + k));
+	}
+
+	// fewer points than k pads the batch output
+	react::spatial_hashf B(1.0f);
+	B.build(points.data(), 3);
+
+	std::vector<uint32_t> batch(queries.size() * k);
+	B.nearest(queries.data(), queries.size(), k, batch.data(), true);
+
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		std::vector<uint32_t> truth = brute_nearest(std::vector<react::vec3f>(points.begin(), points.begin() + 3), queries[i], k);
+
+		BOOST_CHECK_EQUAL_COLLECTIONS(batch.begin() + i * k, batch.begin() + i * k + 3, truth.begin(), truth.end());
+		BOOST_TEST(batch[i * k + 3] == 0xffffffffu);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_span_batch)
+{
+	std::vector<react::vec3f> points = test_points(2000, react::vec3f(0.0f), react::vec3f(8.0f));
+	std::vector<react::vec3f> queries = test_points(300, react::vec3f(0.0f), react::vec3f(9.0f));
+
+	react::spatial_hashf A(1.0f);
+	A.build(points.data(), points.size());
+
+	// the queries as the positions of 32 byte vertices
+	std::vector<float> vertices(queries.size() * 8, 5.0f);
+	react::vec_span<3, float> strided(vertices.data(), queries.size(), 8 * sizeof(float));
+
+	for (size_t i = 0; i < queries.size(); ++i)
+		strided[i] = queries[i];
+
+	const size_t k = 5;
+
+	for (bool parallel : { false, true })
+	{
+		std::vector<uint32_t> offsets, indices, span_offsets, span_indices;
+
+		A.radius(queries.data(), queries.size(), 1.1f, offsets, indices, parallel);
+		A.radius(strided, 1.1f, span_offsets, span_indices, parallel);
+
+		BOOST_TEST(span_offsets == offsets);
+		BOOST_TEST(span_indices == indices);
+
+		std::vector<uint32_t> nearest(queries.size() * k), span_nearest(queries.size() * k);
+
+		A.nearest(queries.data(), queries.size(), k, nearest.data(), parallel);
+		A.nearest(strided, k, span_nearest.data(), parallel);
+
+		BOOST_TEST(span_nearest == nearest);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_nearest_ties)
+{
+	// every shell around a lattice point ties, whatever the cell size the lower indices are kept
+	std::vector<react::vec3f> points = test_lattice(4);
+
+	for (float cell : { 0.7f, 1.0f, 2.5f })
+	{
+		react::spatial_hashf A(cell);
+		A.build(points.data(), points.size());
+
+		for (size_t k : { 1, 4, 7, 12, 19, 30 })
+		{
+			for (const react::vec3f& p : { react::vec3f(0.0f), react::vec3f(1.0f, -2.0f, 3.0f), react::vec3f(0.5f, 0.5f, 0.0f) })
+			{
+				std::vector<uint32_t> found(k);
+				std::vector<uint32_t> truth = brute_nearest(points, p, k);
+
+				BOOST_TEST(A.nearest(p, k, found.data()) == k);
+				BOOST_TEST(found == truth, boost::test_tools::per_element());
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_far_points)
+{
+	// 3e9 is past int32_t in cells, so the far points are clamped into the outermost cells and share them
+	std::vector<react::vec3f> points = test_points(200, react::vec3f(0.0f), react::vec3f(2.0f));
+	std::vector<react::vec3f> far = test_points(50, react::vec3f(3e9f, -3e9f, 0.0f), react::vec3f(2000.0f));
+
+	points.insert(points.end(), far.begin(), far.end());
+
+	react::spatial_hashf A(0.5f);
+	A.build(points.data(), points.size());
+
+	for (size_t i = 0; i < points.size(); i += 7)
+	{
+		float r = i < 200 ? 1.0f : 1500.0f;
+
+		std::vector<uint32_t> found;
+		A.radius(points[i], r, found);
+		std::sort(found.begin(), found.end());
+
+		std::vector<uint32_t> truth = brute_radius(points, points[i], r);
+
+		BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), truth.begin(), truth.end());
+
+		// near the origin a few neighbours, far out the point itself, either found within the first rings
+		size_t k = i < 200 ? 4 : 1;
+		uint32_t nearest[4];
+
+		BOOST_TEST(A.nearest(points[i], k, nearest) == k);
+
+		truth = brute_nearest(points, points[i], k);
+
+		BOOST_CHECK_EQUAL_COLLECTIONS(nearest, nearest + k, truth.begin(), truth.end());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_update)
+{
+	std::vector<react::vec3f> points = test_points(1000, react::vec3f(0.0f), react::vec3f(6.0f));
+
+	react::spatial_hashf A(2.0f);
+	A.build(points.data(), points.size());
+
+	// tiny moves keep (almost) every point in its cell, large ones force a re-sort
+	for (float step : { 0.0f, 0.7f, 3.1f })
+	{
+		for (size_t i = 0; i < points.size(); ++i)
+			points[i] += react::vec3f(step * sin(static_cast<float>(i)), step * 0.5f, -step * 0.25f);
+
+		bool sorted = A.update(points.data(), step > 1.0f);
+
+		if (step == 0.0f)
+			BOOST_TEST(sorted == false);
+
+		for (size_t q = 0; q < 20; ++q)
+		{
+			react::vec3f c = points[q * 41];
+
+			std::vector<uint32_t> found;
+			A.radius(c, 1.7f, found);
+			std::sort(found.begin(), found.end());
+
+			std::vector<uint32_t> truth = brute_radius(points, c, 1.7f);
+
+			BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), truth.begin(), truth.end());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(spatial_hash_parallel_build)
+{
+	std::vector<react::vec3f> points = test_points(100000, react::vec3f(0.0f), react::vec3f(50.0f));
+
+	react::spatial_hashf A(1.0f);
+	react::spatial_hashf B(1.0f);
+
+	A.build(points.data(), points.size());
+	B.build(points.data(), points.size(), true);
+
+	for (size_t q = 0; q < 100; ++q)
+	{
+		react::vec3f c = points[q * 997];
+
+		std::vector<uint32_t> a;
+		std::vector<uint32_t> b;
+
+		A.radius(c, 2.0f, a);
+		B.radius(c, 2.0f, b);
+
+		// same layout, same order
+		BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
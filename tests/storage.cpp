@@ -0,0 +1,167 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-4f;
+
+BOOST_AUTO_TEST_SUITE(storage)
+
+BOOST_AUTO_TEST_CASE(storage_half)
+{
+	BOOST_TEST(react::half(1.0f).bits == 0x3c00);
+	BOOST_TEST(react::half(-2.0f).bits == 0xc000);
+	BOOST_TEST(react::half(-0.0f).bits == 0x8000);
+	BOOST_TEST(react::half(65504.0f).bits == 0x7bff);
+	BOOST_TEST(react::half(1e6f).bits == 0x7c00);
+	BOOST_TEST(react::half(std::numeric_limits<float>::infinity()).bits == 0x7c00);
+
+	// 65520 is halfway between the largest half and the next step up, and rounds to even, which is infinity
+	BOOST_TEST(react::half(65519.0f).bits == 0x7bff);
+	BOOST_TEST(react::half(65520.0f).bits == 0x7c00);
+
+	// ties to even, 1 + 2^-11 is halfway between 1 and 1 + 2^-10
+	BOOST_TEST(react::half(1.0f + 1.0f / 2048.0f).bits == 0x3c00);
+	BOOST_TEST(react::half(1.0f + 3.0f / 2048.0f).bits == 0x3c02);
+
+	// the smallest subnormal, and half of it which ties down to zero
+	BOOST_TEST(react::half(5.9604645e-8f).bits == 0x0001);
+	BOOST_TEST(react::half(2.9802322e-8f).bits == 0x0000);
+
+	float nan = static_cast<float>(react::half(std::numeric_limits<float>::quiet_NaN()));
+	BOOST_TEST(nan != nan);
+
+	// every finite half survives the trip through float
+	bool same = true;
+
+	for (uint32_t bits = 0; bits < 0x10000; ++bits)
+	{
+		if ((bits & 0x7c00) == 0x7c00 && (bits & 0x3ff))
+			continue;
+
+		react::half h;
+		h.bits = static_cast<uint16_t>(bits);
+
+		same = same && react::half(static_cast<float>(h)).bits == bits;
+	}
+
+	BOOST_TEST(same);
+}
+
+BOOST_AUTO_TEST_CASE(storage_normalized)
+{
+	BOOST_TEST(react::snorm16(1.0f).bits == 32767);
+	BOOST_TEST(react::snorm16(-1.0f).bits == -32767);
+	BOOST_TEST(react::snorm16(3.0f).bits == 32767);
+	BOOST_TEST(react::snorm16(0.5f).bits == 16384);
+
+	react::snorm16 s;
+	s.bits = -32768;
+
+	BOOST_TEST(static_cast<float>(s) == -1.0f);
+	BOOST_TEST(static_cast<float>(react::snorm16(1.0f)) == 1.0f);
+
+	// 127.5 rounds to even
+	BOOST_TEST(react::unorm8(0.5f).bits == 128);
+	BOOST_TEST(react::unorm8(1.0f).bits == 255);
+	BOOST_TEST(react::unorm8(-0.2f).bits == 0);
+	BOOST_TEST(static_cast<float>(react::unorm8(1.0f)) == 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(storage_vectors, *boost::unit_test::tolerance(tolerence))
+{
+	BOOST_TEST(sizeof(react::vec3h) == 6u);
+	BOOST_TEST(sizeof(react::vec4h) == 8u);
+	BOOST_TEST(sizeof(react::vec3sn16) == 6u);
+	BOOST_TEST(sizeof(react::vec4un8) == 4u);
+
+	react::vec3h p = react::vec3f(1.0f, 2.5f, -3.0f);
+	react::vec3f q = p + react::vec3f(1.0f);
+
+	BOOST_TEST((q == react::vec3f(2.0f, 3.5f, -2.0f)));
+	BOOST_TEST(((p * 2.0f) == react::vec3f(2.0f, 5.0f, -6.0f)));
+	BOOST_TEST(((react::vec3f(0.0f) - p) == react::vec3f(-1.0f, -2.5f, 3.0f)));
+	BOOST_TEST(p.dot(react::vec3f(1.0f, 0.0f, 0.0f)) == 1.0f);
+
+	// components read and write as floats
+	p[1] = 0.5f;
+	BOOST_TEST(p[1] + 1.0f == 1.5f);
+
+	react::vec3sn16 n = react::vec3f(2.0f, -1.0f, 2.0f).normalized();
+	BOOST_TEST(n.length() == 1.0f);
+	BOOST_TEST(n.normalized().x() == 2.0f / 3.0f);
+
+	react::vec4un8 colour = react::vec4f(1.0f, 0.0f, 0.5f, 1.0f);
+	react::vec4f c = colour;
+	BOOST_TEST(c.z() == 128.0f / 255.0f);
+}
+
+template <typename V>
+static void storage_test_batch(const std::vector<react::vec3f>& v)
+{
+	std::vector<V> batch(v.size());
+	std::vector<V> threaded(v.size());
+	std::vector<react::vec3f> back(v.size());
+
+	react::storage_pack(v.data(), v.size(), batch.data());
+	react::storage_pack(v.data(), v.size(), threaded.data(), true);
+	react::storage_unpack(batch.data(), batch.size(), back.data(), true);
+
+	bool same = std::memcmp(batch.data(), threaded.data(), batch.size() * sizeof(V)) == 0;
+
+	// the SIMD bodies round exactly as one at a time does
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		V one = v[i];
+		react::vec3f f = one;
+
+		same = same && std::memcmp(&one, &batch[i], sizeof(V)) == 0;
+		same = same && std::memcmp(&f, &back[i], sizeof(f)) == 0;
+	}
+
+	// the same vectors five floats apart, the fourth and fifth left alone
+	std::vector<float> interleaved(v.size() * 5, -7.0f);
+	react::vec_span<3, float> strided(interleaved.data(), v.size(), 5 * sizeof(float));
+	std::vector<V> from_span(v.size());
+
+	for (size_t i = 0; i < v.size(); ++i)
+		strided[i] = v[i];
+
+	react::storage_pack(strided, from_span.data(), true);
+	std::fill(interleaved.begin(), interleaved.end(), -7.0f);
+	react::storage_unpack(batch.data(), strided);
+
+	bool untouched = true;
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		same = same && std::memcmp(&strided[i], &back[i], sizeof(react::vec3f)) == 0;
+		untouched = untouched && interleaved[i * 5 + 3] == -7.0f && interleaved[i * 5 + 4] == -7.0f;
+	}
+
+	same = same && std::memcmp(from_span.data(), batch.data(), batch.size() * sizeof(V)) == 0;
+
+	BOOST_TEST(same);
+	BOOST_TEST(untouched);
+}
+
+BOOST_AUTO_TEST_CASE(storage_batch)
+{
+	// not a multiple of any SIMD width, and some values outside every range
+	std::vector<react::vec3f> v;
+
+	for (int i = 0; i < 100003; ++i)
+	{
+		float a = static_cast<float>(i);
+		v.push_back(react::vec3f(sin(a * 0.37f) * 1.1f, cos(a * 1.3f), sin(a) * a * 0.01f));
+	}
+
+	storage_test_batch<react::vec3h>(v);
+	storage_test_batch<react::vec3sn16>(v);
+	storage_test_batch<react::vec3un8>(v);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,203 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <React-Math.h>
+
+static const float tolerence = 1e-4f;
+
+// Checks U^T U = I for the columns of an orthonormal matrix
+template <size_t M, size_t N, typename T>
+static void svd_check_orthonormal(const react::support::matrix<M, N, T>& m, const T& tolerance)
+{
+	for (size_t i = 0; i < M; ++i)
+		for (size_t j = 0; j < M; ++j)
+			BOOST_TEST(m.col(i).dot(m.col(j)) == static_cast<T>(i == j ? 1 : 0), boost::test_tools::tolerance(tolerance));
+}
+
+BOOST_AUTO_TEST_SUITE(svd)
+
+BOOST_AUTO_TEST_CASE(svd_general, *boost::unit_test::tolerance(1e-9))
+{
+	// tall, 4 rows and 3 columns
+	react::mat3x4d A({ 1.0, 2.0, -1.0, 0.5, 0.0, 3.0, 1.0, -2.0, 4.0, 1.0, 0.0, 2.0 });
+	react::svd<3, 4, double> S(A);
+
+	BOOST_TEST(S.values[0] >= S.values[1]);
+	BOOST_TEST(S.values[1] >= S.values[2]);
+	BOOST_TEST(S.values[2] >= 0.0);
+
+	svd_check_orthonormal(S.u, 1e-12);
+	svd_check_orthonormal(S.v, 1e-12);
+
+	react::mat3x4d R = S.reconstruct();
+
+	for (size_t row = 0; row < 4; ++row)
+		for (size_t col = 0; col < 3; ++col)
+			BOOST_TEST(R(row, col) == A(row, col));
+
+	// wide, the transpose has the same singular values
+	react::svd<4, 3, double> W(A.transpose());
+
+	for (size_t i = 0; i < 3; ++i)
+		BOOST_TEST(W.values[i] == S.values[i]);
+
+	react::support::matrix<4, 3, double> RW = W.reconstruct();
+
+	for (size_t row = 0; row < 3; ++row)
+		for (size_t col = 0; col < 4; ++col)
+			BOOST_TEST(RW(row, col) == A(col, row));
+
+	// sum of squared singular values is the squared Frobenius norm
+	double frobenius = 0.0;
+
+	for (size_t i = 0; i < 12; ++i)
+		frobenius += A.m_data[i] * A.m_data[i];
+
+	BOOST_TEST(S.values.length_squared() == frobenius);
+}
+
+BOOST_AUTO_TEST_CASE(svd_rank_deficient, *boost::unit_test::tolerance(tolerence))
+{
+	// third column is the sum of the first two, rows 3 and 4 repeat rows 1 and 2
+	react::mat4f A({ 1.0f, 2.0f, 1.0f, 2.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 3.0f, 1.0f, 3.0f, 2.0f, -1.0f, 2.0f, -1.0f });
+	react::svd<4, 4, float> S(A);
+
+	BOOST_TEST(S.rank(1e-5f) == 2u);
+	BOOST_TEST(S.condition() > 1e5f);
+
+	svd_check_orthonormal(S.u, 1e-5f);
+	svd_check_orthonormal(S.v, 1e-5f);
+
+	react::mat4f R = S.reconstruct();
+
+	for (size_t row = 0; row < 4; ++row)
+		for (size_t col = 0; col < 4; ++col)
+			BOOST_TEST(R(row, col) == A(row, col));
+
+	react::svd<4, 4, float> Z(react::mat4f(0.0f));
+
+	BOOST_TEST(Z.rank() == 0u);
+	svd_check_orthonormal(Z.u, 1e-6f);
+}
+
+BOOST_AUTO_TEST_CASE(svd_3x3, *boost::unit_test::tolerance(tolerence))
+{
+	std::vector<react::mat3f> matrices =
+	{
+		react::mat3f({ 1.0f, 2.0f, 3.0f, -4.0f, 5.0f, 6.0f, 7.0f, -8.0f, 10.0f }),
+		react::mat3f(),
+		react::mat3f(0.0f),
+		react::mat3f({ 2.0f, 0.0f, 0.0f, 0.0f, -3.0f, 0.0f, 0.0f, 0.0f, 1.0f }),
+		react::mat3f({ 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f }),
+		react::mat3f({ 1e-3f, 2e-3f, 0.0f, 0.0f, 1e-3f, 5e-4f, 3e-3f, 0.0f, 1e-3f }),
+		react::mat3f({ 1e4f, 2e3f, 0.0f, -3e3f, 1e4f, 5e2f, 0.0f, 1e2f, 2e4f })
+	};
+
+	// rotated and scaled matrices, some of them inverted
+	for (int i = 0; i < 20; ++i)
+	{
+		float a = static_cast<float>(i);
+		react::mat3f r = react::quatf(react::vec3f(sin(a), cos(a * 1.3f), 0.5f), a * 0.7f).toMat3();
+		react::mat3f s({ 1.0f + a, 0.3f * a, 0.0f, 0.0f, 2.0f, 0.1f, 0.0f, 0.0f, i % 3 ? 0.5f : -0.5f });
+
+		matrices.push_back(r.dot(s));
+	}
+
+	std::vector<react::svd3f> batch(matrices.size());
+	react::svd3f::compute(matrices.data(), matrices.size(), batch.data(), true);
+
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		const react::mat3f& A = matrices[i];
+		react::svd3f S(A);
+
+		float scale = 1e-30f;
+
+		for (size_t k = 0; k < 9; ++k)
+			scale = std::max(scale, std::abs(A.m_data[k]));
+
+		for (const react::svd3f* s : { &S, &batch[i] })
+		{
+			BOOST_TEST(s->values[0] >= std::abs(s->values[1]) * 0.9999f);
+			BOOST_TEST(s->values[1] >= std::abs(s->values[2]) * 0.9999f);
+
+			// proper rotations
+			BOOST_TEST(s->u.determinant() == 1.0f);
+			BOOST_TEST(s->v.determinant() == 1.0f);
+			svd_check_orthonormal(s->u, 1e-5f);
+			svd_check_orthonormal(s->v, 1e-5f);
+
+			react::mat3f R = s->reconstruct();
+
+			for (size_t k = 0; k < 9; ++k)
+				BOOST_TEST(R.m_data[k] / scale == A.m_data[k] / scale, boost::test_tools::tolerance(1e-3f));
+		}
+
+		// same magnitudes as the general solver
+		react::svd<3, 3, double> G((react::mat3d(A)));
+
+		for (size_t k = 0; k < 3; ++k)
+			BOOST_TEST(std::abs(S.values[k]) / scale == static_cast<float>(G.values[k]) / scale, boost::test_tools::tolerance(1e-3f));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(svd_3x3_double, *boost::unit_test::tolerance(1e-9))
+{
+	react::mat3d A({ 1.0, 2.0, 3.0, -4.0, 5.0, 6.0, 7.0, -8.0, 10.0 });
+	react::svd3d S(A);
+	react::mat3d R = S.reconstruct();
+
+	for (size_t k = 0; k < 9; ++k)
+		BOOST_TEST(R.m_data[k] == A.m_data[k]);
+}
+
+BOOST_AUTO_TEST_CASE(svd_polar, *boost::unit_test::tolerance(tolerence))
+{
+	react::quatf truth(react::vec3f(1.0f, -2.0f, 0.5f), 2.2f);
+	react::mat3f stretch({ 2.0f, 0.3f, 0.1f, 0.3f, 1.5f, -0.2f, 0.1f, -0.2f, 0.8f });
+	react::mat3f A = truth.toMat3().dot(stretch);
+
+	react::polar3f P(A);
+
+	// q and -q are the same rotation
+	float sign = P.rotation.dot(truth) < 0.0f ? -1.0f : 1.0f;
+
+	for (int i = 0; i < 4; ++i)
+		BOOST_TEST(P.rotation[i] * sign == truth[i]);
+
+	for (size_t row = 0; row < 3; ++row)
+		for (size_t col = 0; col < 3; ++col)
+			BOOST_TEST(P.stretch(row, col) == stretch(row, col));
+
+	// an inverted deformation still gives a proper rotation, R S reproduces A
+	react::mat3f flip({ 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f });
+	react::mat3f B = A.dot(flip);
+	react::polar3f Q(B);
+	react::mat3f RS = Q.rotation.toMat3().dot(Q.stretch);
+
+	BOOST_TEST(Q.rotation.toMat3().determinant() == 1.0f);
+
+	for (size_t k = 0; k < 9; ++k)
+		BOOST_TEST(RS.m_data[k] == B.m_data[k]);
+
+	// batch rotations match the single ones
+	std::vector<react::mat3f> matrices(19, A);
+	matrices[3] = B;
+
+	std::vector<react::quatf> rotations(matrices.size());
+	std::vector<react::polar3f> polars(matrices.size());
+
+	react::polar3f::rotations(matrices.data(), matrices.size(), rotations.data(), true);
+	react::polar3f::compute(matrices.data(), matrices.size(), polars.data());
+
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		react::polar3f single(matrices[i]);
+
+		BOOST_TEST(std::abs(rotations[i].dot(single.rotation)) == 1.0f);
+		BOOST_TEST(std::abs(polars[i].rotation.dot(single.rotation)) == 1.0f);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+#ifndef _RM_TEST_POINTS_H
+#define _RM_TEST_POINTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <React-Math.h>
+
+// Point sets and brute force references shared by the spatial query and fitting tests
+
+// Deterministic points scattered through the box center +- spread. The three frequencies share no period, so no two
+// points coincide and none sit on a regular grid.
+inline std::vector<react::vec3f> test_points(const size_t& count, const react::vec3f& center, const react::vec3f& spread)
+{
+	std::vector<react::vec3f> points;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float a = static_cast<float>(i);
+
+		points.push_back(center + react::vec3f(spread.x() * sin(a * 1.731f), spread.y() * cos(a * 0.917f + 0.3f), spread.z() * sin(a * 0.377f + 1.1f)));
+	}
+
+	return points;
+}
+
+// The integer points of [-extent, extent]^3, shuffled so index order is not grid order. Every shell of distances
+// around a lattice point ties.
+inline std::vector<react::vec3f> test_lattice(const int& extent)
+{
+	std::vector<react::vec3f> points;
+
+	for (int x = -extent; x <= extent; ++x)
+		for (int y = -extent; y <= extent; ++y)
+			for (int z = -extent; z <= extent; ++z)
+				points.push_back(react::vec3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)));
+
+	for (size_t i = points.size() - 1; i > 0; --i)
+		std::swap(points[i], points[(i * 7919) % (i + 1)]);
+
+	return points;
+}
+
+// The same in S dimensions, every component in [-extent, extent]
+template <size_t S>
+std::vector<react::support::vector<S, float>> test_vectors(const size_t& count, const float& extent)
+{
+	std::vector<react::support::vector<S, float>> points(count);
+
+	for (size_t i = 0; i < count; ++i)
+		for (size_t a = 0; a < S; ++a)
+			points[i].m_data[a] = extent * sin(static_cast<float>(i) * (0.913f + 0.271f * a) + a);
+
+	return points;
+}
+
+// Every point's squared distance to p with its index, nearest first and ties to the lower index
+template <typename V>
+std::vector<std::pair<float, uint32_t>> brute_sorted(const std::vector<V>& points, const V& p)
+{
+	std::vector<std::pair<float, uint32_t>> d;
+
+	for (size_t i = 0; i < points.size(); ++i)
+		d.push_back(std::make_pair(points[i].distance_squared(p), static_cast<uint32_t>(i)));
+
+	std::sort(d.begin(), d.end());
+
+	return d;
+}
+
+// The indices of the k points nearest to p, nearest first
+template <typename V>
+std::vector<uint32_t> brute_nearest(const std::vector<V>& points, const V& p, const size_t& k)
+{
+	std::vector<std::pair<float, uint32_t>> d = brute_sorted(points, p);
+	std::vector<uint32_t> result;
+
+	for (size_t i = 0; i < std::min(k, d.size()); ++i)
+		result.push_back(d[i].second);
+
+	return result;
+}
+
+// The indices of the points within r of c, in order
+template <typename V>
+std::vector<uint32_t> brute_radius(const std::vector<V>& points, const V& c, const float& r)
+{
+	std::vector<uint32_t> result;
+
+	for (size_t i = 0; i < points.size(); ++i)
+		if (points[i].distance_squared(c) <= r * r)
+			result.push_back(static_cast<uint32_t>(i));
+
+	return result;
+}
+
+#endif
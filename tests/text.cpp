@@ -0,0 +1,242 @@
+#include <boost/test/unit_test.hpp>
+
+#include <clocale>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <React-Math.h>
+
+BOOST_AUTO_TEST_SUITE(text)
+
+BOOST_AUTO_TEST_CASE(text_format)
+{
+	char buffer[256];
+
+	char* end = react::format_to(buffer, react::vec3f(1.5f, -2.0f, 0.25f));
+	BOOST_TEST(std::string(buffer, end) == "1.5 -2 0.25");
+
+	// short values stay short, the rest get the digits they need to read back, not the six operator<< prints
+	end = react::format_to(buffer, react::vec2f(0.1f, 16777215.0f), ',');
+	BOOST_TEST(std::string(buffer, end) == "0.1,16777215");
+
+	// matrices are written row by row whatever the storage order
+	react::mat2f m;
+	m(0, 0) = 1.0f; m(0, 1) = 2.0f;
+	m(1, 0) = 3.0f; m(1, 1) = 4.0f;
+
+	end = react::format_to(buffer, m);
+	BOOST_TEST(std::string(buffer, end) == "1 2 3 4");
+
+	end = react::format_to(buffer, react::quatf(0.0f, 0.0f, 0.0f, 1.0f));
+	BOOST_TEST(std::string(buffer, end) == "0 0 0 1");
+
+	end = react::format_to(buffer, react::vec3i(-2147483647 - 1, 0, 42));
+	BOOST_TEST(std::string(buffer, end) == "-2147483648 0 42");
+
+	std::vector<react::vec2d> v = { react::vec2d(1.0, 2.0), react::vec2d(0.1, -1e300) };
+	std::vector<char> out(v.size() * react::text_capacity<react::vec2d>::value);
+
+	end = react::format_array(out.data(), v.data(), v.size(), ',');
+	BOOST_TEST(std::string(out.data(), end) == "1,2\n0.1,-1e+300\n");
+}
+
+BOOST_AUTO_TEST_CASE(text_parse)
+{
+	react::vec3f v;
+
+	BOOST_TEST(react::parse(" 1.5, -2 ;+0.25 \n", v));
+	BOOST_TEST((v == react::vec3f(1.5f, -2.0f, 0.25f)));
+
+	BOOST_TEST(!react::parse("1 2", v));
+	BOOST_TEST(!react::parse("1 2 3 4", v));
+	BOOST_TEST(!react::parse("1 2 x", v));
+
+	react::mat2f m;
+
+	BOOST_TEST(react::parse("1 2 3 4", m));
+	BOOST_TEST(m(0, 1) == 2.0f);
+	BOOST_TEST(m(1, 0) == 3.0f);
+
+	react::vec3i i;
+
+	BOOST_TEST(react::parse("-7 0 2147483647", i));
+	BOOST_TEST((i == react::vec3i(-7, 0, 2147483647)));
+	BOOST_TEST(!react::parse("0 0 2147483648", i));
+
+	// a component longer than any fixed copy is read whole
+	react::vec2f pair;
+
+	BOOST_TEST(react::parse("0." + std::string(72, '1') + " 5", pair));
+	BOOST_TEST((pair == react::vec2f(1.0f / 9.0f, 5.0f)));
+	BOOST_TEST(!react::parse("0." + std::string(72, '1') + " 5 6", pair));
+
+	// every float survives the trip through text
+	char buffer[react::text_capacity<react::quatf>::value];
+	bool same = true;
+
+	for (int k = 0; k < 20000; ++k)
+	{
+		float a = static_cast<float>(k);
+		react::quatf q(sin(a * 1.37f) * 1e-3f, cos(a * 0.71f) * 1e6f, sin(a) / 7.0f, a * 1e-30f);
+		react::quatf back;
+
+		const char* end = react::format_to(buffer, q, ';');
+		const char* parsed = react::parse(buffer, end, back);
+
+		same = same && parsed == end && std::memcmp(q.m_data, back.m_data, sizeof(q.m_data)) == 0;
+	}
+
+	BOOST_TEST(same);
+}
+
+BOOST_AUTO_TEST_CASE(text_grammar)
+{
+	// the charconv and fallback builds take and refuse the same text
+	react::vec2f v;
+
+	BOOST_TEST(react::parse("-.5e2 1.", v));
+	BOOST_TEST((v == react::vec2f(-50.0f, 1.0f)));
+
+	BOOST_TEST(react::parse("inf -NaN", v));
+	BOOST_TEST(std::isinf(v.x()));
+	BOOST_TEST(std::isnan(v.y()));
+
+	BOOST_TEST(!react::parse("0x10 1", v));
+	BOOST_TEST(!react::parse("1 -0X1p3", v));
+	BOOST_TEST(!react::parse("++1 1", v));
+	BOOST_TEST(!react::parse("+-1 1", v));
+	BOOST_TEST(!react::parse("1 + 1", v));
+	BOOST_TEST(!react::parse("1 1e", v));
+	BOOST_TEST(!react::parse("1e40 1", v));
+	BOOST_TEST(!react::parse("1 1e-50", v));
+
+	BOOST_TEST(react::parse("1 1e-40", v));
+	BOOST_TEST(v.y() > 0.0f);
+}
+
+#ifdef _REACT_TEXT_CHARCONV
+BOOST_AUTO_TEST_CASE(text_shortest)
+{
+	// to_chars gives the shortest text that reads back, the fallback would spend max_digits10 on these
+	char buffer[64];
+
+	char* end = react::format_to(buffer, react::vec3f(0.3f + 0.6f, 1.0f / 3.0f, 2.0f / 3.0f));
+	BOOST_TEST(std::string(buffer, end) == "0.90000004 0.33333334 0.6666667");
+
+	end = react::format_to(buffer, react::vec2d(0.1 + 0.2, 1e23));
+	BOOST_TEST(std::string(buffer, end) == "0.30000000000000004 1e+23");
+
+	react::vec2d back;
+
+	BOOST_TEST(react::parse(std::string(buffer, end), back));
+	BOOST_TEST((back == react::vec2d(0.1 + 0.2, 1e23)));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(text_decimal_comma)
+{
+	// a program that set a decimal comma LC_NUMERIC still writes and reads '.', checked where such a locale exists
+	std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+	bool comma = false;
+
+	for (const char* name : { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "German_Germany.1252" })
+	{
+		if (std::setlocale(LC_NUMERIC, name) && std::localeconv()->decimal_point[0] == ',')
+		{
+			comma = true;
+			break;
+		}
+	}
+
+	if (!comma)
+	{
+		std::setlocale(LC_NUMERIC, previous.c_str());
+		BOOST_TEST_MESSAGE("no decimal comma locale installed, text_decimal_comma skipped");
+		return;
+	}
+
+	char buffer[64];
+	char* end = react::format_to(buffer, react::vec3f(0.5f, -1.25f, 3.0f), ',');
+	std::string text(buffer, end);
+
+	react::vec3f v;
+	bool parsed = react::parse("0.5,-1.25,3", v);
+
+	std::setlocale(LC_NUMERIC, previous.c_str());
+
+	BOOST_TEST(text == "0.5,-1.25,3");
+	BOOST_TEST(parsed);
+	BOOST_TEST((v == react::vec3f(0.5f, -1.25f, 3.0f)));
+}
+
+BOOST_AUTO_TEST_CASE(text_streaming)
+{
+	std::vector<react::vec3f> v;
+
+	for (int k = 0; k < 50000; ++k)
+	{
+		float a = static_cast<float>(k);
+		v.push_back(react::vec3f(sin(a) * 100.0f, cos(a * 0.3f), a));
+	}
+
+	std::ostringstream out;
+	out << "# x, y, z\n";
+
+	BOOST_TEST(react::write_text(out, v.data(), v.size(), ','));
+
+	// a small buffer so values are split across refills
+	std::istringstream in(out.str());
+	react::text_reader<react::vec3f> reader(in, 300);
+	std::vector<react::vec3f> chunk(777);
+	std::vector<react::vec3f> loaded;
+
+	while (size_t n = reader.read(chunk.data(), chunk.size()))
+		loaded.insert(loaded.end(), chunk.begin(), chunk.begin() + n);
+
+	BOOST_TEST((reader.status() == react::text_status::ok));
+	BOOST_TEST((loaded == v));
+	BOOST_TEST(reader.line() == v.size() + 2);
+
+	// the same text parsed in place, several elements to a line
+	std::string flat = "1 2 3 4 5 6\n7,8,9\n# done\n";
+	react::text_reader<react::vec3f> memory(flat.data(), flat.data() + flat.size());
+	react::vec3f three[4];
+
+	BOOST_TEST(memory.read(three, 4) == 3u);
+	BOOST_TEST((memory.status() == react::text_status::ok));
+	BOOST_TEST((three[2] == react::vec3f(7.0f, 8.0f, 9.0f)));
+
+	// errors stop the reader and say where
+	std::istringstream bad("1 2 3\n4 5 6\nx,y,z\n");
+	std::vector<react::vec3f> some;
+
+	BOOST_TEST((react::read_text(bad, some) == react::text_status::bad_value));
+	BOOST_TEST(some.size() == 2u);
+
+	// numbers longer than a token, and longer than the whole buffer, are read whole rather than as two values
+	std::string digits = "0." + std::string(152, '1');
+	std::istringstream split(std::string(150, ' ') + digits + " 5 6\n");
+	react::text_reader<react::vec3f> split_reader(split, 256);
+
+	BOOST_TEST(split_reader.read(three, 4) == 1u);
+	BOOST_TEST((split_reader.status() == react::text_status::ok));
+	BOOST_TEST((three[0] == react::vec3f(1.0f / 9.0f, 5.0f, 6.0f)));
+
+	std::string longer = "1 2," + std::string(1000, '0') + "3\n";
+	std::istringstream whole(longer + longer);
+	std::vector<react::vec3f> grown;
+
+	BOOST_TEST((react::read_text(whole, grown) == react::text_status::ok));
+	BOOST_TEST(grown.size() == 2u);
+	BOOST_TEST((grown[1] == react::vec3f(1.0f, 2.0f, 3.0f)));
+
+	react::text_reader<react::vec3f> truncated("1 2 3 4 5", "1 2 3 4 5" + 9);
+
+	BOOST_TEST(truncated.read(three, 4) == 1u);
+	BOOST_TEST((truncated.status() == react::text_status::truncated));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,194 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <React-Math.h>
+
+// components from a small range of integers, so every score is exact and many tie
+template <size_t S, typename T = float>
+static std::vector<react::support::vector<S, T>> topk_test_vectors(const size_t& count, const int& range, const size_t& seed)
+{
+	std::vector<react::support::vector<S, T>> v(count);
+	uint32_t s = static_cast<uint32_t>(seed * 2654435761u + 1);
+
+	for (auto& x : v)
+	{
+		for (size_t i = 0; i < S; ++i)
+		{
+			s = s * 1664525u + 1013904223u;
+			x[i] = static_cast<T>(static_cast<int>((s >> 16) % (2 * range + 1)) - range);
+		}
+	}
+
+	return v;
+}
+
+// the vectors copied 'pad' components apart, as a strided span sees them
+template <size_t S, typename T>
+static std::vector<T> topk_test_interleave(const std::vector<react::support::vector<S, T>>& v, const size_t& pad)
+{
+	std::vector<T> data(v.size() * (S + pad), T(99));
+
+	for (size_t i = 0; i < v.size(); ++i)
+		std::copy(v[i].m_data, v[i].m_data + S, data.begin() + i * (S + pad));
+
+	return data;
+}
+
+// every score, sorted best first with ties to the lower index
+template <size_t S, typename T>
+static void topk_test_reference(const react::support::vector<S, T>& query, const std::vector<react::support::vector<S, T>>& db, const bool& l2, const size_t& k, std::vector<uint32_t>& indices, std::vector<T>& scores)
+{
+	std::vector<std::pair<T, uint32_t>> all;
+
+	for (size_t i = 0; i < db.size(); ++i)
+	{
+		T score = l2 ? -query.distance_squared(db[i]) : query.dot(db[i]);
+
+		if (score > react::support::topk_floor<T>())
+			all.push_back(std::make_pair(score, static_cast<uint32_t>(i)));
+	}
+
+	std::sort(all.begin(), all.end(), [](const std::pair<T, uint32_t>& a, const std::pair<T, uint32_t>& b)
+	{
+		return a.first > b.first || (a.first == b.first && a.second < b.second);
+	});
+
+	indices.assign(k, react::TOPK_EMPTY);
+	scores.assign(k, T(0));
+
+	for (size_t i = 0; i < std::min(k, all.size()); ++i)
+	{
+		indices[i] = all[i].second;
+		scores[i] = l2 ? -all[i].first : all[i].first;
+	}
+}
+
+template <size_t S, typename T = float>
+static void topk_test_exact(const size_t& n, const size_t& count, const size_t& k, const int& range)
+{
+	const std::vector<react::support::vector<S, T>> db = topk_test_vectors<S, T>(n, range, 1);
+	const std::vector<react::support::vector<S, T>> queries = topk_test_vectors<S, T>(count, range, 2);
+
+	const std::vector<T> query_data = topk_test_interleave(queries, 1);
+	const std::vector<T> db_data = topk_test_interleave(db, 3);
+	const react::vec_span<S, const T> query_span(query_data.data(), count, (S + 1) * sizeof(T));
+	const react::vec_span<S, const T> db_span(db_data.data(), n, (S + 3) * sizeof(T));
+
+	const bool metrics[] = { false, true };
+
+	for (bool l2 : metrics)
+	{
+		std::vector<uint32_t> indices(count * k), threaded(count * k), strided(count * k);
+		std::vector<T> scores(count * k), threaded_scores(count * k), strided_scores(count * k);
+
+		if (l2)
+		{
+			react::topk_l2(queries.data(), count, db.data(), n, k, indices.data(), scores.data());
+			react::topk_l2(queries.data(), count, db.data(), n, k, threaded.data(), threaded_scores.data(), true);
+			react::topk_l2(query_span, db_span, k, strided.data(), strided_scores.data(), true);
+		}
+		else
+		{
+			react::topk_dot(queries.data(), count, db.data(), n, k, indices.data(), scores.data());
+			react::topk_dot(queries.data(), count, db.data(), n, k, threaded.data(), threaded_scores.data(), true);
+			react::topk_dot(query_span, db_span, k, strided.data(), strided_scores.data(), true);
+		}
+
+		// the unused slots' NaN scores compare by their bits
+		bool same = indices == threaded && std::memcmp(scores.data(), threaded_scores.data(), scores.size() * sizeof(T)) == 0;
+		same = same && indices == strided && std::memcmp(scores.data(), strided_scores.data(), scores.size() * sizeof(T)) == 0;
+		bool match = true;
+
+		for (size_t q = 0; q < count; ++q)
+		{
+			std::vector<uint32_t> truth;
+			std::vector<T> truth_scores;
+			topk_test_reference(queries[q], db, l2, k, truth, truth_scores);
+
+			std::vector<uint32_t> one(k);
+			std::vector<T> one_scores(k);
+			size_t found = l2 ? react::topk_l2(queries[q], db.data(), n, k, one.data(), one_scores.data())
+				: react::topk_dot(queries[q], db.data(), n, k, one.data(), one_scores.data());
+
+			match = match && found == std::min(k, n);
+			match = match && std::equal(truth.begin(), truth.end(), indices.begin() + q * k);
+			match = match && std::equal(truth.begin(), truth.end(), one.begin());
+
+			for (size_t i = 0; i < found; ++i)
+				match = match && scores[q * k + i] == truth_scores[i] && one_scores[i] == truth_scores[i];
+		}
+
+		BOOST_TEST(same);
+		BOOST_TEST(match);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(topk)
+
+BOOST_AUTO_TEST_CASE(topk_exact)
+{
+	// a lane tail, queries not a multiple of four, several blocks and, threaded, several chunks
+	topk_test_exact<20>(10000, 7, 10, 3);
+	topk_test_exact<128>(3000, 5, 32, 2);
+	topk_test_exact<3>(500, 4, 1, 1);
+
+	// more asked for than there are, and a database shorter than a tile
+	topk_test_exact<16>(37, 3, 50, 4);
+	topk_test_exact<16>(1, 2, 3, 4);
+
+	// integers, where most dot products are not positive and every distance is
+	topk_test_exact<7, int>(2000, 5, 12, 9);
+	topk_test_exact<32, int64_t>(700, 3, 20, 100);
+}
+
+BOOST_AUTO_TEST_CASE(topk_float)
+{
+	const size_t n = 20000;
+	const size_t k = 16;
+
+	// in [-1, 1], with no near ties for rounding to reorder
+	std::vector<react::support::vector<64, float>> db = topk_test_vectors<64>(n, 1000, 3);
+	react::support::vector<64, float> query = topk_test_vectors<64>(1, 1000, 4)[0] * 0.001f;
+
+	for (auto& v : db)
+		v *= 0.001f;
+
+	// unusable vectors are never picked
+	db[5][3] = std::numeric_limits<float>::quiet_NaN();
+	db[6][0] = std::numeric_limits<float>::infinity();
+
+	std::vector<uint32_t> indices(k);
+	std::vector<float> scores(k);
+
+	BOOST_TEST(react::topk_l2(query, db.data(), n, k, indices.data(), scores.data()) == k);
+
+	std::vector<uint32_t> truth;
+	std::vector<float> truth_scores;
+	topk_test_reference(query, db, true, n, truth, truth_scores);
+
+	// the scores agree with distance_squared to rounding, and none closer was missed
+	bool close = true;
+	bool sorted = true;
+
+	for (size_t i = 0; i < k; ++i)
+	{
+		close = close && indices[i] != 5 && indices[i] != 6;
+		close = close && std::abs(scores[i] - query.distance_squared(db[indices[i]])) <= 1e-5f * scores[i];
+		sorted = sorted && (i == 0 || scores[i - 1] <= scores[i]);
+	}
+
+	BOOST_TEST(close);
+	BOOST_TEST(sorted);
+	BOOST_TEST(scores[k - 1] <= truth_scores[k - 1] * (1.0f + 1e-5f));
+	BOOST_TEST(std::count(truth.begin(), truth.begin() + k, indices[0]) == 1);
+
+	BOOST_TEST(react::topk_dot(query, db.data(), n, 0, indices.data()) == 0u);
+	BOOST_TEST(react::topk_dot(query, db.data(), 0, k, indices.data()) == 0u);
+	BOOST_TEST(indices[0] == react::TOPK_EMPTY);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,16 @@
 
 constexpr float tolerence = std::numeric_limits<float>::epsilon();
 
+// a type that opts into compensated sums by default
+namespace react
+{
+	template <>
+	struct accumulation_traits<support::vector<7, float>>
+	{
+		static accumulation policy() { return accumulation::compensated; }
+	};
+}
+
 BOOST_AUTO_TEST_SUITE(vector)
 
 BOOST_AUTO_TEST_CASE(vector_default_constructor)
@@ -167,6 +177,99 @@ BOOST_AUTO_TEST_CASE(vector_accessors)
 	BOOST_TEST(B[3] == B3_truth);
 }
 
+BOOST_AUTO_TEST_CASE(vector_swizzle)
+{
+	react::vec4f A(1.0f, 2.0f, 3.0f, 4.0f);
+	const react::vec3f B(5.0f, 6.0f, 7.0f);
+
+	react::vec3f Azyx_truth(3.0f, 2.0f, 1.0f);
+	react::vec2f Awx_truth(4.0f, 1.0f);
+	react::vec3f Bxxy_truth(5.0f, 5.0f, 6.0f);
+	react::vec4f Awzyx_truth(4.0f, 3.0f, 2.0f, 1.0f);
+
+	BOOST_TEST(A.zyx() == Azyx_truth);
+	BOOST_TEST(A.wx() == Awx_truth);
+	BOOST_TEST(B.xxy() == Bxxy_truth);
+	BOOST_TEST((A.swizzle<3, 2, 1, 0>() == Awzyx_truth));
+
+	// views convert to vectors wherever one is expected
+	react::vec3f C = A.zyx();
+	react::vec3f D = B.cross(A.xyz());
+	react::vec3f E = 2.0f * A.xyz() + B;
+
+	react::vec3f D_truth(4.0f, -8.0f, 4.0f);
+	react::vec3f E_truth(7.0f, 10.0f, 13.0f);
+
+	BOOST_TEST(C == Azyx_truth);
+	BOOST_TEST(D == D_truth);
+	BOOST_TEST(E == E_truth);
+	BOOST_TEST(A.xy().dot(B.yz()) == 20.0f);
+	BOOST_TEST(A.xz().length_squared() == 10.0f);
+
+	// a temporary's swizzle is a copy, so it outlives the temporary
+	auto F = (A + react::vec4f(1.0f)).wzy();
+	auto G = react::vec4f(1.0f, 2.0f, 3.0f, 4.0f).swizzle<1, 0>();
+
+	BOOST_TEST((std::is_same<decltype(F), react::support::vector<3, float>>::value));
+	BOOST_TEST((std::is_same<decltype(G), react::support::vector<2, float>>::value));
+	BOOST_TEST(F == react::vec3f(5.0f, 4.0f, 3.0f));
+	BOOST_TEST(G == react::vec2f(2.0f, 1.0f));
+}
+
+BOOST_AUTO_TEST_CASE(vector_swizzle_write)
+{
+	react::vec4f A(1.0f, 2.0f, 3.0f, 4.0f);
+
+	// a write mask leaves the other components alone
+	A.xz() = react::vec2f(8.0f, 9.0f);
+
+	float A_truth[] = { 8.0f, 2.0f, 9.0f, 4.0f };
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(A.m_data, A.m_data + 4, A_truth, A_truth + 4);
+
+	// overlapping views of the same vector
+	A.xyz() = A.zyx();
+
+	float B_truth[] = { 9.0f, 2.0f, 8.0f, 4.0f };
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(A.m_data, A.m_data + 4, B_truth, B_truth + 4);
+
+	A.yw() += react::vec2f(1.0f, 2.0f);
+	A.zx() *= 0.5f;
+
+	float C_truth[] = { 4.5f, 3.0f, 4.0f, 6.0f };
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(A.m_data, A.m_data + 4, C_truth, C_truth + 4);
+
+	A.w() = 0.0f;
+	A.wy()[0] = 1.0f;
+
+	BOOST_TEST(A.w() == 1.0f);
+
+	// a view written from the vector it views
+	react::vec2f B(1.0f, 2.0f);
+	B.yx() = B;
+
+	BOOST_TEST(B.x() == 2.0f);
+	BOOST_TEST(B.y() == 1.0f);
+
+	B.yx() += B;
+
+	BOOST_TEST(B.x() == 3.0f);
+	BOOST_TEST(B.y() == 3.0f);
+}
+
+BOOST_AUTO_TEST_CASE(vector_swizzle_compare)
+{
+	// views compare as the vectors they convert to, within epsilon
+	react::vec3f A(0.5f, 0.25f, 1.0f);
+	react::vec2f B(0.50000006f, 0.25f);
+
+	BOOST_TEST(A.xy() == B);
+	BOOST_TEST(react::vec2f(A.xy()) == B);
+	BOOST_TEST(A.yx() != B);
+}
+
 BOOST_AUTO_TEST_CASE(vector_angle)
 {
 	react::vec3f A = react::vec3f::UP;
@@ -192,6 +295,68 @@ BOOST_AUTO_TEST_CASE(vector_dot)
 	BOOST_TEST(A.dot(B) == truth);
 }
 
+BOOST_AUTO_TEST_CASE(vector_dot_accumulation)
+{
+	// the ones vanish next to 1e8 in a float running sum
+	react::support::vector<12, float> S(1.0f);
+	react::support::vector<12, float> T(1.0f);
+
+	S[0] = 1e8f;
+	S[2] = -1e8f;
+
+	BOOST_TEST(S.dot(T) == 9.0f);
+	BOOST_TEST(S.dot(T, react::accumulation::in_double) == 10.0f);
+	BOOST_TEST(S.dot(T, react::accumulation::compensated) == 10.0f);
+
+	// and in the 32 interleaved sums, the seven ones sharing a sum with each 1e8, then 1e8 + 56 and -1e8 + 56
+	// folded before they cancel
+	react::support::vector<256, float> A(1.0f);
+	react::support::vector<256, float> B(1.0f);
+
+	A[0] = 1e8f;
+	A[2] = -1e8f;
+
+	BOOST_TEST(A.dot(B) == 240.0f);
+	BOOST_TEST(A.dot(B, react::accumulation::in_double) == 254.0f);
+	BOOST_TEST(A.dot(B, react::accumulation::compensated) == 254.0f);
+
+	// a long sum of values that do not add exactly, against a double reference
+	react::support::vector<4096, float> C;
+	react::support::vector<4096, float> D;
+	double truth = 0.0;
+
+	for (size_t i = 0; i < 4096; ++i)
+	{
+		C[i] = 1.0f + static_cast<float>(i % 97) * 0.01f;
+		D[i] = 0.1f + static_cast<float>(i % 13) * 0.37f;
+		truth += static_cast<double>(C[i]) * D[i];
+	}
+
+	const double native = std::abs(C.dot(D) - truth);
+	const double pairwise = std::abs(C.dot(D, react::accumulation::pairwise) - truth);
+	const double half_ulp = truth * std::numeric_limits<float>::epsilon() * 0.5;
+
+	BOOST_TEST(native <= 4.0 * half_ulp);
+	BOOST_TEST(pairwise <= 4.0 * half_ulp);
+	BOOST_TEST(std::abs(C.dot(D, react::accumulation::in_double) - truth) <= half_ulp);
+	BOOST_TEST(std::abs(C.dot(D, react::accumulation::compensated) - truth) <= half_ulp);
+	BOOST_TEST(std::abs(react::support::vector<4096, float>::dot(C, D, react::accumulation::in_double) - truth) <= half_ulp);
+
+	// the type's own default
+	react::support::vector<7, float> E(1.0f);
+	react::support::vector<7, float> F(1.0f);
+
+	E[0] = 1e8f;
+	E[2] = -1e8f;
+
+	BOOST_TEST(E.dot(F) == 5.0f);
+	BOOST_TEST(E.dot(F, react::accumulation::native) == 4.0f);
+
+	// integers sum exactly whatever the policy
+	react::support::vector<5, int> G(3);
+	BOOST_TEST(G.dot(G, react::accumulation::compensated) == 45);
+}
+
 BOOST_AUTO_TEST_CASE(vector_distance, * boost::unit_test::tolerance(tolerence))
 {
 	react::vec3f A(-5.0f, 2.0f, 7.0f);
@@ -210,6 +375,21 @@ BOOST_AUTO_TEST_CASE(vector_distance, * boost::unit_test::tolerance(tolerence))
 	BOOST_TEST(C.distance(D) == CD_truth);
 }
 
+BOOST_AUTO_TEST_CASE(vector_distance_squared, * boost::unit_test::tolerance(tolerence))
+{
+	react::vec3f A(-5.0f, 2.0f, 7.0f);
+	react::vec3f B(3.0f, -4.0f, -1.0f);
+
+	react::vec4f C(-2.0f, 7.0f, 1.0f, -3.0f);
+	react::vec4f D(1.0f, -2.0f, 4.0f, 0.0f);
+
+	float AB_truth = 164.0f;
+	float CD_truth = 108.0f;
+
+	BOOST_TEST(A.distance_squared(B) == AB_truth);
+	BOOST_TEST(react::vec4f::distance_squared(C, D) == CD_truth);
+}
+
 BOOST_AUTO_TEST_CASE(vector_length, *boost::unit_test::tolerance(tolerence))
 {
 	react::vec3f A(5.0f, 3.0f, 4.0f);
@@ -220,6 +400,11 @@ BOOST_AUTO_TEST_CASE(vector_length, *boost::unit_test::tolerance(tolerence))
 
 	BOOST_TEST(A.length() == A_truth);
 	BOOST_TEST(B.length() == B_truth);
+
+	react::support::vector<1024, float> C(0.1f);
+
+	BOOST_TEST(C.length_squared(react::accumulation::in_double) == static_cast<float>(1024.0 * double(0.1f) * double(0.1f)));
+	BOOST_TEST((C.length(react::accumulation::pairwise) == react::support::vector<1024, float>::length(C, react::accumulation::compensated)));
 }
 
 BOOST_AUTO_TEST_CASE(vector_max_min)
@@ -252,6 +437,65 @@ BOOST_AUTO_TEST_CASE(vector_normalize)
 	BOOST_TEST(C == C_truth);
 }
 
+template <size_t S, typename T>
+static void vector_test_large()
+{
+	react::support::vector<S, T> A;
+	react::support::vector<S, T> B;
+
+	// small integers, so every order of summing is exact and each term must be counted once
+	for (size_t i = 0; i < S; ++i)
+	{
+		A[i] = static_cast<T>(static_cast<int>(i % 7) - 3);
+		B[i] = static_cast<T>(static_cast<int>(i % 5) - 2);
+	}
+
+	T dot = 0;
+	T distance = 0;
+
+	for (size_t i = 0; i < S; ++i)
+	{
+		dot += A[i] * B[i];
+		distance += (A[i] - B[i]) * (A[i] - B[i]);
+	}
+
+	BOOST_TEST(A.dot(B) == dot);
+	BOOST_TEST(A.length_squared() == A.dot(A));
+	BOOST_TEST(A.distance_squared(B) == distance);
+	BOOST_TEST(A.distance(B) == std::sqrt(distance));
+
+	react::support::vector<S, T> C = A.normalized();
+	A.normalize();
+
+	BOOST_TEST(std::memcmp(&A, &C, sizeof(A)) == 0);
+	BOOST_TEST(std::abs(A.length() - T(1)) < 4 * std::numeric_limits<T>::epsilon());
+}
+
+BOOST_AUTO_TEST_CASE(vector_large)
+{
+	// below the interleaved sums, at them, and with 1, 7 and 8 terms past the last whole block
+	vector_test_large<15, float>();
+	vector_test_large<16, float>();
+	vector_test_large<33, float>();
+	vector_test_large<71, float>();
+	vector_test_large<1024, float>();
+	vector_test_large<40, double>();
+	vector_test_large<512, double>();
+
+	// the layout is T's in every language mode, so C++14 and C++17 code can share vectors
+	BOOST_TEST(sizeof(react::support::vector<64, float>) == 256u);
+	BOOST_TEST(sizeof(react::support::vector<17, float>) == 68u);
+	BOOST_TEST(alignof(react::support::vector<17, float>) == alignof(float));
+	BOOST_TEST(alignof(react::support::vector<64, float>) == alignof(float));
+	BOOST_TEST(alignof(react::vec4f) == alignof(float));
+
+	// line alignment is the storage's, an aligned_vector puts each on a line
+	react::support::aligned_vector<react::support::vector<64, float>, 64> lines(3);
+
+	for (size_t i = 0; i < lines.size(); ++i)
+		BOOST_TEST(reinterpret_cast<uintptr_t>(&lines[i]) % 64 == 0u);
+}
+
 BOOST_AUTO_TEST_CASE(vector_lerp)
 {
 	react::vec3f A = react::vec3f::UP;